@@ -0,0 +1,180 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <math.h>
+#include "dsps_ahrs.h"
+#include "dsps_fastmath.h"
+
+static inline int32_t ahrs_mul_q30(int64_t a, int64_t b)
+{
+    return (int32_t)((a * b + (1 << 29)) >> 30);
+}
+
+// Normalization factor of a vector with squared norm n2: x/sqrt(n2) in Q30 is (x * r) >> shift
+static int32_t ahrs_rsqrt(uint64_t n2, int *shift)
+{
+    const int bits = 64 - __builtin_clzll(n2);
+    // Even d that takes n2 to m = n2 / 2^d in [2^29, 2^31), where dsps_fast_rsqrt_q30 does not saturate
+    int d = bits - 31;
+    if (d & 1) {
+        d++;
+    }
+    const uint32_t m = (d >= 0) ? (uint32_t)(n2 >> d) : (uint32_t)(n2 << -d);
+    *shift = 15 + d / 2;
+    return dsps_fast_rsqrt_q30((int32_t)m);
+}
+
+static inline int32_t ahrs_scale(int64_t x, int32_t r, int shift)
+{
+    return (shift > 0) ? (int32_t)((x * r + ((int64_t)1 << (shift - 1))) >> shift) : (int32_t)(x * r);
+}
+
+esp_err_t dsps_ahrs_mahony_init_q30(ahrs_q30_t *ahrs, float sample_rate, int gyro_range_dps, float kp, float ki)
+{
+    if ((gyro_range_dps != 250) && (gyro_range_dps != 500) && (gyro_range_dps != 1000) && (gyro_range_dps != 2000)) {
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    if (!(sample_rate > 0) || !(kp >= 0) || !(ki >= 0)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    const double scale = gyro_range_dps * M_PI / 180 / 32768;
+    const double dt = 1.0 / sample_rate;
+    const double kp_k = kp / scale * 65536;
+    const double ki_k = ki * dt / scale * 65536;
+    if ((kp_k >= INT32_MAX) || (ki_k >= INT32_MAX)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    double h = scale * dt / 2 * (1 << 30);
+    int shift = 0;
+    while ((h * 2 < INT32_MAX) && (shift < 30)) {
+        h *= 2;
+        shift++;
+    }
+    ahrs->q[0] = DSPS_AHRS_Q30_ONE;
+    ahrs->q[1] = 0;
+    ahrs->q[2] = 0;
+    ahrs->q[3] = 0;
+    ahrs->bias[0] = 0;
+    ahrs->bias[1] = 0;
+    ahrs->bias[2] = 0;
+    ahrs->kp = (int32_t)lround(kp_k);
+    ahrs->ki = (int32_t)lround(ki_k);
+    ahrs->gyro_k = (int32_t)lround(h);
+    ahrs->gyro_shift = shift;
+    ahrs->count = 0;
+    return ESP_OK;
+}
+
+// Shortest rotation that takes the measured gravity direction (Q30) to the earth z axis, yaw 0
+static void ahrs_align_q30(ahrs_q30_t *ahrs, int32_t ax, int32_t ay, int32_t az)
+{
+    const int64_t w = (int64_t)DSPS_AHRS_Q30_ONE + az;
+    if (w < (1 << 12)) {
+        // Upside down
+        ahrs->q[0] = 0;
+        ahrs->q[1] = DSPS_AHRS_Q30_ONE;
+        ahrs->q[2] = 0;
+        ahrs->q[3] = 0;
+        return;
+    }
+    // Components halved, so the sum of squares fits in 63 bits
+    const int64_t w2 = w >> 1, x2 = ay >> 1, y2 = -(int64_t)ax >> 1;
+    int shift;
+    int32_t r = ahrs_rsqrt((uint64_t)(w2 * w2 + x2 * x2 + y2 * y2), &shift);
+    ahrs->q[0] = ahrs_scale(w2, r, shift);
+    ahrs->q[1] = ahrs_scale(x2, r, shift);
+    ahrs->q[2] = ahrs_scale(y2, r, shift);
+    ahrs->q[3] = 0;
+}
+
+esp_err_t dsps_ahrs_mahony_q30(ahrs_q30_t *ahrs, const int16_t *raw, int len)
+{
+    const int64_t kp = ahrs->kp;
+    const int64_t ki = ahrs->ki;
+    const int64_t gyro_k = ahrs->gyro_k;
+    const int gyro_shift = 8 + ahrs->gyro_shift;
+    const int64_t gyro_round = (int64_t)1 << (gyro_shift - 1);
+    int32_t q0 = ahrs->q[0], q1 = ahrs->q[1], q2 = ahrs->q[2], q3 = ahrs->q[3];
+    int32_t bx = ahrs->bias[0], by = ahrs->bias[1], bz = ahrs->bias[2];
+
+    for (int i = 0; i < len; i++, raw += 6) {
+        // Rates in Q16 LSB
+        int64_t gx = (int64_t)raw[3] * 65536 - bx;
+        int64_t gy = (int64_t)raw[4] * 65536 - by;
+        int64_t gz = (int64_t)raw[5] * 65536 - bz;
+        const int32_t ax_raw = raw[0], ay_raw = raw[1], az_raw = raw[2];
+        uint32_t an = (uint32_t)(ax_raw * ax_raw) + (uint32_t)(ay_raw * ay_raw) + (uint32_t)(az_raw * az_raw);
+        if (an > 0) {
+            int shift;
+            int32_t r = ahrs_rsqrt(an, &shift);
+            // Unit gravity in Q30
+            int32_t ax = ahrs_scale(ax_raw, r, shift);
+            int32_t ay = ahrs_scale(ay_raw, r, shift);
+            int32_t az = ahrs_scale(az_raw, r, shift);
+            if (ahrs->count == 0) {
+                ahrs_align_q30(ahrs, ax, ay, az);
+                q0 = ahrs->q[0], q1 = ahrs->q[1], q2 = ahrs->q[2], q3 = ahrs->q[3];
+            }
+            // Estimated gravity in body coordinates, the error is its cross product with the measured one
+            int32_t vx = (int32_t)(((int64_t)q1 * q3 - (int64_t)q0 * q2 + (1 << 28)) >> 29);
+            int32_t vy = (int32_t)(((int64_t)q0 * q1 + (int64_t)q2 * q3 + (1 << 28)) >> 29);
+            int32_t vz = (int32_t)(((int64_t)q0 * q0 - (int64_t)q1 * q1 - (int64_t)q2 * q2 + (int64_t)q3 * q3 + (1 << 29)) >> 30);
+            int32_t ex = ahrs_mul_q30(ay, vz) - ahrs_mul_q30(az, vy);
+            int32_t ey = ahrs_mul_q30(az, vx) - ahrs_mul_q30(ax, vz);
+            int32_t ez = ahrs_mul_q30(ax, vy) - ahrs_mul_q30(ay, vx);
+            bx -= ahrs_mul_q30(ki, ex);
+            by -= ahrs_mul_q30(ki, ey);
+            bz -= ahrs_mul_q30(ki, ez);
+            gx += ahrs_mul_q30(kp, ex);
+            gy += ahrs_mul_q30(kp, ey);
+            gz += ahrs_mul_q30(kp, ez);
+        }
+        ahrs->count++;
+
+        // Half rotation of the sample in Q30, then q += q*(0, h)
+        int32_t hx = (int32_t)(((gx >> 8) * gyro_k + gyro_round) >> gyro_shift);
+        int32_t hy = (int32_t)(((gy >> 8) * gyro_k + gyro_round) >> gyro_shift);
+        int32_t hz = (int32_t)(((gz >> 8) * gyro_k + gyro_round) >> gyro_shift);
+        int64_t n0 = (int64_t)q0 * DSPS_AHRS_Q30_ONE - (int64_t)q1 * hx - (int64_t)q2 * hy - (int64_t)q3 * hz;
+        int64_t n1 = (int64_t)q1 * DSPS_AHRS_Q30_ONE + (int64_t)q0 * hx + (int64_t)q2 * hz - (int64_t)q3 * hy;
+        int64_t n2 = (int64_t)q2 * DSPS_AHRS_Q30_ONE + (int64_t)q0 * hy - (int64_t)q1 * hz + (int64_t)q3 * hx;
+        int64_t n3 = (int64_t)q3 * DSPS_AHRS_Q30_ONE + (int64_t)q0 * hz + (int64_t)q1 * hy - (int64_t)q2 * hx;
+        q0 = (int32_t)((n0 + (1 << 29)) >> 30);
+        q1 = (int32_t)((n1 + (1 << 29)) >> 30);
+        q2 = (int32_t)((n2 + (1 << 29)) >> 30);
+        q3 = (int32_t)((n3 + (1 << 29)) >> 30);
+
+        // |q|^2 is close to 1, so a single rsqrt in Q30 normalizes it
+        int32_t qn2 = (int32_t)(((int64_t)q0 * q0 + (int64_t)q1 * q1 + (int64_t)q2 * q2 + (int64_t)q3 * q3 + (1 << 29)) >> 30);
+        int32_t r = dsps_fast_rsqrt_q30(qn2);
+        q0 = ahrs_mul_q30(q0, r);
+        q1 = ahrs_mul_q30(q1, r);
+        q2 = ahrs_mul_q30(q2, r);
+        q3 = ahrs_mul_q30(q3, r);
+    }
+    ahrs->q[0] = q0;
+    ahrs->q[1] = q1;
+    ahrs->q[2] = q2;
+    ahrs->q[3] = q3;
+    ahrs->bias[0] = bx;
+    ahrs->bias[1] = by;
+    ahrs->bias[2] = bz;
+    return ESP_OK;
+}
+
+esp_err_t dsps_ahrs_euler_q30(const ahrs_q30_t *ahrs, int32_t *euler)
+{
+    const int64_t q0 = ahrs->q[0], q1 = ahrs->q[1], q2 = ahrs->q[2], q3 = ahrs->q[3];
+    const int64_t one = (int64_t)1 << 60;
+    int64_t sp = (q0 * q2 - q3 * q1) >> 29;
+    sp = (sp > DSPS_AHRS_Q30_ONE) ? DSPS_AHRS_Q30_ONE : ((sp < -DSPS_AHRS_Q30_ONE) ? -DSPS_AHRS_Q30_ONE : sp);
+    int64_t cp2 = ((one - sp * sp) >> 29);
+    int32_t cp = dsps_fast_sqrt_q31((cp2 > INT32_MAX) ? INT32_MAX : (int32_t)cp2) >> 1;
+    euler[0] = dsps_fast_atan2_q31((int32_t)((q0 * q1 + q2 * q3) >> 29), (int32_t)((one - 2 * (q1 * q1 + q2 * q2)) >> 30));
+    euler[1] = dsps_fast_atan2_q31((int32_t)sp, cp);
+    euler[2] = dsps_fast_atan2_q31((int32_t)((q0 * q3 + q1 * q2) >> 29), (int32_t)((one - 2 * (q2 * q2 + q3 * q3)) >> 30));
+    return ESP_OK;
+}
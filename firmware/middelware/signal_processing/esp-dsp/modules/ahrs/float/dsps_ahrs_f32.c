@@ -0,0 +1,207 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "dsps_ahrs.h"
+#include "dsps_fastmath.h"
+
+#define AHRS_DEG_TO_RAD 0.017453292519943295f
+
+static esp_err_t ahrs_init_f32(ahrs_f32_t *ahrs, float sample_rate, int gyro_range_dps, float g0, float g1)
+{
+    if ((gyro_range_dps != 250) && (gyro_range_dps != 500) && (gyro_range_dps != 1000) && (gyro_range_dps != 2000)) {
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    if (!(sample_rate > 0) || !(g0 >= 0) || !(g1 >= 0)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    ahrs->q[0] = 1;
+    ahrs->q[1] = 0;
+    ahrs->q[2] = 0;
+    ahrs->q[3] = 0;
+    ahrs->bias[0] = 0;
+    ahrs->bias[1] = 0;
+    ahrs->bias[2] = 0;
+    ahrs->gain[0] = g0;
+    ahrs->gain[1] = g1;
+    // Full scale is +-32768 LSB
+    ahrs->gyro_scale = gyro_range_dps * AHRS_DEG_TO_RAD / 32768.0f;
+    ahrs->dt = 1.0f / sample_rate;
+    ahrs->count = 0;
+    return ESP_OK;
+}
+
+esp_err_t dsps_ahrs_mahony_init_f32(ahrs_f32_t *ahrs, float sample_rate, int gyro_range_dps, float kp, float ki)
+{
+    return ahrs_init_f32(ahrs, sample_rate, gyro_range_dps, kp, ki);
+}
+
+esp_err_t dsps_ahrs_madgwick_init_f32(ahrs_f32_t *ahrs, float sample_rate, int gyro_range_dps, float beta, float zeta)
+{
+    return ahrs_init_f32(ahrs, sample_rate, gyro_range_dps, beta, zeta);
+}
+
+// Shortest rotation that takes the measured gravity direction to the earth z axis, yaw 0
+static void ahrs_align_f32(ahrs_f32_t *ahrs, float ax, float ay, float az)
+{
+    float w = 1.0f + az;
+    if (w < 1e-6f) {
+        // Upside down
+        ahrs->q[0] = 0;
+        ahrs->q[1] = 1;
+        ahrs->q[2] = 0;
+        ahrs->q[3] = 0;
+        return;
+    }
+    float rn = dsps_fast_rsqrtf(w * w + ay * ay + ax * ax);
+    ahrs->q[0] = w * rn;
+    ahrs->q[1] = ay * rn;
+    ahrs->q[2] = -ax * rn;
+    ahrs->q[3] = 0;
+}
+
+esp_err_t dsps_ahrs_mahony_f32(ahrs_f32_t *ahrs, const int16_t *raw, int len)
+{
+    const float kp = ahrs->gain[0];
+    const float ki_dt = ahrs->gain[1] * ahrs->dt;
+    const float half_dt = 0.5f * ahrs->dt;
+    const float scale = ahrs->gyro_scale;
+    float q0 = ahrs->q[0], q1 = ahrs->q[1], q2 = ahrs->q[2], q3 = ahrs->q[3];
+    float bx = ahrs->bias[0], by = ahrs->bias[1], bz = ahrs->bias[2];
+
+    for (int i = 0; i < len; i++, raw += 6) {
+        float gx = raw[3] * scale - bx;
+        float gy = raw[4] * scale - by;
+        float gz = raw[5] * scale - bz;
+        float ax = raw[0], ay = raw[1], az = raw[2];
+        float an = ax * ax + ay * ay + az * az;
+        if (an > 0) {
+            an = dsps_fast_rsqrtf(an);
+            ax *= an;
+            ay *= an;
+            az *= an;
+            if (ahrs->count == 0) {
+                ahrs_align_f32(ahrs, ax, ay, az);
+                q0 = ahrs->q[0], q1 = ahrs->q[1], q2 = ahrs->q[2], q3 = ahrs->q[3];
+            }
+            // Estimated gravity in body coordinates, the error is its cross product with the measured one
+            float vx = 2.0f * (q1 * q3 - q0 * q2);
+            float vy = 2.0f * (q0 * q1 + q2 * q3);
+            float vz = q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3;
+            float ex = ay * vz - az * vy;
+            float ey = az * vx - ax * vz;
+            float ez = ax * vy - ay * vx;
+            bx -= ki_dt * ex;
+            by -= ki_dt * ey;
+            bz -= ki_dt * ez;
+            gx += kp * ex;
+            gy += kp * ey;
+            gz += kp * ez;
+        }
+        ahrs->count++;
+
+        // q += 0.5*q*(0, g)*dt
+        gx *= half_dt;
+        gy *= half_dt;
+        gz *= half_dt;
+        float t0 = q0, t1 = q1, t2 = q2;
+        q0 += -t1 * gx - t2 * gy - q3 * gz;
+        q1 += t0 * gx + t2 * gz - q3 * gy;
+        q2 += t0 * gy - t1 * gz + q3 * gx;
+        q3 += t0 * gz + t1 * gy - t2 * gx;
+        float qn = dsps_fast_rsqrtf(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+        q0 *= qn;
+        q1 *= qn;
+        q2 *= qn;
+        q3 *= qn;
+    }
+    ahrs->q[0] = q0;
+    ahrs->q[1] = q1;
+    ahrs->q[2] = q2;
+    ahrs->q[3] = q3;
+    ahrs->bias[0] = bx;
+    ahrs->bias[1] = by;
+    ahrs->bias[2] = bz;
+    return ESP_OK;
+}
+
+esp_err_t dsps_ahrs_madgwick_f32(ahrs_f32_t *ahrs, const int16_t *raw, int len)
+{
+    const float beta_dt = ahrs->gain[0] * ahrs->dt;
+    const float zeta_dt = ahrs->gain[1] * ahrs->dt;
+    const float half_dt = 0.5f * ahrs->dt;
+    const float scale = ahrs->gyro_scale;
+    float q0 = ahrs->q[0], q1 = ahrs->q[1], q2 = ahrs->q[2], q3 = ahrs->q[3];
+    float bx = ahrs->bias[0], by = ahrs->bias[1], bz = ahrs->bias[2];
+
+    for (int i = 0; i < len; i++, raw += 6) {
+        float s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        float ax = raw[0], ay = raw[1], az = raw[2];
+        float an = ax * ax + ay * ay + az * az;
+        if (an > 0) {
+            an = dsps_fast_rsqrtf(an);
+            ax *= an;
+            ay *= an;
+            az *= an;
+            if (ahrs->count == 0) {
+                ahrs_align_f32(ahrs, ax, ay, az);
+                q0 = ahrs->q[0], q1 = ahrs->q[1], q2 = ahrs->q[2], q3 = ahrs->q[3];
+            }
+            // Gradient of |estimated gravity - measured gravity|^2 with respect to q
+            float q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+            s0 = 4.0f * q0 * (q2q2 + q1q1) + 2.0f * (q2 * ax - q1 * ay);
+            s1 = 4.0f * q1 * (q3q3 + q0q0 - 1.0f + 2.0f * (q1q1 + q2q2) + az) - 2.0f * (q3 * ax + q0 * ay);
+            s2 = 4.0f * q2 * (q0q0 + q3q3 - 1.0f + 2.0f * (q1q1 + q2q2) + az) + 2.0f * (q0 * ax - q3 * ay);
+            s3 = 4.0f * q3 * (q1q1 + q2q2) - 2.0f * (q1 * ax + q2 * ay);
+            float sn = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+            if (sn > 0) {
+                sn = dsps_fast_rsqrtf(sn);
+                s0 *= sn;
+                s1 *= sn;
+                s2 *= sn;
+                s3 *= sn;
+                // Rate error of the step, 2*conj(q)*s, integrated into the bias
+                bx += zeta_dt * 2.0f * (q0 * s1 - q1 * s0 - q2 * s3 + q3 * s2);
+                by += zeta_dt * 2.0f * (q0 * s2 + q1 * s3 - q2 * s0 - q3 * s1);
+                bz += zeta_dt * 2.0f * (q0 * s3 - q1 * s2 + q2 * s1 - q3 * s0);
+            }
+        }
+        ahrs->count++;
+
+        // q += (0.5*q*(0, g) - beta*s)*dt
+        float gx = (raw[3] * scale - bx) * half_dt;
+        float gy = (raw[4] * scale - by) * half_dt;
+        float gz = (raw[5] * scale - bz) * half_dt;
+        float t0 = q0, t1 = q1, t2 = q2;
+        q0 += -t1 * gx - t2 * gy - q3 * gz - beta_dt * s0;
+        q1 += t0 * gx + t2 * gz - q3 * gy - beta_dt * s1;
+        q2 += t0 * gy - t1 * gz + q3 * gx - beta_dt * s2;
+        q3 += t0 * gz + t1 * gy - t2 * gx - beta_dt * s3;
+        float qn = dsps_fast_rsqrtf(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+        q0 *= qn;
+        q1 *= qn;
+        q2 *= qn;
+        q3 *= qn;
+    }
+    ahrs->q[0] = q0;
+    ahrs->q[1] = q1;
+    ahrs->q[2] = q2;
+    ahrs->q[3] = q3;
+    ahrs->bias[0] = bx;
+    ahrs->bias[1] = by;
+    ahrs->bias[2] = bz;
+    return ESP_OK;
+}
+
+esp_err_t dsps_ahrs_euler_f32(const ahrs_f32_t *ahrs, float *euler)
+{
+    const float q0 = ahrs->q[0], q1 = ahrs->q[1], q2 = ahrs->q[2], q3 = ahrs->q[3];
+    float sp = 2.0f * (q0 * q2 - q3 * q1);
+    sp = (sp > 1.0f) ? 1.0f : ((sp < -1.0f) ? -1.0f : sp);
+    euler[0] = dsps_fast_atan2f(2.0f * (q0 * q1 + q2 * q3), 1.0f - 2.0f * (q1 * q1 + q2 * q2));
+    euler[1] = dsps_fast_atan2f(sp, dsps_fast_sqrtf(1.0f - sp * sp));
+    euler[2] = dsps_fast_atan2f(2.0f * (q0 * q3 + q1 * q2), 1.0f - 2.0f * (q2 * q2 + q3 * q3));
+    return ESP_OK;
+}
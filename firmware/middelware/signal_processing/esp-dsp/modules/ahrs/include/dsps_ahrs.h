@@ -0,0 +1,164 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _dsps_ahrs_H_
+#define _dsps_ahrs_H_
+
+#include "dsp_err.h"
+#include "dsp_common.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Attitude from a 6-axis IMU with a complementary filter on the quaternion: the gyroscope is integrated
+ * and the accelerometer pulls the estimated gravity direction towards the measured one. The cost is a
+ * few tens of multiplications per sample, instead of the covariance propagation of ekf_imu13states.
+ *
+ * Input samples use the raw format of the MPU6050 driver (MPU6050_getMotion6), six int16_t per sample:
+ * {ax, ay, az, gx, gy, gz}. The accelerometer range does not matter, only its direction is used.
+ *
+ * The quaternion {w, x, y, z} rotates body coordinates into earth coordinates (z up), as the state
+ * of ekf_imu13states. Yaw is not observable without a magnetometer and drifts with the residual
+ * gyroscope bias on z.
+ */
+
+#define DSPS_AHRS_MAHONY_KP     1.0f    /*!< Default proportional gain of the Mahony filter, rad/s*/
+#define DSPS_AHRS_MAHONY_KI     0.2f    /*!< Default integral (gyroscope bias) gain of the Mahony filter, rad/s^2*/
+#define DSPS_AHRS_MADGWICK_BETA 0.1f    /*!< Default gradient step of the Madgwick filter, rad/s*/
+#define DSPS_AHRS_MADGWICK_ZETA 0.01f   /*!< Default gyroscope bias gain of the Madgwick filter, rad/s^2*/
+#define DSPS_AHRS_Q30_ONE       (1 << 30)   /*!< 1.0 in the Q30 quaternion*/
+
+/**
+ * @brief Data struct of the f32 attitude filter
+ *
+ * All fields of this structure are initialized by the dsps_ahrs_mahony_init_f32(...) or
+ * dsps_ahrs_madgwick_init_f32(...) functions.
+ */
+typedef struct ahrs_f32_s {
+    float       q[4];           /*!< Attitude quaternion {w, x, y, z}, body to earth.*/
+    float       bias[3];        /*!< Estimated gyroscope bias, rad/s. Could be preset from a calibration.*/
+    float       gain[2];        /*!< Mahony kp and ki, or Madgwick beta and zeta.*/
+    float       gyro_scale;     /*!< Gyroscope rad/s per LSB.*/
+    float       dt;             /*!< Sample period, s.*/
+    uint32_t    count;          /*!< Number of processed samples, the first one aligns the attitude with gravity.*/
+} ahrs_f32_t;
+
+/**
+ * @brief Data struct of the integer (Q30) Mahony attitude filter
+ *
+ * Integer only after the initialization: the quaternion is Q30, the gyroscope rate and bias are gyroscope
+ * LSB in Q16, and the gains are converted once by dsps_ahrs_mahony_init_q30 into LSB per unit of error.
+ * Normalizations use dsps_fast_rsqrt_q30.
+ * All fields of this structure are initialized by the dsps_ahrs_mahony_init_q30(...) function.
+ */
+typedef struct ahrs_q30_s {
+    int32_t     q[4];           /*!< Attitude quaternion {w, x, y, z} in Q30, body to earth.*/
+    int32_t     bias[3];        /*!< Estimated gyroscope bias, LSB in Q16. Could be preset from a calibration.*/
+    int32_t     kp;             /*!< Proportional gain, Q16 LSB per unit of error.*/
+    int32_t     ki;             /*!< Bias step per sample, Q16 LSB per unit of error.*/
+    int32_t     gyro_k;         /*!< Half rotation per sample and per LSB, rad in Q(30 + gyro_shift).*/
+    int         gyro_shift;     /*!< Extra fractional bits of gyro_k.*/
+    uint32_t    count;          /*!< Number of processed samples, the first one aligns the attitude with gravity.*/
+} ahrs_q30_t;
+
+/**@{*/
+/**
+ * @brief   initialize the attitude filter
+ *
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param ahrs: pointer to filter structure, that must be preallocated
+ * @param sample_rate: IMU sample rate, Hz
+ * @param gyro_range_dps: full scale of the gyroscope: 250, 500, 1000 or 2000 deg/s
+ * @param kp, ki: Mahony proportional and integral gains, for example DSPS_AHRS_MAHONY_KP and DSPS_AHRS_MAHONY_KI.
+ *                ki = 0 disables the bias estimation.
+ * @param beta, zeta: Madgwick gradient step and bias gain, for example DSPS_AHRS_MADGWICK_BETA and DSPS_AHRS_MADGWICK_ZETA.
+ *                zeta = 0 disables the bias estimation.
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_PARAM if gyro_range_dps is not a MPU6050 range
+ *      - ESP_ERR_DSP_PARAM_OUTOFRANGE if sample_rate is not positive or a gain is negative
+ */
+esp_err_t dsps_ahrs_mahony_init_f32(ahrs_f32_t *ahrs, float sample_rate, int gyro_range_dps, float kp, float ki);
+esp_err_t dsps_ahrs_madgwick_init_f32(ahrs_f32_t *ahrs, float sample_rate, int gyro_range_dps, float beta, float zeta);
+/**@}*/
+
+/**
+ * @brief   initialize the integer Mahony attitude filter
+ *
+ * The implementation use ANSI C and could be compiled and run on any platform.
+ * Floating point is used only here, to convert the gains.
+ *
+ * @param ahrs: pointer to filter structure, that must be preallocated
+ * @param sample_rate: IMU sample rate, Hz
+ * @param gyro_range_dps: full scale of the gyroscope: 250, 500, 1000 or 2000 deg/s
+ * @param kp, ki: proportional and integral gains, as dsps_ahrs_mahony_init_f32
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_PARAM if gyro_range_dps is not a MPU6050 range
+ *      - ESP_ERR_DSP_PARAM_OUTOFRANGE if sample_rate is not positive, or a gain is negative or too large for Q16 LSB
+ */
+esp_err_t dsps_ahrs_mahony_init_q30(ahrs_q30_t *ahrs, float sample_rate, int gyro_range_dps, float kp, float ki);
+
+/**@{*/
+/**
+ * @brief   update the attitude with IMU samples
+ *
+ * Mahony: the cross product between the measured and estimated gravity is the attitude error. It is fed
+ * back to the gyroscope rate with gain kp and integrated with gain ki into the bias estimate.
+ * Madgwick: one normalized gradient descent step of beta per sample on the gravity error, the
+ * gyroscope error implied by the step is integrated with gain zeta into the bias estimate.
+ * Samples with a zero accelerometer vector only integrate the gyroscope.
+ * The q30 version is the Mahony filter in integer arithmetic.
+ *
+ * @param ahrs: pointer to filter structure, that must be initialized before
+ * @param[in] raw: len samples of six int16_t {ax, ay, az, gx, gy, gz}
+ * @param len: number of samples
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dsps_ahrs_mahony_f32(ahrs_f32_t *ahrs, const int16_t *raw, int len);
+esp_err_t dsps_ahrs_madgwick_f32(ahrs_f32_t *ahrs, const int16_t *raw, int len);
+esp_err_t dsps_ahrs_mahony_q30(ahrs_q30_t *ahrs, const int16_t *raw, int len);
+/**@}*/
+
+/**
+ * @brief   Euler angles of the attitude
+ *
+ * Aerospace sequence (yaw about z, then pitch about y, then roll about x).
+ *
+ * @param ahrs: pointer to filter structure
+ * @param[out] euler: roll, pitch and yaw, rad
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dsps_ahrs_euler_f32(const ahrs_f32_t *ahrs, float *euler);
+
+/**
+ * @brief   Euler angles of the integer attitude
+ *
+ * Same sequence as dsps_ahrs_euler_f32, with dsps_fast_atan2_q31.
+ *
+ * @param ahrs: pointer to filter structure
+ * @param[out] euler: roll, pitch and yaw, binary angles in Q31 (2^31 = pi)
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dsps_ahrs_euler_q30(const ahrs_q30_t *ahrs, int32_t *euler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _dsps_ahrs_H_
@@ -0,0 +1,57 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _test_ahrs_common_H_
+#define _test_ahrs_common_H_
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define TEST_AHRS_FS        1000    /*!< Sample rate of the simulated recording, Hz*/
+#define TEST_AHRS_GYRO_DPS  500     /*!< Gyroscope full scale of the simulated recording, deg/s*/
+
+/**
+ * @brief gyroscope bias of the simulated recording, rad/s
+ */
+extern const double test_ahrs_sim_bias[3];
+
+/**
+ * @brief restart the simulated MPU6050 recording
+ *
+ * The recording starts at roll 0.3, pitch -0.2, yaw 0.5 rad and turns with body rates of about 1 rad/s.
+ * Samples have the gyroscope bias, white noise on both sensors and 16 bit quantization (+-2 g, +-500 deg/s).
+ *
+ * @param[out] q_init: initial attitude {w, x, y, z}. Could be NULL
+ */
+void test_ahrs_sim_reset(double *q_init);
+
+/**
+ * @brief next sample of the simulated recording
+ *
+ * @param[out] raw: {ax, ay, az, gx, gy, gz} as returned by MPU6050_getMotion6
+ * @param[out] q_true: true attitude at the sample, body to earth
+ */
+void test_ahrs_sim_sample(int16_t *raw, double *q_true);
+
+/**
+ * @brief angle between the true and the estimated gravity direction
+ *
+ * @param[in] q_true: true attitude
+ * @param[in] q_est: estimated attitude, any scale
+ *
+ * @return: tilt error, rad
+ */
+double test_ahrs_tilt_error(const double *q_true, const double *q_est);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _test_ahrs_common_H_
@@ -0,0 +1,96 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "test_ahrs_common.h"
+
+const double test_ahrs_sim_bias[3] = {0.02, -0.015, 0.01};
+
+static double sim_q[4];
+static int sim_n;
+
+void test_ahrs_sim_reset(double *q_init)
+{
+    const double r = 0.15, p = -0.1, y = 0.25;
+    sim_q[0] = cos(r) * cos(p) * cos(y) + sin(r) * sin(p) * sin(y);
+    sim_q[1] = sin(r) * cos(p) * cos(y) - cos(r) * sin(p) * sin(y);
+    sim_q[2] = cos(r) * sin(p) * cos(y) + sin(r) * cos(p) * sin(y);
+    sim_q[3] = cos(r) * cos(p) * sin(y) - sin(r) * sin(p) * cos(y);
+    sim_n = 0;
+    srand(1);
+    if (q_init) {
+        memcpy(q_init, sim_q, sizeof(sim_q));
+    }
+}
+
+static double sim_noise(double rms)
+{
+    // Sum of three uniforms, close enough to gaussian
+    double s = 0;
+    for (int k = 0; k < 3; k++) {
+        s += (double)rand() / RAND_MAX - 0.5;
+    }
+    return s * 2 * rms;
+}
+
+static void sim_rate(double t, double *w)
+{
+    w[0] = 1.5 * sin(2 * M_PI * 0.31 * t);
+    w[1] = 1.0 * sin(2 * M_PI * 0.17 * t + 1);
+    w[2] = 0.8 * sin(2 * M_PI * 0.23 * t + 2);
+}
+
+static int16_t sim_lsb(double v)
+{
+    v = round(v);
+    return (int16_t)((v > 32767) ? 32767 : ((v < -32768) ? -32768 : v));
+}
+
+void test_ahrs_sim_sample(int16_t *raw, double *q_true)
+{
+    const double dt = 1.0 / TEST_AHRS_FS;
+    const double gyro_lsb = 32768.0 / (TEST_AHRS_GYRO_DPS * M_PI / 180);
+    const double accel_lsb = 16384.0;
+    double w[3];
+    sim_rate((sim_n + 0.5) * dt, w);
+    // Exact rotation over the sample period with the mid-point rate
+    double wn = sqrt(w[0] * w[0] + w[1] * w[1] + w[2] * w[2]);
+    double c = cos(wn * dt / 2), s = (wn > 0) ? sin(wn * dt / 2) / wn : 0;
+    double d[4] = {c, w[0] * s, w[1] * s, w[2] * s};
+    const double *q = sim_q;
+    double r[4] = {
+        q[0] * d[0] - q[1] * d[1] - q[2] * d[2] - q[3] * d[3],
+        q[0] * d[1] + q[1] * d[0] + q[2] * d[3] - q[3] * d[2],
+        q[0] * d[2] - q[1] * d[3] + q[2] * d[0] + q[3] * d[1],
+        q[0] * d[3] + q[1] * d[2] - q[2] * d[1] + q[3] * d[0],
+    };
+    memcpy(sim_q, r, sizeof(r));
+    sim_n++;
+    sim_rate(sim_n * dt, w);
+
+    raw[0] = sim_lsb(accel_lsb * (2 * (q[1] * q[3] - q[0] * q[2]) + sim_noise(0.005)));
+    raw[1] = sim_lsb(accel_lsb * (2 * (q[0] * q[1] + q[2] * q[3]) + sim_noise(0.005)));
+    raw[2] = sim_lsb(accel_lsb * (q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3] + sim_noise(0.005)));
+    for (int k = 0; k < 3; k++) {
+        raw[3 + k] = sim_lsb(gyro_lsb * (w[k] + test_ahrs_sim_bias[k] + sim_noise(0.002)));
+    }
+    memcpy(q_true, sim_q, sizeof(sim_q));
+}
+
+double test_ahrs_tilt_error(const double *qt, const double *qe)
+{
+    double gt[3] = {2 * (qt[1] * qt[3] - qt[0] * qt[2]), 2 * (qt[0] * qt[1] + qt[2] * qt[3]),
+                    qt[0] * qt[0] - qt[1] * qt[1] - qt[2] * qt[2] + qt[3] * qt[3]
+                   };
+    double ge[3] = {2 * (qe[1] * qe[3] - qe[0] * qe[2]), 2 * (qe[0] * qe[1] + qe[2] * qe[3]),
+                    qe[0] * qe[0] - qe[1] * qe[1] - qe[2] * qe[2] + qe[3] * qe[3]
+                   };
+    double dot = (gt[0] * ge[0] + gt[1] * ge[1] + gt[2] * ge[2]) /
+                 sqrt((gt[0] * gt[0] + gt[1] * gt[1] + gt[2] * gt[2]) * (ge[0] * ge[0] + ge[1] * ge[1] + ge[2] * ge[2]));
+    return acos((dot > 1) ? 1 : dot);
+}
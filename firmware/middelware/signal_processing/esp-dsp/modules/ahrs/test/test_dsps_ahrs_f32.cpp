@@ -0,0 +1,167 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsps_ahrs.h"
+#include "ekf_imu13states.h"
+#include "dsp_tests.h"
+#include "test_ahrs_common.h"
+
+static const char *TAG = "dsps_ahrs_f32";
+
+#define FS          TEST_AHRS_FS
+#define GYRO_DPS    TEST_AHRS_GYRO_DPS
+#define N_SAMPLES   (30 * FS)
+#define N_SETTLE    (10 * FS)
+#define EKF_DECIM   10
+
+static double tilt_error(const double *q_true, const float *q)
+{
+    double qe[4] = {q[0], q[1], q[2], q[3]};
+    return test_ahrs_tilt_error(q_true, qe);
+}
+
+TEST_CASE("dsps_ahrs_f32 functionality", "[dsps]")
+{
+    ahrs_f32_t mahony;
+    ahrs_f32_t madgwick;
+    int16_t raw[6];
+    double q_true[4];
+    double err2_mahony = 0, err2_madgwick = 0;
+    double err_max_mahony = 0, err_max_madgwick = 0;
+
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_ahrs_mahony_init_f32(&mahony, FS, GYRO_DPS, DSPS_AHRS_MAHONY_KP, DSPS_AHRS_MAHONY_KI));
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_ahrs_madgwick_init_f32(&madgwick, FS, GYRO_DPS, DSPS_AHRS_MADGWICK_BETA, DSPS_AHRS_MADGWICK_ZETA));
+    test_ahrs_sim_reset(NULL);
+    for (int i = 0; i < N_SAMPLES; i++) {
+        test_ahrs_sim_sample(raw, q_true);
+        dsps_ahrs_mahony_f32(&mahony, raw, 1);
+        dsps_ahrs_madgwick_f32(&madgwick, raw, 1);
+        if (i == 0) {
+            // Aligned with gravity from the first sample
+            TEST_ASSERT_LESS_THAN(20, (int)(1000 * tilt_error(q_true, mahony.q)));
+            TEST_ASSERT_LESS_THAN(20, (int)(1000 * tilt_error(q_true, madgwick.q)));
+        }
+        if (i >= N_SETTLE) {
+            double e = tilt_error(q_true, mahony.q);
+            err2_mahony += e * e;
+            err_max_mahony = fmax(err_max_mahony, e);
+            e = tilt_error(q_true, madgwick.q);
+            err2_madgwick += e * e;
+            err_max_madgwick = fmax(err_max_madgwick, e);
+        }
+    }
+    float rms_mahony = (float)(sqrt(err2_mahony / (N_SAMPLES - N_SETTLE)) * 180 / M_PI);
+    float rms_madgwick = (float)(sqrt(err2_madgwick / (N_SAMPLES - N_SETTLE)) * 180 / M_PI);
+    ESP_LOGI(TAG, "tilt error rms/max, deg: mahony %f/%f, madgwick %f/%f", rms_mahony, err_max_mahony * 180 / M_PI,
+             rms_madgwick, err_max_madgwick * 180 / M_PI);
+    ESP_LOGI(TAG, "bias: mahony %f %f %f, madgwick %f %f %f", mahony.bias[0], mahony.bias[1], mahony.bias[2],
+             madgwick.bias[0], madgwick.bias[1], madgwick.bias[2]);
+    TEST_ASSERT_LESS_THAN(500, (int)(1000 * rms_mahony));
+    TEST_ASSERT_LESS_THAN(500, (int)(1000 * rms_madgwick));
+    for (int k = 0; k < 3; k++) {
+        TEST_ASSERT_FLOAT_WITHIN(0.003f, test_ahrs_sim_bias[k], mahony.bias[k]);
+        TEST_ASSERT_FLOAT_WITHIN(0.003f, test_ahrs_sim_bias[k], madgwick.bias[k]);
+    }
+
+    // Euler angles of a known attitude, roll 0.3, pitch -0.2, yaw 0.5
+    float euler[3];
+    test_ahrs_sim_reset(q_true);
+    for (int k = 0; k < 4; k++) {
+        mahony.q[k] = (float)q_true[k];
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_ahrs_euler_f32(&mahony, euler));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.3f, euler[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, -0.2f, euler[1]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.5f, euler[2]);
+
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_PARAM, dsps_ahrs_mahony_init_f32(&mahony, FS, 300, 1, 0));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_ahrs_madgwick_init_f32(&madgwick, 0, GYRO_DPS, 0.1f, 0));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_ahrs_mahony_init_f32(&mahony, FS, GYRO_DPS, -1, 0));
+}
+
+TEST_CASE("dsps_ahrs_f32 benchmark", "[dsps]")
+{
+    // Same recording through the complementary filters at 1 kHz and through ekf_imu13states at 100 Hz,
+    // gyroscope averaged over EKF_DECIM samples. The EKF also gets an ideal magnetometer, it needs one.
+    const int n_samples = 10 * FS;
+    const int n_settle = 5 * FS;
+    ahrs_f32_t mahony;
+    ahrs_f32_t madgwick;
+    ekf_imu13states *ekf13 = new ekf_imu13states();
+    int16_t raw[6];
+    double q_true[4];
+    float R[6] = {0.01f, 0.01f, 0.01f, 0.01f, 0.01f, 0.01f};
+    float gyro[3] = {0, 0, 0};
+    unsigned int cycles_mahony = 0, cycles_madgwick = 0, cycles_ekf = 0;
+    double err2_mahony = 0, err2_madgwick = 0, err2_ekf = 0;
+
+    dsps_ahrs_mahony_init_f32(&mahony, FS, GYRO_DPS, DSPS_AHRS_MAHONY_KP, DSPS_AHRS_MAHONY_KI);
+    dsps_ahrs_madgwick_init_f32(&madgwick, FS, GYRO_DPS, DSPS_AHRS_MADGWICK_BETA, DSPS_AHRS_MADGWICK_ZETA);
+    ekf13->Init();
+    test_ahrs_sim_reset(NULL);
+    for (int i = 0; i < n_samples; i++) {
+        test_ahrs_sim_sample(raw, q_true);
+
+        unsigned int start_b = dsp_get_cpu_cycle_count();
+        dsps_ahrs_mahony_f32(&mahony, raw, 1);
+        unsigned int end_b = dsp_get_cpu_cycle_count();
+        cycles_mahony += end_b - start_b;
+
+        start_b = dsp_get_cpu_cycle_count();
+        dsps_ahrs_madgwick_f32(&madgwick, raw, 1);
+        end_b = dsp_get_cpu_cycle_count();
+        cycles_madgwick += end_b - start_b;
+
+        for (int k = 0; k < 3; k++) {
+            gyro[k] += raw[3 + k] * mahony.gyro_scale / EKF_DECIM;
+        }
+        if ((i % EKF_DECIM) == EKF_DECIM - 1) {
+            float an = sqrtf((float)raw[0] * raw[0] + (float)raw[1] * raw[1] + (float)raw[2] * raw[2]);
+            float accel[3] = {raw[0] / an, raw[1] / an, raw[2] / an};
+            const double *q = q_true;
+            float magn[3] = {(float)(q[0] * q[0] + q[1] * q[1] - q[2] * q[2] - q[3] * q[3]),
+                             (float)(2 * (q[1] * q[2] - q[0] * q[3])), (float)(2 * (q[1] * q[3] + q[0] * q[2]))
+                            };
+            start_b = dsp_get_cpu_cycle_count();
+            ekf13->Process(gyro, 1.0f / FS * EKF_DECIM);
+            ekf13->UpdateRefMeasurement(accel, magn, R);
+            end_b = dsp_get_cpu_cycle_count();
+            cycles_ekf += end_b - start_b;
+            gyro[0] = gyro[1] = gyro[2] = 0;
+            if (i >= n_settle) {
+                double e = tilt_error(q_true, ekf13->X.data);
+                err2_ekf += e * e;
+            }
+        }
+        if (i >= n_settle) {
+            double e = tilt_error(q_true, mahony.q);
+            err2_mahony += e * e;
+            e = tilt_error(q_true, madgwick.q);
+            err2_madgwick += e * e;
+        }
+    }
+    delete ekf13;
+
+    const int n = n_samples - n_settle;
+    ESP_LOGI(TAG, "cycles per update: mahony %f, madgwick %f, ekf_imu13states %f", (float)cycles_mahony / n_samples,
+             (float)cycles_madgwick / n_samples, (float)cycles_ekf / (n_samples / EKF_DECIM));
+    ESP_LOGI(TAG, "tilt error rms, deg: mahony %f, madgwick %f, ekf_imu13states %f",
+             sqrt(err2_mahony / n) * 180 / M_PI, sqrt(err2_madgwick / n) * 180 / M_PI,
+             sqrt(err2_ekf / (n / EKF_DECIM)) * 180 / M_PI);
+
+    float min_exec = 10;
+    float max_exec = 5000;
+    TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, (float)cycles_mahony / n_samples);
+    TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, (float)cycles_madgwick / n_samples);
+}
@@ -0,0 +1,179 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsps_ahrs.h"
+#include "dsp_tests.h"
+#include "test_ahrs_common.h"
+
+static const char *TAG = "dsps_ahrs_q30";
+
+#define FS          TEST_AHRS_FS
+#define GYRO_DPS    TEST_AHRS_GYRO_DPS
+#define N_SAMPLES   (30 * FS)
+#define N_SETTLE    (10 * FS)
+
+static void q30_to_double(const ahrs_q30_t *ahrs, double *q)
+{
+    for (int k = 0; k < 4; k++) {
+        q[k] = ahrs->q[k] / (double)DSPS_AHRS_Q30_ONE;
+    }
+}
+
+// Angle of the rotation between two attitudes, rad
+static double attitude_error(const double *a, const double *b)
+{
+    // Vector part of conj(a)*b, that does not lose precision for small angles like acos would
+    double x = a[0] * b[1] - a[1] * b[0] - a[2] * b[3] + a[3] * b[2];
+    double y = a[0] * b[2] + a[1] * b[3] - a[2] * b[0] - a[3] * b[1];
+    double z = a[0] * b[3] - a[1] * b[2] + a[2] * b[1] - a[3] * b[0];
+    double s = sqrt(x * x + y * y + z * z);
+    return 2 * asin((s > 1) ? 1 : s);
+}
+
+// Double precision Mahony filter, the reference of the integer one
+static void mahony_ref(double *q, double *bias, const int16_t *raw, double kp, double ki, bool first)
+{
+    const double dt = 1.0 / FS;
+    const double scale = GYRO_DPS * M_PI / 180 / 32768;
+    double g[3] = {raw[3] * scale - bias[0], raw[4] * scale - bias[1], raw[5] * scale - bias[2]};
+    double an = sqrt((double)raw[0] * raw[0] + (double)raw[1] * raw[1] + (double)raw[2] * raw[2]);
+    double a[3] = {raw[0] / an, raw[1] / an, raw[2] / an};
+    if (first) {
+        double n = sqrt((1 + a[2]) * (1 + a[2]) + a[1] * a[1] + a[0] * a[0]);
+        q[0] = (1 + a[2]) / n;
+        q[1] = a[1] / n;
+        q[2] = -a[0] / n;
+        q[3] = 0;
+    }
+    double v[3] = {2 * (q[1] * q[3] - q[0] * q[2]), 2 * (q[0] * q[1] + q[2] * q[3]),
+                   q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3]
+                  };
+    double e[3] = {a[1] *v[2] - a[2] *v[1], a[2] *v[0] - a[0] *v[2], a[0] *v[1] - a[1] *v[0]};
+    for (int k = 0; k < 3; k++) {
+        bias[k] -= ki * dt * e[k];
+        g[k] = (g[k] + kp * e[k]) * dt / 2;
+    }
+    double r[4] = {
+        q[0] - q[1] * g[0] - q[2] * g[1] - q[3] * g[2],
+        q[1] + q[0] * g[0] + q[2] * g[2] - q[3] * g[1],
+        q[2] + q[0] * g[1] - q[1] * g[2] + q[3] * g[0],
+        q[3] + q[0] * g[2] + q[1] * g[1] - q[2] * g[0],
+    };
+    double n = sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2] + r[3] * r[3]);
+    for (int k = 0; k < 4; k++) {
+        q[k] = r[k] / n;
+    }
+}
+
+TEST_CASE("dsps_ahrs_q30 functionality", "[dsps]")
+{
+    const double scale = GYRO_DPS * M_PI / 180 / 32768;
+    ahrs_q30_t ahrs;
+    int16_t raw[6];
+    double q_true[4];
+    double q_ref[4];
+    double bias_ref[3] = {0, 0, 0};
+    double q[4];
+    double err_ref_max = 0;
+    double err2 = 0;
+
+    // Integer filter against the same filter in double precision, on the same recording
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_ahrs_mahony_init_q30(&ahrs, FS, GYRO_DPS, DSPS_AHRS_MAHONY_KP, DSPS_AHRS_MAHONY_KI));
+    test_ahrs_sim_reset(NULL);
+    for (int i = 0; i < N_SAMPLES; i++) {
+        test_ahrs_sim_sample(raw, q_true);
+        dsps_ahrs_mahony_q30(&ahrs, raw, 1);
+        mahony_ref(q_ref, bias_ref, raw, DSPS_AHRS_MAHONY_KP, DSPS_AHRS_MAHONY_KI, i == 0);
+        q30_to_double(&ahrs, q);
+        err_ref_max = fmax(err_ref_max, attitude_error(q, q_ref));
+        if (i >= N_SETTLE) {
+            double e = test_ahrs_tilt_error(q_true, q);
+            err2 += e * e;
+        }
+    }
+    double rms = sqrt(err2 / (N_SAMPLES - N_SETTLE)) * 180 / M_PI;
+    ESP_LOGI(TAG, "max attitude difference to the double reference %g rad, tilt error rms %f deg", err_ref_max, rms);
+    ESP_LOGI(TAG, "bias %f %f %f, reference %f %f %f", ahrs.bias[0] / 65536.0 * scale, ahrs.bias[1] / 65536.0 * scale,
+             ahrs.bias[2] / 65536.0 * scale, bias_ref[0], bias_ref[1], bias_ref[2]);
+    TEST_ASSERT_LESS_THAN(20, (int)(1e6 * err_ref_max));
+    TEST_ASSERT_LESS_THAN(500, (int)(1000 * rms));
+    for (int k = 0; k < 3; k++) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-5, bias_ref[k], ahrs.bias[k] / 65536.0 * scale);
+        TEST_ASSERT_FLOAT_WITHIN(0.003, test_ahrs_sim_bias[k], ahrs.bias[k] / 65536.0 * scale);
+    }
+
+    // Drift of the gyroscope integration alone, 60 s
+    dsps_ahrs_mahony_init_q30(&ahrs, FS, GYRO_DPS, 0, 0);
+    bias_ref[0] = bias_ref[1] = bias_ref[2] = 0;
+    test_ahrs_sim_reset(NULL);
+    for (int i = 0; i < 2 * N_SAMPLES; i++) {
+        test_ahrs_sim_sample(raw, q_true);
+        dsps_ahrs_mahony_q30(&ahrs, raw, 1);
+        mahony_ref(q_ref, bias_ref, raw, 0, 0, i == 0);
+    }
+    q30_to_double(&ahrs, q);
+    double drift = attitude_error(q, q_ref);
+    ESP_LOGI(TAG, "gyroscope integration drift after 60 s: %g rad", drift);
+    TEST_ASSERT_LESS_THAN(5, (int)(1e6 * drift));
+
+    // Euler angles of a known attitude, roll 0.3, pitch -0.2, yaw 0.5
+    int32_t euler[3];
+    test_ahrs_sim_reset(q_true);
+    for (int k = 0; k < 4; k++) {
+        ahrs.q[k] = (int32_t)lround(q_true[k] * DSPS_AHRS_Q30_ONE);
+    }
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_ahrs_euler_q30(&ahrs, euler));
+    const double rad = M_PI / 2147483648.0;
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 0.3, euler[0] * rad);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, -0.2, euler[1] * rad);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 0.5, euler[2] * rad);
+
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_PARAM, dsps_ahrs_mahony_init_q30(&ahrs, FS, 300, 1, 0));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_ahrs_mahony_init_q30(&ahrs, -1, GYRO_DPS, 1, 0));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_ahrs_mahony_init_q30(&ahrs, FS, 250, 100, 0));
+}
+
+TEST_CASE("dsps_ahrs_q30 benchmark", "[dsps]")
+{
+    const int n_samples = 2 * FS;
+    static int16_t raw[2 * FS][6];
+    double q_true[4];
+    ahrs_q30_t ahrs;
+    ahrs_f32_t ahrs_f32;
+
+    test_ahrs_sim_reset(NULL);
+    for (int i = 0; i < n_samples; i++) {
+        test_ahrs_sim_sample(raw[i], q_true);
+    }
+    dsps_ahrs_mahony_init_q30(&ahrs, FS, GYRO_DPS, DSPS_AHRS_MAHONY_KP, DSPS_AHRS_MAHONY_KI);
+    dsps_ahrs_mahony_init_f32(&ahrs_f32, FS, GYRO_DPS, DSPS_AHRS_MAHONY_KP, DSPS_AHRS_MAHONY_KI);
+
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    dsps_ahrs_mahony_q30(&ahrs, raw[0], n_samples);
+    unsigned int end_b = dsp_get_cpu_cycle_count();
+    float cycles_q30 = (float)(end_b - start_b) / n_samples;
+
+    start_b = dsp_get_cpu_cycle_count();
+    dsps_ahrs_mahony_f32(&ahrs_f32, raw[0], n_samples);
+    end_b = dsp_get_cpu_cycle_count();
+    float cycles_f32 = (float)(end_b - start_b) / n_samples;
+
+    // Share of a 160 MHz core at 1 kHz
+    ESP_LOGI(TAG, "cycles per update: q30 %f (%f%% of 160 MHz at 1 kHz), f32 %f", cycles_q30,
+             cycles_q30 * FS / 160e6f * 100, cycles_f32);
+
+    float min_exec = 10;
+    float max_exec = 3000;
+    TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles_q30);
+}
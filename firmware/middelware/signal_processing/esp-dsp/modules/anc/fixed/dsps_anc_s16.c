@@ -0,0 +1,121 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <math.h>
+#include "dsps_anc.h"
+
+esp_err_t dsps_anc_init_s16(anc_s16_t *anc, int16_t *lut, int32_t lut_len, float freq, int n_harm, const int16_t *mu, float fll)
+{
+    if ((n_harm < 1) || (n_harm > DSPS_ANC_MAX_HARMONICS) || (freq <= 0) || (n_harm * freq * (1 + DSPS_ANC_FLL_RANGE) >= 0.5f)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if ((fll < 0) || (fll > 1)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    memset(anc, 0, sizeof(anc_s16_t));
+    anc->n_harm = n_harm;
+    anc->freq = freq;
+    anc->freq_nom = freq;
+    anc->fll = fll;
+
+    for (int h = 0; h < n_harm; h++) {
+        void *shared_lut = (h == 0) ? (void *)lut : anc->gen[0].lut;
+        esp_err_t ret = dsps_cplx_gen_init(&anc->gen[h], S16_FIXED, shared_lut, lut_len, (h + 1) * freq, 0);
+        if (ret != ESP_OK) {
+            dsps_anc_free_s16(anc);
+            return ret;
+        }
+        // The Q15 reference pair is full scale, its power is 1 and the step needs no normalization
+        anc->mu[h] = mu[h];
+    }
+    return ESP_OK;
+}
+
+void dsps_anc_free_s16(anc_s16_t *anc)
+{
+    cplx_gen_free(&anc->gen[0]);
+}
+
+// Frequency-locked loop: a mains frequency above the NCO makes the weights of the fundamental
+// rotate clockwise by 2*pi*df every sample. The angle is measured with the cross product of
+// the weights at the beginning and the end of the chunk.
+static void dsps_anc_fll_s16(anc_s16_t *anc, int n)
+{
+    const float wp0 = anc->w_prev[0];
+    const float wp1 = anc->w_prev[1];
+    const float w0 = anc->w[0][0];
+    const float w1 = anc->w[0][1];
+    const float norm = sqrtf((wp0 * wp0 + wp1 * wp1) * (w0 * w0 + w1 * w1));
+    if (norm <= 0) {
+        return;
+    }
+    const float dtheta = (wp0 * w1 - wp1 * w0) / norm;
+    float freq = anc->freq - anc->fll * dtheta / (2 * (float)M_PI * n);
+    const float dev = anc->freq_nom * DSPS_ANC_FLL_RANGE;
+    if (freq > anc->freq_nom + dev) {
+        freq = anc->freq_nom + dev;
+    } else if (freq < anc->freq_nom - dev) {
+        freq = anc->freq_nom - dev;
+    }
+    anc->freq = freq;
+    for (int h = 0; h < anc->n_harm; h++) {
+        anc->gen[h].freq = (h + 1) * freq;
+    }
+}
+
+esp_err_t dsps_anc_s16(anc_s16_t *anc, const int16_t *input, int16_t *output, int len)
+{
+    const int n_harm = anc->n_harm;
+    while (len > 0) {
+        if (anc->pos == 0) {
+            // Reference of the next chunk, then advance the NCO phase
+            anc->w_prev[0] = anc->w[0][0];
+            anc->w_prev[1] = anc->w[0][1];
+            for (int h = 0; h < n_harm; h++) {
+                cplx_sig_t *gen = &anc->gen[h];
+                dsps_cplx_gen(gen, anc->ref[h], DSPS_ANC_CHUNK);
+                float ph = gen->phase + DSPS_ANC_CHUNK * gen->freq;
+                ph -= (int)ph;
+                gen->phase = ph;
+            }
+        }
+        const int n = (len < DSPS_ANC_CHUNK - anc->pos) ? len : DSPS_ANC_CHUNK - anc->pos;
+
+        for (int i = 0; i < n; i++) {
+            const int r = 2 * (anc->pos + i);
+            // Q30 weights * Q15 reference = Q45, back to Q15 with rounding
+            int64_t acc = 1LL << 29;
+            for (int h = 0; h < n_harm; h++) {
+                acc += (int64_t)anc->w[h][0] * anc->ref[h][r] + (int64_t)anc->w[h][1] * anc->ref[h][r + 1];
+            }
+            int32_t e = (int32_t)input[i] - (int32_t)(acc >> 30);
+            if (e > INT16_MAX) {
+                e = INT16_MAX;
+            } else if (e < INT16_MIN) {
+                e = INT16_MIN;
+            }
+            for (int h = 0; h < n_harm; h++) {
+                // mu (Q15) * e (Q15) * ref (Q15) = Q45, Q30 update
+                const int32_t g = anc->mu[h] * e;
+                anc->w[h][0] += (int32_t)(((int64_t)g * anc->ref[h][r] + (1 << 14)) >> 15);
+                anc->w[h][1] += (int32_t)(((int64_t)g * anc->ref[h][r + 1] + (1 << 14)) >> 15);
+            }
+            output[i] = (int16_t)e;
+        }
+        anc->pos += n;
+        if (anc->pos == DSPS_ANC_CHUNK) {
+            anc->pos = 0;
+            if (anc->fll > 0) {
+                dsps_anc_fll_s16(anc, DSPS_ANC_CHUNK);
+            }
+        }
+        input += n;
+        output += n;
+        len -= n;
+    }
+    return ESP_OK;
+}
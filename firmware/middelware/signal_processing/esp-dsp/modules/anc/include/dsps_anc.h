@@ -0,0 +1,160 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _dsps_anc_H_
+#define _dsps_anc_H_
+
+#include "dsp_err.h"
+#include "dsp_common.h"
+#include "dsps_cplx_gen.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define DSPS_ANC_MAX_HARMONICS  5   /*!< Maximum number of cancelled harmonics, fundamental included*/
+#define DSPS_ANC_CHUNK          16  /*!< Number of reference samples generated per call of the NCO*/
+#define DSPS_ANC_FLL_RANGE      0.05f   /*!< Maximum deviation of the tracked mains frequency, relative to the nominal*/
+
+/**
+ * @brief Data struct of the floating point mains interference canceller
+ *
+ * Adaptive noise canceller with an internal reference: for every harmonic h of the mains frequency
+ * a cos/sin pair is generated by dsps_cplx_gen and two weights are adapted with NLMS, so each harmonic
+ * behaves as a notch whose width is set by its step size. The NCO phase is kept in this structure,
+ * the generators are only used to read the LUT.
+ * When the mains frequency is off its nominal value the weights of the fundamental rotate; an optional
+ * frequency-locked loop measures that rotation once per chunk and retunes all the generators.
+ * All fields of this structure are initialized by the dsps_anc_init_f32(...) function.
+ */
+typedef struct anc_f32_s {
+    cplx_sig_t  gen[DSPS_ANC_MAX_HARMONICS];    /*!< Reference generators, all of them share the LUT of gen[0].*/
+    float       ref[DSPS_ANC_MAX_HARMONICS][2 * DSPS_ANC_CHUNK];    /*!< Reference cos/sin pairs of the current chunk.*/
+    float       w[DSPS_ANC_MAX_HARMONICS][2];   /*!< Weights of the cos and sin references.*/
+    float       mu[DSPS_ANC_MAX_HARMONICS];     /*!< Step size of every harmonic, divided by the reference power.*/
+    float       freq;                           /*!< Tracked mains frequency, relative to the sample rate.*/
+    float       freq_nom;                       /*!< Nominal mains frequency, relative to the sample rate.*/
+    float       fll;                            /*!< Gain of the frequency-locked loop, 0 disables it.*/
+    float       w_prev[2];                      /*!< Weights of the fundamental at the beginning of the chunk.*/
+    int         n_harm;                         /*!< Number of harmonics.*/
+    int         pos;                            /*!< Position in the current reference chunk.*/
+} anc_f32_t;
+
+/**
+ * @brief Data struct of the fixed point mains interference canceller
+ *
+ * Same structure as anc_f32_t for Q15 signals. The weights are Q30 so small step sizes still adapt.
+ * All fields of this structure are initialized by the dsps_anc_init_s16(...) function.
+ */
+typedef struct anc_s16_s {
+    cplx_sig_t  gen[DSPS_ANC_MAX_HARMONICS];    /*!< Reference generators, all of them share the LUT of gen[0].*/
+    int16_t     ref[DSPS_ANC_MAX_HARMONICS][2 * DSPS_ANC_CHUNK];    /*!< Reference cos/sin pairs of the current chunk, Q15.*/
+    int32_t     w[DSPS_ANC_MAX_HARMONICS][2];   /*!< Weights of the cos and sin references, Q30.*/
+    int16_t     mu[DSPS_ANC_MAX_HARMONICS];     /*!< Step size of every harmonic, Q15.*/
+    float       freq;                           /*!< Tracked mains frequency, relative to the sample rate.*/
+    float       freq_nom;                       /*!< Nominal mains frequency, relative to the sample rate.*/
+    float       fll;                            /*!< Gain of the frequency-locked loop, 0 disables it.*/
+    int32_t     w_prev[2];                      /*!< Weights of the fundamental at the beginning of the chunk.*/
+    int         n_harm;                         /*!< Number of harmonics.*/
+    int         pos;                            /*!< Position in the current reference chunk.*/
+} anc_s16_t;
+
+/**
+ * @brief   init floating point mains interference canceller
+ *
+ * The step sizes are normalized by the power of the reference pair, so they do not depend on the LUT scale.
+ * The adaptation time constant of harmonic h is about 2/mu[h] samples and the -3 dB width of its
+ * notch is about mu[h]*fs/(2*pi) Hz. For example mu = 0.02 at 500 Hz attenuates the interference
+ * by 40 dB in less than a second with a notch 1.6 Hz wide.
+ * dsps_anc_free_f32(...) must be called once the canceller is not needed anymore when lut is NULL.
+ *
+ * @param anc: pointer to canceller structure, that must be preallocated
+ * @param lut: float sine LUT shared by all the generators, or NULL to allocate it
+ * @param lut_len: length of the LUT, power of 2. Longer tables reduce the phase jitter of the reference
+ * @param freq: mains frequency relative to the sample rate, for example 50/500
+ * @param n_harm: number of harmonics, fundamental included [1..DSPS_ANC_MAX_HARMONICS]
+ * @param mu: step size of every harmonic, array of length n_harm
+ * @param fll: gain of the frequency-locked loop [0..1], 0 keeps the frequency fixed. About 0.1 tracks
+ *             a mains deviation within a second; the tracked frequency is limited to DSPS_ANC_FLL_RANGE
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_PARAM_OUTOFRANGE if n_harm or fll are out of range or a harmonic is above the Nyquist frequency
+ *      - One of the error codes from dsps_cplx_gen_init
+ */
+esp_err_t dsps_anc_init_f32(anc_f32_t *anc, float *lut, int32_t lut_len, float freq, int n_harm, const float *mu, float fll);
+
+/**
+ * @brief   release the LUT allocated by dsps_anc_init_f32
+ *
+ * @param anc: pointer to canceller structure
+ */
+void dsps_anc_free_f32(anc_f32_t *anc);
+
+/**
+ * @brief   floating point mains interference canceller
+ *
+ * Function removes the mains frequency and its harmonics from the input signal.
+ * Can be called with any length, also sample by sample, the result does not depend on it.
+ *
+ * @param anc: pointer to canceller structure, that must be initialized before
+ * @param[in] input: input array
+ * @param[out] output: output array, can be the same as input
+ * @param len: length of the input and output arrays
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dsps_anc_f32(anc_f32_t *anc, const float *input, float *output, int len);
+
+/**
+ * @brief   init fixed point mains interference canceller
+ *
+ * See dsps_anc_init_f32(...) for the meaning of the parameters.
+ *
+ * @param anc: pointer to canceller structure, that must be preallocated
+ * @param lut: Q15 sine LUT shared by all the generators, or NULL to allocate it
+ * @param lut_len: length of the LUT, power of 2
+ * @param freq: mains frequency relative to the sample rate
+ * @param n_harm: number of harmonics, fundamental included [1..DSPS_ANC_MAX_HARMONICS]
+ * @param mu: step size of every harmonic in Q15, array of length n_harm
+ * @param fll: gain of the frequency-locked loop [0..1], 0 keeps the frequency fixed
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_PARAM_OUTOFRANGE if n_harm or fll are out of range or a harmonic is above the Nyquist frequency
+ *      - One of the error codes from dsps_cplx_gen_init
+ */
+esp_err_t dsps_anc_init_s16(anc_s16_t *anc, int16_t *lut, int32_t lut_len, float freq, int n_harm, const int16_t *mu, float fll);
+
+/**
+ * @brief   release the LUT allocated by dsps_anc_init_s16
+ *
+ * @param anc: pointer to canceller structure
+ */
+void dsps_anc_free_s16(anc_s16_t *anc);
+
+/**
+ * @brief   fixed point mains interference canceller
+ *
+ * Q15 version of dsps_anc_f32(...). The output saturates to the int16 range.
+ *
+ * @param anc: pointer to canceller structure, that must be initialized before
+ * @param[in] input: input array
+ * @param[out] output: output array, can be the same as input
+ * @param len: length of the input and output arrays
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dsps_anc_s16(anc_s16_t *anc, const int16_t *input, int16_t *output, int len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _dsps_anc_H_
@@ -0,0 +1,144 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <math.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsps_anc.h"
+#include "dsp_tests.h"
+
+static const char *TAG = "dsps_anc";
+
+#define FS          500.0f
+#define N_SAMPLES   2000
+#define N_HARM      3
+
+static float ecg[N_SAMPLES];
+static float x[N_SAMPLES];
+static float y[N_SAMPLES];
+static int16_t x16[N_SAMPLES];
+static int16_t y16[N_SAMPLES];
+
+// Synthetic ECG at 72 bpm: narrow QRS and a wide T wave, plus the interference of
+// a 50 Hz mains slightly off its nominal frequency with its 2nd and 3rd harmonics
+static void anc_test_signal(float mains_hz)
+{
+    for (int i = 0; i < N_SAMPLES; i++) {
+        float t = i / FS;
+        float tb = fmodf(t, 60.0f / 72) - 0.3f;
+        float qrs = expf(-tb * tb / (2 * 0.01f * 0.01f));
+        float tw = 0.25f * expf(-(tb - 0.25f) * (tb - 0.25f) / (2 * 0.04f * 0.04f));
+        ecg[i] = 0.5f * (qrs + tw);
+        float w = 2 * M_PI * mains_hz * t;
+        x[i] = ecg[i] + 0.3f * sinf(w + 0.7f) + 0.1f * sinf(2 * w + 1.1f) + 0.05f * sinf(3 * w);
+    }
+}
+
+// RMS of the error after the first second, relative to the interference
+static float anc_residual_db(const float *out)
+{
+    float e_out = 0;
+    float e_in = 0;
+    for (int i = (int)FS; i < N_SAMPLES; i++) {
+        e_out += (out[i] - ecg[i]) * (out[i] - ecg[i]);
+        e_in += (x[i] - ecg[i]) * (x[i] - ecg[i]);
+    }
+    return 10 * log10f(e_out / e_in);
+}
+
+TEST_CASE("dsps_anc functionality", "[dsps]")
+{
+    const float mu[N_HARM] = {0.02f, 0.02f, 0.02f};
+    const int16_t mu16[N_HARM] = {655, 655, 655};
+    const float mains[] = {50.0f, 50.2f};
+    anc_f32_t anc;
+    anc_s16_t anc16;
+
+    for (int m = 0; m < sizeof(mains) / sizeof(mains[0]); m++) {
+        anc_test_signal(mains[m]);
+        for (int f = 0; f < 2; f++) {
+            const float fll = f ? 0.1f : 0;
+
+            TEST_ASSERT_EQUAL(ESP_OK, dsps_anc_init_f32(&anc, NULL, 2048, 50.0f / FS, N_HARM, mu, fll));
+            dsps_anc_f32(&anc, x, y, N_SAMPLES);
+            float att = anc_residual_db(y);
+            float freq = anc.freq * FS;
+
+            // Sample by sample gives the same result as the whole block
+            dsps_anc_free_f32(&anc);
+            TEST_ASSERT_EQUAL(ESP_OK, dsps_anc_init_f32(&anc, NULL, 2048, 50.0f / FS, N_HARM, mu, fll));
+            for (int i = 0; i < N_SAMPLES; i++) {
+                float out;
+                dsps_anc_f32(&anc, &x[i], &out, 1);
+                TEST_ASSERT_EQUAL_FLOAT(y[i], out);
+            }
+            dsps_anc_free_f32(&anc);
+
+            TEST_ASSERT_EQUAL(ESP_OK, dsps_anc_init_s16(&anc16, NULL, 2048, 50.0f / FS, N_HARM, mu16, fll));
+            for (int i = 0; i < N_SAMPLES; i++) {
+                x16[i] = (int16_t)lrintf(x[i] * 16384);
+            }
+            dsps_anc_s16(&anc16, x16, y16, N_SAMPLES);
+            for (int i = 0; i < N_SAMPLES; i++) {
+                y[i] = y16[i] / 16384.0f;
+            }
+            float att16 = anc_residual_db(y);
+            float freq16 = anc16.freq * FS;
+            dsps_anc_free_s16(&anc16);
+
+            ESP_LOGI(TAG, "mains %.1f Hz, fll %.1f: residual interference f32 %.1f dB (%.2f Hz), s16 %.1f dB (%.2f Hz)",
+                     mains[m], fll, att, freq, att16, freq16);
+            // Without the loop, only the nominal frequency is inside the notch
+            if ((fll > 0) || (mains[m] == 50.0f)) {
+                TEST_ASSERT_TRUE(att < -20);
+                TEST_ASSERT_TRUE(att16 < -20);
+            }
+            if (fll > 0) {
+                TEST_ASSERT_FLOAT_WITHIN(0.05f, mains[m], freq);
+                TEST_ASSERT_FLOAT_WITHIN(0.05f, mains[m], freq16);
+            }
+        }
+    }
+
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_anc_init_f32(&anc, NULL, 1024, 50.0f / FS, DSPS_ANC_MAX_HARMONICS + 1, mu, 0));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_anc_init_f32(&anc, NULL, 1024, 200.0f / FS, N_HARM, mu, 0));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_anc_init_s16(&anc16, NULL, 1024, 50.0f / FS, N_HARM, mu16, 2));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_LENGTH, dsps_anc_init_f32(&anc, NULL, 1000, 50.0f / FS, N_HARM, mu, 0));
+}
+
+TEST_CASE("dsps_anc benchmark", "[dsps]")
+{
+    const float mu[N_HARM] = {0.02f, 0.02f, 0.02f};
+    const int16_t mu16[N_HARM] = {655, 655, 655};
+    anc_f32_t anc;
+    anc_s16_t anc16;
+    anc_test_signal(50.0f);
+
+    dsps_anc_init_f32(&anc, NULL, 1024, 50.0f / FS, N_HARM, mu, 0.1f);
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    dsps_anc_f32(&anc, x, y, N_SAMPLES);
+    unsigned int end_b = dsp_get_cpu_cycle_count();
+    float cycles_f32 = (float)(end_b - start_b) / N_SAMPLES;
+    dsps_anc_free_f32(&anc);
+
+    dsps_anc_init_s16(&anc16, NULL, 1024, 50.0f / FS, N_HARM, mu16, 0.1f);
+    start_b = dsp_get_cpu_cycle_count();
+    dsps_anc_s16(&anc16, x16, y16, N_SAMPLES);
+    end_b = dsp_get_cpu_cycle_count();
+    float cycles_s16 = (float)(end_b - start_b) / N_SAMPLES;
+    dsps_anc_free_s16(&anc16);
+
+    ESP_LOGI(TAG, "%i harmonics: f32 %f, s16 %f cycles per sample", N_HARM, cycles_f32, cycles_s16);
+
+    float min_exec = 1;
+    float max_exec = 2000;
+    TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles_f32);
+    TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles_s16);
+}
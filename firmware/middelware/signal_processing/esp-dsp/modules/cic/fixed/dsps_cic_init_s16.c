@@ -0,0 +1,160 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <math.h>
+#include "dsps_cic.h"
+
+#define CIC_DESIGN_GRID     64      // number of frequency points used by the least squares fit
+#define CIC_DESIGN_RIDGE    1e-4    // regularization, keeps long compensators with a narrow band bounded
+
+// Magnitude response of the CIC decimator at frequency f, relative to the output sample rate
+static double cic_droop(double f, int order, int decim)
+{
+    if (f < 1e-9) {
+        return 1.0;
+    }
+    double num = sin(M_PI * f);
+    double den = decim * sin(M_PI * f / decim);
+    return pow(fabs(num / den), order);
+}
+
+// Least squares design of a symmetric FIR with the response gain / droop(f) over [0..passband]
+static void cic_design_comp(int16_t *coeffs, int comp_len, int order, int decim, double passband, double gain)
+{
+    const int n = comp_len / 2 + 1;                 // a[0] is the central tap, a[k] the pair at distance k
+    double ata[(DSPS_CIC_MAX_COMP_LEN / 2 + 1) * (DSPS_CIC_MAX_COMP_LEN / 2 + 2)];
+    const int stride = n + 1;                       // augmented matrix [A'A | A'T]
+    double basis[DSPS_CIC_MAX_COMP_LEN / 2 + 1];
+
+    for (int i = 0; i < n * stride; i++) {
+        ata[i] = 0;
+    }
+    for (int g = 0; g < CIC_DESIGN_GRID; g++) {
+        double f = passband * g / (CIC_DESIGN_GRID - 1);
+        double target = gain / cic_droop(f, order, decim);
+        basis[0] = 1.0;
+        for (int k = 1; k < n; k++) {
+            basis[k] = 2.0 * cos(2.0 * M_PI * k * f);
+        }
+        for (int r = 0; r < n; r++) {
+            for (int c = 0; c < n; c++) {
+                ata[r * stride + c] += basis[r] * basis[c];
+            }
+            ata[r * stride + n] += basis[r] * target;
+        }
+    }
+    for (int k = 1; k < n; k++) {
+        ata[k * stride + k] += CIC_DESIGN_RIDGE * CIC_DESIGN_GRID;
+    }
+
+    // Gauss-Jordan elimination with partial pivoting, the system is at most 16x16
+    for (int c = 0; c < n; c++) {
+        int pivot = c;
+        for (int r = c + 1; r < n; r++) {
+            if (fabs(ata[r * stride + c]) > fabs(ata[pivot * stride + c])) {
+                pivot = r;
+            }
+        }
+        if (pivot != c) {
+            for (int k = 0; k <= n; k++) {
+                double t = ata[c * stride + k];
+                ata[c * stride + k] = ata[pivot * stride + k];
+                ata[pivot * stride + k] = t;
+            }
+        }
+        for (int r = 0; r < n; r++) {
+            if (r == c) {
+                continue;
+            }
+            double m = ata[r * stride + c] / ata[c * stride + c];
+            for (int k = c; k <= n; k++) {
+                ata[r * stride + k] -= m * ata[c * stride + k];
+            }
+        }
+    }
+
+    // Quantize to Q14. The central tap absorbs the rounding error, so the DC gain is exact
+    const int mid = comp_len / 2;
+    long sum = 0;
+    for (int k = n - 1; k >= 0; k--) {
+        double a = ata[k * stride + n] / ata[k * stride + k];
+        long q = lround(a * (1 << DSPS_CIC_COMP_SHIFT));
+        if (k == 0) {
+            q = lround(gain * (1 << DSPS_CIC_COMP_SHIFT)) - sum;
+        }
+        if (q > INT16_MAX) {
+            q = INT16_MAX;
+        } else if (q < INT16_MIN) {
+            q = INT16_MIN;
+        }
+        coeffs[mid + k] = (int16_t)q;
+        coeffs[mid - k] = (int16_t)q;
+        sum += 2 * q;
+    }
+}
+
+esp_err_t dsps_cic_init_s16(cic_s16_t *cic, int32_t *state, int16_t *coeffs, int16_t *delay, int order, int decim, int comp_len, float passband, int in_bits)
+{
+    if ((order < 1) || (order > DSPS_CIC_MAX_ORDER) || (decim < 2) || (decim > INT16_MAX)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if ((in_bits < 2) || (in_bits > 16)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if ((comp_len != 0) && ((comp_len < 3) || (comp_len > DSPS_CIC_MAX_COMP_LEN) || ((comp_len & 1) == 0))) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    if ((comp_len != 0) && ((passband <= 0) || (passband >= 0.5f))) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if ((state == NULL) || ((comp_len != 0) && ((coeffs == NULL) || (delay == NULL)))) {
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+
+    // Bit growth: smallest g with 2^g >= decim^order
+    uint64_t gain = 1;
+    int growth = 0;
+    for (int i = 0; i < order; i++) {
+        gain *= (uint64_t)decim;
+        if (gain > ((uint64_t)1 << 32)) {
+            return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+        }
+    }
+    while (((uint64_t)1 << growth) < gain) {
+        growth++;
+    }
+    if (in_bits + growth > 32) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+
+    cic->state = (uint32_t *)state;
+    cic->coeffs = coeffs;
+    cic->delay = delay;
+    cic->order = order;
+    cic->decim = decim;
+    cic->shift = in_bits + growth - 16;
+    cic->comp_len = comp_len;
+
+    if (comp_len != 0) {
+        double residual = (double)((uint64_t)1 << growth) / (double)gain;
+        cic_design_comp(coeffs, comp_len, order, decim, passband, residual);
+    }
+
+    return dsps_cic_reset_s16(cic);
+}
+
+esp_err_t dsps_cic_reset_s16(cic_s16_t *cic)
+{
+    for (int i = 0; i < 2 * cic->order; i++) {
+        cic->state[i] = 0;
+    }
+    for (int i = 0; i < cic->comp_len; i++) {
+        cic->delay[i] = 0;
+    }
+    cic->d_pos = 0;
+    cic->pos = 0;
+    return ESP_OK;
+}
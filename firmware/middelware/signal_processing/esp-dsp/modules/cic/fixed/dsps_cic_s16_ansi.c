@@ -0,0 +1,79 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "dsps_cic.h"
+
+static inline int16_t cic_sat16(int32_t x)
+{
+    if (x > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (x < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)x;
+}
+
+int32_t dsps_cic_s16_ansi(cic_s16_t *cic, const int16_t *input, int16_t *output, int32_t len)
+{
+    uint32_t *integ = cic->state;
+    uint32_t *comb = cic->state + cic->order;
+    const int order = cic->order;
+    int32_t result = 0;
+
+    for (int32_t i = 0; i < len; i++) {
+        // Integrators, modulo 2^32
+        uint32_t acc = (uint32_t)(int32_t)input[i];
+        for (int n = 0; n < order; n++) {
+            integ[n] += acc;
+            acc = integ[n];
+        }
+        if (++cic->d_pos < cic->decim) {
+            continue;
+        }
+        cic->d_pos = 0;
+
+        // Combs at the low rate
+        for (int n = 0; n < order; n++) {
+            uint32_t prev = comb[n];
+            comb[n] = acc;
+            acc -= prev;
+        }
+        int32_t y;
+        if (cic->shift >= 0) {
+            y = ((int32_t)acc) >> cic->shift;
+        } else {
+            y = (int32_t)(acc << (-cic->shift));
+        }
+
+        if (cic->comp_len == 0) {
+            output[result++] = cic_sat16(y);
+            continue;
+        }
+
+        // Droop compensation, symmetric FIR in Q14
+        cic->delay[cic->pos] = cic_sat16(y);
+        if (++cic->pos >= cic->comp_len) {
+            cic->pos = 0;
+        }
+        long long macc = 1 << (DSPS_CIC_COMP_SHIFT - 1);
+        int16_t coeff_pos = 0;
+        for (int n = cic->pos; n < cic->comp_len; n++) {
+            macc += (int32_t)cic->coeffs[coeff_pos++] * (int32_t)cic->delay[n];
+        }
+        for (int n = 0; n < cic->pos; n++) {
+            macc += (int32_t)cic->coeffs[coeff_pos++] * (int32_t)cic->delay[n];
+        }
+        macc >>= DSPS_CIC_COMP_SHIFT;
+        if (macc > INT16_MAX) {
+            macc = INT16_MAX;
+        } else if (macc < INT16_MIN) {
+            macc = INT16_MIN;
+        }
+        output[result++] = (int16_t)macc;
+    }
+    return result;
+}
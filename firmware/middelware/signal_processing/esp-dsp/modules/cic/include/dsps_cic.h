@@ -0,0 +1,117 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _dsps_cic_H_
+#define _dsps_cic_H_
+
+#include "dsp_err.h"
+#include "dsp_common.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define DSPS_CIC_MAX_ORDER      6       /*!< Maximum number of integrator/comb stages*/
+#define DSPS_CIC_MAX_COMP_LEN   31      /*!< Maximum length of the compensation FIR filter*/
+#define DSPS_CIC_COMP_SHIFT     14      /*!< Compensation coefficients are stored in Q14*/
+
+/**
+ * @brief Data struct of s16 CIC decimator
+ *
+ * This structure is used by a filter internally. A user should access this structure only in case of
+ * extensions for the DSP Library.
+ * All fields of this structure are initialized by the dsps_cic_init_s16(...) function.
+ *
+ * The integrator and comb registers use modulo 2^32 arithmetic, so intermediate overflows in the
+ * integrators are harmless as long as the final output range fits into 32 bits. This is checked by
+ * the init function.
+ */
+typedef struct cic_s16_s {
+    uint32_t   *state;          /*!< Pointer to the integrator (first order values) and comb (next order values) registers.*/
+    int16_t    *coeffs;         /*!< Pointer to the Q14 compensation FIR coefficients.*/
+    int16_t    *delay;          /*!< Pointer to the compensation FIR delay line.*/
+    int16_t     order;          /*!< Number of integrator and comb stages (N).*/
+    int16_t     decim;          /*!< Decimation factor (R).*/
+    int16_t     d_pos;          /*!< Actual decimation counter.*/
+    int16_t     shift;          /*!< Right shift applied to the comb output to obtain a 16 bit value.*/
+    int16_t     comp_len;       /*!< Compensation FIR length, 0 if the compensation is disabled.*/
+    int16_t     pos;            /*!< Position in the compensation delay line.*/
+} cic_s16_t;
+
+/**
+ * @brief   initialize structure for 16 bit CIC decimator
+ *
+ * Function initializes a multiplierless cascaded integrator-comb decimator (differential delay of 1)
+ * followed by an optional short FIR compensation filter running at the output rate.
+ * The compensation coefficients are designed automatically by a least squares fit of the inverse
+ * CIC droop over [0..passband] and stored in Q14. The residual gain of a non power of two decimation
+ * factor is folded into these coefficients, so the DC gain of the chain is 2^(16 - in_bits):
+ * a full scale in_bits input is returned as a full scale 16 bit output. Without compensation
+ * the DC gain is 2^(16 - in_bits) * decim^order / 2^ceil(order*log2(decim)).
+ * Design happens once, in floating point, inside this function. The processing functions are integer only.
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param cic: pointer to CIC structure, that must be preallocated
+ * @param state: array for the integrator and comb registers. Must be length 2*order
+ * @param coeffs: array for the compensation FIR coefficients. Must be length comp_len. Could be NULL if comp_len is 0
+ * @param delay: array for the compensation FIR delay line. Must be length comp_len. Could be NULL if comp_len is 0
+ * @param order: number of integrator and comb stages [1..DSPS_CIC_MAX_ORDER]
+ * @param decim: decimation factor, must be higher than 1
+ * @param comp_len: compensation FIR length, odd number [3..DSPS_CIC_MAX_COMP_LEN] or 0 to disable the compensation
+ * @param passband: edge of the compensated band, relative to the output sample rate (0..0.5)
+ * @param in_bits: number of significant bits of the signed input samples [2..16], 12 for the ESP32-C6 ADC
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_PARAM if a required buffer is NULL
+ *      - ESP_ERR_DSP_INVALID_LENGTH if comp_len is not valid
+ *      - ESP_ERR_DSP_PARAM_OUTOFRANGE if order, decimation, passband or in_bits are out of range,
+ *        or if in_bits + order*log2(decim) exceeds 32 bits
+ */
+esp_err_t dsps_cic_init_s16(cic_s16_t *cic, int32_t *state, int16_t *coeffs, int16_t *delay, int order, int decim, int comp_len, float passband, int in_bits);
+
+/**
+ * @brief   reset the CIC decimator state
+ *
+ * Function clears integrators, combs, the compensation delay line and the decimation counter
+ * without redesigning the compensation filter.
+ *
+ * @param cic: pointer to CIC structure, that must be initialized before
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dsps_cic_reset_s16(cic_s16_t *cic);
+
+/**@{*/
+/**
+ * @brief   16 bit signed fixed point CIC decimator
+ *
+ * Function pushes len input samples through the integrators and produces one output sample every
+ * decim input samples. The decimation phase is kept in the structure, so the input could be split
+ * into blocks of any length (for example, one block per ADC DMA frame).
+ * Per input sample the cost is order additions; per output sample order subtractions plus
+ * comp_len multiply-accumulates.
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param cic: pointer to CIC structure, that must be initialized before
+ * @param[in] input: input array
+ * @param[out] output: output array. Must have at least len/decim + 1 elements
+ * @param len: length of the input array
+ *
+ * @return: function returns the number of samples stored in the output array
+ */
+int32_t dsps_cic_s16_ansi(cic_s16_t *cic, const int16_t *input, int16_t *output, int32_t len);
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#define dsps_cic_s16 dsps_cic_s16_ansi
+
+#endif // _dsps_cic_H_
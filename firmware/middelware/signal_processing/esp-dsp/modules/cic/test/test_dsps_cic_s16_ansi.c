@@ -0,0 +1,137 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <math.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsps_cic.h"
+#include "dsp_tests.h"
+
+static const char *TAG = "dsps_cic_s16_ansi";
+
+#define N_IN_SAMPLES    4096
+#define MAX_DECIM       32
+
+static int16_t x[N_IN_SAMPLES];
+static int16_t y[N_IN_SAMPLES / 2 + 1];
+static int16_t y_ref[N_IN_SAMPLES / 2 + 1];
+static int32_t state[2 * DSPS_CIC_MAX_ORDER];
+static int16_t coeffs[DSPS_CIC_MAX_COMP_LEN];
+static int16_t delay[DSPS_CIC_MAX_COMP_LEN];
+
+// RMS of the output over the last n samples
+static float cic_out_rms(const int16_t *out, int total, int n)
+{
+    float acc = 0;
+    for (int i = total - n; i < total; i++) {
+        acc += (float)out[i] * out[i];
+    }
+    return sqrtf(acc / n);
+}
+
+static int cic_run_tone(int comp_len, float f_out, float amplitude)
+{
+    const int decim = 16;
+    cic_s16_t cic;
+    dsps_cic_init_s16(&cic, state, coeffs, delay, 3, decim, comp_len, 0.2f, 12);
+    for (int i = 0; i < N_IN_SAMPLES; i++) {
+        x[i] = (int16_t)lroundf(amplitude * sinf(2 * M_PI * f_out * i / decim));
+    }
+    return dsps_cic_s16_ansi(&cic, x, y, N_IN_SAMPLES);
+}
+
+TEST_CASE("dsps_cic_s16_ansi functionality", "[dsps]")
+{
+    // First order CIC is a boxcar: each output is the sum of the last decim inputs
+    cic_s16_t cic;
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_cic_init_s16(&cic, state, NULL, NULL, 1, 4, 0, 0, 16));
+    for (int i = 0; i < N_IN_SAMPLES; i++) {
+        x[i] = (int16_t)((rand() & 0xffff) - 0x8000);
+    }
+    int total = dsps_cic_s16_ansi(&cic, x, y, N_IN_SAMPLES);
+    TEST_ASSERT_EQUAL(N_IN_SAMPLES / 4, total);
+    for (int i = 0; i < total; i++) {
+        int32_t sum = x[4 * i] + x[4 * i + 1] + x[4 * i + 2] + x[4 * i + 3];
+        TEST_ASSERT_EQUAL(sum >> 2, y[i]);
+    }
+
+    // Splitting the input into odd sized blocks must not change the result
+    const int decim = 5;
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_cic_init_s16(&cic, state, coeffs, delay, 4, decim, 5, 0.25f, 12));
+    for (int i = 0; i < N_IN_SAMPLES; i++) {
+        x[i] = (int16_t)((rand() & 0xfff) - 0x800);
+    }
+    total = dsps_cic_s16_ansi(&cic, x, y_ref, N_IN_SAMPLES);
+    TEST_ASSERT_EQUAL(N_IN_SAMPLES / decim, total);
+    dsps_cic_reset_s16(&cic);
+    int pos = 0;
+    int out = 0;
+    while (pos < N_IN_SAMPLES) {
+        int block = 1 + (rand() % 37);
+        if (pos + block > N_IN_SAMPLES) {
+            block = N_IN_SAMPLES - pos;
+        }
+        out += dsps_cic_s16_ansi(&cic, &x[pos], &y[out], block);
+        pos += block;
+    }
+    TEST_ASSERT_EQUAL(total, out);
+    for (int i = 0; i < total; i++) {
+        TEST_ASSERT_EQUAL(y_ref[i], y[i]);
+    }
+}
+
+TEST_CASE("dsps_cic_s16_ansi gain and compensation", "[dsps]")
+{
+    // DC: a 12 bit input is returned scaled to 16 bits
+    cic_s16_t cic;
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_cic_init_s16(&cic, state, coeffs, delay, 3, 20, 7, 0.2f, 12));
+    for (int i = 0; i < N_IN_SAMPLES; i++) {
+        x[i] = 1000;
+    }
+    int total = dsps_cic_s16_ansi(&cic, x, y, N_IN_SAMPLES);
+    TEST_ASSERT_INT_WITHIN(1, 16000, y[total - 1]);
+
+    // Droop at the passband edge: 3rd order CIC loses ~1.7 dB, the compensator must restore it
+    const float amplitude = 1500;
+    const float expected = amplitude * 16 / sqrtf(2);
+    total = cic_run_tone(0, 0.2f, amplitude);
+    float droop = cic_out_rms(y, total, 200) / expected;
+    total = cic_run_tone(7, 0.2f, amplitude);
+    float compensated = cic_out_rms(y, total, 200) / expected;
+    ESP_LOGI(TAG, "passband edge gain: %f without, %f with compensation", droop, compensated);
+    TEST_ASSERT_TRUE(droop < 0.85f);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, compensated);
+
+    // Out of range configurations
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_cic_init_s16(&cic, state, NULL, NULL, 6, 64, 0, 0, 12));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_LENGTH, dsps_cic_init_s16(&cic, state, coeffs, delay, 3, 16, 4, 0.2f, 12));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_PARAM, dsps_cic_init_s16(&cic, state, NULL, NULL, 3, 16, 5, 0.2f, 12));
+}
+
+TEST_CASE("dsps_cic_s16_ansi benchmark", "[dsps]")
+{
+    const int decim = MAX_DECIM;
+    cic_s16_t cic;
+    dsps_cic_init_s16(&cic, state, coeffs, delay, 4, decim, 7, 0.2f, 12);
+    for (int i = 0; i < N_IN_SAMPLES; i++) {
+        x[i] = (int16_t)((rand() & 0xfff) - 0x800);
+    }
+
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    dsps_cic_s16_ansi(&cic, x, y, N_IN_SAMPLES);
+    unsigned int end_b = dsp_get_cpu_cycle_count();
+
+    float cycles = (float)(end_b - start_b) / N_IN_SAMPLES;
+    ESP_LOGI(TAG, "dsps_cic_s16_ansi - %f cycles per input sample, order 4, decimation %i, 7 taps compensation", cycles, decim);
+
+    float min_exec = 2;
+    float max_exec = 100;
+    TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles);
+}
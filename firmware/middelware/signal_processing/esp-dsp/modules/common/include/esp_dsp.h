@@ -28,8 +28,19 @@ extern "C"
 #include "dsps_dotprod.h"
 #include "dsps_math.h"
 #include "dsps_fir.h"
+#include "dsps_cic.h"
+#include "dsps_running.h"
+#include "dsps_stats.h"
 #include "dsps_biquad.h"
 #include "dsps_biquad_gen.h"
+#include "dsps_octave.h"
+#include "dsps_anc.h"
+#include "dsps_rls.h"
+#include "dsps_qrs.h"
+#include "dsps_hrv.h"
+#include "dsps_baseline.h"
+#include "dsps_emg.h"
+#include "dsps_ahrs.h"
 #include "dsps_wind.h"
 #include "dsps_conv.h"
 #include "dsps_corr.h"
@@ -43,6 +54,7 @@ extern "C"
 #include "dsps_fft2r.h"
 #include "dsps_fft4r.h"
 #include "dsps_dct.h"
+#include "dsps_dwt.h"
 
 // Matrix operations
 #include "dspm_matrix.h"
@@ -60,6 +72,11 @@ extern "C"
 
 #ifdef __cplusplus
 #include "mat.h"
+#include "mat_alloc.h"
+#include "mat_fixed.h"
+#include "mat_sparse.h"
+#include "mat_solve.h"
+#include "fir_fixed.h"
 #endif
 
 #endif // _esp_dsp_H_
@@ -0,0 +1,215 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "dsps_dwt.h"
+
+// One lifting step: x[i] += (c*(x[i-1] + x[i+1]) + rnd) >> shift for the odd (parity 1)
+// or even (parity 0) samples of the n samples at data[0], data[stride], ...
+typedef struct dwt_lift_step_s {
+    int32_t parity;
+    int32_t c;
+    int32_t shift;
+    int32_t rnd;
+} dwt_lift_step_t;
+
+// LeGall 5/3: d -= (l + r) >> 1, s += (l + r + 2) >> 2
+static const dwt_lift_step_t dwt_steps_53[] = {
+    {1, -1, 1, 1},
+    {0, 1, 2, 2},
+};
+
+// CDF 9/7 lifting constants alpha, beta, gamma, delta in Q12
+static const dwt_lift_step_t dwt_steps_97[] = {
+    {1, -6497, 12, 2048},
+    {0, -217, 12, 2048},
+    {1, 3616, 12, 2048},
+    {0, 1817, 12, 2048},
+};
+
+static inline int32_t dwt_lift_term(const dwt_lift_step_t *st, int32_t sum)
+{
+    if (st->c == 1 || st->c == -1) {
+        return (st->c * sum + st->rnd) >> st->shift;
+    }
+    return (int32_t)(((int64_t)st->c * sum + st->rnd) >> st->shift);
+}
+
+// Whole-sample symmetric extension: x[-1] = x[1], x[n] = x[n-2]
+static void dwt_lift(int32_t *data, int n, int stride, const dwt_lift_step_t *st, int32_t sign)
+{
+    int32_t *x = data;
+    const int s2 = 2 * stride;
+    if (st->parity) {
+        x += stride;
+        for (int i = 1; i < n - 1; i += 2) {
+            x[0] += sign * dwt_lift_term(st, x[-stride] + x[stride]);
+            x += s2;
+        }
+        x[0] += sign * dwt_lift_term(st, x[-stride] + x[-stride]);
+    } else {
+        x[0] += sign * dwt_lift_term(st, x[stride] + x[stride]);
+        x += s2;
+        for (int i = 2; i < n; i += 2) {
+            x[0] += sign * dwt_lift_term(st, x[-stride] + x[stride]);
+            x += s2;
+        }
+    }
+}
+
+static void dwt_haar_fwd(int32_t *x, int n, int stride)
+{
+    for (int i = 0; i < n; i += 2) {
+        int32_t d = x[stride] - x[0];
+        x[0] += d >> 1;
+        x[stride] = d;
+        x += 2 * stride;
+    }
+}
+
+static void dwt_haar_inv(int32_t *x, int n, int stride)
+{
+    for (int i = 0; i < n; i += 2) {
+        int32_t d = x[stride];
+        x[0] -= d >> 1;
+        x[stride] = d + x[0];
+        x += 2 * stride;
+    }
+}
+
+static esp_err_t dwt_check(int len, int levels)
+{
+    if ((levels < 1) || (levels > DSPS_DWT_MAX_LEVELS)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if ((len <= 0) || (len & ((1 << levels) - 1))) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    return ESP_OK;
+}
+
+static const dwt_lift_step_t *dwt_get_steps(dsps_dwt_type_t type, int *n_steps)
+{
+    switch (type) {
+    case DSPS_DWT_LEGALL53:
+        *n_steps = sizeof(dwt_steps_53) / sizeof(dwt_steps_53[0]);
+        return dwt_steps_53;
+    case DSPS_DWT_CDF97:
+        *n_steps = sizeof(dwt_steps_97) / sizeof(dwt_steps_97[0]);
+        return dwt_steps_97;
+    default:
+        *n_steps = 0;
+        return NULL;
+    }
+}
+
+esp_err_t dsps_dwt_fwd_s32(int32_t *data, int len, int levels, dsps_dwt_type_t type)
+{
+    esp_err_t ret = dwt_check(len, levels);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    int n_steps = 0;
+    const dwt_lift_step_t *steps = dwt_get_steps(type, &n_steps);
+    if ((type != DSPS_DWT_HAAR) && (steps == NULL)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+
+    for (int l = 0; l < levels; l++) {
+        const int stride = 1 << l;
+        const int n = len >> l;
+        if (type == DSPS_DWT_HAAR) {
+            dwt_haar_fwd(data, n, stride);
+            continue;
+        }
+        for (int s = 0; s < n_steps; s++) {
+            dwt_lift(data, n, stride, &steps[s], 1);
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_dwt_inv_s32(int32_t *data, int len, int levels, dsps_dwt_type_t type)
+{
+    esp_err_t ret = dwt_check(len, levels);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    int n_steps = 0;
+    const dwt_lift_step_t *steps = dwt_get_steps(type, &n_steps);
+    if ((type != DSPS_DWT_HAAR) && (steps == NULL)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+
+    for (int l = levels - 1; l >= 0; l--) {
+        const int stride = 1 << l;
+        const int n = len >> l;
+        if (type == DSPS_DWT_HAAR) {
+            dwt_haar_inv(data, n, stride);
+            continue;
+        }
+        for (int s = n_steps - 1; s >= 0; s--) {
+            dwt_lift(data, n, stride, &steps[s], -1);
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_dwt_thresh_s32(int32_t *data, int len, int levels, const int32_t *thresh, dsps_dwt_thresh_t mode)
+{
+    esp_err_t ret = dwt_check(len, levels);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    for (int l = 0; l < levels; l++) {
+        const int32_t t = thresh[l];
+        const int step = 2 << l;
+        for (int i = 1 << l; i < len; i += step) {
+            int32_t c = data[i];
+            if ((c <= t) && (c >= -t)) {
+                data[i] = 0;
+            } else if (mode == DSPS_DWT_SOFT) {
+                data[i] = (c > 0) ? c - t : c + t;
+            }
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_dwt_pack_s32(const int32_t *src, int32_t *dst, int len, int levels)
+{
+    esp_err_t ret = dwt_check(len, levels);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    int pos = 0;
+    for (int i = 0; i < len; i += 1 << levels) {
+        dst[pos++] = src[i];
+    }
+    for (int l = levels - 1; l >= 0; l--) {
+        for (int i = 1 << l; i < len; i += 2 << l) {
+            dst[pos++] = src[i];
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_dwt_unpack_s32(const int32_t *src, int32_t *dst, int len, int levels)
+{
+    esp_err_t ret = dwt_check(len, levels);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    int pos = 0;
+    for (int i = 0; i < len; i += 1 << levels) {
+        dst[i] = src[pos++];
+    }
+    for (int l = levels - 1; l >= 0; l--) {
+        for (int i = 1 << l; i < len; i += 2 << l) {
+            dst[i] = src[pos++];
+        }
+    }
+    return ESP_OK;
+}
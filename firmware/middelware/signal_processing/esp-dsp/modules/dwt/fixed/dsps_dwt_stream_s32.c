@@ -0,0 +1,78 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include "dsps_dwt.h"
+
+// Half support of the analysis lowpass filter: 1 (Haar), 2 (5/3) or 4 (9/7) samples.
+// The forward and the inverse transforms each reach hs*(2^levels - 1) samples away,
+// so a margin of 2*hs*2^levels keeps the central samples free of border effects.
+static int dwt_stream_margin(int levels, dsps_dwt_type_t type)
+{
+    const int hs = (type == DSPS_DWT_CDF97) ? 4 : (type == DSPS_DWT_LEGALL53) ? 2 : 1;
+    return 2 * hs << levels;
+}
+
+int dsps_dwt_stream_buf_len(int hop, int levels, dsps_dwt_type_t type)
+{
+    return 2 * (hop + 2 * dwt_stream_margin(levels, type));
+}
+
+esp_err_t dsps_dwt_stream_init_s32(dwt_stream_s32_t *st, int32_t *buf, int hop, int levels, dsps_dwt_type_t type, const int32_t *thresh, dsps_dwt_thresh_t mode)
+{
+    if ((buf == NULL) || (thresh == NULL)) {
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    if ((levels < 1) || (levels > DSPS_DWT_MAX_LEVELS) || (type > DSPS_DWT_CDF97)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if ((hop <= 0) || (hop & ((1 << levels) - 1))) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    st->hop = hop;
+    st->margin = dwt_stream_margin(levels, type);
+    st->win_len = hop + 2 * st->margin;
+    st->window = buf;
+    st->work = buf + st->win_len;
+    st->fill = 0;
+    st->levels = levels;
+    st->type = type;
+    st->mode = mode;
+    for (int l = 0; l < levels; l++) {
+        st->thresh[l] = thresh[l];
+    }
+    memset(buf, 0, 2 * st->win_len * sizeof(int32_t));
+    return ESP_OK;
+}
+
+int dsps_dwt_stream_s32(dwt_stream_s32_t *st, const int32_t *input, int len, int32_t *output)
+{
+    int out_len = 0;
+    while (len > 0) {
+        int n = st->win_len - st->fill;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(&st->window[st->fill], input, n * sizeof(int32_t));
+        st->fill += n;
+        input += n;
+        len -= n;
+        if (st->fill < st->win_len) {
+            break;
+        }
+
+        memcpy(st->work, st->window, st->win_len * sizeof(int32_t));
+        dsps_dwt_fwd_s32(st->work, st->win_len, st->levels, st->type);
+        dsps_dwt_thresh_s32(st->work, st->win_len, st->levels, st->thresh, st->mode);
+        dsps_dwt_inv_s32(st->work, st->win_len, st->levels, st->type);
+        memcpy(&output[out_len], &st->work[st->margin], st->hop * sizeof(int32_t));
+        out_len += st->hop;
+
+        st->fill = st->win_len - st->hop;
+        memmove(st->window, &st->window[st->hop], st->fill * sizeof(int32_t));
+    }
+    return out_len;
+}
@@ -0,0 +1,199 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _dsps_dwt_H_
+#define _dsps_dwt_H_
+
+#include "dsp_err.h"
+#include "dsp_common.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define DSPS_DWT_MAX_LEVELS     12  /*!< Maximum number of decomposition levels*/
+
+/**
+ * @brief Wavelet of the integer lifting transform
+ */
+typedef enum dsps_dwt_type {
+    DSPS_DWT_HAAR = 0,      /*!< Haar (S transform)*/
+    DSPS_DWT_LEGALL53 = 1,  /*!< LeGall 5/3, the JPEG2000 reversible wavelet*/
+    DSPS_DWT_CDF97 = 2,     /*!< CDF 9/7 with Q12 lifting constants and rounding, without the final scaling*/
+} dsps_dwt_type_t;
+
+/**
+ * @brief Thresholding mode
+ */
+typedef enum dsps_dwt_thresh {
+    DSPS_DWT_HARD = 0,      /*!< Coefficients with |c| <= T are cleared, the others are kept*/
+    DSPS_DWT_SOFT = 1,      /*!< Coefficients are shrunk toward zero by T*/
+} dsps_dwt_thresh_t;
+
+/**
+ * @brief Data struct of the streaming wavelet denoiser
+ *
+ * The input is processed in overlapping windows of hop + 2*margin samples. Every window is transformed,
+ * thresholded and reconstructed, and only its central hop samples are returned. The margin covers the
+ * support of the analysis and synthesis filters at the deepest level, so the output is identical to the
+ * denoising of the whole signal at once, with a latency of hop + margin samples.
+ * All fields of this structure are initialized by the dsps_dwt_stream_init_s32(...) function.
+ */
+typedef struct dwt_stream_s32_s {
+    int32_t            *window;     /*!< Last hop + 2*margin input samples.*/
+    int32_t            *work;       /*!< Transform buffer, same length as the window.*/
+    int32_t             thresh[DSPS_DWT_MAX_LEVELS];    /*!< Threshold of every detail level, finest first.*/
+    int                 hop;        /*!< Number of new samples per window.*/
+    int                 margin;     /*!< Samples kept on each side of the hop.*/
+    int                 win_len;    /*!< Window length, hop + 2*margin.*/
+    int                 fill;       /*!< Number of valid samples in the window.*/
+    int                 levels;     /*!< Number of decomposition levels.*/
+    dsps_dwt_type_t     type;       /*!< Wavelet.*/
+    dsps_dwt_thresh_t   mode;       /*!< Thresholding mode.*/
+} dwt_stream_s32_t;
+
+/**
+ * @brief   forward integer lifting wavelet transform
+ *
+ * Multi-level integer-to-integer transform computed in place, with whole-sample symmetric extension
+ * at the borders. Only integer additions, shifts and (for CDF 9/7) multiplications are used.
+ * The coefficients are left interleaved: after L levels the approximation is at the indexes that are
+ * multiples of 2^L and the details of level j (1 is the finest) are at the indexes equal to 2^(j-1) modulo 2^j.
+ * Use dsps_dwt_pack_s32 to get the usual [aL dL ... d1] order.
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param[in,out] data: signal, replaced by the coefficients
+ * @param len: length of the signal, must be a multiple of 2^levels
+ * @param levels: number of decomposition levels [1..DSPS_DWT_MAX_LEVELS]
+ * @param type: wavelet
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_LENGTH if len is not a multiple of 2^levels
+ *      - ESP_ERR_DSP_PARAM_OUTOFRANGE if levels or type are out of range
+ */
+esp_err_t dsps_dwt_fwd_s32(int32_t *data, int len, int levels, dsps_dwt_type_t type);
+
+/**
+ * @brief   inverse integer lifting wavelet transform
+ *
+ * Exact inverse of dsps_dwt_fwd_s32: every lifting step is undone with the same integer rounding,
+ * so the reconstruction is lossless.
+ *
+ * @param[in,out] data: interleaved coefficients, replaced by the signal
+ * @param len: length of the signal, must be a multiple of 2^levels
+ * @param levels: number of decomposition levels [1..DSPS_DWT_MAX_LEVELS]
+ * @param type: wavelet
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_LENGTH if len is not a multiple of 2^levels
+ *      - ESP_ERR_DSP_PARAM_OUTOFRANGE if levels or type are out of range
+ */
+esp_err_t dsps_dwt_inv_s32(int32_t *data, int len, int levels, dsps_dwt_type_t type);
+
+/**
+ * @brief   threshold the detail coefficients
+ *
+ * The approximation coefficients are not modified.
+ *
+ * @param[in,out] data: interleaved coefficients from dsps_dwt_fwd_s32
+ * @param len: length of the data array
+ * @param levels: number of decomposition levels
+ * @param thresh: threshold of every detail level, finest first. Must be length levels
+ * @param mode: hard or soft thresholding
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_LENGTH if len is not a multiple of 2^levels
+ *      - ESP_ERR_DSP_PARAM_OUTOFRANGE if levels is out of range
+ */
+esp_err_t dsps_dwt_thresh_s32(int32_t *data, int len, int levels, const int32_t *thresh, dsps_dwt_thresh_t mode);
+
+/**
+ * @brief   reorder interleaved coefficients into subbands
+ *
+ * Writes [aL, dL, dL-1, ... d1] to dst, the order used to store or transmit the coefficients.
+ *
+ * @param[in] src: interleaved coefficients
+ * @param[out] dst: packed coefficients, must not overlap src
+ * @param len: length of both arrays, must be a multiple of 2^levels
+ * @param levels: number of decomposition levels
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_LENGTH if len is not a multiple of 2^levels
+ */
+esp_err_t dsps_dwt_pack_s32(const int32_t *src, int32_t *dst, int len, int levels);
+
+/**
+ * @brief   reorder subbands into interleaved coefficients
+ *
+ * Inverse of dsps_dwt_pack_s32.
+ *
+ * @param[in] src: packed coefficients
+ * @param[out] dst: interleaved coefficients, must not overlap src
+ * @param len: length of both arrays, must be a multiple of 2^levels
+ * @param levels: number of decomposition levels
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_LENGTH if len is not a multiple of 2^levels
+ */
+esp_err_t dsps_dwt_unpack_s32(const int32_t *src, int32_t *dst, int len, int levels);
+
+/**
+ * @brief   initialize the streaming wavelet denoiser
+ *
+ * @param st: pointer to the stream structure, that must be preallocated
+ * @param buf: working memory. Must be length dsps_dwt_stream_buf_len(hop, levels, type)
+ * @param hop: number of output samples per window, must be a multiple of 2^levels
+ * @param levels: number of decomposition levels [1..DSPS_DWT_MAX_LEVELS]
+ * @param type: wavelet
+ * @param thresh: threshold of every detail level, finest first. Must be length levels
+ * @param mode: hard or soft thresholding
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_PARAM if buf or thresh are NULL
+ *      - ESP_ERR_DSP_INVALID_LENGTH if hop is not a multiple of 2^levels
+ *      - ESP_ERR_DSP_PARAM_OUTOFRANGE if levels or type are out of range
+ */
+esp_err_t dsps_dwt_stream_init_s32(dwt_stream_s32_t *st, int32_t *buf, int hop, int levels, dsps_dwt_type_t type, const int32_t *thresh, dsps_dwt_thresh_t mode);
+
+/**
+ * @brief   working memory of the streaming wavelet denoiser
+ *
+ * @param hop: number of output samples per window
+ * @param levels: number of decomposition levels
+ * @param type: wavelet
+ *
+ * @return number of int32_t elements needed by dsps_dwt_stream_init_s32
+ */
+int dsps_dwt_stream_buf_len(int hop, int levels, dsps_dwt_type_t type);
+
+/**
+ * @brief   streaming wavelet denoiser
+ *
+ * Function pushes len samples and writes the denoised signal, hop samples every time a window is complete.
+ * The first output sample corresponds to the input sample received hop + margin samples before it.
+ * The first margin samples of the signal are never returned.
+ *
+ * @param st: pointer to the stream structure, that must be initialized before
+ * @param[in] input: input array
+ * @param len: length of the input array
+ * @param[out] output: output array. Must have at least len + hop elements
+ *
+ * @return: function returns the number of samples stored in the output array
+ */
+int dsps_dwt_stream_s32(dwt_stream_s32_t *st, const int32_t *input, int len, int32_t *output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _dsps_dwt_H_
@@ -0,0 +1,183 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsps_dwt.h"
+#include "dsp_tests.h"
+
+static const char *TAG = "dsps_dwt_s32";
+
+#define N_SAMPLES   1024
+#define N_LEVELS    5
+#define HOP         64
+
+static int32_t x[N_SAMPLES];
+static int32_t clean[N_SAMPLES];
+static int32_t y[N_SAMPLES];
+static int32_t y2[N_SAMPLES + HOP];
+static int32_t ref[N_SAMPLES];
+static int32_t stream_buf[2 * (HOP + 4 * 4 * (1 << N_LEVELS))];
+
+// Triangle wave with a sharp spike, the kind of edges the wavelet denoising must keep
+static void dwt_test_signal(void)
+{
+    for (int i = 0; i < N_SAMPLES; i++) {
+        int p = i % 256;
+        clean[i] = (p < 128) ? p * 16 - 1024 : (255 - p) * 16 - 1024;
+        if ((i % 300) == 150) {
+            clean[i] += 3000;
+        }
+        x[i] = clean[i] + (rand() % 201) - 100;
+    }
+}
+
+static int64_t dwt_err_energy(const int32_t *a, const int32_t *b, int from, int to)
+{
+    int64_t e = 0;
+    for (int i = from; i < to; i++) {
+        int64_t d = a[i] - b[i];
+        e += d * d;
+    }
+    return e;
+}
+
+TEST_CASE("dsps_dwt_s32 functionality", "[dsps]")
+{
+    const dsps_dwt_type_t types[] = {DSPS_DWT_HAAR, DSPS_DWT_LEGALL53, DSPS_DWT_CDF97};
+    for (int i = 0; i < N_SAMPLES; i++) {
+        x[i] = (rand() % 65536) - 32768;
+    }
+
+    // Lossless reconstruction for every wavelet and depth
+    for (int t = 0; t < 3; t++) {
+        for (int levels = 1; levels <= 8; levels++) {
+            memcpy(y, x, sizeof(x));
+            TEST_ASSERT_EQUAL(ESP_OK, dsps_dwt_fwd_s32(y, N_SAMPLES, levels, types[t]));
+            TEST_ASSERT_EQUAL(ESP_OK, dsps_dwt_inv_s32(y, N_SAMPLES, levels, types[t]));
+            TEST_ASSERT_EQUAL_INT32_ARRAY(x, y, N_SAMPLES);
+        }
+    }
+
+    // One level of LeGall 5/3 against the JPEG2000 formulas on separate subbands
+    int32_t d[N_SAMPLES / 2];
+    int32_t s[N_SAMPLES / 2];
+    const int half = N_SAMPLES / 2;
+    for (int n = 0; n < half; n++) {
+        int32_t right = (n + 1 < half) ? x[2 * n + 2] : x[2 * n];
+        d[n] = x[2 * n + 1] - ((x[2 * n] + right) >> 1);
+    }
+    for (int n = 0; n < half; n++) {
+        int32_t left = (n > 0) ? d[n - 1] : d[0];
+        s[n] = x[2 * n] + ((left + d[n] + 2) >> 2);
+    }
+    memcpy(y, x, sizeof(x));
+    dsps_dwt_fwd_s32(y, N_SAMPLES, 1, DSPS_DWT_LEGALL53);
+    for (int n = 0; n < half; n++) {
+        TEST_ASSERT_EQUAL(s[n], y[2 * n]);
+        TEST_ASSERT_EQUAL(d[n], y[2 * n + 1]);
+    }
+
+    // Packed order: approximation first, then the details from the coarsest level
+    dsps_dwt_fwd_s32(y, N_SAMPLES, N_LEVELS, DSPS_DWT_CDF97);
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_dwt_pack_s32(y, ref, N_SAMPLES, N_LEVELS));
+    TEST_ASSERT_EQUAL(y[0], ref[0]);
+    TEST_ASSERT_EQUAL(y[1 << N_LEVELS], ref[1]);
+    TEST_ASSERT_EQUAL(y[1 << (N_LEVELS - 1)], ref[N_SAMPLES >> N_LEVELS]);
+    TEST_ASSERT_EQUAL(y[1], ref[N_SAMPLES / 2]);
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_dwt_unpack_s32(ref, y2, N_SAMPLES, N_LEVELS));
+    TEST_ASSERT_EQUAL_INT32_ARRAY(y, y2, N_SAMPLES);
+
+    // Thresholding never touches the approximation
+    const int32_t big[N_LEVELS] = {1 << 30, 1 << 30, 1 << 30, 1 << 30, 1 << 30};
+    memcpy(ref, y, sizeof(y));
+    dsps_dwt_thresh_s32(y, N_SAMPLES, N_LEVELS, big, DSPS_DWT_SOFT);
+    for (int i = 0; i < N_SAMPLES; i++) {
+        TEST_ASSERT_EQUAL((i % (1 << N_LEVELS)) ? 0 : ref[i], y[i]);
+    }
+
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_LENGTH, dsps_dwt_fwd_s32(y, 100, 3, DSPS_DWT_HAAR));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_dwt_fwd_s32(y, N_SAMPLES, 0, DSPS_DWT_HAAR));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_dwt_inv_s32(y, N_SAMPLES, 2, (dsps_dwt_type_t)7));
+}
+
+TEST_CASE("dsps_dwt_s32 denoising", "[dsps]")
+{
+    const dsps_dwt_type_t types[] = {DSPS_DWT_HAAR, DSPS_DWT_LEGALL53, DSPS_DWT_CDF97};
+    const int32_t thresh[N_LEVELS] = {250, 175, 125, 90, 60};
+    dwt_test_signal();
+    int64_t e_noisy = dwt_err_energy(x, clean, 0, N_SAMPLES);
+
+    for (int t = 0; t < 3; t++) {
+        for (int mode = DSPS_DWT_HARD; mode <= DSPS_DWT_SOFT; mode++) {
+            memcpy(ref, x, sizeof(x));
+            dsps_dwt_fwd_s32(ref, N_SAMPLES, N_LEVELS, types[t]);
+            dsps_dwt_thresh_s32(ref, N_SAMPLES, N_LEVELS, thresh, (dsps_dwt_thresh_t)mode);
+            dsps_dwt_inv_s32(ref, N_SAMPLES, N_LEVELS, types[t]);
+            int64_t e_denoised = dwt_err_energy(ref, clean, 0, N_SAMPLES);
+            ESP_LOGI(TAG, "type %i, mode %i: error energy %lli -> %lli", t, mode, (long long)e_noisy, (long long)e_denoised);
+            // Haar leaves a staircase on the ramps, the smoother wavelets must remove most of the noise
+            if (types[t] != DSPS_DWT_HAAR) {
+                TEST_ASSERT_TRUE(e_denoised < e_noisy / 2);
+            }
+
+            // The streaming denoiser returns exactly the samples of the block transform
+            // that are far enough from the borders of the signal
+            dwt_stream_s32_t st;
+            int buf_len = dsps_dwt_stream_buf_len(HOP, N_LEVELS, types[t]);
+            TEST_ASSERT_LESS_OR_EQUAL(sizeof(stream_buf) / sizeof(stream_buf[0]), buf_len);
+            TEST_ASSERT_EQUAL(ESP_OK, dsps_dwt_stream_init_s32(&st, stream_buf, HOP, N_LEVELS, types[t], thresh, (dsps_dwt_thresh_t)mode));
+            int out_len = 0;
+            for (int i = 0; i < N_SAMPLES; i += 37) {
+                int n = (N_SAMPLES - i < 37) ? N_SAMPLES - i : 37;
+                out_len += dsps_dwt_stream_s32(&st, &x[i], n, &y2[out_len]);
+            }
+            TEST_ASSERT_EQUAL((N_SAMPLES - 2 * st.margin) / HOP * HOP, out_len);
+            for (int i = 0; i < out_len; i++) {
+                int pos = st.margin + i;
+                if ((pos >= 2 * st.margin) && (pos < N_SAMPLES - 2 * st.margin)) {
+                    TEST_ASSERT_EQUAL(ref[pos], y2[i]);
+                }
+            }
+        }
+    }
+
+    dwt_stream_s32_t st;
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_LENGTH, dsps_dwt_stream_init_s32(&st, stream_buf, 20, 3, DSPS_DWT_HAAR, thresh, DSPS_DWT_HARD));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_PARAM, dsps_dwt_stream_init_s32(&st, NULL, HOP, 3, DSPS_DWT_HAAR, thresh, DSPS_DWT_HARD));
+}
+
+TEST_CASE("dsps_dwt_s32 benchmark", "[dsps]")
+{
+    const dsps_dwt_type_t types[] = {DSPS_DWT_HAAR, DSPS_DWT_LEGALL53, DSPS_DWT_CDF97};
+    for (int i = 0; i < N_SAMPLES; i++) {
+        x[i] = (rand() % 4096) - 2048;
+    }
+
+    for (int t = 0; t < 3; t++) {
+        unsigned int start_b = dsp_get_cpu_cycle_count();
+        dsps_dwt_fwd_s32(x, N_SAMPLES, N_LEVELS, types[t]);
+        unsigned int end_b = dsp_get_cpu_cycle_count();
+        float cycles_fwd = (float)(end_b - start_b) / N_SAMPLES;
+
+        start_b = dsp_get_cpu_cycle_count();
+        dsps_dwt_inv_s32(x, N_SAMPLES, N_LEVELS, types[t]);
+        end_b = dsp_get_cpu_cycle_count();
+        float cycles_inv = (float)(end_b - start_b) / N_SAMPLES;
+
+        ESP_LOGI(TAG, "type %i, %i levels: forward %f, inverse %f cycles per sample", t, N_LEVELS, cycles_fwd, cycles_inv);
+
+        float min_exec = 1;
+        float max_exec = 500;
+        TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles_fwd);
+        TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles_inv);
+    }
+}
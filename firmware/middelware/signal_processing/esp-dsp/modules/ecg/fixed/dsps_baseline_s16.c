@@ -0,0 +1,155 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <math.h>
+#include "dsps_baseline.h"
+
+#define BASELINE_COEF_SHIFT     15
+
+int32_t dsps_baseline_delay_s16(int decim, int fir_len)
+{
+    return (fir_len / 2 + 2) * decim;
+}
+
+// Windowed sinc low-pass, Blackman window, fc relative to the low rate.
+// The central tap absorbs the rounding error, so the DC gain is exact.
+static void baseline_design(int16_t *coeffs, int fir_len, double fc)
+{
+    const int mid = fir_len / 2;
+    double h[DSPS_BASELINE_MAX_FIR_LEN / 2 + 1];
+    double gain = 0;
+    for (int k = 0; k <= mid; k++) {
+        double w = 0.42 + 0.5 * cos(M_PI * k / (mid + 1)) + 0.08 * cos(2 * M_PI * k / (mid + 1));
+        h[k] = ((k == 0) ? 2 * fc : sin(2 * M_PI * fc * k) / (M_PI * k)) * w;
+        gain += (k == 0) ? h[k] : 2 * h[k];
+    }
+    long sum = 0;
+    for (int k = 1; k <= mid; k++) {
+        long q = lround(h[k] / gain * (1 << BASELINE_COEF_SHIFT));
+        coeffs[mid + k] = (int16_t)q;
+        coeffs[mid - k] = (int16_t)q;
+        sum += 2 * q;
+    }
+    coeffs[mid] = (int16_t)((1 << BASELINE_COEF_SHIFT) - sum);
+}
+
+esp_err_t dsps_baseline_init_s16(baseline_s16_t *bl, int16_t *coeffs, int32_t *fir_delay, int16_t *x_delay, int decim, int fir_len, float fc)
+{
+    if ((coeffs == NULL) || (fir_delay == NULL) || (x_delay == NULL)) {
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    if ((fir_len < 3) || (fir_len > DSPS_BASELINE_MAX_FIR_LEN) || ((fir_len & 1) == 0)) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    if ((decim < 2) || (decim > DSPS_BASELINE_MAX_DECIM) || (fc <= 0) || (fc * decim > 0.25f)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    bl->coeffs = coeffs;
+    bl->fir_delay = fir_delay;
+    bl->x_delay = x_delay;
+    bl->decim = decim;
+    bl->fir_len = fir_len;
+    bl->delay = dsps_baseline_delay_s16(decim, fir_len);
+    bl->phase = 0;
+    bl->fir_pos = 0;
+    bl->x_pos = 0;
+    bl->primed = 0;
+    baseline_design(coeffs, fir_len, (double)fc * decim);
+    return ESP_OK;
+}
+
+// Starts every delay line from the steady state of a constant input x0
+static void baseline_prime(baseline_s16_t *bl, int16_t x0)
+{
+    const int32_t R = bl->decim;
+    const int32_t level = (int32_t)x0 << DSPS_BASELINE_FRAC;
+    for (int k = 0; k < bl->fir_len; k++) {
+        bl->fir_delay[k] = level;
+    }
+    for (int k = 0; k < bl->delay; k++) {
+        bl->x_delay[k] = x0;
+    }
+    bl->sum = 0;
+    bl->sum2 = 0;
+    bl->sum_prev = R * x0;
+    bl->sum2_prev = R * (R + 1) / 2 * x0;
+    bl->level = level;
+    bl->target = level;
+    bl->step = 0;
+    bl->primed = 1;
+}
+
+// Decimated sample of the block that just ended, low rate FIR, and the next interpolation segment
+static void baseline_block(baseline_s16_t *bl)
+{
+    const int32_t R = bl->decim;
+    const int64_t R2 = R * R;
+
+    // Triangular window: weights R..1 on the current block (sum2), 0..R-1 on the previous one
+    int64_t c = (int64_t)bl->sum2 + (int64_t)R * bl->sum_prev - bl->sum2_prev;
+    c <<= DSPS_BASELINE_FRAC;
+    c = (c >= 0) ? (c + R2 / 2) / R2 : (c - R2 / 2) / R2;
+    bl->sum_prev = bl->sum;
+    bl->sum2_prev = bl->sum2;
+    bl->sum = 0;
+    bl->sum2 = 0;
+
+    bl->fir_delay[bl->fir_pos] = (int32_t)c;
+    if (++bl->fir_pos >= bl->fir_len) {
+        bl->fir_pos = 0;
+    }
+    int64_t acc = 1 << (BASELINE_COEF_SHIFT - 1);
+    int k = 0;
+    for (int n = bl->fir_pos; n < bl->fir_len; n++) {
+        acc += (int64_t)bl->coeffs[k++] * bl->fir_delay[n];
+    }
+    for (int n = 0; n < bl->fir_pos; n++) {
+        acc += (int64_t)bl->coeffs[k++] * bl->fir_delay[n];
+    }
+
+    bl->level = bl->target;
+    bl->target = (int32_t)(acc >> BASELINE_COEF_SHIFT);
+    bl->step = (bl->target - bl->level) / R;
+}
+
+esp_err_t dsps_baseline_s16(baseline_s16_t *bl, const int16_t *input, int16_t *output, int16_t *baseline, int len)
+{
+    if ((len > 0) && !bl->primed) {
+        baseline_prime(bl, input[0]);
+    }
+    const int32_t round = 1 << (DSPS_BASELINE_FRAC - 1);
+    for (int i = 0; i < len; i++) {
+        const int16_t x = input[i];
+
+        // Input delayed to the time of the interpolated baseline
+        const int32_t xd = bl->x_delay[bl->x_pos];
+        bl->x_delay[bl->x_pos] = x;
+        if (++bl->x_pos >= bl->delay) {
+            bl->x_pos = 0;
+        }
+        const int32_t b = (bl->level + round) >> DSPS_BASELINE_FRAC;
+        bl->level += bl->step;
+        int32_t y = xd - b;
+        if (y > INT16_MAX) {
+            y = INT16_MAX;
+        } else if (y < INT16_MIN) {
+            y = INT16_MIN;
+        }
+        output[i] = (int16_t)y;
+        if (baseline != NULL) {
+            baseline[i] = (int16_t)b;
+        }
+
+        // Decimation
+        bl->sum += x;
+        bl->sum2 += bl->sum;
+        if (++bl->phase >= bl->decim) {
+            bl->phase = 0;
+            baseline_block(bl);
+        }
+    }
+    return ESP_OK;
+}
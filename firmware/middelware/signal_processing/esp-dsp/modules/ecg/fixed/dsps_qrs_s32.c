@@ -0,0 +1,246 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include "dsps_qrs.h"
+
+#define QRS_LP_MASK     (DSPS_QRS_LP_RING - 1)
+#define QRS_MASK        (DSPS_QRS_RING - 1)
+#define QRS_D_MAX       32767
+
+static int32_t qrs_log2(int32_t x)
+{
+    int32_t r = 0;
+    while (x > 1) {
+        x >>= 1;
+        r++;
+    }
+    return r;
+}
+
+esp_err_t dsps_qrs_init_s32(qrs_s32_t *qrs, int fs)
+{
+    if ((fs < DSPS_QRS_MIN_FS) || (fs > DSPS_QRS_MAX_FS)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    memset(qrs, 0, sizeof(qrs_s32_t));
+    qrs->fs = fs;
+    // Lengths of the 200 Hz design (6, 32 and 30 samples) scaled to fs
+    qrs->lp_m = (6 * fs + 100) / 200;
+    qrs->lp_shift = qrs_log2(qrs->lp_m * qrs->lp_m);
+    qrs->hp_len = (32 * fs + 100) / 200;
+    qrs->mwi_len = (15 * fs + 50) / 100;
+    qrs->delay = qrs->lp_m - 1 + qrs->hp_len / 2;
+    qrs->refractory = fs / 5;
+    qrs->t_wave = (36 * fs) / 100;
+    qrs->learn_len = 2 * fs;
+    qrs->rr_avg1 = fs;
+    qrs->rr_avg2 = fs;
+    return ESP_OK;
+}
+
+static void qrs_rr_update(qrs_s32_t *qrs, int32_t rr)
+{
+    qrs->rr1[qrs->rr_pos1] = rr;
+    qrs->rr_pos1 = (qrs->rr_pos1 + 1) % DSPS_QRS_RR_AVG;
+    int32_t n1 = (qrs->n_beats - 1 < DSPS_QRS_RR_AVG) ? qrs->n_beats - 1 : DSPS_QRS_RR_AVG;
+    int32_t sum = 0;
+    for (int i = 0; i < n1; i++) {
+        sum += qrs->rr1[i];
+    }
+    qrs->rr_avg1 = sum / n1;
+
+    // Regular intervals, between 92% and 116% of the regular average. The first one is always accepted.
+    if ((qrs->rr_count2 == 0) || ((rr * 100 >= qrs->rr_avg2 * 92) && (rr * 100 <= qrs->rr_avg2 * 116))) {
+        qrs->rr2[qrs->rr_pos2] = rr;
+        qrs->rr_pos2 = (qrs->rr_pos2 + 1) % DSPS_QRS_RR_AVG;
+        if (qrs->rr_count2 < DSPS_QRS_RR_AVG) {
+            qrs->rr_count2++;
+        }
+        sum = 0;
+        for (int i = 0; i < qrs->rr_count2; i++) {
+            sum += qrs->rr2[i];
+        }
+        qrs->rr_avg2 = sum / qrs->rr_count2;
+    } else if (qrs->rr_count2 < DSPS_QRS_RR_AVG) {
+        // The rhythm changed before the regular average settled: follow the plain average
+        qrs->rr_avg2 = qrs->rr_avg1;
+    }
+}
+
+static void qrs_beat(qrs_s32_t *qrs, uint32_t r, int32_t slope, int32_t searchback, qrs_beat_t *beats, int *n_out, int max_beats)
+{
+    int32_t rr = 0;
+    if (qrs->n_beats > 0) {
+        rr = (int32_t)(r - qrs->last_r);
+    }
+    if (qrs->n_beats <= DSPS_QRS_RR_AVG) {
+        qrs->n_beats++;
+    }
+    if (rr > 0) {
+        qrs_rr_update(qrs, rr);
+    }
+    qrs->last_r = r;
+    qrs->last_slope = slope;
+    qrs->sb_pk = 0;
+
+    if (*n_out < max_beats) {
+        qrs_beat_t *beat = &beats[(*n_out)++];
+        beat->index = r;
+        beat->rr = rr;
+        beat->hr = (rr > 0) ? (600 * qrs->fs + rr / 2) / rr : 0;
+        beat->searchback = searchback;
+    }
+}
+
+// Locates the R peak and the largest slope of the QRS that produced the integrator peak at pk_n
+static uint32_t qrs_locate(qrs_s32_t *qrs, uint32_t pk_n, int32_t *slope)
+{
+    // The squared derivative at n is centered on the band-passed sample n - 2
+    uint32_t first = pk_n - qrs->mwi_len - 1;
+    uint32_t last = pk_n - 2;
+    if ((int32_t)(qrs->n - first) >= DSPS_QRS_RING - 4) {
+        first = qrs->n - DSPS_QRS_RING + 5;
+    }
+    int32_t best = -1;
+    uint32_t best_n = last;
+    int32_t max_slope = 0;
+    for (uint32_t i = first; i != last + 1; i++) {
+        int32_t v = qrs->bp[i & QRS_MASK];
+        v = (v < 0) ? -v : v;
+        if (v > best) {
+            best = v;
+            best_n = i;
+        }
+        int32_t d = 2 * qrs->bp[(i + 2) & QRS_MASK] + qrs->bp[(i + 1) & QRS_MASK] - qrs->bp[(i - 1) & QRS_MASK] - 2 * qrs->bp[(i - 2) & QRS_MASK];
+        d = (d < 0) ? -d : d;
+        max_slope = (d > max_slope) ? d : max_slope;
+    }
+    *slope = max_slope;
+    return best_n - qrs->delay;
+}
+
+// Classifies the integrator peak pk found at pk_n. Returns the number of beats written.
+static int qrs_peak(qrs_s32_t *qrs, uint32_t pk, uint32_t pk_n, qrs_beat_t *beats, int max_beats)
+{
+    int n_out = 0;
+    int32_t slope;
+    uint32_t r = qrs_locate(qrs, pk_n, &slope);
+
+    if ((int32_t)pk_n < qrs->learn_len) {
+        return 0;
+    }
+
+    // Search back: no beat for 166% of the regular RR interval
+    if ((qrs->n_beats > 0) && (qrs->sb_pk > 0) && ((int32_t)(r - qrs->last_r) * 100 > qrs->rr_avg2 * 166)) {
+        uint32_t sb_pk = qrs->sb_pk;
+        qrs_beat(qrs, qrs->sb_r, qrs->sb_slope, 1, beats, &n_out, max_beats);
+        qrs->spki = (sb_pk >> 2) + qrs->spki - (qrs->spki >> 2);
+    }
+
+    const uint32_t thr1 = qrs->npki + ((qrs->spki - qrs->npki) >> 2);
+    const uint32_t thr2 = thr1 >> 1;
+    const int32_t since = (qrs->n_beats > 0) ? (int32_t)(r - qrs->last_r) : INT32_MAX;
+    if (since < qrs->refractory) {
+        return n_out;
+    }
+
+    int qrs_found = pk > thr1;
+    if (qrs_found && (since < qrs->t_wave) && (2 * slope < qrs->last_slope)) {
+        qrs_found = 0;  // T wave
+    }
+    if (qrs_found) {
+        qrs->spki = (pk >> 3) + qrs->spki - (qrs->spki >> 3);
+        qrs_beat(qrs, r, slope, 0, beats, &n_out, max_beats);
+    } else {
+        qrs->npki = (pk >> 3) + qrs->npki - (qrs->npki >> 3);
+        if ((pk > thr2) && (pk > qrs->sb_pk) && (since >= qrs->t_wave)) {
+            qrs->sb_pk = pk;
+            qrs->sb_r = r;
+            qrs->sb_slope = slope;
+        }
+    }
+    return n_out;
+}
+
+int dsps_qrs_s32(qrs_s32_t *qrs, const int32_t *input, int len, qrs_beat_t *beats, int max_beats)
+{
+    const int32_t m = qrs->lp_m;
+    const int32_t L = qrs->hp_len;
+    const int32_t W = qrs->mwi_len;
+    const int32_t mwi_shift = qrs_log2(W);
+    int n_out = 0;
+
+    for (int i = 0; i < len; i++) {
+        const int32_t x = input[i];
+        uint32_t n = qrs->n;
+
+        if (n == 0) {
+            // Start from the steady state of the first sample, so the step does not look like a QRS
+            for (int k = 0; k < DSPS_QRS_LP_RING; k++) {
+                qrs->lp_x[k] = x;
+            }
+            qrs->lp_y1 = x * m * m;
+            qrs->lp_y2 = qrs->lp_y1;
+            const int32_t lp0 = qrs->lp_y1 >> qrs->lp_shift;
+            for (int k = 0; k < DSPS_QRS_RING; k++) {
+                qrs->hp_x[k] = lp0;
+            }
+            qrs->hp_sum = lp0 * L;
+        }
+
+        // Low-pass
+        qrs->lp_x[n & QRS_LP_MASK] = x;
+        int32_t y = 2 * qrs->lp_y1 - qrs->lp_y2 + x - 2 * qrs->lp_x[(n - m) & QRS_LP_MASK] + qrs->lp_x[(n - 2 * m) & QRS_LP_MASK];
+        qrs->lp_y2 = qrs->lp_y1;
+        qrs->lp_y1 = y;
+        const int32_t lp = y >> qrs->lp_shift;
+
+        // High-pass: delayed sample minus the moving average
+        qrs->hp_sum += lp - qrs->hp_x[(n - L) & QRS_MASK];
+        qrs->hp_x[n & QRS_MASK] = lp;
+        const int32_t bp = qrs->hp_x[(n - L / 2) & QRS_MASK] - qrs->hp_sum / L;
+        qrs->bp[n & QRS_MASK] = bp;
+
+        // Derivative, squaring and moving window integration
+        int32_t d = (2 * bp + qrs->bp[(n - 1) & QRS_MASK] - qrs->bp[(n - 3) & QRS_MASK] - 2 * qrs->bp[(n - 4) & QRS_MASK]) >> 1;
+        d = (d > QRS_D_MAX) ? QRS_D_MAX : (d < -QRS_D_MAX) ? -QRS_D_MAX : d;
+        const uint32_t sq = (uint32_t)(d * d);
+        qrs->mwi_sum += sq - (int64_t)qrs->sq[(n - W) & QRS_MASK];
+        qrs->sq[n & QRS_MASK] = sq;
+        const uint32_t mwi = (uint32_t)(qrs->mwi_sum >> mwi_shift);
+        qrs->n = n + 1;
+
+        // Training of the signal and noise levels, once the filters are filled
+        if ((int32_t)n < qrs->learn_len) {
+            if ((int32_t)n >= L + W) {
+                qrs->learn_max = (mwi > qrs->learn_max) ? mwi : qrs->learn_max;
+                qrs->learn_sum += mwi;
+            }
+            if ((int32_t)n == qrs->learn_len - 1) {
+                qrs->spki = qrs->learn_max / 3;
+                qrs->npki = (uint32_t)(qrs->learn_sum / (qrs->learn_len - L - W) / 2);
+            }
+        }
+
+        // Peak of the integrator: confirmed when it falls to half, or after one window
+        if (!qrs->tracking) {
+            if (mwi > qrs->mwi_prev) {
+                qrs->tracking = 1;
+                qrs->pk = mwi;
+                qrs->pk_n = n;
+            }
+        } else if (mwi > qrs->pk) {
+            qrs->pk = mwi;
+            qrs->pk_n = n;
+        } else if ((mwi <= (qrs->pk >> 1)) || ((int32_t)(n - qrs->pk_n) >= W)) {
+            qrs->tracking = 0;
+            n_out += qrs_peak(qrs, qrs->pk, qrs->pk_n, &beats[n_out], max_beats - n_out);
+        }
+        qrs->mwi_prev = mwi;
+    }
+    return n_out;
+}
@@ -0,0 +1,177 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <math.h>
+#include "dsps_hrv.h"
+
+esp_err_t dsps_hrv_init_f32(hrv_f32_t *hrv, int32_t *rr_buf, float *work, int capacity, int32_t window_ms)
+{
+    if (rr_buf == NULL) {
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    if ((capacity < 2) || (window_ms <= 0)) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    memset(hrv, 0, sizeof(hrv_f32_t));
+    hrv->rr = rr_buf;
+    hrv->work = work;
+    hrv->capacity = capacity;
+    hrv->window_ms = window_ms;
+    return ESP_OK;
+}
+
+static inline int32_t hrv_at(const hrv_f32_t *hrv, int i)
+{
+    int pos = hrv->head + i;
+    if (pos >= hrv->capacity) {
+        pos -= hrv->capacity;
+    }
+    return hrv->rr[pos];
+}
+
+static void hrv_pop(hrv_f32_t *hrv)
+{
+    const int32_t rr = hrv->rr[hrv->head];
+    hrv->sum -= rr;
+    hrv->sum2 -= (int64_t)rr * rr;
+    if (hrv->count > 1) {
+        const int32_t d = hrv_at(hrv, 1) - rr;
+        hrv->sum_d2 -= (int64_t)d * d;
+        if ((d > DSPS_HRV_NN50_MS) || (d < -DSPS_HRV_NN50_MS)) {
+            hrv->nn50--;
+        }
+    }
+    hrv->head = (hrv->head + 1 < hrv->capacity) ? hrv->head + 1 : 0;
+    hrv->count--;
+}
+
+esp_err_t dsps_hrv_push_f32(hrv_f32_t *hrv, int32_t rr_ms)
+{
+    if (rr_ms <= 0) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if (hrv->count == hrv->capacity) {
+        hrv_pop(hrv);
+    }
+    if (hrv->count > 0) {
+        const int32_t d = rr_ms - hrv_at(hrv, hrv->count - 1);
+        hrv->sum_d2 += (int64_t)d * d;
+        if ((d > DSPS_HRV_NN50_MS) || (d < -DSPS_HRV_NN50_MS)) {
+            hrv->nn50++;
+        }
+    }
+    int pos = hrv->head + hrv->count;
+    if (pos >= hrv->capacity) {
+        pos -= hrv->capacity;
+    }
+    hrv->rr[pos] = rr_ms;
+    hrv->count++;
+    hrv->sum += rr_ms;
+    hrv->sum2 += (int64_t)rr_ms * rr_ms;
+
+    // The newest interval always stays, even if it is longer than the window
+    while ((hrv->sum > hrv->window_ms) && (hrv->count > 1)) {
+        hrv_pop(hrv);
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_hrv_time_f32(hrv_f32_t *hrv, hrv_time_t *out)
+{
+    const int n = hrv->count;
+    if (n < 2) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    // n*sum2 - sum^2 is exact in 64 bits for 5 minute windows of millisecond intervals
+    const int64_t var_n2 = (int64_t)n * hrv->sum2 - hrv->sum * hrv->sum;
+    out->n = n;
+    out->mean_rr = (float)hrv->sum / n;
+    out->sdnn = sqrtf((float)var_n2 / ((float)n * (n - 1)));
+    out->rmssd = sqrtf((float)hrv->sum_d2 / (n - 1));
+    out->pnn50 = (float)hrv->nn50 / (n - 1);
+    return ESP_OK;
+}
+
+esp_err_t dsps_hrv_freq_f32(hrv_f32_t *hrv, float df, float *lf, float *hf)
+{
+    const int n = hrv->count;
+    if ((hrv->work == NULL) || (df <= 0)) {
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    if (n < 4) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    // cos and sin of 2*pi*f*t for every beat time t, and of the rotation by df that moves them to the next f
+    float *c = hrv->work;
+    float *s = c + n;
+    float *rc = s + n;
+    float *rs = rc + n;
+
+    const float mean = (float)hrv->sum / n;
+    const float f0 = DSPS_HRV_LF_LOW;
+    const int n_freq = (int)((DSPS_HRV_HF_HIGH - DSPS_HRV_LF_LOW) / df + 0.5f);
+    float t = 0;
+    for (int i = 0; i < n; i++) {
+        t += hrv_at(hrv, i) * 0.001f;
+        c[i] = cosf(2 * (float)M_PI * f0 * t);
+        s[i] = sinf(2 * (float)M_PI * f0 * t);
+        rc[i] = cosf(2 * (float)M_PI * df * t);
+        rs[i] = sinf(2 * (float)M_PI * df * t);
+    }
+
+    // One-sided PSD S(f) = 2*P(f)/fm, with fm = n/T the mean beat rate, integrated with the step df
+    const float scale = 2.0f * t / n * df;
+    float p_lf = 0;
+    float p_hf = 0;
+    for (int k = 0; k < n_freq; k++) {
+        const float f = f0 + k * df;
+        float xc = 0;
+        float xs = 0;
+        float c2 = 0;
+        float s2 = 0;
+        for (int i = 0; i < n; i++) {
+            const float x = hrv_at(hrv, i) - mean;
+            xc += x * c[i];
+            xs += x * s[i];
+            c2 += c[i] * c[i] - s[i] * s[i];
+            s2 += 2 * c[i] * s[i];
+        }
+        // tau of Lomb: tan(2*w*tau) = s2/c2, the sums over cos^2 and sin^2 at t - tau are (n +- r2)/2
+        const float r2 = sqrtf(c2 * c2 + s2 * s2);
+        float ct = 1;
+        float st = 0;
+        if (r2 > 0) {
+            const float cos2 = c2 / r2;
+            ct = sqrtf(0.5f * (1 + cos2));
+            st = sqrtf(0.5f * (1 - cos2));
+            st = (s2 < 0) ? -st : st;
+        }
+        const float cc = xc * ct + xs * st;
+        const float ss = xs * ct - xc * st;
+        // P = (cc^2/sum_cos2 + ss^2/sum_sin2)/2, with the sums equal to (n +- r2)/2
+        float p = cc * cc / (n + r2);
+        if (n - r2 > 1e-6f * n) {
+            p += ss * ss / (n - r2);
+        }
+        if (f < DSPS_HRV_LF_HIGH) {
+            p_lf += p;
+        } else {
+            p_hf += p;
+        }
+
+        if (k + 1 < n_freq) {
+            for (int i = 0; i < n; i++) {
+                const float ci = c[i];
+                c[i] = ci * rc[i] - s[i] * rs[i];
+                s[i] = s[i] * rc[i] + ci * rs[i];
+            }
+        }
+    }
+    *lf = p_lf * scale;
+    *hf = p_hf * scale;
+    return ESP_OK;
+}
@@ -0,0 +1,114 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _dsps_baseline_H_
+#define _dsps_baseline_H_
+
+#include "dsp_err.h"
+#include "dsp_common.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define DSPS_BASELINE_MAX_DECIM     128     /*!< Maximum decimation factor*/
+#define DSPS_BASELINE_MAX_FIR_LEN   63      /*!< Maximum length of the low rate FIR filter*/
+#define DSPS_BASELINE_FRAC          12      /*!< Fractional bits of the internal baseline*/
+
+/**
+ * @brief Data struct of s16 baseline wander remover
+ *
+ * The baseline is estimated at a low rate and subtracted at full rate:
+ * - decimation by R with a triangular (2nd order CIC) window of 2R-1 samples, computed from a running
+ *   sum and a running sum of sums, so it costs two additions per input sample
+ * - linear phase low-pass FIR of fir_len taps at the low rate, Q15 coefficients
+ * - linear interpolation back to the full rate, one addition per input sample
+ * The three stages are linear phase, so the baseline is aligned with the input delayed by
+ * (fir_len/2 + 2)*R samples, the same delay for every frequency. A ramp is removed exactly.
+ * All fields of this structure are initialized by the dsps_baseline_init_s16(...) function.
+ */
+typedef struct baseline_s16_s {
+    int16_t    *coeffs;         /*!< Q15 low-pass coefficients of the low rate FIR.*/
+    int32_t    *fir_delay;      /*!< Delay line of the low rate FIR, decimated signal.*/
+    int16_t    *x_delay;        /*!< Delay line of the input, aligns it with the baseline.*/
+    int32_t     sum;            /*!< Sum of the input samples of the current block.*/
+    int32_t     sum2;           /*!< Sum of the running sums of the current block.*/
+    int32_t     sum_prev;       /*!< sum of the previous block.*/
+    int32_t     sum2_prev;      /*!< sum2 of the previous block.*/
+    int32_t     level;          /*!< Interpolated baseline, DSPS_BASELINE_FRAC fractional bits.*/
+    int32_t     step;           /*!< Increment of the interpolated baseline per input sample.*/
+    int32_t     target;         /*!< Baseline at the end of the current interpolation segment.*/
+    int32_t     delay;          /*!< Delay of the output, samples.*/
+    int32_t     x_pos;          /*!< Position in the input delay line.*/
+    int16_t     decim;          /*!< Decimation factor R.*/
+    int16_t     fir_len;        /*!< Length of the low rate FIR.*/
+    int16_t     phase;          /*!< Position in the current decimation block.*/
+    int16_t     fir_pos;        /*!< Position in the FIR delay line.*/
+    int16_t     primed;         /*!< 1 after the first sample initialized the delay lines.*/
+} baseline_s16_t;
+
+/**
+ * @brief   delay of the baseline wander remover
+ *
+ * The output of dsps_baseline_s16 is the input delayed by this number of samples, minus the baseline.
+ * It is also the length of the x_delay buffer required by dsps_baseline_init_s16.
+ *
+ * @param decim: decimation factor
+ * @param fir_len: length of the low rate FIR
+ *
+ * @return: delay in input samples
+ */
+int32_t dsps_baseline_delay_s16(int decim, int fir_len);
+
+/**
+ * @brief   init baseline wander remover
+ *
+ * Function designs the low rate FIR (windowed sinc, Blackman window, DC gain exactly 1) in floating point.
+ * The processing function is integer only. For ECG at 500 Hz, decim = 100, fir_len = 31 and
+ * fc = 0.5/500 give a 0.5 Hz high-pass with a delay of 3.4 s and about 10 operations per sample.
+ * The low rate fs/decim should be at least 4 times fc, and the decimation window removes most
+ * of the signal above fs/decim before it aliases.
+ *
+ * @param bl: pointer to baseline remover structure, that must be preallocated
+ * @param coeffs: array for the FIR coefficients. Must be length fir_len
+ * @param fir_delay: array for the FIR delay line. Must be length fir_len
+ * @param x_delay: array for the input delay line. Must be length dsps_baseline_delay_s16(decim, fir_len)
+ * @param decim: decimation factor [2..DSPS_BASELINE_MAX_DECIM]
+ * @param fir_len: odd FIR length [3..DSPS_BASELINE_MAX_FIR_LEN]
+ * @param fc: cut-off frequency of the baseline relative to the input sample rate, (0..0.25/decim]
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_PARAM if a buffer is NULL
+ *      - ESP_ERR_DSP_INVALID_LENGTH if fir_len is not valid
+ *      - ESP_ERR_DSP_PARAM_OUTOFRANGE if decim or fc are out of range
+ */
+esp_err_t dsps_baseline_init_s16(baseline_s16_t *bl, int16_t *coeffs, int32_t *fir_delay, int16_t *x_delay, int decim, int fir_len, float fc);
+
+/**
+ * @brief   16 bit baseline wander remover
+ *
+ * Function writes the input delayed by bl->delay samples minus its baseline. The delay lines start
+ * from the first input sample, so a DC offset does not produce a transient.
+ * The input could be split into blocks of any length. In place processing is allowed.
+ *
+ * @param bl: pointer to baseline remover structure, that must be initialized before
+ * @param[in] input: input array
+ * @param[out] output: delayed input minus the baseline, saturated to 16 bits
+ * @param[out] baseline: delayed baseline. Could be NULL
+ * @param len: length of the arrays
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dsps_baseline_s16(baseline_s16_t *bl, const int16_t *input, int16_t *output, int16_t *baseline, int len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _dsps_baseline_H_
@@ -0,0 +1,126 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _dsps_hrv_H_
+#define _dsps_hrv_H_
+
+#include "dsp_err.h"
+#include "dsp_common.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define DSPS_HRV_NN50_MS    50          /*!< Threshold of the NN50 count, ms*/
+#define DSPS_HRV_LF_LOW     0.04f       /*!< Lower edge of the LF band, Hz*/
+#define DSPS_HRV_LF_HIGH    0.15f       /*!< Upper edge of the LF band, Hz*/
+#define DSPS_HRV_HF_HIGH    0.4f        /*!< Upper edge of the HF band, Hz*/
+
+/**
+ * @brief Time domain heart rate variability metrics
+ */
+typedef struct hrv_time_s {
+    float   mean_rr;    /*!< Mean RR interval, ms.*/
+    float   sdnn;       /*!< Standard deviation of the RR intervals, ms.*/
+    float   rmssd;      /*!< Root mean square of the successive differences, ms.*/
+    float   pnn50;      /*!< Fraction of successive differences larger than 50 ms, 0..1.*/
+    int     n;          /*!< Number of RR intervals in the window.*/
+} hrv_time_t;
+
+/**
+ * @brief Data struct of the heart rate variability window
+ *
+ * Keeps the RR intervals of the last window_ms milliseconds in a ring buffer. The sums of the
+ * intervals, of their squares and of the squared successive differences are kept as exact integers
+ * and updated when an interval enters and when it leaves the window, so the time domain metrics cost
+ * O(1) per beat and do not drift. The frequency domain metrics are computed on request.
+ * All fields of this structure are initialized by the dsps_hrv_init_f32(...) function.
+ */
+typedef struct hrv_f32_s {
+    int32_t    *rr;         /*!< Ring buffer of RR intervals, ms.*/
+    float      *work;       /*!< Working memory of the Lomb-Scargle periodogram, 4*capacity.*/
+    int64_t     sum;        /*!< Sum of the intervals.*/
+    int64_t     sum2;       /*!< Sum of the squared intervals.*/
+    int64_t     sum_d2;     /*!< Sum of the squared successive differences.*/
+    int32_t     nn50;       /*!< Number of successive differences larger than DSPS_HRV_NN50_MS.*/
+    int32_t     window_ms;  /*!< Length of the window, ms.*/
+    int         capacity;   /*!< Length of the ring buffer.*/
+    int         head;       /*!< Position of the oldest interval.*/
+    int         count;      /*!< Number of intervals in the window.*/
+} hrv_f32_t;
+
+/**
+ * @brief   init heart rate variability window
+ *
+ * @param hrv: pointer to HRV structure, that must be preallocated
+ * @param rr_buf: ring buffer of intervals. Must hold the number of beats of one window at the highest
+ *                heart rate, for example 1000 for 5 minutes at 200 bpm
+ * @param work: working memory of dsps_hrv_freq_f32, 4*capacity elements. Can be NULL if it is not used
+ * @param capacity: length of rr_buf. When it is full the oldest interval leaves the window
+ * @param window_ms: length of the window, ms
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_PARAM if rr_buf is NULL
+ *      - ESP_ERR_DSP_INVALID_LENGTH if capacity is less than 2 or window_ms is not positive
+ */
+esp_err_t dsps_hrv_init_f32(hrv_f32_t *hrv, int32_t *rr_buf, float *work, int capacity, int32_t window_ms);
+
+/**
+ * @brief   add an RR interval to the window
+ *
+ * Intervals older than window_ms leave the window. O(1) per call, amortized.
+ * Ectopic beats and artifacts should be removed by the caller.
+ *
+ * @param hrv: pointer to HRV structure, that must be initialized before
+ * @param rr_ms: RR interval, ms
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_PARAM_OUTOFRANGE if rr_ms is not positive
+ */
+esp_err_t dsps_hrv_push_f32(hrv_f32_t *hrv, int32_t rr_ms);
+
+/**
+ * @brief   time domain metrics of the window
+ *
+ * O(1), computed from the running sums.
+ *
+ * @param hrv: pointer to HRV structure
+ * @param[out] out: metrics
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_LENGTH if the window holds less than 2 intervals
+ */
+esp_err_t dsps_hrv_time_f32(hrv_f32_t *hrv, hrv_time_t *out);
+
+/**
+ * @brief   frequency domain metrics of the window
+ *
+ * Lomb-Scargle periodogram of the unevenly sampled RR series, integrated over the LF (0.04-0.15 Hz) and
+ * HF (0.15-0.4 Hz) bands. The trigonometric functions are only evaluated for the first frequency,
+ * the others are reached with a rotation, so the cost is O(N*K) multiplications for N intervals and
+ * K = 0.36/df frequencies.
+ *
+ * @param hrv: pointer to HRV structure, initialized with a work array
+ * @param df: frequency step, Hz. About 1/(4*window) gives an accurate integration
+ * @param[out] lf: power of the LF band, ms^2
+ * @param[out] hf: power of the HF band, ms^2
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_PARAM if the structure has no work array or df is not positive
+ *      - ESP_ERR_DSP_INVALID_LENGTH if the window holds less than 4 intervals
+ */
+esp_err_t dsps_hrv_freq_f32(hrv_f32_t *hrv, float df, float *lf, float *hf);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _dsps_hrv_H_
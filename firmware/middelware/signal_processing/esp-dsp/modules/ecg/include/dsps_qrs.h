@@ -0,0 +1,129 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _dsps_qrs_H_
+#define _dsps_qrs_H_
+
+#include "dsp_err.h"
+#include "dsp_common.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define DSPS_QRS_MIN_FS     100     /*!< Minimum sample rate, Hz*/
+#define DSPS_QRS_MAX_FS     1000    /*!< Maximum sample rate, Hz*/
+#define DSPS_QRS_LP_RING    64      /*!< Length of the low-pass delay line, power of 2*/
+#define DSPS_QRS_RING       512     /*!< Length of the other delay lines, power of 2*/
+#define DSPS_QRS_RR_AVG     8       /*!< Number of RR intervals in the averages*/
+
+/**
+ * @brief R peak reported by the QRS detector
+ */
+typedef struct qrs_beat_s {
+    uint32_t    index;      /*!< Input sample index of the R peak, counted from the init.*/
+    int32_t     rr;         /*!< RR interval in samples, 0 for the first beat.*/
+    int32_t     hr;         /*!< Instantaneous heart rate in tenths of bpm, 0 for the first beat.*/
+    int32_t     searchback; /*!< 1 if the beat was found by the search back.*/
+} qrs_beat_t;
+
+/**
+ * @brief Data struct of the Pan-Tompkins QRS detector
+ *
+ * Integer implementation of the Pan-Tompkins detector for any sample rate between DSPS_QRS_MIN_FS and
+ * DSPS_QRS_MAX_FS. The lengths of the original 200 Hz filters are scaled with the sample rate:
+ * - low-pass  y[n] = 2y[n-1] - y[n-2] + x[n] - 2x[n-m] + x[n-2m], first zero at 33 Hz
+ * - high-pass y[n] = x[n-L/2] - mean(x[n-L+1..n]), corner near 5 Hz
+ * - derivative (2x[n] + x[n-1] - x[n-3] - 2x[n-4])/8, squaring and a 150 ms moving window integrator
+ *
+ * Peaks of the integrated signal are classified with the adaptive signal and noise levels SPKI and NPKI
+ * and the dual thresholds NPKI + (SPKI - NPKI)/4 and half of it. A candidate within 360 ms of the last beat
+ * whose slope is less than half of the slope of that beat is a T wave. When no beat is found for 166% of
+ * the average regular RR interval, the largest peak above the second threshold is taken (search back).
+ * The R peak is located as the maximum of the band-passed signal under the integrator window.
+ *
+ * The first 2 s train the signal and noise levels and produce no beats. Regular beats are reported when
+ * the integrator falls to half of its peak, at most delay + 2*mwi_len samples after the R peak (about
+ * 0.4 s); beats found by the search back are reported when the next peak is processed.
+ * All fields of this structure are initialized by the dsps_qrs_init_s32(...) function.
+ */
+typedef struct qrs_s32_s {
+    int32_t     lp_x[DSPS_QRS_LP_RING]; /*!< Low-pass input delay line.*/
+    int32_t     hp_x[DSPS_QRS_RING];    /*!< High-pass input delay line.*/
+    int32_t     bp[DSPS_QRS_RING];      /*!< Band-passed signal.*/
+    uint32_t    sq[DSPS_QRS_RING];      /*!< Squared derivative.*/
+    int32_t     rr1[DSPS_QRS_RR_AVG];   /*!< Last RR intervals.*/
+    int32_t     rr2[DSPS_QRS_RR_AVG];   /*!< Last regular RR intervals.*/
+    int64_t     mwi_sum;                /*!< Sum of the integrator window.*/
+    int32_t     lp_y1;                  /*!< Low-pass output, n-1.*/
+    int32_t     lp_y2;                  /*!< Low-pass output, n-2.*/
+    int32_t     hp_sum;                 /*!< Sum of the high-pass window.*/
+    uint32_t    n;                      /*!< Number of processed samples.*/
+    int32_t     fs;                     /*!< Sample rate, Hz.*/
+    int32_t     lp_m;                   /*!< Low-pass comb length m.*/
+    int32_t     lp_shift;               /*!< Shift that removes most of the m^2 low-pass gain.*/
+    int32_t     hp_len;                 /*!< High-pass window length L.*/
+    int32_t     mwi_len;                /*!< Integrator window length.*/
+    int32_t     delay;                  /*!< Delay of the band-pass filter, samples.*/
+    int32_t     refractory;             /*!< 200 ms.*/
+    int32_t     t_wave;                 /*!< 360 ms.*/
+    int32_t     learn_len;              /*!< 2 s.*/
+    uint32_t    mwi_prev;               /*!< Last integrator output.*/
+    uint32_t    pk;                     /*!< Height of the current integrator peak.*/
+    uint32_t    pk_n;                   /*!< Sample index of the current integrator peak.*/
+    int32_t     tracking;               /*!< 1 while the integrator rises or falls from a peak.*/
+    uint32_t    spki;                   /*!< Signal level.*/
+    uint32_t    npki;                   /*!< Noise level.*/
+    uint32_t    learn_max;              /*!< Largest integrator output of the training.*/
+    uint64_t    learn_sum;              /*!< Sum of the integrator output of the training.*/
+    uint32_t    last_r;                 /*!< Index of the last R peak.*/
+    int32_t     last_slope;             /*!< Slope of the last QRS.*/
+    int32_t     n_beats;                /*!< Number of detected beats, saturated at DSPS_QRS_RR_AVG + 1.*/
+    uint32_t    sb_pk;                  /*!< Largest search back candidate since the last beat.*/
+    uint32_t    sb_r;                   /*!< R index of the search back candidate.*/
+    int32_t     sb_slope;               /*!< Slope of the search back candidate.*/
+    int32_t     rr_pos1;                /*!< Write position in rr1.*/
+    int32_t     rr_pos2;                /*!< Write position in rr2.*/
+    int32_t     rr_count2;              /*!< Number of values in rr2.*/
+    int32_t     rr_avg1;                /*!< Average of rr1.*/
+    int32_t     rr_avg2;                /*!< Average of rr2.*/
+} qrs_s32_t;
+
+/**
+ * @brief   init Pan-Tompkins QRS detector
+ *
+ * @param qrs: pointer to detector structure, that must be preallocated
+ * @param fs: sample rate in Hz [DSPS_QRS_MIN_FS..DSPS_QRS_MAX_FS]
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_PARAM_OUTOFRANGE if fs is out of range
+ */
+esp_err_t dsps_qrs_init_s32(qrs_s32_t *qrs, int fs);
+
+/**
+ * @brief   Pan-Tompkins QRS detector
+ *
+ * Function processes len ECG samples and reports the R peaks found, in time order.
+ * Input is raw ADC counts or any integer scale up to 16 bits; the detector is insensitive to offset and gain.
+ * Only integer arithmetic is used.
+ *
+ * @param qrs: pointer to detector structure, that must be initialized before
+ * @param[in] input: ECG samples
+ * @param len: length of the input array
+ * @param[out] beats: detected beats
+ * @param max_beats: length of the beats array. Beats that do not fit are dropped
+ *
+ * @return: function returns the number of beats stored in the beats array
+ */
+int dsps_qrs_s32(qrs_s32_t *qrs, const int32_t *input, int len, qrs_beat_t *beats, int max_beats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _dsps_qrs_H_
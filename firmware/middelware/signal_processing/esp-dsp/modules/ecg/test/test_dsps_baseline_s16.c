@@ -0,0 +1,143 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsps_baseline.h"
+#include "dsp_tests.h"
+
+static const char *TAG = "dsps_baseline_s16";
+
+#define FS          500
+#define DECIM       100
+#define FIR_LEN     31
+#define DELAY       ((FIR_LEN / 2 + 2) * DECIM)
+#define N_SAMPLES   (20 * FS)
+
+static int16_t coeffs[FIR_LEN];
+static int32_t fir_delay[FIR_LEN];
+static int16_t x_delay[DELAY];
+static int16_t x[N_SAMPLES];
+static int16_t y[N_SAMPLES];
+static int16_t y2[N_SAMPLES];
+
+// RMS of y[n] - ref[n - DELAY] after the start-up, ref is NULL for a zero reference
+static float baseline_err(const int16_t *ref)
+{
+    double e = 0;
+    for (int n = 3 * DELAY; n < N_SAMPLES; n++) {
+        double d = y[n] - (ref ? ref[n - DELAY] : 0);
+        e += d * d;
+    }
+    return sqrt(e / (N_SAMPLES - 3 * DELAY));
+}
+
+static void baseline_run(baseline_s16_t *bl)
+{
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_baseline_init_s16(bl, coeffs, fir_delay, x_delay, DECIM, FIR_LEN, 0.5f / FS));
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_baseline_s16(bl, x, y, NULL, N_SAMPLES));
+}
+
+TEST_CASE("dsps_baseline_s16 functionality", "[dsps]")
+{
+    baseline_s16_t bl;
+    TEST_ASSERT_EQUAL(DELAY, dsps_baseline_delay_s16(DECIM, FIR_LEN));
+
+    // A DC offset is removed from the first sample
+    for (int n = 0; n < N_SAMPLES; n++) {
+        x[n] = 1234;
+    }
+    baseline_run(&bl);
+    for (int n = 0; n < N_SAMPLES; n++) {
+        TEST_ASSERT_EQUAL(0, y[n]);
+    }
+
+    // All the stages are linear phase: a ramp is removed exactly, up to the rounding
+    for (int n = 0; n < N_SAMPLES; n++) {
+        x[n] = -10000 + 2 * n;
+    }
+    baseline_run(&bl);
+    for (int n = 3 * DELAY; n < N_SAMPLES; n++) {
+        TEST_ASSERT_INT_WITHIN(1, 0, y[n]);
+    }
+
+    // Wander of 0.2 Hz and 3000 counts is attenuated, a 7 Hz tone passes with the delay of the filter
+    for (int n = 0; n < N_SAMPLES; n++) {
+        x[n] = (int16_t)lrintf(3000 * sinf(2 * M_PI * 0.2f * n / FS));
+    }
+    baseline_run(&bl);
+    float e_wander = baseline_err(NULL);
+    for (int n = 0; n < N_SAMPLES; n++) {
+        x[n] = (int16_t)lrintf(1000 * sinf(2 * M_PI * 7.0f * n / FS));
+    }
+    baseline_run(&bl);
+    float e_tone = baseline_err(x);
+    ESP_LOGI(TAG, "0.2 Hz wander residual %f of 2121 RMS, 7 Hz tone error %f of 707 RMS", e_wander, e_tone);
+    TEST_ASSERT_TRUE(e_wander < 0.05f * 2121);
+    TEST_ASSERT_TRUE(e_tone < 0.01f * 707);
+
+    // ECG like pulses at 72 bpm on the wander: the QRS keeps its shape and position
+    static int16_t ecg[N_SAMPLES];
+    for (int n = 0; n < N_SAMPLES; n++) {
+        int t = n % (FS * 60 / 72) - 100;
+        ecg[n] = (int16_t)lrintf(1500 * expf(-(float)(t * t) / 18) - 300 * expf(-(float)((t + 8) * (t + 8)) / 8));
+        x[n] = ecg[n] + (int16_t)lrintf(2000 * sinf(2 * M_PI * 0.3f * n / FS) + 500 * sinf(2 * M_PI * 0.07f * n / FS));
+    }
+    baseline_run(&bl);
+    int worst = 0;
+    for (int n = 3 * DELAY; n < N_SAMPLES; n++) {
+        int t = (n - DELAY) % (FS * 60 / 72) - 100;
+        if (abs(t) < 10) {
+            int peak_err = abs((y[n] - y[n - t - 20]) - (ecg[n - DELAY] - ecg[n - DELAY - t - 20]));
+            worst = (peak_err > worst) ? peak_err : worst;
+        }
+    }
+    ESP_LOGI(TAG, "largest QRS shape error %i of 1500", worst);
+    TEST_ASSERT_LESS_THAN(50, worst);
+
+    // Split into blocks of any length and in place
+    memcpy(y2, x, sizeof(x));
+    dsps_baseline_init_s16(&bl, coeffs, fir_delay, x_delay, DECIM, FIR_LEN, 0.5f / FS);
+    for (int pos = 0, len = 1; pos < N_SAMPLES; pos += len, len = len % 113 + 7) {
+        if (pos + len > N_SAMPLES) {
+            len = N_SAMPLES - pos;
+        }
+        dsps_baseline_s16(&bl, &y2[pos], &y2[pos], NULL, len);
+    }
+    TEST_ASSERT_EQUAL_INT16_ARRAY(y, y2, N_SAMPLES);
+
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_PARAM, dsps_baseline_init_s16(&bl, coeffs, NULL, x_delay, DECIM, FIR_LEN, 0.001f));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_LENGTH, dsps_baseline_init_s16(&bl, coeffs, fir_delay, x_delay, DECIM, 20, 0.001f));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_baseline_init_s16(&bl, coeffs, fir_delay, x_delay, DECIM, FIR_LEN, 0.01f));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_baseline_init_s16(&bl, coeffs, fir_delay, x_delay, 1, FIR_LEN, 0.001f));
+}
+
+TEST_CASE("dsps_baseline_s16 benchmark", "[dsps]")
+{
+    baseline_s16_t bl;
+    for (int n = 0; n < N_SAMPLES; n++) {
+        x[n] = (int16_t)(rand() % 4096 - 2048);
+    }
+    dsps_baseline_init_s16(&bl, coeffs, fir_delay, x_delay, DECIM, FIR_LEN, 0.5f / FS);
+
+    const int len = 10 * DECIM;
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    dsps_baseline_s16(&bl, x, y, NULL, len);
+    unsigned int end_b = dsp_get_cpu_cycle_count();
+    float cycles = (float)(end_b - start_b) / len;
+
+    ESP_LOGI(TAG, "decimation %i, %i taps at the low rate: %f cycles per sample", DECIM, FIR_LEN, cycles);
+
+    float min_exec = 5;
+    float max_exec = 100;
+    TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles);
+}
@@ -0,0 +1,163 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsps_hrv.h"
+#include "dsp_tests.h"
+
+static const char *TAG = "dsps_hrv_f32";
+
+#define WINDOW_MS   (5 * 60 * 1000)
+#define CAPACITY    600
+#define N_RR        1200
+
+static int32_t rr_buf[CAPACITY];
+static float work[4 * CAPACITY];
+static int32_t rr[N_RR];
+
+// RR series of 800 ms modulated at 0.1 Hz (LF, 30 ms) and 0.25 Hz (HF, 20 ms), sampled at the beats
+static void hrv_series(float lf_amp, float hf_amp)
+{
+    float t = 0;
+    for (int i = 0; i < N_RR; i++) {
+        float v = 800 + lf_amp * sinf(2 * M_PI * 0.1f * t) + hf_amp * sinf(2 * M_PI * 0.25f * t + 1);
+        rr[i] = (int32_t)lrintf(v);
+        t += rr[i] * 0.001f;
+    }
+}
+
+// Brute force metrics of the intervals rr[first..last]
+static void hrv_ref(int first, int last, hrv_time_t *out)
+{
+    int n = last - first + 1;
+    double sum = 0;
+    double d2 = 0;
+    int nn50 = 0;
+    for (int i = first; i <= last; i++) {
+        sum += rr[i];
+        if (i > first) {
+            int d = rr[i] - rr[i - 1];
+            d2 += (double)d * d;
+            nn50 += abs(d) > 50;
+        }
+    }
+    double mean = sum / n;
+    double var = 0;
+    for (int i = first; i <= last; i++) {
+        var += (rr[i] - mean) * (rr[i] - mean);
+    }
+    out->n = n;
+    out->mean_rr = mean;
+    out->sdnn = sqrt(var / (n - 1));
+    out->rmssd = sqrt(d2 / (n - 1));
+    out->pnn50 = (float)nn50 / (n - 1);
+}
+
+TEST_CASE("dsps_hrv_f32 functionality", "[dsps]")
+{
+    hrv_f32_t hrv;
+    hrv_time_t tm;
+    hrv_time_t ref;
+    hrv_series(30, 20);
+    for (int i = 0; i < N_RR; i += 37) {
+        rr[i] += (i % 2) ? 120 : -90;   // some large successive differences for pNN50
+    }
+
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_hrv_init_f32(&hrv, rr_buf, work, CAPACITY, WINDOW_MS));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_LENGTH, dsps_hrv_time_f32(&hrv, &tm));
+
+    // Every interval enters, and after 5 minutes the oldest ones leave
+    int first = 0;
+    int32_t window_sum = 0;
+    for (int i = 0; i < N_RR; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, dsps_hrv_push_f32(&hrv, rr[i]));
+        window_sum += rr[i];
+        while (window_sum > WINDOW_MS) {
+            window_sum -= rr[first++];
+        }
+        if (i - first < 1) {
+            continue;
+        }
+        TEST_ASSERT_EQUAL(ESP_OK, dsps_hrv_time_f32(&hrv, &tm));
+        hrv_ref(first, i, &ref);
+        TEST_ASSERT_EQUAL(ref.n, tm.n);
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f, ref.mean_rr, tm.mean_rr);
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f, ref.sdnn, tm.sdnn);
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f, ref.rmssd, tm.rmssd);
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, ref.pnn50, tm.pnn50);
+    }
+    ESP_LOGI(TAG, "window of %i beats: mean %f, SDNN %f, RMSSD %f, pNN50 %f", tm.n, tm.mean_rr, tm.sdnn, tm.rmssd, tm.pnn50);
+
+    // LF and HF power of the two modulations: amplitude^2/2
+    const float amp[][2] = {{30, 20}, {10, 25}};
+    for (int a = 0; a < 2; a++) {
+        hrv_series(amp[a][0], amp[a][1]);
+        dsps_hrv_init_f32(&hrv, rr_buf, work, CAPACITY, WINDOW_MS);
+        for (int i = 0; i < N_RR; i++) {
+            dsps_hrv_push_f32(&hrv, rr[i]);
+        }
+        float lf, hf;
+        TEST_ASSERT_EQUAL(ESP_OK, dsps_hrv_freq_f32(&hrv, 1.0f / 1200, &lf, &hf));
+        ESP_LOGI(TAG, "LF %f ms^2, HF %f ms^2, LF/HF %f", lf, hf, lf / hf);
+        float lf_ref = amp[a][0] * amp[a][0] / 2;
+        float hf_ref = amp[a][1] * amp[a][1] / 2;
+        TEST_ASSERT_FLOAT_WITHIN(0.1f * lf_ref, lf_ref, lf);
+        TEST_ASSERT_FLOAT_WITHIN(0.1f * hf_ref, hf_ref, hf);
+    }
+
+    // A capacity smaller than the window limits the number of intervals
+    dsps_hrv_init_f32(&hrv, rr_buf, NULL, 10, WINDOW_MS);
+    for (int i = 0; i < 25; i++) {
+        dsps_hrv_push_f32(&hrv, rr[i]);
+    }
+    dsps_hrv_time_f32(&hrv, &tm);
+    hrv_ref(15, 24, &ref);
+    TEST_ASSERT_EQUAL(10, tm.n);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, ref.rmssd, tm.rmssd);
+    float lf, hf;
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_PARAM, dsps_hrv_freq_f32(&hrv, 0.001f, &lf, &hf));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_hrv_push_f32(&hrv, 0));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_LENGTH, dsps_hrv_init_f32(&hrv, rr_buf, NULL, 1, WINDOW_MS));
+}
+
+TEST_CASE("dsps_hrv_f32 benchmark", "[dsps]")
+{
+    hrv_f32_t hrv;
+    hrv_time_t tm;
+    hrv_series(30, 20);
+    dsps_hrv_init_f32(&hrv, rr_buf, work, CAPACITY, WINDOW_MS);
+    for (int i = 0; i < N_RR / 2; i++) {
+        dsps_hrv_push_f32(&hrv, rr[i]);
+    }
+
+    const int repeat = 100;
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    for (int i = 0; i < repeat; i++) {
+        dsps_hrv_push_f32(&hrv, rr[N_RR / 2 + i]);
+        dsps_hrv_time_f32(&hrv, &tm);
+    }
+    unsigned int end_b = dsp_get_cpu_cycle_count();
+    float cycles_time = (float)(end_b - start_b) / repeat;
+
+    float lf, hf;
+    start_b = dsp_get_cpu_cycle_count();
+    dsps_hrv_freq_f32(&hrv, 1.0f / 1200, &lf, &hf);
+    end_b = dsp_get_cpu_cycle_count();
+    float cycles_freq = (float)(end_b - start_b);
+
+    ESP_LOGI(TAG, "%i beats: push + time metrics %f cycles per beat, LF/HF %f cycles", hrv.count, cycles_time, cycles_freq);
+
+    float min_exec = 10;
+    float max_exec = 2000;
+    TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles_time);
+}
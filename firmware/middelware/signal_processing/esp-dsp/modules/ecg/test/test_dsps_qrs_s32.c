@@ -0,0 +1,154 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsps_qrs.h"
+#include "dsp_tests.h"
+
+static const char *TAG = "dsps_qrs_s32";
+
+// One beat recorded at 250 Hz, the table replayed through the DAC by the guia2_4 project
+#define ECG_LEN     231
+#define ECG_R_POS   132
+static const uint8_t ecg_beat[ECG_LEN] = {
+    76, 77, 78, 77, 79, 86, 81, 76, 84, 93, 85, 80,
+    89, 95, 89, 85, 93, 98, 94, 88, 98, 105, 96, 91,
+    99, 105, 101, 96, 102, 106, 101, 96, 100, 107, 101,
+    94, 100, 104, 100, 91, 99, 103, 98, 91, 96, 105, 95,
+    88, 95, 100, 94, 85, 93, 99, 92, 84, 91, 96, 87, 80,
+    83, 92, 86, 78, 84, 89, 79, 73, 81, 83, 78, 70, 80, 82,
+    79, 69, 80, 82, 81, 70, 75, 81, 77, 74, 79, 83, 82, 72,
+    80, 87, 79, 76, 85, 95, 87, 81, 88, 93, 88, 84, 87, 94,
+    86, 82, 85, 94, 85, 82, 85, 95, 86, 83, 92, 99, 91, 88,
+    94, 98, 95, 90, 97, 105, 104, 94, 98, 114, 117, 124, 144,
+    180, 210, 236, 253, 227, 171, 99, 49, 34, 29, 43, 69, 89,
+    89, 90, 98, 107, 104, 98, 104, 110, 102, 98, 103, 111, 101,
+    94, 103, 108, 102, 95, 97, 106, 100, 92, 101, 103, 100, 94, 98,
+    103, 96, 90, 98, 103, 97, 90, 99, 104, 95, 90, 99, 104, 100, 93,
+    100, 106, 101, 93, 101, 105, 103, 96, 105, 112, 105, 99, 103, 108,
+    99, 96, 102, 106, 99, 90, 92, 100, 87, 80, 82, 88, 77, 69, 75, 79,
+    74, 67, 71, 78, 72, 67, 73, 81, 77, 71, 75, 84, 79, 77, 77, 76, 76,
+};
+
+#define N_BEATS     40
+#define MAX_LEN     ((N_BEATS * (ECG_LEN + 40) + 100) * 2)
+
+static int32_t ecg[MAX_LEN];
+static uint32_t r_true[N_BEATS];
+static qrs_beat_t beats[N_BEATS + 8];
+static uint32_t reported_at[N_BEATS + 8];
+
+// Builds a record of N_BEATS beats at 250 Hz * upsample, each beat followed by extra[k] samples of
+// its last value, with a baseline wander and the noise of the ADC. Beat weak is scaled by 0.45.
+// The last beat is followed by 0.4 s more, so it is reported before the end of the record.
+static int qrs_record(int upsample, const int *extra, int weak)
+{
+    int pos = 0;
+    for (int k = 0; k < N_BEATS; k++) {
+        r_true[k] = (pos + ECG_R_POS) * upsample;
+        const int beat_len = ECG_LEN + extra[k] + ((k == N_BEATS - 1) ? 100 : 0);
+        for (int i = 0; i < beat_len; i++) {
+            int32_t v = ecg_beat[(i < ECG_LEN) ? i : ECG_LEN - 1] - 90;
+            if (k == weak) {
+                v = v * 45 / 100;
+            }
+            for (int u = 0; u < upsample; u++) {
+                int32_t t = pos * upsample + u;
+                // Sample and hold of the DAC, 12 bit ADC: 16 counts per DAC step
+                ecg[t] = 2048 + 16 * v + ((t / 4) % 400 < 200 ? (t / 4) % 200 : 200 - (t / 4) % 200) + (rand() % 9) - 4;
+            }
+            pos++;
+        }
+    }
+    return pos * upsample;
+}
+
+// Runs the detector in blocks of 17 samples and checks every beat against r_true
+static void qrs_check(int fs, int len, int tol, int weak)
+{
+    qrs_s32_t qrs;
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_qrs_init_s32(&qrs, fs));
+    int n_beats = 0;
+    for (int i = 0; i < len; i += 17) {
+        int n = (len - i < 17) ? len - i : 17;
+        int found = dsps_qrs_s32(&qrs, &ecg[i], n, &beats[n_beats], N_BEATS + 8 - n_beats);
+        for (int k = 0; k < found; k++) {
+            reported_at[n_beats + k] = i + n;
+        }
+        n_beats += found;
+    }
+
+    // The beats of the first 2 s train the detector, all the others are found once
+    int first = 0;
+    while (r_true[first] + qrs.delay + qrs.mwi_len < (uint32_t)qrs.learn_len) {
+        first++;
+    }
+    ESP_LOGI(TAG, "fs %i: %i beats, first expected %i", fs, n_beats, first);
+    TEST_ASSERT_EQUAL(N_BEATS - first, n_beats);
+    for (int k = 0; k < n_beats; k++) {
+        const int expected = first + k;
+        TEST_ASSERT_INT_WITHIN(tol, r_true[expected], beats[k].index);
+        TEST_ASSERT_EQUAL(expected == weak, beats[k].searchback);
+        if (k > 0) {
+            int32_t rr = r_true[expected] - r_true[expected - 1];
+            TEST_ASSERT_INT_WITHIN(tol * 2, rr, beats[k].rr);
+            TEST_ASSERT_INT_WITHIN(60 * 10 * fs * tol * 2 / rr / rr + 1, 600 * fs / rr, beats[k].hr);
+        }
+        if (!beats[k].searchback) {
+            TEST_ASSERT_LESS_OR_EQUAL(qrs.delay + 2 * qrs.mwi_len + 17, reported_at[k] - beats[k].index);
+        }
+    }
+}
+
+TEST_CASE("dsps_qrs_s32 functionality", "[dsps]")
+{
+    int extra[N_BEATS];
+
+    // Replay of the table as the DAC does it, 65 bpm
+    memset(extra, 0, sizeof(extra));
+    int len = qrs_record(1, extra, -1);
+    qrs_check(250, len, 2, -1);
+
+    // Read back by the ADC every 2 ms
+    len = qrs_record(2, extra, -1);
+    qrs_check(500, len, 3, -1);
+
+    // Heart rate changing between 56 and 65 bpm, and a weak beat found by the search back
+    for (int k = 0; k < N_BEATS; k++) {
+        extra[k] = (k * 7) % 40;
+    }
+    len = qrs_record(2, extra, 20);
+    qrs_check(500, len, 3, 20);
+
+    qrs_s32_t qrs;
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_qrs_init_s32(&qrs, 50));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_qrs_init_s32(&qrs, 2000));
+}
+
+TEST_CASE("dsps_qrs_s32 benchmark", "[dsps]")
+{
+    int extra[N_BEATS];
+    memset(extra, 0, sizeof(extra));
+    int len = qrs_record(2, extra, -1);
+    qrs_s32_t qrs;
+    dsps_qrs_init_s32(&qrs, 500);
+
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    dsps_qrs_s32(&qrs, ecg, len, beats, N_BEATS + 8);
+    unsigned int end_b = dsp_get_cpu_cycle_count();
+    float cycles = (float)(end_b - start_b) / len;
+    ESP_LOGI(TAG, "500 Hz: %f cycles per sample", cycles);
+
+    float min_exec = 10;
+    float max_exec = 1000;
+    TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles);
+}
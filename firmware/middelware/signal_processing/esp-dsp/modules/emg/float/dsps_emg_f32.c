@@ -0,0 +1,136 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <math.h>
+#include "dsps_emg.h"
+#include "dsps_biquad.h"
+#include "dsps_biquad_gen.h"
+
+// Butterworth Q of the 2nd order sections, as in the IIR filter middleware
+static const float emg_butter_q[DSPS_EMG_MAX_SECTIONS][DSPS_EMG_MAX_SECTIONS] = {
+    {1 / 1.414f},
+    {1 / 0.765f, 1 / 1.848f},
+    {1 / 0.518f, 1 / 1.414f, 1 / 1.932f},
+    {1 / 0.390f, 1 / 1.111f, 1 / 1.663f, 1 / 1.962f},
+};
+
+esp_err_t dsps_emg_init_f32(emg_f32_t *emg, float *buf, int win_len, int hop, float env_fc, int env_order, float thresh)
+{
+    if (buf == NULL) {
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    if ((win_len < 2) || (hop < 1)) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    if ((env_fc <= 0) || (env_fc >= 0.5f) || (env_order < 2) || (env_order > 2 * DSPS_EMG_MAX_SECTIONS) || (env_order & 1)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    memset(emg, 0, sizeof(emg_f32_t));
+    emg->x = buf;
+    emg->win_len = win_len;
+    emg->ring_len = win_len + 1;
+    emg->hop = hop;
+    emg->thresh = thresh;
+    emg->n_sections = env_order / 2;
+    for (int s = 0; s < emg->n_sections; s++) {
+        dsps_biquad_gen_lpf_f32(emg->coeffs[s], env_fc, emg_butter_q[emg->n_sections - 1][s]);
+    }
+    memset(buf, 0, emg->ring_len * sizeof(float));
+    return ESP_OK;
+}
+
+static inline void emg_kahan(float *sum, float *c, float v)
+{
+    const float y = v - *c;
+    const float t = *sum + y;
+    *c = (t - *sum) - y;
+    *sum = t;
+}
+
+static inline int32_t emg_zc(float a, float b, float thresh)
+{
+    return (a * b < 0) && (fabsf(a - b) >= thresh);
+}
+
+static inline int32_t emg_ssc(float a, float b, float c, float thresh)
+{
+    return ((b - a) * (b - c) > 0) && (fabsf(b - a) >= thresh) && (fabsf(b - c) >= thresh);
+}
+
+static inline float emg_at(const emg_f32_t *emg, int back)
+{
+    int i = emg->pos - back;
+    return emg->x[(i < 0) ? i + emg->ring_len : i];
+}
+
+int dsps_emg_f32(emg_f32_t *emg, const float *input, int len, emg_features_t *features, int max_features)
+{
+    const int W = emg->win_len;
+    const float thr = emg->thresh;
+    int n_out = 0;
+
+    while (len > 0) {
+        const int n = (len < DSPS_EMG_CHUNK) ? len : DSPS_EMG_CHUNK;
+
+        // Envelope of the chunk: rectification and the low-pass cascade
+        for (int i = 0; i < n; i++) {
+            emg->env[i] = fabsf(input[i]);
+        }
+        for (int s = 0; s < emg->n_sections; s++) {
+            dsps_biquad_f32(emg->env, emg->env, n, emg->coeffs[s], emg->delay[s]);
+        }
+
+        for (int i = 0; i < n; i++) {
+            const float v = input[i];
+            const float p1 = emg_at(emg, 0);
+            const float p2 = emg_at(emg, 1);
+            emg->pos = (emg->pos + 1 < emg->ring_len) ? emg->pos + 1 : 0;
+            emg->x[emg->pos] = v;
+
+            // Sample entering the window
+            emg_kahan(&emg->sum2, &emg->sum2_c, v * v);
+            emg_kahan(&emg->sum_abs, &emg->sum_abs_c, fabsf(v));
+            if (emg->count >= 1) {
+                emg_kahan(&emg->sum_wl, &emg->sum_wl_c, fabsf(v - p1));
+                emg->zc += emg_zc(p1, v, thr);
+            }
+            if (emg->count >= 2) {
+                emg->ssc += emg_ssc(p2, p1, v, thr);
+            }
+
+            // Sample leaving the window, with the pair and the triple that start at it
+            if (emg->count >= W) {
+                const float o0 = emg_at(emg, W);
+                const float o1 = emg_at(emg, W - 1);
+                const float o2 = emg_at(emg, W - 2);
+                emg_kahan(&emg->sum2, &emg->sum2_c, -o0 * o0);
+                emg_kahan(&emg->sum_abs, &emg->sum_abs_c, -fabsf(o0));
+                emg_kahan(&emg->sum_wl, &emg->sum_wl_c, -fabsf(o1 - o0));
+                emg->zc -= emg_zc(o0, o1, thr);
+                emg->ssc -= emg_ssc(o0, o1, o2, thr);
+            } else {
+                emg->count++;
+            }
+
+            if (emg->count == W) {
+                if ((emg->hop_pos == 0) && (n_out < max_features)) {
+                    emg_features_t *f = &features[n_out++];
+                    f->envelope = emg->env[i];
+                    f->rms = sqrtf(((emg->sum2 > 0) ? emg->sum2 : 0) / W);
+                    f->mav = emg->sum_abs / W;
+                    f->wl = emg->sum_wl;
+                    f->zc = emg->zc;
+                    f->ssc = emg->ssc;
+                }
+                emg->hop_pos = (emg->hop_pos + 1 < emg->hop) ? emg->hop_pos + 1 : 0;
+            }
+        }
+        input += n;
+        len -= n;
+    }
+    return n_out;
+}
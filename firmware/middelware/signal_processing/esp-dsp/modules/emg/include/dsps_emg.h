@@ -0,0 +1,104 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _dsps_emg_H_
+#define _dsps_emg_H_
+
+#include "dsp_err.h"
+#include "dsp_common.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define DSPS_EMG_MAX_SECTIONS   4   /*!< Maximum number of biquads of the envelope low-pass (8th order)*/
+#define DSPS_EMG_CHUNK          32  /*!< Number of samples of the envelope filtered per call of dsps_biquad_f32*/
+
+/**
+ * @brief EMG feature vector
+ */
+typedef struct emg_features_s {
+    float   envelope;   /*!< Rectified and low-pass filtered signal at the last sample of the window.*/
+    float   rms;        /*!< Root mean square of the window.*/
+    float   mav;        /*!< Mean absolute value of the window.*/
+    float   wl;         /*!< Waveform length, sum of |x[i] - x[i-1]| over the window.*/
+    int32_t zc;         /*!< Zero crossings with a step of at least thresh.*/
+    int32_t ssc;        /*!< Slope sign changes with both steps of at least thresh.*/
+} emg_features_t;
+
+/**
+ * @brief Data struct of the EMG feature extractor
+ *
+ * All the features are updated in one pass per sample: every running sum adds the new sample and
+ * removes the one that leaves the window, so the cost does not depend on the window length. The float
+ * sums use Kahan compensation, so they do not drift over long recordings.
+ * The envelope low-pass is a Butterworth cascade designed like the one of the IIR filter middleware
+ * (LowPassInit), with its own delay lines so several channels can run at the same time.
+ * All fields of this structure are initialized by the dsps_emg_init_f32(...) function.
+ */
+typedef struct emg_f32_s {
+    float  *x;              /*!< Ring buffer of the last win_len + 1 samples.*/
+    float   coeffs[DSPS_EMG_MAX_SECTIONS][5];   /*!< Envelope low-pass biquads.*/
+    float   delay[DSPS_EMG_MAX_SECTIONS][2];    /*!< Delay lines of the biquads.*/
+    float   env[DSPS_EMG_CHUNK];    /*!< Envelope of the current chunk.*/
+    float   sum2;           /*!< Sum of x^2.*/
+    float   sum2_c;         /*!< Kahan compensation of sum2.*/
+    float   sum_abs;        /*!< Sum of |x|.*/
+    float   sum_abs_c;      /*!< Kahan compensation of sum_abs.*/
+    float   sum_wl;         /*!< Sum of |x[i] - x[i-1]|.*/
+    float   sum_wl_c;       /*!< Kahan compensation of sum_wl.*/
+    float   thresh;         /*!< Threshold of the zero crossings and slope sign changes.*/
+    int32_t zc;             /*!< Zero crossings in the window.*/
+    int32_t ssc;            /*!< Slope sign changes in the window.*/
+    int     win_len;        /*!< Window length.*/
+    int     ring_len;       /*!< Length of the ring buffer, win_len + 1.*/
+    int     hop;            /*!< Number of samples between feature vectors.*/
+    int     n_sections;     /*!< Number of biquads of the envelope low-pass.*/
+    int     pos;            /*!< Position of the newest sample in the ring buffer.*/
+    int     count;          /*!< Number of samples received, saturated at win_len.*/
+    int     hop_pos;        /*!< Samples since the last feature vector.*/
+} emg_f32_t;
+
+/**
+ * @brief   init EMG feature extractor
+ *
+ * @param emg: pointer to feature extractor structure, that must be preallocated
+ * @param buf: ring buffer, win_len + 1 elements
+ * @param win_len: window length, samples
+ * @param hop: number of samples between two feature vectors
+ * @param env_fc: cut-off frequency of the envelope low-pass relative to the sample rate, for example 5/1000
+ * @param env_order: order of the envelope low-pass, 2, 4, 6 or 8
+ * @param thresh: minimum step for a zero crossing or a slope sign change, in input units, to reject noise
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_PARAM if buf is NULL
+ *      - ESP_ERR_DSP_INVALID_LENGTH if win_len is less than 2 or hop is less than 1
+ *      - ESP_ERR_DSP_PARAM_OUTOFRANGE if env_fc or env_order are out of range
+ */
+esp_err_t dsps_emg_init_f32(emg_f32_t *emg, float *buf, int win_len, int hop, float env_fc, int env_order, float thresh);
+
+/**
+ * @brief   EMG feature extraction
+ *
+ * Function pushes len samples and writes a feature vector every hop samples, once the window is full.
+ *
+ * @param emg: pointer to feature extractor structure, that must be initialized before
+ * @param[in] input: EMG signal, band-pass filtered and without offset
+ * @param len: length of the input array
+ * @param[out] features: feature vectors
+ * @param max_features: length of the features array. Vectors that do not fit are dropped
+ *
+ * @return: function returns the number of feature vectors stored in the features array
+ */
+int dsps_emg_f32(emg_f32_t *emg, const float *input, int len, emg_features_t *features, int max_features);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _dsps_emg_H_
@@ -0,0 +1,141 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsps_emg.h"
+#include "dsp_tests.h"
+
+static const char *TAG = "dsps_emg_f32";
+
+#define FS          1000
+#define WIN_LEN     200
+#define HOP         50
+#define N_SAMPLES   4000
+#define MAX_FEAT    (N_SAMPLES / HOP)
+#define THRESH      0.01f
+
+static float ring[WIN_LEN + 1];
+static float x[N_SAMPLES];
+static emg_features_t feat[MAX_FEAT];
+static emg_features_t feat2[MAX_FEAT];
+
+// Noise burst with an amplitude of 0.05 at rest and 0.5 during the contraction, from 1.5 s to 2.5 s
+static void emg_signal(void)
+{
+    srand(1);
+    for (int i = 0; i < N_SAMPLES; i++) {
+        float amp = ((i >= 1500) && (i < 2500)) ? 0.5f : 0.05f;
+        float noise = 0;
+        for (int k = 0; k < 4; k++) {
+            noise += (float)rand() / RAND_MAX - 0.5f;
+        }
+        x[i] = amp * noise + 0.002f * sinf(2 * M_PI * 3 * i / FS);
+    }
+}
+
+// Brute force features of the window that ends at sample last
+static void emg_ref(int last, emg_features_t *out)
+{
+    int first = last - WIN_LEN + 1;
+    double s2 = 0, sa = 0, wl = 0;
+    int zc = 0, ssc = 0;
+    for (int i = first; i <= last; i++) {
+        s2 += (double)x[i] * x[i];
+        sa += fabsf(x[i]);
+        if (i > first) {
+            wl += fabsf(x[i] - x[i - 1]);
+            zc += (x[i] * x[i - 1] < 0) && (fabsf(x[i] - x[i - 1]) >= THRESH);
+        }
+        if (i > first + 1) {
+            float d1 = x[i - 1] - x[i - 2];
+            float d2 = x[i - 1] - x[i];
+            ssc += (d1 * d2 > 0) && (fabsf(d1) >= THRESH) && (fabsf(d2) >= THRESH);
+        }
+    }
+    out->rms = sqrt(s2 / WIN_LEN);
+    out->mav = sa / WIN_LEN;
+    out->wl = wl;
+    out->zc = zc;
+    out->ssc = ssc;
+}
+
+TEST_CASE("dsps_emg_f32 functionality", "[dsps]")
+{
+    emg_f32_t emg;
+    emg_features_t ref;
+    emg_signal();
+
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_emg_init_f32(&emg, ring, WIN_LEN, HOP, 5.0f / FS, 4, THRESH));
+    int n = dsps_emg_f32(&emg, x, N_SAMPLES, feat, MAX_FEAT);
+    TEST_ASSERT_EQUAL((N_SAMPLES - WIN_LEN) / HOP + 1, n);
+
+    // The running sums match the brute force features of every window
+    for (int k = 0; k < n; k++) {
+        emg_ref(WIN_LEN - 1 + k * HOP, &ref);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f * ref.rms + 1e-6f, ref.rms, feat[k].rms);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f * ref.mav + 1e-6f, ref.mav, feat[k].mav);
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f * ref.wl + 1e-6f, ref.wl, feat[k].wl);
+        TEST_ASSERT_EQUAL(ref.zc, feat[k].zc);
+        TEST_ASSERT_EQUAL(ref.ssc, feat[k].ssc);
+    }
+
+    // The envelope follows the contraction and settles at the mean absolute value
+    int rest = (1400 - WIN_LEN + 1) / HOP;
+    int active = (2400 - WIN_LEN + 1) / HOP;
+    ESP_LOGI(TAG, "envelope rest %f, active %f, RMS rest %f, active %f, ZC %i, SSC %i", feat[rest].envelope, feat[active].envelope,
+             feat[rest].rms, feat[active].rms, (int)feat[active].zc, (int)feat[active].ssc);
+    TEST_ASSERT_FLOAT_WITHIN(0.25f * feat[rest].mav, feat[rest].mav, feat[rest].envelope);
+    TEST_ASSERT_FLOAT_WITHIN(0.25f * feat[active].mav, feat[active].mav, feat[active].envelope);
+    TEST_ASSERT_TRUE(feat[active].rms > 5 * feat[rest].rms);
+
+    // The result does not depend on the length of the calls
+    dsps_emg_init_f32(&emg, ring, WIN_LEN, HOP, 5.0f / FS, 4, THRESH);
+    int n2 = 0;
+    for (int pos = 0, len = 1; pos < N_SAMPLES; pos += len, len = len % 97 + 3) {
+        if (pos + len > N_SAMPLES) {
+            len = N_SAMPLES - pos;
+        }
+        n2 += dsps_emg_f32(&emg, &x[pos], len, &feat2[n2], MAX_FEAT - n2);
+    }
+    TEST_ASSERT_EQUAL(n, n2);
+    for (int k = 0; k < n; k++) {
+        TEST_ASSERT_EQUAL_FLOAT(feat[k].envelope, feat2[k].envelope);
+        TEST_ASSERT_EQUAL_FLOAT(feat[k].rms, feat2[k].rms);
+        TEST_ASSERT_EQUAL(feat[k].ssc, feat2[k].ssc);
+    }
+
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_PARAM, dsps_emg_init_f32(&emg, NULL, WIN_LEN, HOP, 0.005f, 4, THRESH));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_LENGTH, dsps_emg_init_f32(&emg, ring, 1, HOP, 0.005f, 4, THRESH));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_emg_init_f32(&emg, ring, WIN_LEN, HOP, 0.005f, 3, THRESH));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_emg_init_f32(&emg, ring, WIN_LEN, HOP, 0.6f, 4, THRESH));
+}
+
+TEST_CASE("dsps_emg_f32 benchmark", "[dsps]")
+{
+    emg_f32_t emg;
+    emg_signal();
+    dsps_emg_init_f32(&emg, ring, WIN_LEN, HOP, 5.0f / FS, 4, THRESH);
+    dsps_emg_f32(&emg, x, WIN_LEN, feat, MAX_FEAT);
+
+    const int len = 1000;
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    dsps_emg_f32(&emg, &x[WIN_LEN], len, feat, MAX_FEAT);
+    unsigned int end_b = dsp_get_cpu_cycle_count();
+    float cycles = (float)(end_b - start_b) / len;
+
+    ESP_LOGI(TAG, "window %i, 4th order envelope: %f cycles per sample", WIN_LEN, cycles);
+
+    float min_exec = 10;
+    float max_exec = 1000;
+    TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles);
+}
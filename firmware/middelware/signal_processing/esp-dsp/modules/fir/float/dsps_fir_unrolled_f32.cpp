@@ -0,0 +1,133 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "dsps_fir.h"
+#include "fir_fixed.h"
+
+typedef void (*fir_unrolled_kernel_t)(fir_f32_t *fir, const float *input, float *output, int len, int decim);
+
+// Window push and unrolled dot product for a compile-time length
+template <int N>
+static void fir_unrolled_kernel(fir_f32_t *fir, const float *input, float *output, int len, int decim)
+{
+    float *d = fir->delay;
+    const float *h = fir->coeffs;
+    int pos = fir->pos;
+    for (int i = 0; i < len; i++) {
+        for (int k = 0; k < decim; k++) {
+            float x = *input++;
+            d[pos] = x;
+            d[pos + N] = x;
+            if (++pos >= N) {
+                pos = 0;
+            }
+        }
+        output[i] = dsps::FirDot<N>::run(h, &d[pos]);
+    }
+    fir->pos = pos;
+}
+
+// Longer filters: same delay line layout, runtime length loop
+static void fir_unrolled_generic(fir_f32_t *fir, const float *input, float *output, int len, int decim)
+{
+    float *d = fir->delay;
+    const float *h = fir->coeffs;
+    const int N = fir->N;
+    int pos = fir->pos;
+    for (int i = 0; i < len; i++) {
+        for (int k = 0; k < decim; k++) {
+            float x = *input++;
+            d[pos] = x;
+            d[pos + N] = x;
+            if (++pos >= N) {
+                pos = 0;
+            }
+        }
+        const float *w = &d[pos];
+        float acc = 0;
+        for (int n = 0; n < N; n++) {
+            acc += h[n] * w[n];
+        }
+        output[i] = acc;
+    }
+    fir->pos = pos;
+}
+
+static const fir_unrolled_kernel_t fir_unrolled_kernels[DSPS_FIR_UNROLLED_MAX_LEN + 1] = {
+    fir_unrolled_generic,
+    fir_unrolled_kernel<1>,
+    fir_unrolled_kernel<2>,
+    fir_unrolled_kernel<3>,
+    fir_unrolled_kernel<4>,
+    fir_unrolled_kernel<5>,
+    fir_unrolled_kernel<6>,
+    fir_unrolled_kernel<7>,
+    fir_unrolled_kernel<8>,
+    fir_unrolled_kernel<9>,
+    fir_unrolled_kernel<10>,
+    fir_unrolled_kernel<11>,
+    fir_unrolled_kernel<12>,
+    fir_unrolled_kernel<13>,
+    fir_unrolled_kernel<14>,
+    fir_unrolled_kernel<15>,
+    fir_unrolled_kernel<16>,
+    fir_unrolled_kernel<17>,
+    fir_unrolled_kernel<18>,
+    fir_unrolled_kernel<19>,
+    fir_unrolled_kernel<20>,
+    fir_unrolled_kernel<21>,
+    fir_unrolled_kernel<22>,
+    fir_unrolled_kernel<23>,
+    fir_unrolled_kernel<24>,
+    fir_unrolled_kernel<25>,
+    fir_unrolled_kernel<26>,
+    fir_unrolled_kernel<27>,
+    fir_unrolled_kernel<28>,
+    fir_unrolled_kernel<29>,
+    fir_unrolled_kernel<30>,
+    fir_unrolled_kernel<31>,
+    fir_unrolled_kernel<32>
+};
+
+static inline fir_unrolled_kernel_t fir_unrolled_select(const fir_f32_t *fir)
+{
+    if (fir->N <= DSPS_FIR_UNROLLED_MAX_LEN) {
+        return fir_unrolled_kernels[fir->N];
+    }
+    return fir_unrolled_generic;
+}
+
+esp_err_t dsps_fir_unrolled_init_f32(fir_f32_t *fir, float *coeffs, float *delay, int coeffs_len, int decim)
+{
+    if ((coeffs == NULL) || (delay == NULL)) {
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    if ((coeffs_len < 1) || (decim < 1)) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    fir->coeffs = coeffs;
+    fir->delay = delay;
+    fir->N = coeffs_len;
+    fir->pos = 0;
+    fir->decim = decim;
+    fir->use_delay = 0;
+    for (int i = 0; i < 2 * coeffs_len; i++) {
+        delay[i] = 0;
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_fir_unrolled_f32(fir_f32_t *fir, const float *input, float *output, int len)
+{
+    fir_unrolled_select(fir)(fir, input, output, len, 1);
+    return ESP_OK;
+}
+
+int dsps_fird_unrolled_f32(fir_f32_t *fir, const float *input, float *output, int len)
+{
+    fir_unrolled_select(fir)(fir, input, output, len, fir->decim);
+    return len;
+}
@@ -21,6 +21,8 @@
 #include "dsps_fir_platform.h"
 #include "dsp_common.h"
 
+#define DSPS_FIR_UNROLLED_MAX_LEN   32  /*!< Longest FIR filter with a compile-time unrolled kernel*/
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -181,6 +183,59 @@ int32_t dsps_fird_s16_aes3(fir_s16_t *fir, const int16_t *input, int16_t *output
 /**@}*/
 
 
+/**@{*/
+/**
+ * @brief   initialize structure for 32 bit unrolled FIR filter
+ *
+ * Function initializes a fir_f32_t structure for the dsps_fir_unrolled_f32/dsps_fird_unrolled_f32 kernels.
+ * These kernels store every sample twice in the delay line, so the window is always contiguous and,
+ * for up to DSPS_FIR_UNROLLED_MAX_LEN taps, the inner loop is fully unrolled at compile time
+ * (see fir_fixed.h for the C++ classes).
+ * The implementation use ANSI C++ and could be compiled and run on any platform
+ *
+ * @param fir: pointer to fir filter structure, that must be preallocated
+ * @param coeffs: array with FIR filter coefficients. Must be length coeffs_len
+ * @param delay: array for FIR filter delay line. Must be length 2*coeffs_len
+ * @param coeffs_len: FIR filter length
+ * @param decim: decimation factor, 1 for the dsps_fir_unrolled_f32 kernel
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_PARAM if coeffs or delay are NULL
+ *      - ESP_ERR_DSP_INVALID_LENGTH if coeffs_len or decim is lower than 1
+ */
+esp_err_t dsps_fir_unrolled_init_f32(fir_f32_t *fir, float *coeffs, float *delay, int coeffs_len, int decim);
+
+/**
+ * @brief   32 bit floating point unrolled FIR filter
+ *
+ * Same result as dsps_fir_f32_ansi, the structure must be initialized by dsps_fir_unrolled_init_f32(...).
+ *
+ * @param fir: pointer to fir filter structure, that must be initialized before
+ * @param[in] input: input array
+ * @param[out] output: array with the result of FIR filter
+ * @param[in] len: length of input and result arrays
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dsps_fir_unrolled_f32(fir_f32_t *fir, const float *input, float *output, int len);
+
+/**
+ * @brief   32 bit floating point unrolled Decimation FIR filter
+ *
+ * Same result as dsps_fird_f32_ansi, the structure must be initialized by dsps_fir_unrolled_init_f32(...).
+ *
+ * @param fir: pointer to fir filter structure, that must be initialized before
+ * @param input: input array, length len*decim
+ * @param output: array with the result of FIR filter
+ * @param len: length of result array
+ *
+ * @return: function returns the number of samples stored in the output array
+ */
+int dsps_fird_unrolled_f32(fir_f32_t *fir, const float *input, float *output, int len);
+/**@}*/
+
 /**@{*/
 /**
  * @brief   support arrays freeing function
@@ -0,0 +1,327 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _dsps_fir_fixed_h_
+#define _dsps_fir_fixed_h_
+
+#include <stdint.h>
+
+/**
+ * @brief   DSP signal processing namespace
+ *
+ * Compile-time length filter blocks. With the length known at compile time the dot product is fully
+ * unrolled and the delay line is stored twice (2*N values), so the last N samples are always contiguous
+ * and the circular buffer needs neither modulo nor a split loop. Results are bit exact with the
+ * dsps_fir_f32_ansi/dsps_fird_f32_ansi kernels: coeffs[0] multiplies the oldest sample of the window
+ * and the accumulation order is the same.
+ */
+namespace dsps {
+
+/**
+ * @brief Unrolled dot product of K coefficients with K contiguous samples
+ *
+ * Accumulation starts from h[0]*d[0], the same order as the ANSI C kernels.
+ */
+template <int K>
+struct FirDot {
+    static inline float run(const float *h, const float *d)
+    {
+        return FirDot < K - 1 >::run(h, d) + h[K - 1] * d[K - 1];
+    }
+};
+
+template <>
+struct FirDot<1> {
+    static inline float run(const float *h, const float *d)
+    {
+        return h[0] * d[0];
+    }
+};
+
+/**
+ * @brief Double-length delay line
+ *
+ * Every sample is written at pos and pos + N. After the write, the window oldest..newest
+ * is delay[pos .. pos + N - 1].
+ */
+template <int N>
+struct FirDelay {
+    float   d[2 * N];   /*!< Delay line, every sample stored twice*/
+    int     pos;        /*!< Position of the oldest sample*/
+
+    inline void reset()
+    {
+        for (int i = 0; i < 2 * N; i++) {
+            d[i] = 0;
+        }
+        pos = 0;
+    }
+
+    inline void push(float x)
+    {
+        d[pos] = x;
+        d[pos + N] = x;
+        if (++pos >= N) {
+            pos = 0;
+        }
+    }
+
+    inline const float *window() const
+    {
+        return &d[pos];
+    }
+};
+
+/**
+ * @brief   FIR filter with N taps
+ *
+ * Coefficients and delay line are stored inside the object, so small filters live on the stack
+ * or in static memory without any heap activity.
+ */
+template <int N>
+class Fir {
+    static_assert(N > 0, "FIR length must be positive");
+public:
+    /**
+     * Constructor
+     * @param[in] coeffs: N filter coefficients, same order as for dsps_fir_init_f32
+     */
+    explicit Fir(const float *coeffs)
+    {
+        setCoeffs(coeffs);
+        reset();
+    }
+
+    /**
+     * Replace the coefficients, the delay line is kept.
+     * @param[in] coeffs: N filter coefficients
+     */
+    void setCoeffs(const float *coeffs)
+    {
+        for (int i = 0; i < N; i++) {
+            h[i] = coeffs[i];
+        }
+    }
+
+    /**
+     * Clear the delay line.
+     */
+    void reset()
+    {
+        delay.reset();
+    }
+
+    /**
+     * Filter one sample.
+     * @param[in] x: input sample
+     * @return filtered sample
+     */
+    inline float process(float x)
+    {
+        delay.push(x);
+        return FirDot<N>::run(h, delay.window());
+    }
+
+    /**
+     * Filter a block of samples. Input and output could be the same array.
+     * @param[in] input: input array
+     * @param[out] output: output array
+     * @param[in] len: length of input and output arrays
+     */
+    void process(const float *input, float *output, int len)
+    {
+        for (int i = 0; i < len; i++) {
+            output[i] = process(input[i]);
+        }
+    }
+
+    static const int length = N;    /*!< Number of taps*/
+
+private:
+    float h[N];
+    FirDelay<N> delay;
+};
+
+/**
+ * @brief   Decimating FIR filter with N taps and decimation factor D
+ *
+ * One output sample is computed for every D input samples, only the outputs are evaluated.
+ */
+template <int N, int D>
+class FirDecim {
+    static_assert(N > 0, "FIR length must be positive");
+    static_assert(D > 0, "Decimation factor must be positive");
+public:
+    /**
+     * Constructor
+     * @param[in] coeffs: N filter coefficients, same order as for dsps_fird_init_f32
+     */
+    explicit FirDecim(const float *coeffs)
+    {
+        for (int i = 0; i < N; i++) {
+            h[i] = coeffs[i];
+        }
+        reset();
+    }
+
+    /**
+     * Clear the delay line and the decimation counter.
+     */
+    void reset()
+    {
+        delay.reset();
+        phase = 0;
+    }
+
+    /**
+     * Push one input sample.
+     * @param[in] x: input sample
+     * @param[out] y: output sample, written only when the function returns true
+     * @return true every D samples, when a new output is available
+     */
+    inline bool push(float x, float &y)
+    {
+        delay.push(x);
+        if (++phase < D) {
+            return false;
+        }
+        phase = 0;
+        y = FirDot<N>::run(h, delay.window());
+        return true;
+    }
+
+    /**
+     * Decimate a block, same semantics as dsps_fird_f32_ansi.
+     * @param[in] input: input array, length len*D
+     * @param[out] output: output array
+     * @param[in] len: length of the output array
+     * @return number of output samples
+     */
+    int process(const float *input, float *output, int len)
+    {
+        for (int i = 0; i < len; i++) {
+            for (int k = 0; k < D; k++) {
+                delay.push(*input++);
+            }
+            output[i] = FirDot<N>::run(h, delay.window());
+        }
+        return len;
+    }
+
+    static const int length = N;    /*!< Number of taps*/
+    static const int decim = D;     /*!< Decimation factor*/
+
+private:
+    float h[N];
+    FirDelay<N> delay;
+    int phase;
+};
+
+/**
+ * @brief   Accumulator type used by MovingAverage for every sample type
+ */
+template <typename T> struct MovingAverageAcc {
+    typedef int32_t type;
+};
+template <> struct MovingAverageAcc<int32_t> {
+    typedef int64_t type;
+};
+template <> struct MovingAverageAcc<float> {
+    typedef float type;
+};
+
+/**
+ * @brief   Moving average over N samples
+ *
+ * O(1) per sample running sum. With N known at compile time the division becomes a multiplication.
+ * Integer samples use an exact wider accumulator and round to nearest; float samples use
+ * compensated summation, so the sum does not drift. Until N samples are received the missing
+ * samples count as zero.
+ */
+template <int N, typename T = float>
+class MovingAverage {
+    static_assert(N > 0, "Window length must be positive");
+    typedef typename MovingAverageAcc<T>::type Acc;
+public:
+    MovingAverage()
+    {
+        reset();
+    }
+
+    /**
+     * Clear the window.
+     */
+    void reset()
+    {
+        for (int i = 0; i < N; i++) {
+            buf[i] = 0;
+        }
+        pos = 0;
+        sum = 0;
+        comp = 0;
+    }
+
+    /**
+     * Add one sample.
+     * @param[in] x: input sample
+     * @return average of the last N samples
+     */
+    inline T process(T x)
+    {
+        Acc delta = (Acc)x - (Acc)buf[pos];
+        buf[pos] = x;
+        if (++pos >= N) {
+            pos = 0;
+        }
+        accumulate(delta);
+        return average();
+    }
+
+    /**
+     * Average a block of samples. Input and output could be the same array.
+     * @param[in] input: input array
+     * @param[out] output: output array
+     * @param[in] len: length of input and output arrays
+     */
+    void process(const T *input, T *output, int len)
+    {
+        for (int i = 0; i < len; i++) {
+            output[i] = process(input[i]);
+        }
+    }
+
+    static const int length = N;    /*!< Window length*/
+
+private:
+    inline void accumulate(Acc delta)
+    {
+        if (Acc(0.5) != 0) {
+            Acc y = delta - comp;
+            Acc t = sum + y;
+            comp = (t - sum) - y;
+            sum = t;
+        } else {
+            sum += delta;
+        }
+    }
+
+    inline T average() const
+    {
+        if (Acc(0.5) != 0) {
+            return (T)(sum * (Acc(1) / N));
+        }
+        return (T)((sum >= 0) ? (sum + N / 2) / N : (sum - N / 2) / N);
+    }
+
+    T buf[N];
+    int pos;
+    Acc sum;
+    Acc comp;
+};
+
+} // namespace dsps
+
+#endif // _dsps_fir_fixed_h_
@@ -0,0 +1,161 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsps_fir.h"
+#include "fir_fixed.h"
+#include "dsp_tests.h"
+
+static const char *TAG = "dsps_fir_unrolled_f32";
+
+#define N_SAMPLES   1024
+#define MAX_TAPS    40
+#define DECIM       4
+
+static float x[N_SAMPLES];
+static float y[N_SAMPLES];
+static float y_ref[N_SAMPLES];
+static float coeffs[MAX_TAPS];
+static float delay[2 * MAX_TAPS];
+static float delay_ref[MAX_TAPS + 4];
+
+static void fill_random(float *buf, int len)
+{
+    for (int i = 0; i < len; i++) {
+        buf[i] = (float)(rand() % 2000 - 1000) / 1000.0f;
+    }
+}
+
+template <int N>
+static void test_fir_class(void)
+{
+    fir_f32_t fir;
+    fill_random(coeffs, N);
+    dsps_fir_init_f32(&fir, coeffs, delay_ref, N);
+    dsps_fir_f32_ansi(&fir, x, y_ref, N_SAMPLES);
+
+    dsps::Fir<N> filter(coeffs);
+    for (int i = 0; i < N_SAMPLES; i++) {
+        y[i] = filter.process(x[i]);
+    }
+    TEST_ASSERT_EQUAL(0, memcmp(y, y_ref, sizeof(y)));
+}
+
+template <int N, int D>
+static void test_fird_class(void)
+{
+    fir_f32_t fir;
+    fill_random(coeffs, N);
+    dsps_fird_init_f32(&fir, coeffs, delay_ref, N, D);
+    int total_ref = dsps_fird_f32_ansi(&fir, x, y_ref, N_SAMPLES / D);
+
+    dsps::FirDecim<N, D> filter(coeffs);
+    int total = 0;
+    for (int i = 0; i < N_SAMPLES; i++) {
+        float out;
+        if (filter.push(x[i], out)) {
+            y[total++] = out;
+        }
+    }
+    TEST_ASSERT_EQUAL(total_ref, total);
+    TEST_ASSERT_EQUAL(0, memcmp(y, y_ref, total * sizeof(float)));
+}
+
+TEST_CASE("dsps_fir_unrolled_f32 functionality", "[dsps]")
+{
+    fill_random(x, N_SAMPLES);
+
+    // Templates must be bit exact with the ANSI C kernels
+    test_fir_class<5>();
+    test_fir_class<15>();
+    test_fir_class<31>();
+    test_fird_class<15, DECIM>();
+    test_fird_class<31, 3>();
+
+    // C shims, inside and outside of the unrolled range
+    const int lens[] = {1, 5, 7, 16, 31, DSPS_FIR_UNROLLED_MAX_LEN, MAX_TAPS};
+    for (int l = 0; l < (int)(sizeof(lens) / sizeof(lens[0])); l++) {
+        int n = lens[l];
+        fir_f32_t fir_ref;
+        fir_f32_t fir;
+        fill_random(coeffs, n);
+
+        dsps_fir_init_f32(&fir_ref, coeffs, delay_ref, n);
+        dsps_fir_f32_ansi(&fir_ref, x, y_ref, N_SAMPLES);
+        TEST_ASSERT_EQUAL(ESP_OK, dsps_fir_unrolled_init_f32(&fir, coeffs, delay, n, 1));
+        // Two blocks, the position must be kept between calls
+        dsps_fir_unrolled_f32(&fir, x, y, 100);
+        dsps_fir_unrolled_f32(&fir, x + 100, y + 100, N_SAMPLES - 100);
+        TEST_ASSERT_EQUAL(0, memcmp(y, y_ref, sizeof(y)));
+
+        dsps_fird_init_f32(&fir_ref, coeffs, delay_ref, n, DECIM);
+        int total_ref = dsps_fird_f32_ansi(&fir_ref, x, y_ref, N_SAMPLES / DECIM);
+        dsps_fir_unrolled_init_f32(&fir, coeffs, delay, n, DECIM);
+        int total = dsps_fird_unrolled_f32(&fir, x, y, N_SAMPLES / DECIM);
+        TEST_ASSERT_EQUAL(total_ref, total);
+        TEST_ASSERT_EQUAL(0, memcmp(y, y_ref, total * sizeof(float)));
+    }
+
+    // Moving average
+    dsps::MovingAverage<8> avg_f32;
+    dsps::MovingAverage<8, int16_t> avg_s16;
+    int16_t xs[16];
+    for (int i = 0; i < 16; i++) {
+        xs[i] = (int16_t)(i * 100 - 700);
+        float out_f32 = avg_f32.process((float)xs[i]);
+        int16_t out_s16 = avg_s16.process(xs[i]);
+        float sum = 0;
+        for (int k = (i >= 7) ? i - 7 : 0; k <= i; k++) {
+            sum += xs[k];
+        }
+        TEST_ASSERT_FLOAT_WITHIN(1e-3f, sum / 8, out_f32);
+        TEST_ASSERT_INT_WITHIN(1, (int)(sum / 8), out_s16);
+    }
+}
+
+template <int N>
+static void bench_fir(void)
+{
+    fir_f32_t fir;
+    fill_random(coeffs, N);
+    dsps_fir_init_f32(&fir, coeffs, delay_ref, N);
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    dsps_fir_f32_ansi(&fir, x, y_ref, N_SAMPLES);
+    unsigned int end_b = dsp_get_cpu_cycle_count();
+    float cycles_ansi = (float)(end_b - start_b) / N_SAMPLES;
+
+    dsps::Fir<N> filter(coeffs);
+    start_b = dsp_get_cpu_cycle_count();
+    filter.process(x, y, N_SAMPLES);
+    end_b = dsp_get_cpu_cycle_count();
+    float cycles_tmpl = (float)(end_b - start_b) / N_SAMPLES;
+
+    dsps_fir_unrolled_init_f32(&fir, coeffs, delay, N, 1);
+    start_b = dsp_get_cpu_cycle_count();
+    dsps_fir_unrolled_f32(&fir, x, y, N_SAMPLES);
+    end_b = dsp_get_cpu_cycle_count();
+    float cycles_shim = (float)(end_b - start_b) / N_SAMPLES;
+
+    ESP_LOGI(TAG, "%2i taps: dsps_fir_f32_ansi %f, Fir<N> %f, dsps_fir_unrolled_f32 %f cycles per sample", N, cycles_ansi, cycles_tmpl, cycles_shim);
+    float min_exec = 1;
+    float max_exec = cycles_ansi * 1.1f;
+    TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles_tmpl);
+}
+
+TEST_CASE("dsps_fir_unrolled_f32 benchmark", "[dsps]")
+{
+    fill_random(x, N_SAMPLES);
+    bench_fir<5>();
+    bench_fir<9>();
+    bench_fir<15>();
+    bench_fir<31>();
+}
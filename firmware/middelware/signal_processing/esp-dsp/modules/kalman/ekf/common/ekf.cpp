@@ -13,7 +13,9 @@
 // limitations under the License.
 
 #include "ekf.h"
+#include "mat_solve.h"
 #include <float.h>
+#include "esp_log.h"
 
 ekf::ekf(int x, int w) : NUMX(x),
     NUMW(w),
@@ -22,7 +24,19 @@ ekf::ekf(int x, int w) : NUMX(x),
     F(*new dspm::Mat(x, x)),
     G(*new dspm::Mat(x, w)),
     P(*new dspm::Mat(x, x)),
-    Q(*new dspm::Mat(w, w))
+    Q(*new dspm::Mat(w, w)),
+    joseph_form(false),
+
+    Xlast(x, 1),
+    K1(x, 1),
+    K2(x, 1),
+    K3(x, 1),
+    K4(x, 1),
+
+    Fw(x, x),
+    FPw(x, x),
+    Pw(x, x),
+    GQw(x, w)
 {
 
     this->P *= 0;
@@ -31,9 +45,12 @@ ekf::ekf(int x, int w) : NUMX(x),
     this->X.data[0] = 1; // direction to 0
     this->HP = new float[this->NUMX];
     this->Km = new float[this->NUMX];
+    this->Wh = new float[this->NUMX];
+    this->Hnz = new int[this->NUMX];
     for (size_t i = 0; i < this->NUMX; i++) {
         this->HP[i] = 0;
         this->Km[i] = 0;
+        this->Wh[i] = 0;
     }
 }
 
@@ -45,8 +62,10 @@ ekf::~ekf()
     delete &P;
     delete &Q;
 
-    delete this->HP;
-    delete this->Km;
+    delete[] this->HP;
+    delete[] this->Km;
+    delete[] this->Wh;
+    delete[] this->Hnz;
 }
 
 void ekf::Process(float *u, float dt)
@@ -61,30 +80,37 @@ void ekf::RungeKutta(dspm::Mat &x, float *U, float dt)
 
     float dt2 = dt / 2.0f;
 
-    dspm::Mat Xlast = x;          // make a working copy
-    dspm::Mat K1 = StateXdot(x, U); // k1 = f(x, u)
+    // The work matrices keep their buffers, the results of StateXdot() are moved to them
+    Xlast = x;                // make a working copy
+    K1 = StateXdot(x, U); // k1 = f(x, u)
     x = Xlast + (K1 * dt2);
 
-    dspm::Mat K2 = StateXdot(x, U); // k2 = f(x + 0.5*dT*k1, u)
+    K2 = StateXdot(x, U); // k2 = f(x + 0.5*dT*k1, u)
     x = Xlast + K2 * dt2;
 
-    dspm::Mat K3 = StateXdot(x, U); // k3 = f(x + 0.5*dT*k2, u)
+    K3 = StateXdot(x, U); // k3 = f(x + 0.5*dT*k2, u)
     x = Xlast + K3 * dt;
 
-    dspm::Mat K4 = StateXdot(x, U); // k4 = f(x + dT * k3, u)
+    K4 = StateXdot(x, U); // k4 = f(x + dT * k3, u)
 
     // Xnew = X + dT * (k1 + 2 * k2 + 2 * k3 + k4) / 6
     x = Xlast + (K1 + 2.0f * K2 + 2.0f * K3 + K4) * (dt / 6.0f);
 }
 
 dspm::Mat ekf::SkewSym4x4(float w[3])
+{
+    dspm::FixedMat<4, 4> result;
+    SkewSym4x4(w, result);
+    return result.toMat();
+}
+
+void ekf::SkewSym4x4(const float *w, dspm::FixedMat<4, 4> &result)
 {
     //={    0,  -w[0],  -w[1],  -w[2],
     //   w[0],      0,   w[2],  -w[1],
     //   w[1],  -w[2],      0,   w[0],
     //   w[2],   w[1],  -w[0],     0 };
 
-    dspm::Mat result(4, 4);
     result.data[0] = 0;
     result.data[1] = -w[0];
     result.data[2] = -w[1];
@@ -104,14 +130,17 @@ dspm::Mat ekf::SkewSym4x4(float w[3])
     result.data[13] = w[1];
     result.data[14] = -w[0];
     result.data[15] = 0;
-
-    return result;
 }
 
 dspm::Mat ekf::qProduct(float *q)
 {
-    dspm::Mat result(4, 4);
+    dspm::FixedMat<4, 4> result;
+    qProduct(q, result);
+    return result.toMat();
+}
 
+void ekf::qProduct(const float *q, dspm::FixedMat<4, 4> &result)
+{
     result.data[0] = q[0];
     result.data[1] = -q[1];
     result.data[2] = -q[2];
@@ -131,49 +160,107 @@ dspm::Mat ekf::qProduct(float *q)
     result.data[13] = -q[2];
     result.data[14] = q[1];
     result.data[15] = q[0];
-
-    return result;
 }
 
 void ekf::CovariancePrediction(float dt)
 {
-    dspm::Mat f = this->F * dt;
-
-    f = f + dspm::Mat::eye(this->NUMX);
+    // f = F*dt + I
+    dspm::mult_into(this->F, dt, this->Fw);
+    for (int i = 0; i < this->NUMX; i++) {
+        this->Fw(i, i) += 1;
+    }
 
-    dspm::Mat f_t = f.t();
-    this->P = ((f * this->P) * f_t) + (dt * dt) * ((G * Q) * G.t());
+    // P = f*P*f' + dt^2*G*Q*G', without transposed and temporary matrices,
+    // the products with symmetric results calculate only the upper triangle
+    dspm::mult_into(this->Fw, this->P, this->FPw);
+    dspm::mult_bt_sym_into(this->FPw, this->Fw, this->Pw);
+    dspm::mult_into(this->G, this->Q, this->GQw);
+    dspm::mult_bt_sym_into(this->GQw, this->G, this->FPw);
+    this->P = this->Pw + (dt * dt) * this->FPw;
 }
 
 void ekf::Update(dspm::Mat &H, float *measured, float *expected, float *R)
+{
+    UpdateSequential(H, measured, expected, R, 1);
+}
+
+void ekf::Update(dspm::Mat &H, float *measured, float *expected, dspm::Mat &R)
+{
+    if ((R.rows != H.rows) || (R.cols != H.rows)) {
+        ESP_LOGE("ekf", "Update Error: R must be %dx%d, not %dx%d", H.rows, H.rows, R.rows, R.cols);
+        return;
+    }
+    for (int i = 0; i < R.rows; i++) {
+        for (int j = 0; j < R.cols; j++) {
+            if ((i != j) && (R(i, j) != 0)) {
+                // Correlated measurements
+                UpdateBlock(H, measured, expected, R);
+                return;
+            }
+        }
+    }
+    UpdateSequential(H, measured, expected, R.data, R.stride + 1);
+}
+
+void ekf::UpdateSequential(dspm::Mat &H, float *measured, float *expected, const float *R, int R_step)
 {
     float HPHR, Error;
     dspm::Mat Y(measured, H.rows, 1);
     dspm::Mat Z(expected, H.rows, 1);
 
     for (int m = 0; m < H.rows; m++) {
+        // The zero elements of the Jacobian row are skipped
+        int nnz = 0;
+        for (int k = 0; k < this->NUMX; k++) {
+            if (H(m, k) != 0) {
+                Hnz[nnz++] = k;
+            }
+        }
         for (int j = 0; j < this->NUMX; j++) {
             // Find Hp = H*P
             HP[j] = 0;
         }
-        for (int k = 0; k < this->NUMX; k++) {
+        for (int s = 0; s < nnz; s++) {
+            int k = Hnz[s];
             for (int j = 0; j < this->NUMX; j++) {
                 // Find Hp = H*P
                 HP[j] += H(m, k) * P(k, j);
             }
         }
-        HPHR = R[m]; // Find  HPHR = H*P*H' + R
-        for (int k = 0; k < this->NUMX; k++) {
-            HPHR += HP[k] * H(m, k);
+        HPHR = R[m * R_step]; // Find  HPHR = H*P*H' + R
+        for (int s = 0; s < nnz; s++) {
+            HPHR += HP[Hnz[s]] * H(m, Hnz[s]);
         }
         float invHPHR = 1.0f / HPHR;
         for (int k = 0; k < this->NUMX; k++) {
             Km[k] = HP[k] * invHPHR; // find K = HP/HPHR
         }
-        for (int i = 0; i < this->NUMX; i++) {
-            // Find P(m)= P(m-1) + K*HP
-            for (int j = i; j < NUMX; j++) {
-                P(i, j) = P(j, i) = P(i, j) - Km[i] * HP[j];
+        if (this->joseph_form) {
+            // Joseph form for one measurement: P(m) = (I - K*h)*P*(I - K*h)' + r*K*K'
+            // = W - (W*h')*K' + r*K*K' with W = P - K*HP. W*h' is calculated from W, it is not
+            // replaced by r*K, so the rounding of K does not make P(m) indefinite.
+            for (int i = 0; i < this->NUMX; i++) {
+                float wh = 0;
+                for (int s = 0; s < nnz; s++) {
+                    int k = Hnz[s];
+                    wh += (P(i, k) - Km[i] * HP[k]) * H(m, k);
+                }
+                Wh[i] = wh;
+            }
+            float r = R[m * R_step];
+            for (int i = 0; i < this->NUMX; i++) {
+                // -(W*h')[i] + r*K[i], the factor of K[j]
+                float a = r * Km[i] - Wh[i];
+                for (int j = i; j < NUMX; j++) {
+                    P(i, j) = P(j, i) = P(i, j) - Km[i] * HP[j] + a * Km[j];
+                }
+            }
+        } else {
+            for (int i = 0; i < this->NUMX; i++) {
+                // Find P(m)= P(m-1) + K*HP
+                for (int j = i; j < NUMX; j++) {
+                    P(i, j) = P(j, i) = P(i, j) - Km[i] * HP[j];
+                }
             }
         }
 
@@ -185,6 +272,44 @@ void ekf::Update(dspm::Mat &H, float *measured, float *expected, float *R)
     }
 }
 
+void ekf::UpdateBlock(dspm::Mat &H, float *measured, float *expected, dspm::Mat &R)
+{
+    int m = H.rows;
+    dspm::Mat HP(m, this->NUMX);
+    dspm::mult_into(H, this->P, HP);
+    dspm::Mat S(m, m);
+    dspm::mult_bt_sym_into(HP, H, S); // S = H*P*H' + R
+    S += R;
+
+    // S*K' = H*P, S is positive definite: Cholesky factor of S replaces S
+    dspm::Mat Kt = HP;
+    if (!dspm::cholesky_factor(S)) {
+        ESP_LOGE("ekf", "UpdateBlock Error: H*P*H' + R is not positive definite");
+        return;
+    }
+    dspm::cholesky_solve(S, Kt);
+    dspm::Mat K = Kt.t();
+
+    if (this->joseph_form) {
+        // P = (I - K*H)*P*(I - K*H)' + K*R*K'
+        dspm::Mat A = dspm::Mat::eye(this->NUMX) - K * H;
+        dspm::Mat AP = A * this->P;
+        dspm::Mat KR = K * R;
+        dspm::mult_bt_sym_into(AP, A, this->Pw);
+        dspm::mult_bt_sym_into(KR, K, this->FPw);
+        this->P = this->Pw + this->FPw;
+    } else {
+        // P = P - K*H*P, K*H*P = K*(P*H')' is symmetric
+        dspm::Mat PHt = HP.t();
+        dspm::mult_bt_sym_into(K, PHt, this->Pw);
+        this->P -= this->Pw;
+    }
+
+    dspm::Mat Y(measured, m, 1);
+    dspm::Mat Z(expected, m, 1);
+    this->X += K * (Y - Z);
+}
+
 void ekf::UpdateRef(dspm::Mat &H, float *measured, float *expected, float *R)
 {
     dspm::Mat h_t = H.t();
@@ -201,17 +326,22 @@ void ekf::UpdateRef(dspm::Mat &H, float *measured, float *expected, float *R)
     dspm::Mat Y(measured, H.rows, 1);
     dspm::Mat Z(expected, H.rows, 1);
 
-    dspm::Mat Err = Y - Z;
-    this->X += (K * Err);
+    this->X += K * (Y - Z);
 }
 
 dspm::Mat ekf::quat2rotm(float q[4])
+{
+    dspm::FixedMat<3, 3> Rm;
+    quat2rotm(q, Rm);
+    return Rm.toMat();
+}
+
+void ekf::quat2rotm(const float q[4], dspm::FixedMat<3, 3> &Rm)
 {
     float q0 = q[0];
     float q1 = q[1];
     float q2 = q[2];
     float q3 = q[3];
-    dspm::Mat Rm(3, 3);
 
     Rm(0, 0) = q0 * q0 + q1 * q1 - q2 * q2 - q3 * q3;
     Rm(1, 0) = 2.0f * (q1 * q2 + q0 * q3);
@@ -222,8 +352,6 @@ dspm::Mat ekf::quat2rotm(float q[4])
     Rm(0, 2) = 2.0f * (q1 * q3 + q0 * q2);
     Rm(1, 2) = 2.0f * (q2 * q3 - q0 * q1);
     Rm(2, 2) = (q0 * q0 - q1 * q1 - q2 * q2 + q3 * q3);
-
-    return Rm;
 }
 
 dspm::Mat ekf::quat2eul(const float q[4])
@@ -365,51 +493,63 @@ dspm::Mat ekf::rotm2quat(dspm::Mat &m)
 
 dspm::Mat ekf::dFdq(dspm::Mat &vector, dspm::Mat &q)
 {
-    dspm::Mat result(3, 4);
-    result(0, 0) = q.data[0] * vector.data[0] - q.data[3] * vector.data[1] + q.data[2] * vector.data[2];
-    result(0, 1) = q.data[1] * vector.data[0] + q.data[2] * vector.data[1] + q.data[3] * vector.data[2];
-    result(0, 2) = -q.data[2] * vector.data[0] + q.data[1] * vector.data[1] + q.data[0] * vector.data[2];
-    result(0, 3) = -q.data[3] * vector.data[0] - q.data[0] * vector.data[1] + q.data[1] * vector.data[2];
-
-    result(1, 0) = q.data[3] * vector.data[0] + q.data[0] * vector.data[1] - q.data[1] * vector.data[2];
-    result(1, 1) = q.data[2] * vector.data[0] - q.data[1] * vector.data[1] - q.data[0] * vector.data[2];
-    result(1, 2) = q.data[1] * vector.data[0] + q.data[2] * vector.data[1] + q.data[3] * vector.data[2];
-    result(1, 3) = q.data[0] * vector.data[0] - q.data[3] * vector.data[1] + q.data[2] * vector.data[2];
-
-    result(2, 0) = -q.data[2] * vector.data[0] + q.data[1] * vector.data[1] + q.data[0] * vector.data[2];
-    result(2, 1) = q.data[3] * vector.data[0] + q.data[0] * vector.data[1] - q.data[1] * vector.data[2];
-    result(2, 2) = -q.data[0] * vector.data[0] + q.data[3] * vector.data[1] - q.data[2] * vector.data[2];
-    result(2, 3) = q.data[1] * vector.data[0] + q.data[2] * vector.data[1] + q.data[3] * vector.data[2];
+    dspm::FixedMat<3, 4> result;
+    dFdq(vector.data, q.data, result);
+    return result.toMat();
+}
+
+void ekf::dFdq(const float *vector, const float *q, dspm::FixedMat<3, 4> &result)
+{
+    result(0, 0) = q[0] * vector[0] - q[3] * vector[1] + q[2] * vector[2];
+    result(0, 1) = q[1] * vector[0] + q[2] * vector[1] + q[3] * vector[2];
+    result(0, 2) = -q[2] * vector[0] + q[1] * vector[1] + q[0] * vector[2];
+    result(0, 3) = -q[3] * vector[0] - q[0] * vector[1] + q[1] * vector[2];
+
+    result(1, 0) = q[3] * vector[0] + q[0] * vector[1] - q[1] * vector[2];
+    result(1, 1) = q[2] * vector[0] - q[1] * vector[1] - q[0] * vector[2];
+    result(1, 2) = q[1] * vector[0] + q[2] * vector[1] + q[3] * vector[2];
+    result(1, 3) = q[0] * vector[0] - q[3] * vector[1] + q[2] * vector[2];
+
+    result(2, 0) = -q[2] * vector[0] + q[1] * vector[1] + q[0] * vector[2];
+    result(2, 1) = q[3] * vector[0] + q[0] * vector[1] - q[1] * vector[2];
+    result(2, 2) = -q[0] * vector[0] + q[3] * vector[1] - q[2] * vector[2];
+    result(2, 3) = q[1] * vector[0] + q[2] * vector[1] + q[3] * vector[2];
 
     result *= 2;
-    return result;
 }
 
 dspm::Mat ekf::dFdq_inv(dspm::Mat &vector, dspm::Mat &q)
 {
-    dspm::Mat result(3, 4);
-    result(0, 0) = q.data[0] * vector.data[0] + q.data[3] * vector.data[1] - q.data[2] * vector.data[2];
-    result(0, 1) = q.data[1] * vector.data[0] + q.data[2] * vector.data[1] + q.data[3] * vector.data[2];
-    result(0, 2) = -q.data[2] * vector.data[0] + q.data[1] * vector.data[1] - q.data[0] * vector.data[2];
-    result(0, 3) = -q.data[3] * vector.data[0] + q.data[0] * vector.data[1] + q.data[1] * vector.data[2];
-
-    result(1, 0) = -q.data[3] * vector.data[0] + q.data[0] * vector.data[1] + q.data[1] * vector.data[2];
-    result(1, 1) = q.data[2] * vector.data[0] - q.data[1] * vector.data[1] + q.data[0] * vector.data[2];
-    result(1, 2) = q.data[1] * vector.data[0] + q.data[2] * vector.data[1] + q.data[3] * vector.data[2];
-    result(1, 3) = -q.data[0] * vector.data[0] - q.data[3] * vector.data[1] + q.data[2] * vector.data[2];
-
-    result(2, 0) = q.data[2] * vector.data[0] - q.data[1] * vector.data[1] + q.data[0] * vector.data[2];
-    result(2, 1) = q.data[3] * vector.data[0] - q.data[0] * vector.data[1] - q.data[1] * vector.data[2];
-    result(2, 2) = q.data[0] * vector.data[0] + q.data[3] * vector.data[1] - q.data[2] * vector.data[2];
-    result(2, 3) = q.data[1] * vector.data[0] + q.data[2] * vector.data[1] + q.data[3] * vector.data[2];
+    dspm::FixedMat<3, 4> result;
+    dFdq_inv(vector.data, q.data, result);
+    return result.toMat();
+}
+
+void ekf::dFdq_inv(const float *vector, const float *q, dspm::FixedMat<3, 4> &result)
+{
+    result(0, 0) = q[0] * vector[0] + q[3] * vector[1] - q[2] * vector[2];
+    result(0, 1) = q[1] * vector[0] + q[2] * vector[1] + q[3] * vector[2];
+    result(0, 2) = -q[2] * vector[0] + q[1] * vector[1] - q[0] * vector[2];
+    result(0, 3) = -q[3] * vector[0] + q[0] * vector[1] + q[1] * vector[2];
+
+    result(1, 0) = -q[3] * vector[0] + q[0] * vector[1] + q[1] * vector[2];
+    result(1, 1) = q[2] * vector[0] - q[1] * vector[1] + q[0] * vector[2];
+    result(1, 2) = q[1] * vector[0] + q[2] * vector[1] + q[3] * vector[2];
+    result(1, 3) = -q[0] * vector[0] - q[3] * vector[1] + q[2] * vector[2];
+
+    result(2, 0) = q[2] * vector[0] - q[1] * vector[1] + q[0] * vector[2];
+    result(2, 1) = q[3] * vector[0] - q[0] * vector[1] - q[1] * vector[2];
+    result(2, 2) = q[0] * vector[0] + q[3] * vector[1] - q[2] * vector[2];
+    result(2, 3) = q[1] * vector[0] + q[2] * vector[1] + q[3] * vector[2];
 
     result *= 2;
-    return result;
 }
 
 dspm::Mat ekf::StateXdot(dspm::Mat &x, float *u)
 {
     dspm::Mat U(u, this->G.cols, 1);
-    dspm::Mat Xdot = (this->F * x + this->G * U);
+    dspm::Mat Xdot(this->NUMX, 1);
+    dspm::mult_into(this->F, x, Xdot);
+    Xdot += this->G * U;
     return Xdot;
 }
@@ -21,6 +21,7 @@
 #include <math.h>
 #include <stdint.h>
 #include <mat.h>
+#include <mat_fixed.h>
 
 /**
  * The ekf is a base class for Extended Kalman Filter.
@@ -83,6 +84,7 @@ public:
 
     /**
     * Covariance matrix and state vector
+    * P is kept exactly symmetric, see dspm::sym_pack() for packed storage.
     */
     dspm::Mat &P;
 
@@ -91,6 +93,15 @@ public:
     */
     dspm::Mat &Q;
 
+    /**
+     * Use the Joseph form P = (I - K*H)*P*(I - K*H)' + K*R*K' in Update().
+     * It keeps P positive definite also with rounding errors in the gain K.
+     * UpdateSequential() applies it per measurement row h with variance r, in O(n^2):
+     * P = W - (W*h')*K' + r*K*K' with W = P - K*h*P, for about 2 times more
+     * multiplications in the update of P. UpdateBlock() uses the matrix form. Default: false.
+    */
+    bool joseph_form;
+
     /**
      * Runge-Kutta state update method.
      * The method calculates derivatives of input vector x and control measurements u
@@ -124,7 +135,7 @@ public:
 
     /**
      * Calculates covariance prediction matrux P.
-     * Update matrix P
+     * Update matrix P. Only the upper triangles of the symmetric products are calculated.
      * @param[in] dt: time interval from last update
      */
     virtual void CovariancePrediction(float dt);
@@ -139,6 +150,30 @@ public:
      * @param[in] R: measurement noise covariance values
      */
     virtual void Update(dspm::Mat &H, float *measured, float *expected, float *R);
+
+    /**
+     * Update of current state by measured values with measurement noise covariance matrix.
+     * A diagonal R is processed as sequential scalar updates, same as Update() with
+     * the vector of variances: O(n^2) per measurement and no matrix inverse.
+     * Otherwise the measurements are correlated and UpdateBlock() is used.
+     * @param[in] H: derivative matrix
+     * @param[in] measured: array of measured values
+     * @param[in] expected: array of expected values
+     * @param[in] R: measurement noise covariance matrix [m]x[m]
+     */
+    virtual void Update(dspm::Mat &H, float *measured, float *expected, dspm::Mat &R);
+
+    /**
+     * Update of current state by correlated measured values, all measurements at once.
+     * K = P*H'*inv(S), where S = H*P*H' + R, is found by solving S*K' = H*P with the
+     * Cholesky factor of S, the inverse of S is not calculated. If S is not positive
+     * definite, the state is not updated.
+     * @param[in] H: derivative matrix
+     * @param[in] measured: array of measured values
+     * @param[in] expected: array of expected values
+     * @param[in] R: measurement noise covariance matrix [m]x[m]
+     */
+    virtual void UpdateBlock(dspm::Mat &H, float *measured, float *expected, dspm::Mat &R);
     /**
      * Update of current state by measured values.
      * This method just as a reference for research purpose.
@@ -158,6 +193,15 @@ public:
      * Matrix for intermidieve calculations
     */
     float *Km;
+    /**
+     * Vector W*h' of the Joseph form in the sequential update
+    */
+    float *Wh;
+
+    /**
+     * Columns of the nonzero elements in the current row of H
+    */
+    int *Hnz;
 
 public:
     // Additional universal helper methods
@@ -170,6 +214,13 @@ public:
      */
     static dspm::Mat quat2rotm(float q[4]);
 
+    /**
+     * Convert quaternion to rotation matrix, without heap allocation.
+     * @param[in] q: quaternion
+     * @param[out] Rm: rotation matrix 3x3
+     */
+    static void quat2rotm(const float q[4], dspm::FixedMat<3, 3> &Rm);
+
     /**
      * Convert rotation matrix to quaternion.
      * @param[in] R: rotation matrix
@@ -215,6 +266,14 @@ public:
      */
     static dspm::Mat dFdq(dspm::Mat &vector, dspm::Mat &quat);
 
+    /**
+     * Df/dq:  Derivative of vector by quaternion, without heap allocation.
+     * @param[in] vector: input vector, 3 values
+     * @param[in] quat: quaternion, 4 values
+     * @param[out] result: derivative matrix 3x4
+     */
+    static void dFdq(const float *vector, const float *quat, dspm::FixedMat<3, 4> &result);
+
     /**
      * Df/dq: Derivative of vector by inverted quaternion.
      * @param[in] vector: input vector
@@ -225,6 +284,14 @@ public:
      */
     static dspm::Mat dFdq_inv(dspm::Mat &vector, dspm::Mat &quat);
 
+    /**
+     * Df/dq: Derivative of vector by inverted quaternion, without heap allocation.
+     * @param[in] vector: input vector, 3 values
+     * @param[in] quat: quaternion, 4 values
+     * @param[out] result: derivative matrix 3x4
+     */
+    static void dFdq_inv(const float *vector, const float *quat, dspm::FixedMat<3, 4> &result);
+
     /**
      * Make skew-symmetric matrix of vector.
      * @param[in] w: source vector
@@ -234,6 +301,13 @@ public:
      */
     static dspm::Mat SkewSym4x4(float *w);
 
+    /**
+     * Make skew-symmetric matrix of vector, without heap allocation.
+     * @param[in] w: source vector
+     * @param[out] result: skew-symmetric matrix 4x4
+     */
+    static void SkewSym4x4(const float *w, dspm::FixedMat<4, 4> &result);
+
     // q product
     // Rl = [q(1) - q(2) - q(3) - q(4); ...
     //      q(2)  q(1) - q(4)  q(3); ...
@@ -249,6 +323,41 @@ public:
      */
     static dspm::Mat qProduct(float *q);
 
+    /**
+     * Make right quaternion-product matrices, without heap allocation.
+     * @param[in] q: source quaternion
+     * @param[out] result: right quaternion-product matrix 4x4
+     */
+    static void qProduct(const float *q, dspm::FixedMat<4, 4> &result);
+
+
+protected:
+    /**
+     * Sequential scalar updates of Update().
+     * @param[in] H: derivative matrix
+     * @param[in] measured: array of measured values
+     * @param[in] expected: array of expected values
+     * @param[in] R: measurement noise variances, R[m*R_step] for measurement m
+     * @param[in] R_step: distance between the variances in R
+     */
+    void UpdateSequential(dspm::Mat &H, float *measured, float *expected, const float *R, int R_step);
+
+    /**
+     * Work matrices of RungeKutta(), allocated once in the constructor
+    */
+    dspm::Mat Xlast;
+    dspm::Mat K1;
+    dspm::Mat K2;
+    dspm::Mat K3;
+    dspm::Mat K4;
+
+    /**
+     * Work matrices of CovariancePrediction(), allocated once in the constructor
+    */
+    dspm::Mat Fw;
+    dspm::Mat FPw;
+    dspm::Mat Pw;
+    dspm::Mat GQw;
 };
 
 #endif // _ekf_h_
@@ -14,11 +14,45 @@
 
 #include "ekf_imu13states.h"
 
+// f = F*dt + I: quaternion rows 0..3 depend on the quaternion and the gyro bias, others are identity
+static const int f_row_start[14] = {0, 7, 14, 21, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37};
+static const int f_col_index[37] = {
+    0, 1, 2, 3, 4, 5, 6,
+    0, 1, 2, 3, 4, 5, 6,
+    0, 1, 2, 3, 4, 5, 6,
+    0, 1, 2, 3, 4, 5, 6,
+    4, 5, 6, 7, 8, 9, 10, 11, 12
+};
+const dspm::SparsePattern ekf_imu13states::f_pattern = {13, 13, f_row_start, f_col_index};
+
+// G: gyro noise of the quaternion, bias noise, rotated magnetometer and magnetometer noises
+static const int G_row_start[14] = {0, 3, 6, 9, 12, 13, 14, 15, 19, 23, 27, 29, 31, 33};
+static const int G_col_index[33] = {
+    0, 1, 2,
+    0, 1, 2,
+    0, 1, 2,
+    0, 1, 2,
+    3,
+    4,
+    5,
+    6, 7, 8, 12,
+    6, 7, 8, 13,
+    6, 7, 8, 14,
+    9, 15,
+    10, 16,
+    11, 17
+};
+const dspm::SparsePattern ekf_imu13states::G_pattern = {13, 18, G_row_start, G_col_index};
+
 ekf_imu13states::ekf_imu13states() : ekf(13, 18),
     mag0(3, 1),
     accel0(3, 1)
 {
     this->NUMU = 3;
+    this->covariance_decimation = 1;
+    this->Phi = dspm::FixedMat<4, 7>::eye();
+    this->Phi_steps = 0;
+    this->Phi_noise = 0;
 }
 
 ekf_imu13states::~ekf_imu13states()
@@ -50,21 +84,82 @@ void ekf_imu13states::Init()
     this->X.data[7] = 1; // Initial magnetometer vector
 }
 
+void ekf_imu13states::Process(float *u, float dt)
+{
+    this->LinearizeFG(this->X, u);
+
+    // Runge-Kutta step, the same calculations as ekf::RungeKutta()
+    float dt2 = dt / 2.0f;
+    dspm::FixedMat<13, 1> x0(this->X.data);
+    dspm::FixedMat<13, 1> k1 = StateXdot(x0, u);
+    dspm::FixedMat<13, 1> k2 = StateXdot(x0 + k1 * dt2, u);
+    dspm::FixedMat<13, 1> k3 = StateXdot(x0 + k2 * dt2, u);
+    dspm::FixedMat<13, 1> k4 = StateXdot(x0 + k3 * dt, u);
+    dspm::FixedMat<13, 1> x = x0 + (k1 + 2.0f * k2 + 2.0f * k3 + k4) * (dt / 6.0f);
+    memcpy(this->X.data, x.data, sizeof(x.data));
+
+    if (this->covariance_decimation <= 1) {
+        this->CovariancePrediction(dt);
+        return;
+    }
+
+    // Multi-rate mode: Phi = f*Phi, where f = [A B 0; 0 I 0; 0 0 I] keeps the structure of Phi
+    dspm::FixedMat<4, 4> A;
+    dspm::FixedMat<4, 3> B;
+    for (int i = 0; i < 4; i++) {
+        for (int k = 0; k < 4; k++) {
+            A(i, k) = this->F(i, k) * dt + ((i == k) ? 1 : 0);
+        }
+        for (int k = 0; k < 3; k++) {
+            B(i, k) = this->F(i, k + 4) * dt;
+        }
+    }
+    this->Phi.Copy<0, 4>(A * this->Phi.Get<0, 4, 4, 3>() + B);
+    this->Phi.Copy<0, 0>(A * this->Phi.Get<0, 0, 4, 4>());
+    this->Phi_steps++;
+    this->Phi_noise += dt * dt;
+    if (this->Phi_steps >= this->covariance_decimation) {
+        this->PropagateCovariance();
+    }
+}
+
+void ekf_imu13states::PropagateCovariance()
+{
+    if (this->Phi_steps == 0) {
+        return;
+    }
+    // Fw = Phi, the rows of the other states are identity
+    for (int i = 0; i < 13; i++) {
+        for (int s = f_pattern.row_start[i]; s < f_pattern.row_start[i + 1]; s++) {
+            int k = f_pattern.col_index[s];
+            Fw(i, k) = (i < 4) ? this->Phi(i, k) : 1;
+        }
+    }
+    this->TransitionCovariance(this->Phi_noise);
+
+    this->Phi = dspm::FixedMat<4, 7>::eye();
+    this->Phi_steps = 0;
+    this->Phi_noise = 0;
+}
+
 dspm::Mat ekf_imu13states::StateXdot(dspm::Mat &x, float *u)
 {
-    float wx = u[0] - x(4, 0); // subtract the biases on gyros
-    float wy = u[1] - x(5, 0);
-    float wz = u[2] - x(6, 0);
+    dspm::FixedMat<13, 1> xdot = StateXdot(dspm::FixedMat<13, 1>(x), u);
+    dspm::Mat Xdot(this->NUMX, 1);
+    Xdot.Copy(xdot.view(), 0, 0);
+    return Xdot;
+}
 
-    float w[] = {wx, wy, wz};
-    dspm::Mat q = dspm::Mat(x.data, 4, 1);
+dspm::FixedMat<13, 1> ekf_imu13states::StateXdot(const dspm::FixedMat<13, 1> &x, const float *u)
+{
+    float w[] = {u[0] - x(4, 0), u[1] - x(5, 0), u[2] - x(6, 0)}; // subtract the biases on gyros
 
     // qdot = Q * w
-    dspm::Mat Omega = 0.5 * SkewSym4x4(w);
-    dspm::Mat qdot = Omega * q;
-    dspm::Mat Xdot(this->NUMX, 1);
-    Xdot *= 0;
-    Xdot.Copy(qdot, 0, 0);
+    dspm::FixedMat<4, 4> Omega;
+    SkewSym4x4(w, Omega);
+    Omega *= 0.5f;
+    dspm::FixedMat<13, 1> Xdot;
+    Xdot.Copy<0, 0>(Omega * x.Get<0, 0, 4, 1>());
     // dwbias = 0
     // dMang_Ampl = 0
     // dMang_offset = 0
@@ -76,28 +171,62 @@ void ekf_imu13states::LinearizeFG(dspm::Mat &x, float *u)
     float w[3] = {(u[0] - x(4, 0)), (u[1] - x(5, 0)), (u[2] - x(6, 0))}; // subtract the biases on gyros
     // float w[3] = {u[0], u[1], u[2]}; // subtract the biases on gyros
 
-    this->F *= 0; // Initialize F and G matrixes.
-    this->G *= 0;
+    this->F.clear(); // Initialize F and G matrixes.
+    this->G.clear();
 
     // dqdot / dq - skey matrix
-    F.Copy(0.5 * ekf::SkewSym4x4(w), 0, 0);
+    dspm::FixedMat<4, 4> skew;
+    SkewSym4x4(w, skew);
+    skew *= 0.5f;
+    F.Copy(skew.view(), 0, 0);
 
     // dqdot/dvector
-    dspm::Mat dq = -0.5 * qProduct(x.data);
-    dspm::Mat dq_q = dq.Get(0, 4, 1, 3);
+    dspm::FixedMat<4, 4> dq;
+    qProduct(x.data, dq);
+    dq *= -0.5f;
+    dspm::FixedMat<4, 3> dq_q = dq.Get<0, 1, 4, 3>();
 
     // dqdot / dnw
-    G.Copy(dq_q, 0, 0);
+    G.Copy(dq_q.view(), 0, 0);
     // dqdot / dwbias
-    F.Copy(dq_q, 0, 4);
+    F.Copy(dq_q.view(), 0, 4);
+
+    dspm::FixedMat<3, 3> rotm;
+    quat2rotm(x.data, rotm); // Convert quat to rotation matrix
+    rotm *= -1.0f;
+
+    dspm::FixedMat<3, 3> eye = dspm::FixedMat<3, 3>::eye();
+    G.Copy(rotm.view(), 7, 6);
+    G.Copy(eye.view(), 4, 3);   // random noise wbias
+    G.Copy(eye.view(), 7, 12);  // random noise magnetometer amplitude
+    G.Copy(eye.view(), 10, 9);  // magnetometer offset constant
+    G.Copy(eye.view(), 10, 15); // random noise offset constant
+}
 
-    dspm::Mat rotm = -1 * this->quat2rotm(x.data); // Convert quat to rotation matrix
+void ekf_imu13states::CovariancePrediction(float dt)
+{
+    // f = F*dt + I, the elements outside of f_pattern stay 0
+    for (int i = 0; i < 13; i++) {
+        for (int s = f_pattern.row_start[i]; s < f_pattern.row_start[i + 1]; s++) {
+            int k = f_pattern.col_index[s];
+            Fw(i, k) = this->F(i, k) * dt + ((i == k) ? 1 : 0);
+        }
+    }
 
-    G.Copy(rotm, 7, 6);
-    G.Copy(dspm::Mat::eye(3), 4, 3);   // random noise wbias
-    G.Copy(dspm::Mat::eye(3), 7, 12);  // random noise magnetometer amplitude
-    G.Copy(dspm::Mat::eye(3), 10, 9);  // magnetometer offset constant
-    G.Copy(dspm::Mat::eye(3), 10, 15); // random noise offset constant
+    this->TransitionCovariance(dt * dt);
+}
+
+void ekf_imu13states::TransitionCovariance(float noise)
+{
+    // P = f*P*f' + dt^2*G*Q*G', f' and G' are not calculated,
+    // the products skip the zeros of f and G and calculate the upper triangles of the symmetric results
+    dspm::mult_sparse_into(f_pattern, Fw, this->P, FPw);
+    dspm::mult_bt_sparse_sym_into(FPw, f_pattern, Fw, Pw);
+    dspm::mult_sparse_into(G_pattern, this->G, this->Q, GQw);
+    dspm::mult_bt_sparse_sym_into(GQw, G_pattern, this->G, FPw);
+    for (int i = 0; i < 13 * 13; i++) {
+        this->P.data[i] = Pw.data[i] + noise * FPw.data[i];
+    }
 }
 
 void ekf_imu13states::Test()
@@ -186,22 +315,27 @@ void ekf_imu13states::TestFull(bool enable_att)
 
 void ekf_imu13states::UpdateRefMeasurement(float *accel_data, float *magn_data, float R[6])
 {
+    this->PropagateCovariance();
     dspm::Mat quat(this->X.data, 4, 1);
-    dspm::Mat H = 0 * dspm::Mat(6, this->NUMX);
-    dspm::Mat Re = this->quat2rotm(quat.data).t();
+    dspm::FixedMat<6, 13> H;
+    dspm::FixedMat<3, 3> Rm;
+    this->quat2rotm(quat.data, Rm);
+    dspm::FixedMat<3, 3> Re = Rm.t();
 
     // dAccel/dq
-    dspm::Mat dAccel_dq = ekf::dFdq_inv(this->accel0, quat);
-    H.Copy(dAccel_dq, 3, 0);
+    dspm::FixedMat<3, 4> dAccel_dq;
+    ekf::dFdq_inv(this->accel0.data, quat.data, dAccel_dq);
+    H.Copy<3, 0>(dAccel_dq);
 
     // dMagn/dq
-    dspm::Mat magn(&this->X.data[7], 3, 1);
-    dspm::Mat magn_offset(&this->X.data[10], 3, 1);
-    dspm::Mat dMagn_dq = ekf::dFdq_inv(magn, quat);
-    H.Copy(dMagn_dq, 0, 0);
+    dspm::FixedMat<3, 1> magn(&this->X.data[7]);
+    dspm::FixedMat<3, 1> magn_offset(&this->X.data[10]);
+    dspm::FixedMat<3, 4> dMagn_dq;
+    ekf::dFdq_inv(magn.data, quat.data, dMagn_dq);
+    H.Copy<0, 0>(dMagn_dq);
 
-    dspm::Mat expected_magn = Re * magn + magn_offset;
-    dspm::Mat expected_accel = Re * this->accel0;
+    dspm::FixedMat<3, 1> expected_magn = Re * magn + magn_offset;
+    dspm::FixedMat<3, 1> expected_accel = Re * dspm::FixedMat<3, 1>(this->accel0.data);
 
     float measured_data[6];
     float expected_data[6];
@@ -212,32 +346,38 @@ void ekf_imu13states::UpdateRefMeasurement(float *accel_data, float *magn_data,
         expected_data[i + 3] = expected_accel.data[i];
     }
 
-    this->Update(H, measured_data, expected_data, R);
+    dspm::Mat H_view = H.view();
+    this->Update(H_view, measured_data, expected_data, R);
     quat /= quat.norm();
 }
 
 void ekf_imu13states::UpdateRefMeasurementMagn(float *accel_data, float *magn_data, float R[6])
 {
+    this->PropagateCovariance();
     dspm::Mat quat(this->X.data, 4, 1);
-    dspm::Mat H = 0 * dspm::Mat(6, this->NUMX);
-    dspm::Mat Re = this->quat2rotm(quat.data).t();
+    dspm::FixedMat<6, 13> H;
+    dspm::FixedMat<3, 3> Rm;
+    this->quat2rotm(quat.data, Rm);
+    dspm::FixedMat<3, 3> Re = Rm.t();
 
     // We include these two line to update magnetometer initial state
-    H.Copy(Re, 0, 7);
-    H.Copy(dspm::Mat::eye(3), 0, 10);
+    H.Copy<0, 7>(Re);
+    H.Copy<0, 10>(dspm::FixedMat<3, 3>::eye());
 
     // dAccel/dq
-    dspm::Mat dAccel_dq = ekf::dFdq_inv(this->accel0, quat);
-    H.Copy(dAccel_dq, 3, 0);
+    dspm::FixedMat<3, 4> dAccel_dq;
+    ekf::dFdq_inv(this->accel0.data, quat.data, dAccel_dq);
+    H.Copy<3, 0>(dAccel_dq);
 
     // dMagn/dq
-    dspm::Mat magn(&this->X.data[7], 3, 1);
-    dspm::Mat magn_offset(&this->X.data[10], 3, 1);
-    dspm::Mat dMagn_dq = ekf::dFdq_inv(magn, quat);
-    H.Copy(dMagn_dq, 0, 0);
+    dspm::FixedMat<3, 1> magn(&this->X.data[7]);
+    dspm::FixedMat<3, 1> magn_offset(&this->X.data[10]);
+    dspm::FixedMat<3, 4> dMagn_dq;
+    ekf::dFdq_inv(magn.data, quat.data, dMagn_dq);
+    H.Copy<0, 0>(dMagn_dq);
 
-    dspm::Mat expected_magn = Re * magn + magn_offset;
-    dspm::Mat expected_accel = Re * this->accel0;
+    dspm::FixedMat<3, 1> expected_magn = Re * magn + magn_offset;
+    dspm::FixedMat<3, 1> expected_accel = Re * dspm::FixedMat<3, 1>(this->accel0.data);
 
     float measured_data[6];
     float expected_data[6];
@@ -248,32 +388,38 @@ void ekf_imu13states::UpdateRefMeasurementMagn(float *accel_data, float *magn_da
         expected_data[i + 3] = expected_accel.data[i];
     }
 
-    this->Update(H, measured_data, expected_data, R);
+    dspm::Mat H_view = H.view();
+    this->Update(H_view, measured_data, expected_data, R);
     quat /= quat.norm();
 }
 
 void ekf_imu13states::UpdateRefMeasurement(float *accel_data, float *magn_data, float *attitude, float R[10])
 {
+    this->PropagateCovariance();
     dspm::Mat quat(this->X.data, 4, 1);
-    dspm::Mat H = 0 * dspm::Mat(10, this->NUMX);
-    dspm::Mat Re = this->quat2rotm(quat.data).t();
+    dspm::FixedMat<10, 13> H;
+    dspm::FixedMat<3, 3> Rm;
+    this->quat2rotm(quat.data, Rm);
+    dspm::FixedMat<3, 3> Re = Rm.t();
 
-    H.Copy(Re, 0, 7);
-    H.Copy(dspm::Mat::eye(3), 0, 10);
+    H.Copy<0, 7>(Re);
+    H.Copy<0, 10>(dspm::FixedMat<3, 3>::eye());
     // dAccel/dq
-    dspm::Mat dAccel_dq = ekf::dFdq_inv(this->accel0, quat);
-    H.Copy(dAccel_dq, 3, 0);
+    dspm::FixedMat<3, 4> dAccel_dq;
+    ekf::dFdq_inv(this->accel0.data, quat.data, dAccel_dq);
+    H.Copy<3, 0>(dAccel_dq);
     // dMagn/dq
-    dspm::Mat magn(&this->X.data[7], 3, 1);
-    dspm::Mat magn_offset(&this->X.data[10], 3, 1);
-    dspm::Mat dMagn_dq = ekf::dFdq_inv(magn, quat);
-    H.Copy(dMagn_dq, 0, 0);
+    dspm::FixedMat<3, 1> magn(&this->X.data[7]);
+    dspm::FixedMat<3, 1> magn_offset(&this->X.data[10]);
+    dspm::FixedMat<3, 4> dMagn_dq;
+    ekf::dFdq_inv(magn.data, quat.data, dMagn_dq);
+    H.Copy<0, 0>(dMagn_dq);
 
     // dq/dq
-    H.Copy(dspm::Mat::eye(4), 6, 1);
+    H.Copy<6, 1>(dspm::FixedMat<4, 4>::eye());
 
-    dspm::Mat expected_magn = Re * magn + magn_offset;
-    dspm::Mat expected_accel = Re * this->accel0;
+    dspm::FixedMat<3, 1> expected_magn = Re * magn + magn_offset;
+    dspm::FixedMat<3, 1> expected_accel = Re * dspm::FixedMat<3, 1>(this->accel0.data);
 
     float measured_data[10];
     float expected_data[10];
@@ -288,6 +434,7 @@ void ekf_imu13states::UpdateRefMeasurement(float *accel_data, float *magn_data,
         expected_data[i + 6] = this->X.data[i];
     }
 
-    this->Update(H, measured_data, expected_data, R);
+    dspm::Mat H_view = H.view();
+    this->Update(H_view, measured_data, expected_data, R);
     quat /= quat.norm();
 }
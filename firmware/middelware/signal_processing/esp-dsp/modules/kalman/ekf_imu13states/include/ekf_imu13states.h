@@ -16,6 +16,7 @@
 #define _ekf_imu13states_H_
 
 #include "ekf.h"
+#include "mat_sparse.h"
 
 /**
 * @brief This class is used to process and calculate attitude from imu sensors.
@@ -34,10 +35,67 @@ public:
     virtual ~ekf_imu13states();
     virtual void Init();
 
+    /**
+     * Main processing method of the EKF.
+     * Same steps as ekf::Process(), the intermediate values use fixed size
+     * matrices, so the method does not use the heap.
+     * In multi-rate mode the covariance is propagated only every covariance_decimation calls,
+     * see PropagateCovariance().
+     *
+     * @param[in] u: - gyroscope values in radian per seconds (rad/sec)
+     * @param[in] dt: - time difference from the last call in seconds
+    */
+    virtual void Process(float *u, float dt);
+
     // Method calculates Xdot values depends on U
     // U - gyroscope values in radian per seconds (rad/sec)
-    virtual dspm::Mat StateXdot(dspm::Mat &x, float *u);
+    // Calls the fixed size StateXdot() below, which Process() uses directly: it is final,
+    // so the two can not differ.
+    virtual dspm::Mat StateXdot(dspm::Mat &x, float *u) final;
+    /**
+     * Derivative of state vector X, without heap allocation.
+     * The only implementation of the model, used by Process() and by StateXdot(dspm::Mat &, float *).
+     * @param[in] x: state vector
+     * @param[in] u: gyroscope values in radian per seconds (rad/sec)
+     * @return
+     *      - derivative of input vector x and u
+     */
+    dspm::FixedMat<13, 1> StateXdot(const dspm::FixedMat<13, 1> &x, const float *u);
     virtual void LinearizeFG(dspm::Mat &x, float *u);
+    /**
+     * Calculates covariance prediction matrix P = f*P*f' + dt^2*G*Q*G', where f = F*dt + I.
+     * Same as ekf::CovariancePrediction(), the products skip the zero elements of f and G,
+     * see f_pattern and G_pattern.
+     * @param[in] dt: time interval from last update
+     */
+    virtual void CovariancePrediction(float dt);
+
+    /**
+     * Sparsity pattern of f = F*dt + I, as set by LinearizeFG().
+     * Only the quaternion rows depend on the state: d(qdot)/dq and d(qdot)/dwbias.
+     */
+    static const dspm::SparsePattern f_pattern;
+    /**
+     * Sparsity pattern of G, as set by LinearizeFG().
+     */
+    static const dspm::SparsePattern G_pattern;
+
+    /**
+     * Multi-rate mode: amount of Process() calls per propagation of the covariance P.
+     * With 1 (default) P is propagated on every call. With N > 1 the state is integrated
+     * on every call, but the transitions f = F*dt + I are only multiplied together and P is
+     * propagated once by PropagateCovariance(): by the update methods, or after N calls.
+     * For example, gyro data at 1 kHz and reference measurements at 100 Hz: N = 10.
+     */
+    int covariance_decimation;
+
+    /**
+     * Propagate P with the transition accumulated by Process() in multi-rate mode:
+     * P = Phi*P*Phi' + sum(dt^2)*G*Q*G', where Phi is the product of the transitions since the
+     * last propagation and G is the Jacobian of the last step. Does nothing without pending transition.
+     * Called by the update methods, must be called before P is read directly.
+     */
+    void PropagateCovariance();
 
     /**
     *     Method for development and tests only.
@@ -93,6 +151,20 @@ public:
      */
     void UpdateRefMeasurement(float *accel_data, float *magn_data, float *attitude, float R[10]);
 
+protected:
+    /**
+     * P = Fw*P*Fw' + noise*G*Q*G', only the elements of Fw in f_pattern are used
+     * @param[in] noise: scale of the process noise
+     */
+    void TransitionCovariance(float noise);
+
+    /**
+     * Accumulated transition Phi of multi-rate mode. Phi has the structure of f: only the
+     * quaternion rows differ from the identity, so only their first 7 columns are kept.
+     */
+    dspm::FixedMat<4, 7> Phi;
+    int Phi_steps;      /*!< Amount of transitions in Phi*/
+    float Phi_noise;    /*!< Sum of dt^2 of the transitions in Phi*/
 };
 
 #endif // _ekf_imu13states_H_
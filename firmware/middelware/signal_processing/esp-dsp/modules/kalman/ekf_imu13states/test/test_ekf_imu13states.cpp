@@ -18,7 +18,9 @@
 #include "esp_log.h"
 
 #include "ekf_imu13states.h"
+#include "mat_solve.h"
 #include "esp_attr.h"
+#include "dsp_common.h"
 
 static const char *TAG = "ekf_imu13states";
 
@@ -58,3 +60,535 @@ TEST_CASE("ekf_imu13states functionality gyro and magn", "[dspm]")
     printf("Expected result = %i, calculated result = %i\n", 200, (int)(1000 * ekf13->X.data[5] + 0.5));
     printf("Expected result = %i, calculated result = %i\n", 300, (int)(1000 * ekf13->X.data[6] + 0.5));
 }
+
+TEST_CASE("ekf_imu13states fixed size step", "[dspm]")
+{
+    const float dt = 0.01f;
+    float gyro[3] = {0.1f, -0.2f, 0.3f};
+    float accel[3] = {0, 0.1f, 1};
+    float magn[3] = {1, 0.2f, 0};
+    float attitude[4] = {1, 0, 0, 0};
+    float R[10];
+    for (size_t i = 0; i < 10; i++) {
+        R[i] = 0.01f;
+    }
+
+    ekf_imu13states *ekf13 = new ekf_imu13states();
+    ekf_imu13states *ekf_ref = new ekf_imu13states();
+    ekf13->Init();
+    ekf_ref->Init();
+    for (int n = 0; n < 20; n++) {
+        ekf13->Process(gyro, dt);
+        ekf13->UpdateRefMeasurement(accel, magn, R);
+        ekf_ref->Process(gyro, dt);
+        ekf_ref->UpdateRefMeasurement(accel, magn, R);
+    }
+
+    // Process() with fixed size matrices against the generic steps of the base class
+    unsigned int allocs = dspm::Mat::alloc_count;
+    ekf13->Process(gyro, dt);
+    TEST_ASSERT_EQUAL(0, dspm::Mat::alloc_count - allocs);
+    // The generic steps allocate only the vectors returned by StateXdot()
+    allocs = dspm::Mat::alloc_count;
+    ekf_ref->LinearizeFG(ekf_ref->X, gyro);
+    ekf_ref->RungeKutta(ekf_ref->X, gyro, dt);
+    ekf_ref->ekf::CovariancePrediction(dt);
+    TEST_ASSERT_EQUAL(4, dspm::Mat::alloc_count - allocs);
+    for (int i = 0; i < 13; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-6, ekf_ref->X(i, 0), ekf13->X(i, 0));
+    }
+    for (int i = 0; i < 13 * 13; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-6, ekf_ref->P.data[i], ekf13->P.data[i]);
+    }
+
+    allocs = dspm::Mat::alloc_count;
+    ekf13->UpdateRefMeasurement(accel, magn, R);
+    ekf13->UpdateRefMeasurementMagn(accel, magn, R);
+    ekf13->UpdateRefMeasurement(accel, magn, attitude, R);
+    TEST_ASSERT_EQUAL(0, dspm::Mat::alloc_count - allocs);
+
+    delete ekf13;
+    delete ekf_ref;
+}
+
+// Covariance prediction with the full products, as before the symmetric kernels
+class ekf_imu13states_full: public ekf_imu13states {
+public:
+    virtual void CovariancePrediction(float dt)
+    {
+        dspm::mult_into(this->F, dt, Fw);
+        for (int i = 0; i < 13; i++) {
+            Fw(i, i) += 1;
+        }
+        dspm::FixedMult<13, 13, 13>::mult(Fw.data, this->P.data, FPw.data);
+        dspm::FixedMult<13, 13, 13>::mult_bt(FPw.data, Fw.data, Pw.data);
+        dspm::FixedMult<13, 18, 18>::mult(this->G.data, this->Q.data, GQw.data);
+        dspm::FixedMult<13, 18, 13>::mult_bt(GQw.data, this->G.data, FPw.data);
+        for (int i = 0; i < 13 * 13; i++) {
+            this->P.data[i] = Pw.data[i] + dt * dt * FPw.data[i];
+        }
+    }
+};
+
+// Covariance prediction with the dense symmetric products, as before the sparse kernels
+class ekf_imu13states_dense: public ekf_imu13states {
+public:
+    virtual void CovariancePrediction(float dt)
+    {
+        dspm::mult_into(this->F, dt, Fw);
+        for (int i = 0; i < 13; i++) {
+            Fw(i, i) += 1;
+        }
+        dspm::FixedMult<13, 13, 13>::mult(Fw.data, this->P.data, FPw.data);
+        dspm::FixedSymMult<13, 13>::mult_bt(FPw.data, Fw.data, Pw.data);
+        dspm::FixedMult<13, 18, 18>::mult(this->G.data, this->Q.data, GQw.data);
+        dspm::FixedSymMult<13, 18>::mult_bt(GQw.data, this->G.data, FPw.data);
+        for (int i = 0; i < 13 * 13; i++) {
+            this->P.data[i] = Pw.data[i] + dt * dt * FPw.data[i];
+        }
+    }
+};
+
+// Multiply-add operations of mult_sparse_into() and mult_bt_sparse_sym_into()
+static int sparse_macs(const dspm::SparsePattern &pattern, int cols)
+{
+    int result = pattern.nnz() * cols;
+    for (int j = 0; j < pattern.rows; j++) {
+        result += (j + 1) * (pattern.row_start[j + 1] - pattern.row_start[j]);
+    }
+    return result;
+}
+
+TEST_CASE("ekf_imu13states sparse prediction", "[dspm]")
+{
+    const int steps = 1000;
+    const float dt = 0.01f;
+    float accel[3] = {0, 0.1f, 1};
+    float magn[3] = {1, 0.2f, 0};
+    float R[6];
+    for (size_t i = 0; i < 6; i++) {
+        R[i] = 0.01f;
+    }
+
+    ekf_imu13states *ekf13 = new ekf_imu13states();
+    ekf_imu13states_dense *ekf_dense = new ekf_imu13states_dense();
+    ekf13->Init();
+    ekf_dense->Init();
+    dspm::Mat f(13, 13);
+
+    unsigned int cycles_sparse = 0;
+    unsigned int cycles_dense = 0;
+    for (int n = 0; n < steps; n++) {
+        float gyro[3] = {0.1f * sinf(n * 0.01f), -0.2f, 0.3f * cosf(n * 0.02f)};
+        ekf13->LinearizeFG(ekf13->X, gyro);
+        ekf_dense->LinearizeFG(ekf_dense->X, gyro);
+
+        // The patterns describe the Jacobians of all states
+        f = ekf13->F * dt + dspm::Mat::eye(13);
+        TEST_ASSERT_TRUE(ekf_imu13states::f_pattern.covers(f));
+        TEST_ASSERT_TRUE(ekf_imu13states::G_pattern.covers(ekf13->G));
+
+        unsigned int start_b = dsp_get_cpu_cycle_count();
+        ekf13->CovariancePrediction(dt);
+        cycles_sparse += dsp_get_cpu_cycle_count() - start_b;
+        start_b = dsp_get_cpu_cycle_count();
+        ekf_dense->CovariancePrediction(dt);
+        cycles_dense += dsp_get_cpu_cycle_count() - start_b;
+
+        // The sparse products skip only zeros, so the results are the same
+        for (int i = 0; i < 13 * 13; i++) {
+            TEST_ASSERT_EQUAL_FLOAT(ekf_dense->P.data[i], ekf13->P.data[i]);
+        }
+        ekf13->UpdateRefMeasurement(accel, magn, R);
+        ekf_dense->UpdateRefMeasurement(accel, magn, R);
+    }
+
+    int macs_dense = 13 * 13 * 13 + 13 * 14 / 2 * 13 + 13 * 18 * 18 + 13 * 14 / 2 * 18;
+    int macs_sparse = sparse_macs(ekf_imu13states::f_pattern, 13) + sparse_macs(ekf_imu13states::G_pattern, 18);
+    ESP_LOGI(TAG, "CovariancePrediction: dense %i multiply-adds, %f cycles; sparse %i multiply-adds, %f cycles",
+             macs_dense, (float)cycles_dense / steps, macs_sparse, (float)cycles_sparse / steps);
+    TEST_ASSERT_TRUE(macs_sparse < macs_dense / 4);
+
+    delete ekf13;
+    delete ekf_dense;
+}
+
+TEST_CASE("ekf_imu13states symmetric covariance", "[dspm]")
+{
+    const int steps = 5000;
+    const float dt = 0.01f;
+    float accel[3] = {0, 0.1f, 1};
+    float magn[3] = {1, 0.2f, 0};
+    float R[6];
+    for (size_t i = 0; i < 6; i++) {
+        R[i] = 0.01f;
+    }
+
+    ekf_imu13states *ekf13 = new ekf_imu13states();
+    ekf_imu13states *ekf_joseph = new ekf_imu13states();
+    ekf_imu13states_full *ekf_full = new ekf_imu13states_full();
+    ekf13->Init();
+    ekf_joseph->Init();
+    ekf_full->Init();
+    ekf_joseph->joseph_form = true;
+
+    unsigned int cycles_sym = 0;
+    unsigned int cycles_full = 0;
+    unsigned int cycles_update = 0;
+    unsigned int cycles_joseph = 0;
+    float error_full = 0;
+    for (int n = 0; n < steps; n++) {
+        float gyro[3] = {0.1f * sinf(n * 0.01f), -0.2f, 0.3f * cosf(n * 0.02f)};
+        ekf13->LinearizeFG(ekf13->X, gyro);
+        ekf_joseph->LinearizeFG(ekf_joseph->X, gyro);
+        ekf_full->LinearizeFG(ekf_full->X, gyro);
+
+        unsigned int start_b = dsp_get_cpu_cycle_count();
+        ekf13->CovariancePrediction(dt);
+        cycles_sym += dsp_get_cpu_cycle_count() - start_b;
+        start_b = dsp_get_cpu_cycle_count();
+        ekf_full->CovariancePrediction(dt);
+        cycles_full += dsp_get_cpu_cycle_count() - start_b;
+        ekf_joseph->CovariancePrediction(dt);
+        // Update() writes the upper triangle to both halves, the error is checked before
+        float error = dspm::sym_error(ekf_full->P);
+        if (error > error_full) {
+            error_full = error;
+        }
+        TEST_ASSERT_EQUAL_FLOAT(0, dspm::sym_error(ekf13->P));
+
+        start_b = dsp_get_cpu_cycle_count();
+        ekf13->UpdateRefMeasurement(accel, magn, R);
+        cycles_update += dsp_get_cpu_cycle_count() - start_b;
+        start_b = dsp_get_cpu_cycle_count();
+        ekf_joseph->UpdateRefMeasurement(accel, magn, R);
+        cycles_joseph += dsp_get_cpu_cycle_count() - start_b;
+        ekf_full->UpdateRefMeasurement(accel, magn, R);
+
+        TEST_ASSERT_EQUAL_FLOAT(0, dspm::sym_error(ekf13->P));
+        TEST_ASSERT_EQUAL_FLOAT(0, dspm::sym_error(ekf_joseph->P));
+    }
+    ESP_LOGI(TAG, "CovariancePrediction: symmetric %f, full %f cycles", (float)cycles_sym / steps, (float)cycles_full / steps);
+    ESP_LOGI(TAG, "UpdateRefMeasurement: %f, Joseph form %f cycles", (float)cycles_update / steps, (float)cycles_joseph / steps);
+    ESP_LOGI(TAG, "Max symmetry error of predicted P in %i steps: symmetric 0, full products %g", steps, error_full);
+
+    // The three filters estimate the same state, the diagonal of P stays positive
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-3, ekf_full->X(i, 0), ekf13->X(i, 0));
+        TEST_ASSERT_FLOAT_WITHIN(1e-3, ekf13->X(i, 0), ekf_joseph->X(i, 0));
+    }
+    for (int i = 0; i < 13; i++) {
+        TEST_ASSERT_TRUE(ekf13->P(i, i) > 0);
+        TEST_ASSERT_TRUE(ekf_joseph->P(i, i) > 0);
+    }
+
+    // Packed storage of P
+    float packed[13 * 14 / 2];
+    TEST_ASSERT_EQUAL(91, dspm::sym_packed_length(13));
+    dspm::sym_pack(ekf13->P, packed);
+    dspm::Mat P_unpacked(13, 13);
+    dspm::sym_unpack(packed, P_unpacked);
+    TEST_ASSERT_TRUE(P_unpacked == ekf13->P);
+
+    delete ekf13;
+    delete ekf_joseph;
+    delete ekf_full;
+}
+
+static void assert_same_filter(ekf *expected, ekf *actual, float tol, const char *message)
+{
+    for (int i = 0; i < expected->NUMX; i++) {
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(tol, expected->X(i, 0), actual->X(i, 0), message);
+    }
+    for (int i = 0; i < expected->NUMX * expected->NUMX; i++) {
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(tol, expected->P.data[i], actual->P.data[i], message);
+    }
+}
+
+// Positive definite: the Cholesky factorization succeeds
+static bool positive_definite(const dspm::Mat &P)
+{
+    dspm::Mat F = P;
+    return dspm::cholesky_factor(F);
+}
+
+TEST_CASE("ekf_imu13states Joseph form", "[dspm]")
+{
+    // Large, strongly correlated uncertainty and very precise measurements: K rounds to 1,
+    // the standard update cancels P to zero, the Joseph form keeps the variance r
+    dspm::Mat P0 = dspm::Mat::eye(13);
+    P0(0, 0) = P0(1, 1) = 1e6f;
+    P0(0, 1) = P0(1, 0) = 0.9999e6f;
+    dspm::Mat H(2, 13);
+    H(0, 0) = 1;
+    H(1, 1) = 1;
+    float R[2] = {1e-4f, 1e-4f};
+    float measured[2] = {0.1f, 0.2f};
+    float expected[2] = {0, 0};
+
+    ekf_imu13states *ekf13 = new ekf_imu13states();
+    ekf_imu13states *ekf_joseph = new ekf_imu13states();
+    ekf13->Init();
+    ekf_joseph->Init();
+    ekf_joseph->joseph_form = true;
+    ekf13->P = P0;
+    ekf_joseph->P = P0;
+    ekf13->Update(H, measured, expected, R);
+    ekf_joseph->Update(H, measured, expected, R);
+    ESP_LOGI(TAG, "P(0, 0) after the update: standard %g, Joseph form %g, exact %g",
+             ekf13->P(0, 0), ekf_joseph->P(0, 0), 1e-4 * 1e6 / (1e6 + 1e-4));
+    TEST_ASSERT_FALSE(positive_definite(ekf13->P));
+    TEST_ASSERT_TRUE(positive_definite(ekf_joseph->P));
+    TEST_ASSERT_EQUAL_FLOAT(0, dspm::sym_error(ekf_joseph->P));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 1e-4, ekf_joseph->P(0, 0));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 1e-4, ekf_joseph->P(1, 1));
+    // The gain and the state are the same
+    for (int i = 0; i < 13; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-6, ekf13->X(i, 0), ekf_joseph->X(i, 0));
+    }
+
+    delete ekf13;
+    delete ekf_joseph;
+}
+
+TEST_CASE("ekf_imu13states sequential and block update", "[dspm]")
+{
+    const float dt = 0.01f;
+    float gyro[3] = {0.1f, -0.2f, 0.3f};
+    float measured[6] = {0.1f, 0.2f, 0.9f, 0.8f, 0.1f, 0.3f};
+    float expected[6] = {0, 0.1f, 1, 1, 0.2f, 0};
+    float R[6] = {0.01f, 0.02f, 0.01f, 0.03f, 0.01f, 0.02f};
+    dspm::Mat R_mat(6, 6);
+    for (int i = 0; i < 6; i++) {
+        R_mat(i, i) = R[i];
+    }
+    dspm::Mat H(6, 13);
+    for (int i = 0; i < 6 * 13; i++) {
+        H.data[i] = (float)(rand() % 2001 - 1000) / 1000.0f;
+    }
+
+    const int filters = 4;
+    ekf_imu13states *ekf13[filters];
+    for (int f = 0; f < filters; f++) {
+        ekf13[f] = new ekf_imu13states();
+        ekf13[f]->Init();
+        for (int n = 0; n < 10; n++) {
+            ekf13[f]->Process(gyro, dt);
+        }
+    }
+
+    // Diagonal R: scalar updates, the block update and pinv() give the same result
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    ekf13[0]->Update(H, measured, expected, R);
+    unsigned int cycles_seq = dsp_get_cpu_cycle_count() - start_b;
+    ekf13[1]->Update(H, measured, expected, R_mat);
+    start_b = dsp_get_cpu_cycle_count();
+    ekf13[2]->UpdateBlock(H, measured, expected, R_mat);
+    unsigned int cycles_block = dsp_get_cpu_cycle_count() - start_b;
+    start_b = dsp_get_cpu_cycle_count();
+    ekf13[3]->UpdateRef(H, measured, expected, R);
+    unsigned int cycles_ref = dsp_get_cpu_cycle_count() - start_b;
+    ESP_LOGI(TAG, "Update of 6 measurements: sequential %u, block %u, pinv %u cycles", cycles_seq, cycles_block, cycles_ref);
+
+    assert_same_filter(ekf13[0], ekf13[1], 0, "Update with diagonal R matrix");
+    assert_same_filter(ekf13[0], ekf13[2], 1e-5, "UpdateBlock");
+    assert_same_filter(ekf13[0], ekf13[3], 1e-5, "UpdateRef");
+    TEST_ASSERT_EQUAL_FLOAT(0, dspm::sym_error(ekf13[2]->P));
+
+    // Correlated measurements fall back to the block update
+    R_mat(0, 1) = R_mat(1, 0) = 0.005f;
+    R_mat(3, 5) = R_mat(5, 3) = -0.01f;
+    dspm::Mat P0 = ekf13[0]->P;
+    dspm::Mat X0 = ekf13[0]->X;
+    ekf13[0]->Update(H, measured, expected, R_mat);
+    ekf13[1]->UpdateBlock(H, measured, expected, R_mat);
+    assert_same_filter(ekf13[1], ekf13[0], 0, "Update with correlated R");
+
+    // Reference: K = P*H'*pinv(H*P*H' + R)
+    dspm::Mat S = H * P0 * H.t() + R_mat;
+    dspm::Mat K = P0 * H.t() * S.pinv();
+    dspm::Mat Y(measured, 6, 1);
+    dspm::Mat Z(expected, 6, 1);
+    dspm::Mat X_ref = X0 + K * (Y - Z);
+    dspm::Mat P_ref = P0 - K * H * P0;
+    for (int i = 0; i < 13; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-5, X_ref(i, 0), ekf13[0]->X(i, 0));
+    }
+    for (int i = 0; i < 13 * 13; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-5, P_ref.data[i], ekf13[0]->P.data[i]);
+    }
+
+    // Joseph form of the block update
+    ekf13[2]->joseph_form = true;
+    ekf13[2]->P = P0;
+    ekf13[2]->X = X0;
+    ekf13[2]->UpdateBlock(H, measured, expected, R_mat);
+    assert_same_filter(ekf13[0], ekf13[2], 1e-5, "UpdateBlock Joseph form");
+
+    ESP_LOGI(TAG, "following is expected error message about R dimensions");
+    dspm::Mat R_wrong(5, 5);
+    ekf13[1]->Update(H, measured, expected, R_wrong);
+    assert_same_filter(ekf13[0], ekf13[1], 0, "Update with wrong R");
+
+    for (int f = 0; f < filters; f++) {
+        delete ekf13[f];
+    }
+}
+
+// Angle between two attitude quaternions in degrees
+static float attitude_error(const float *q1, const float *q2)
+{
+    float dot = fabsf(q1[0] * q2[0] + q1[1] * q2[1] + q1[2] * q2[2] + q1[3] * q2[3]);
+    dot /= sqrtf(q1[0] * q1[0] + q1[1] * q1[1] + q1[2] * q1[2] + q1[3] * q1[3]);
+    dot /= sqrtf(q2[0] * q2[0] + q2[1] * q2[1] + q2[2] * q2[2] + q2[3] * q2[3]);
+    return 2 * acosf(dot > 1 ? 1 : dot) * 180 / M_PI;
+}
+
+TEST_CASE("ekf_imu13states multi-rate", "[dspm]")
+{
+    // Gyro at 1 kHz with constant bias, accelerometer and magnetometer at 100 Hz
+    const int steps = 6000;
+    const int decimation = 10;
+    const float dt = 0.001f;
+    float gyro_bias[3] = {0.02f, -0.03f, 0.01f};
+    float accel0[3] = {0, 0, 1};
+    float magn0[3] = {1, 0, 0};
+    float R[6];
+    for (size_t i = 0; i < 6; i++) {
+        R[i] = 0.01f;
+    }
+
+    ekf_imu13states *ekf_single = new ekf_imu13states();
+    ekf_imu13states *ekf_multi = new ekf_imu13states();
+    ekf_single->Init();
+    ekf_multi->Init();
+    ekf_multi->covariance_decimation = decimation;
+
+    dspm::Mat Rm = dspm::Mat::eye(3);
+    dspm::Mat accel0_mat(accel0, 3, 1);
+    dspm::Mat magn0_mat(magn0, 3, 1);
+    unsigned int cycles_single = 0;
+    unsigned int cycles_multi = 0;
+    float error_single = 0;
+    float error_multi = 0;
+    for (int n = 0; n < steps; n++) {
+        float t = n * dt;
+        float w[3] = {0.8f * sinf(2 * t), 0.5f * cosf(3 * t), 0.3f * sinf(t)};
+        float w_dt[3] = {w[0] * dt, w[1] * dt, w[2] * dt};
+        Rm = Rm * ekf::eul2rotm(w_dt);
+        float gyro[3] = {w[0] + gyro_bias[0], w[1] + gyro_bias[1], w[2] + gyro_bias[2]};
+
+        unsigned int start_b = dsp_get_cpu_cycle_count();
+        ekf_single->Process(gyro, dt);
+        cycles_single += dsp_get_cpu_cycle_count() - start_b;
+        start_b = dsp_get_cpu_cycle_count();
+        ekf_multi->Process(gyro, dt);
+        cycles_multi += dsp_get_cpu_cycle_count() - start_b;
+
+        if ((n % decimation) == (decimation - 1)) {
+            dspm::Mat accel = Rm.t() * accel0_mat;
+            dspm::Mat magn = Rm.t() * magn0_mat;
+            start_b = dsp_get_cpu_cycle_count();
+            ekf_single->UpdateRefMeasurement(accel.data, magn.data, R);
+            cycles_single += dsp_get_cpu_cycle_count() - start_b;
+            start_b = dsp_get_cpu_cycle_count();
+            ekf_multi->UpdateRefMeasurement(accel.data, magn.data, R);
+            cycles_multi += dsp_get_cpu_cycle_count() - start_b;
+
+            if (n > steps / 2) {
+                dspm::Mat q = ekf::rotm2quat(Rm);
+                float error = attitude_error(q.data, ekf_single->X.data);
+                error_single = error > error_single ? error : error_single;
+                error = attitude_error(q.data, ekf_multi->X.data);
+                error_multi = error > error_multi ? error : error_multi;
+            }
+        }
+    }
+    ESP_LOGI(TAG, "Multi-rate 1/%i: %f cycles per gyro sample, single rate %f cycles", decimation,
+             (float)cycles_multi / steps, (float)cycles_single / steps);
+    ESP_LOGI(TAG, "Max attitude error: multi-rate %f deg, single rate %f deg", error_multi, error_single);
+    ESP_LOGI(TAG, "Gyro bias: multi-rate %f %f %f, single rate %f %f %f",
+             ekf_multi->X(4, 0), ekf_multi->X(5, 0), ekf_multi->X(6, 0),
+             ekf_single->X(4, 0), ekf_single->X(5, 0), ekf_single->X(6, 0));
+
+    TEST_ASSERT_TRUE(error_multi < error_single + 0.1f);
+    for (int i = 0; i < 7; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(2e-3, ekf_single->X(i, 0), ekf_multi->X(i, 0));
+    }
+    TEST_ASSERT_TRUE(cycles_multi < cycles_single);
+
+    // Decimation 1 is the single rate filter
+    ekf_multi->covariance_decimation = 1;
+    ekf_multi->X = ekf_single->X;
+    ekf_multi->P = ekf_single->P;
+    float gyro[3] = {0.1f, 0.2f, 0.3f};
+    ekf_single->Process(gyro, dt);
+    ekf_multi->Process(gyro, dt);
+    TEST_ASSERT_TRUE(ekf_single->P == ekf_multi->P);
+    TEST_ASSERT_TRUE(ekf_single->X == ekf_multi->X);
+
+    delete ekf_single;
+    delete ekf_multi;
+}
+
+TEST_CASE("ekf_imu13states arena step", "[dspm]")
+{
+    const float dt = 0.01f;
+    float gyro[3] = {0.1f, -0.2f, 0.3f};
+    float accel[3] = {0, 0.1f, 1};
+    float magn[3] = {1, 0.2f, 0};
+    float R[6];
+    for (size_t i = 0; i < 6; i++) {
+        R[i] = 0.01f;
+    }
+
+    ekf_imu13states *ekf13 = new ekf_imu13states();
+    ekf13->Init();
+    // The generic steps of the base class take their temporary matrices from the arena
+    dspm::MatArena arena(256);
+    for (int n = 0; n < 20; n++) {
+        dspm::MatArenaStep step(arena);
+        ekf13->LinearizeFG(ekf13->X, gyro);
+        ekf13->RungeKutta(ekf13->X, gyro, dt);
+        ekf13->ekf::CovariancePrediction(dt);
+        ekf13->UpdateRefMeasurement(accel, magn, R);
+    }
+    delete ekf13;
+
+    ESP_LOGI(TAG, "Arena peak %i values, %i heap allocations", arena.peak, arena.overflows);
+    TEST_ASSERT_EQUAL(0, arena.overflows);
+    TEST_ASSERT_EQUAL(0, arena.live);
+}
+
+TEST_CASE("ekf_imu13states benchmark", "[dspm]")
+{
+    const int steps = 100;
+    const float dt = 0.01f;
+    float gyro[3] = {0.1f, 0.2f, 0.3f};
+    float accel[3] = {0, 0, 1};
+    float magn[3] = {1, 0, 0};
+    float R[6];
+    for (size_t i = 0; i < 6; i++) {
+        R[i] = 0.01f;
+    }
+
+    ekf_imu13states *ekf13 = new ekf_imu13states();
+    ekf13->Init();
+    // First step outside of the measurement
+    ekf13->Process(gyro, dt);
+    ekf13->UpdateRefMeasurement(accel, magn, R);
+
+    unsigned int allocs = dspm::Mat::alloc_count;
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    for (int n = 0; n < steps; n++) {
+        ekf13->Process(gyro, dt);
+        ekf13->UpdateRefMeasurement(accel, magn, R);
+    }
+    unsigned int end_b = dsp_get_cpu_cycle_count();
+    allocs = dspm::Mat::alloc_count - allocs;
+    delete ekf13;
+
+    float cycles = (float)(end_b - start_b) / steps;
+    ESP_LOGI(TAG, "Process + UpdateRefMeasurement: %f cycles, %f heap allocations per step", cycles, (float)allocs / steps);
+    TEST_ASSERT_EQUAL(0, allocs);
+}
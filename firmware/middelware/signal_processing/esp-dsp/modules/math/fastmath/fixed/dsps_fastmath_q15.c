@@ -0,0 +1,128 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <math.h>
+#include "dsps_fastmath.h"
+
+// Polynomial coefficients are kept in Q28, so their rounding does not add to the Q15 error
+#define FM_Q28(c)   ((int32_t)((c) * 268435456.0 + (((c) >= 0) ? 0.5 : -0.5)))
+
+static inline int32_t fm_mul_q15(int32_t a, int32_t b)
+{
+    return (int32_t)(((int64_t)a * b + (1 << 14)) >> 15);
+}
+
+static inline int16_t fm_sat16(int32_t x)
+{
+    if (x > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (x < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)x;
+}
+
+// sin(pi/2 * z) for z in [0..1] (Q15), result in Q28
+static int32_t fm_sin_quarter(int32_t z)
+{
+    const int32_t z2 = fm_mul_q15(z, z);
+    int32_t p = FM_Q28(-0.004333095375);
+    p = FM_Q28(0.079434344771) + fm_mul_q15(p, z2);
+    p = FM_Q28(-0.645892849634) + fm_mul_q15(p, z2);
+    p = FM_Q28(1.570791011089) + fm_mul_q15(p, z2);
+    return fm_mul_q15(p, z);
+}
+
+int16_t dsps_fast_sin_q15(int16_t angle)
+{
+    const uint16_t u = (uint16_t)angle;
+    const int quadrant = u >> 14;
+    int32_t z = (u & 0x3fff) << 1;
+    if (quadrant & 1) {
+        z = 32768 - z;
+    }
+    int32_t s = (fm_sin_quarter(z) + (1 << 12)) >> 13;
+    return fm_sat16((quadrant & 2) ? -s : s);
+}
+
+int16_t dsps_fast_cos_q15(int16_t angle)
+{
+    return dsps_fast_sin_q15((int16_t)(angle + 16384));
+}
+
+int16_t dsps_fast_atan2_q15(int16_t y, int16_t x)
+{
+    const int32_t ax = (x < 0) ? -x : x;
+    const int32_t ay = (y < 0) ? -y : y;
+    if ((ax | ay) == 0) {
+        return 0;
+    }
+    const int32_t mn = (ax < ay) ? ax : ay;
+    const int32_t mx = (ax < ay) ? ay : ax;
+    const int32_t r = (mn << 15) / mx;
+    const int32_t r2 = fm_mul_q15(r, r);
+
+    // atan(r)/pi for r in [0..1], so the result is a binary angle
+    int32_t p = FM_Q28(0.020845113381 / M_PI);
+    p = FM_Q28(-0.085156349865 / M_PI) + fm_mul_q15(p, r2);
+    p = FM_Q28(0.180159294821 / M_PI) + fm_mul_q15(p, r2);
+    p = FM_Q28(-0.330304785975 / M_PI) + fm_mul_q15(p, r2);
+    p = FM_Q28(0.999866329566 / M_PI) + fm_mul_q15(p, r2);
+    int32_t a = (fm_mul_q15(p, r) + (1 << 12)) >> 13;
+
+    if (ay > ax) {
+        a = 16384 - a;
+    }
+    if (x < 0) {
+        a = 32768 - a;
+    }
+    return (int16_t)((y < 0) ? -a : a);
+}
+
+int16_t dsps_fast_sqrt_q15(int16_t x)
+{
+    if (x <= 0) {
+        return 0;
+    }
+    return fm_sat16((int32_t)(((uint32_t)dsps_fast_sqrt_q31((int32_t)x << 16) + (1u << 15)) >> 16));
+}
+
+int16_t dsps_fast_log2_q15(int16_t x)
+{
+    if (x <= 0) {
+        return INT16_MIN;
+    }
+    // x = (1 + f) * 2^-s
+    const int s = __builtin_clz((uint32_t)x) - 16;
+    const int32_t f = (((int32_t)x << (s - 1)) - (1 << 14)) << 1;
+    int32_t p = FM_Q28(-0.084768696733);
+    p = FM_Q28(0.325595777765) + fm_mul_q15(p, f);
+    p = FM_Q28(-0.679944109294) + fm_mul_q15(p, f);
+    p = FM_Q28(1.439014690989) + fm_mul_q15(p, f);
+    p = fm_mul_q15(p, f);
+    return (int16_t)(((p + (1 << 16)) >> 17) - (s << 11));
+}
+
+int16_t dsps_fast_exp2_q15(int16_t x)
+{
+    if (x >= 0) {
+        return INT16_MAX;
+    }
+    // x = k + f, 2^x = 2^(f - 1) * 2^(k + 1)
+    const int32_t k = x >> 11;
+    const int32_t f = (x & 0x7ff) << 4;
+    int32_t p = FM_Q28(0.013534167616 / 2);
+    p = FM_Q28(0.052011461188 / 2) + fm_mul_q15(p, f);
+    p = FM_Q28(0.241442756550 / 2) + fm_mul_q15(p, f);
+    p = FM_Q28(0.693003834533 / 2) + fm_mul_q15(p, f);
+    p = FM_Q28(1.000002593369 / 2) + fm_mul_q15(p, f);
+    const int shift = 13 - k - 1;
+    if (shift >= 30) {
+        return 0;
+    }
+    return (int16_t)((p + (1 << (shift - 1))) >> shift);
+}
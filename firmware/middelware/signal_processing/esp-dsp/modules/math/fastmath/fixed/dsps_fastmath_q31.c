@@ -0,0 +1,233 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "dsps_fastmath.h"
+
+#define FM_CORDIC_ITER  30
+#define FM_SINCOS_ITER  18          // the residual angle, below 2^-17 rad, is applied to first order
+#define FM_CORDIC_K     652032874   // prod(1/sqrt(1 + 2^-2i)), Q30, the same for 18 and 30 iterations
+#define FM_PI_Q29       1686629713  // pi, Q29
+#define FM_Q(c, q)      ((int32_t)((c) * (double)(1u << (q)) + (((c) >= 0) ? 0.5 : -0.5)))
+
+// atan(2^-i)/pi as binary angles with 8 guard bits (2^39 = pi), so the table rounding does not add up
+#define FM_ANGLE_GUARD  8
+static const int64_t fm_cordic_atan[FM_CORDIC_ITER] = {
+    137438953472LL, 81134951838LL, 42869480287LL, 21761217566LL,
+    10922836750LL, 5466743129LL, 2734038620LL, 1367102738LL,
+    683561799LL, 341782203LL, 170891265LL, 85445653LL,
+    42722829LL, 21361415LL, 10680707LL, 5340354LL,
+    2670177LL, 1335088LL, 667544LL, 333772LL,
+    166886LL, 83443LL, 41722LL, 20861LL,
+    10430LL, 5215LL, 2608LL, 1304LL,
+    652LL, 326LL,
+};
+
+static inline int32_t fm_mul_q31(int32_t a, int32_t b)
+{
+    return (int32_t)(((int64_t)a * b + (1 << 30)) >> 31);
+}
+
+// Arithmetic shift right with rounding, so the CORDIC iterations do not accumulate a bias
+static inline int32_t fm_shr(int32_t x, int i)
+{
+    return (x + ((1 << i) >> 1)) >> i;
+}
+
+static inline int32_t fm_q30_to_q31(int32_t x)
+{
+    if (x >= (1 << 30)) {
+        return INT32_MAX;
+    }
+    if (x < -(1 << 30)) {
+        return INT32_MIN;
+    }
+    return x * 2;
+}
+
+void dsps_fast_sincos_q31(int32_t angle, int32_t *sin, int32_t *cos)
+{
+    // CORDIC converges for |angle| < 99 degrees: rotate the other half turn by pi
+    int negate = 0;
+    if ((angle > (1 << 30)) || (angle < -(1 << 30))) {
+        angle = (int32_t)((uint32_t)angle + 0x80000000u);
+        negate = 1;
+    }
+    int32_t x = FM_CORDIC_K;
+    int32_t y = 0;
+    int64_t z = (int64_t)angle << FM_ANGLE_GUARD;
+    for (int i = 0; i < FM_SINCOS_ITER; i++) {
+        const int32_t dx = fm_shr(y, i);
+        const int32_t dy = fm_shr(x, i);
+        if (z >= 0) {
+            x -= dx;
+            y += dy;
+            z -= fm_cordic_atan[i];
+        } else {
+            x += dx;
+            y -= dy;
+            z += fm_cordic_atan[i];
+        }
+    }
+    // Remaining rotation by z: sin(a + z) = sin(a) + z*cos(a), with z in radians, Q31
+    const int32_t zr = (int32_t)((z * FM_PI_Q29) >> (29 + FM_ANGLE_GUARD));
+    const int32_t xr = x - fm_mul_q31(y, zr);
+    y += fm_mul_q31(x, zr);
+    x = xr;
+    if (negate) {
+        x = -x;
+        y = -y;
+    }
+    if (sin != NULL) {
+        *sin = fm_q30_to_q31(y);
+    }
+    if (cos != NULL) {
+        *cos = fm_q30_to_q31(x);
+    }
+}
+
+int32_t dsps_fast_atan2_q31(int32_t y, int32_t x)
+{
+    if ((x | y) == 0) {
+        return 0;
+    }
+    // Normalize the larger component to 29 bits: room for the CORDIC gain and the sqrt(2) of the diagonal
+    const uint32_t ax = (x < 0) ? -(uint32_t)x : (uint32_t)x;
+    const uint32_t ay = (y < 0) ? -(uint32_t)y : (uint32_t)y;
+    const int shift = __builtin_clz(ax | ay) - 3;
+    int32_t xs, ys;
+    if (shift >= 0) {
+        xs = (int32_t)((uint32_t)x << shift);
+        ys = (int32_t)((uint32_t)y << shift);
+    } else {
+        xs = x >> -shift;
+        ys = y >> -shift;
+    }
+    int64_t z = 0;
+    if (xs < 0) {
+        xs = -xs;
+        ys = -ys;
+        z = (int64_t)1 << (31 + FM_ANGLE_GUARD);
+    }
+    for (int i = 0; i < FM_CORDIC_ITER; i++) {
+        const int32_t dx = fm_shr(ys, i);
+        const int32_t dy = fm_shr(xs, i);
+        if (ys >= 0) {
+            xs += dx;
+            ys -= dy;
+            z += fm_cordic_atan[i];
+        } else {
+            xs -= dx;
+            ys += dy;
+            z -= fm_cordic_atan[i];
+        }
+    }
+    return (int32_t)(uint32_t)((z + (1 << (FM_ANGLE_GUARD - 1))) >> FM_ANGLE_GUARD);
+}
+
+// 1/sqrt(m) for m in [0.25..1) (Q31), result in Q30. Quadratic estimate (2.4%) and three Newton iterations.
+static uint32_t fm_rsqrt_core(uint32_t m)
+{
+    int32_t p = FM_Q(1.638564743957, 28);
+    p = FM_Q(-3.285352682874, 28) + fm_mul_q31(p, (int32_t)m);
+    p = FM_Q(2.670834366617, 28) + fm_mul_q31(p, (int32_t)m);
+    uint32_t y = (uint32_t)p << 2;
+    for (int i = 0; i < 3; i++) {
+        const uint32_t e = (uint32_t)(((uint64_t)m * y) >> 31);     // sqrt(m), Q30
+        const uint32_t e2 = (uint32_t)(((uint64_t)e * y) >> 30);    // m * y^2, Q30
+        y = (uint32_t)(((uint64_t)y * ((3u << 30) - e2)) >> 31);
+    }
+    return y;
+}
+
+int32_t dsps_fast_sqrt_q31(int32_t x)
+{
+    if (x <= 0) {
+        return 0;
+    }
+    // x = m * 2^-e, e even, m in [0.25..1)
+    const int e = (__builtin_clz((uint32_t)x) - 1) & ~1;
+    const uint32_t m = (uint32_t)x << e;
+    const uint32_t y = fm_rsqrt_core(m);
+    int64_t r = (int64_t)(((uint64_t)m * y) >> 30);
+    // The product keeps the few LSB error of y: one more Newton step on sqrt(m) itself,
+    // r += (m - r^2) / (2 * r), with the residual in Q62 and 1/r from y, rounded
+    const int64_t d = ((int64_t)m << 31) - r * r;
+    r += ((d >> 8) * (int64_t)y + (1ll << 53)) >> 54;
+    const int shift = e / 2;
+    if (shift > 0) {
+        r = (r + (1 << (shift - 1))) >> shift;
+    }
+    return (r > INT32_MAX) ? INT32_MAX : (int32_t)r;
+}
+
+int32_t dsps_fast_rsqrt_q30(int32_t x)
+{
+    if (x <= 0) {
+        return INT32_MAX;
+    }
+    // m = x * 2^e in [0.25..1) as Q31 with e odd, then 1/sqrt(x) = 1/sqrt(m) * 2^((e - 1)/2)
+    const int s = __builtin_clz((uint32_t)x);
+    int e = ((s - 1) & 1) ? s - 1 : s - 2;
+    const uint32_t m = (e >= 0) ? (uint32_t)x << e : (uint32_t)x >> 1;
+    uint32_t y = fm_rsqrt_core(m);
+    const int shift = (e - 1) / 2;
+    if (shift < 0) {
+        y = (y + 1) >> 1;
+    } else if (shift > 0) {
+        if (y > ((uint32_t)INT32_MAX >> shift)) {
+            return INT32_MAX;
+        }
+        y <<= shift;
+    }
+    return (y > INT32_MAX) ? INT32_MAX : (int32_t)y;
+}
+
+int32_t dsps_fast_log2_q31(int32_t x)
+{
+    if (x <= 0) {
+        return INT32_MIN;
+    }
+    // x = (1 + f) * 2^-s
+    const int s = __builtin_clz((uint32_t)x);
+    const uint32_t f = (((uint32_t)x << (s - 1)) - (1u << 30)) << 1;
+    int32_t p = FM_Q(0.005670434734, 30);
+    p = FM_Q(-0.034416072376, 30) + (int32_t)(((int64_t)p * f + (1 << 30)) >> 31);
+    p = FM_Q(0.098225301797, 30) + (int32_t)(((int64_t)p * f + (1 << 30)) >> 31);
+    p = FM_Q(-0.183090658226, 30) + (int32_t)(((int64_t)p * f + (1 << 30)) >> 31);
+    p = FM_Q(0.267905754545, 30) + (int32_t)(((int64_t)p * f + (1 << 30)) >> 31);
+    p = FM_Q(-0.355951610248, 30) + (int32_t)(((int64_t)p * f + (1 << 30)) >> 31);
+    p = FM_Q(0.480268384722, 30) + (int32_t)(((int64_t)p * f + (1 << 30)) >> 31);
+    p = FM_Q(-0.721305599328, 30) + (int32_t)(((int64_t)p * f + (1 << 30)) >> 31);
+    p = FM_Q(1.442694071473, 30) + (int32_t)(((int64_t)p * f + (1 << 30)) >> 31);
+    p = (int32_t)(((int64_t)p * f + (1 << 30)) >> 31);
+    return ((p + 8) >> 4) - (s << 26);
+}
+
+int32_t dsps_fast_exp2_q31(int32_t x)
+{
+    if (x >= 0) {
+        return INT32_MAX;
+    }
+    // x = k + f, 2^x = 2^(f - 1) * 2^(k + 1)
+    const int32_t k = x >> 26;
+    const uint32_t f = (uint32_t)(x - (k << 26)) << 5;
+    int32_t p = FM_Q(0.000021498756 / 2, 31);
+    p = FM_Q(0.000143523166 / 2, 31) + (int32_t)(((int64_t)p * f + (1 << 30)) >> 31);
+    p = FM_Q(0.001342263445 / 2, 31) + (int32_t)(((int64_t)p * f + (1 << 30)) >> 31);
+    p = FM_Q(0.009614017038 / 2, 31) + (int32_t)(((int64_t)p * f + (1 << 30)) >> 31);
+    p = FM_Q(0.055505126850 / 2, 31) + (int32_t)(((int64_t)p * f + (1 << 30)) >> 31);
+    p = FM_Q(0.240226384620 / 2, 31) + (int32_t)(((int64_t)p * f + (1 << 30)) >> 31);
+    p = FM_Q(0.693147186084 / 2, 31) + (int32_t)(((int64_t)p * f + (1 << 30)) >> 31);
+    p = FM_Q(0.999999999960 / 2, 31) + (int32_t)(((int64_t)p * f + (1 << 30)) >> 31);
+    const int shift = -k - 1;
+    if (shift >= 32) {
+        return 0;
+    }
+    if (shift == 0) {
+        return p;
+    }
+    return (int32_t)(((int64_t)p + (1 << (shift - 1))) >> shift);
+}
@@ -0,0 +1,130 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <math.h>
+#include "dsps_fastmath.h"
+
+#define FM_2_PI     0.636619772f            // 2/pi
+#define FM_PI_2_1   1.5703125f                  // pi/2 in three parts, k*FM_PI_2_1 and k*FM_PI_2_2
+#define FM_PI_2_2   4.837512969970703125e-4f    // are exact for |k| < 2^12
+#define FM_PI_2_3   7.54978995489188216e-8f
+
+typedef union {
+    float f;
+    uint32_t i;
+} fm_bits_t;
+
+static inline float fm_sin_poly(float r)
+{
+    const float r2 = r * r;
+    return r * (0.999999996764f + r2 * (-0.166666502273f + r2 * (0.008332016551f + r2 * -0.000195018310f)));
+}
+
+static inline float fm_cos_poly(float r)
+{
+    const float r2 = r * r;
+    return 0.999999972444f + r2 * (-0.499998567223f + r2 * (0.041655027742f + r2 * -0.001358591646f));
+}
+
+// x = k*pi/2 + r, |r| <= pi/4, returns k
+static inline int32_t fm_reduce(float x, float *r)
+{
+    const float q = x * FM_2_PI;
+    int32_t k = (int32_t)q;
+    k += (q - (float)k >= 0.5f) ? 1 : 0;
+    k -= (q - (float)k < -0.5f) ? 1 : 0;
+    *r = ((x - (float)k * FM_PI_2_1) - (float)k * FM_PI_2_2) - (float)k * FM_PI_2_3;
+    return k;
+}
+
+float dsps_fast_sinf(float x)
+{
+    float r;
+    const int32_t k = fm_reduce(x, &r);
+    const float v = (k & 1) ? fm_cos_poly(r) : fm_sin_poly(r);
+    return (k & 2) ? -v : v;
+}
+
+float dsps_fast_cosf(float x)
+{
+    float r;
+    const int32_t k = fm_reduce(x, &r) + 1;
+    const float v = (k & 1) ? fm_cos_poly(r) : fm_sin_poly(r);
+    return (k & 2) ? -v : v;
+}
+
+float dsps_fast_atan2f(float y, float x)
+{
+    const float ax = fabsf(x);
+    const float ay = fabsf(y);
+    if ((ax == 0) && (ay == 0)) {
+        return 0;
+    }
+    const int swap = ay > ax;
+    const float r = swap ? ax / ay : ay / ax;
+    const float r2 = r * r;
+    float a = r * (0.999999335580f + r2 * (-0.333298607875f + r2 * (0.199465656746f + r2 * (-0.139086296286f +
+                   r2 * (0.096421974660f + r2 * (-0.055912328051f + r2 * (0.021862958459f + r2 * -0.004054567312f)))))));
+    if (swap) {
+        a = (float)M_PI_2 - a;
+    }
+    if (x < 0) {
+        a = (float)M_PI - a;
+    }
+    return (y < 0) ? -a : a;
+}
+
+float dsps_fast_rsqrtf(float x)
+{
+    fm_bits_t v = {.f = x};
+    const float half = 0.5f * x;
+    v.i = 0x5f375a86 - (v.i >> 1);
+    v.f = v.f * (1.5f - half * v.f * v.f);
+    v.f = v.f * (1.5f - half * v.f * v.f);
+    return v.f;
+}
+
+float dsps_fast_sqrtf(float x)
+{
+    if (x <= 0) {
+        return 0;
+    }
+    const float y = dsps_fast_rsqrtf(x);
+    const float s = x * y;
+    // One Newton step of the square root itself, y/2 approximates 1/(2s)
+    return s + 0.5f * y * (x - s * s);
+}
+
+float dsps_fast_log2f(float x)
+{
+    if (x <= 0) {
+        return -INFINITY;
+    }
+    fm_bits_t v = {.f = x};
+    const int32_t e = (int32_t)((v.i >> 23) & 0xff) - 127;
+    v.i = (v.i & 0x007fffff) | 0x3f800000;
+    const float f = v.f - 1.0f;
+    const float p = f * (1.442689881160f + f * (-0.721165805575f + f * (0.478683696659f + f * (-0.347301075102f +
+                         f * (0.241864752537f + f * (-0.137521317669f + f * (0.052058979660f + f * -0.009309157979f)))))));
+    return (float)e + p;
+}
+
+float dsps_fast_exp2f(float x)
+{
+    if (x < -126.0f) {
+        x = -126.0f;
+    } else if (x > 127.99999f) {
+        x = 127.99999f;
+    }
+    int32_t k = (int32_t)x;
+    k -= (x < (float)k) ? 1 : 0;
+    const float f = x - (float)k;
+    fm_bits_t v;
+    v.f = 0.999999925064f + f * (0.693153073198f + f * (0.240153617065f + f * (0.055826317993f +
+                                 f * (0.008989340163f + f * 0.001877576645f))));
+    v.i += (uint32_t)k << 23;
+    return v.f;
+}
@@ -0,0 +1,235 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _dsps_fastmath_H_
+#define _dsps_fastmath_H_
+
+#include "dsp_err.h"
+#include "dsp_common.h"
+
+/**
+ * Fast elementary functions for targets without FPU (ESP32-C6), where every libm call is soft-float.
+ *
+ * Fixed point formats:
+ * - angles are binary: the full int16 (int32) range is one turn, 0x8000 (0x80000000) is -pi,
+ *   so an angle in Q15 (Q31) is angle/pi and wraps around for free
+ * - log2 returns, and exp2 takes, Q11 (Q26) values, so exp2(log2(x)) is a round trip
+ * - rsqrt works in Q30, so 1.0 and the inverse square roots of normalized vectors are representable
+ *
+ * Max errors below were measured against double precision over the whole input range and are
+ * in units of the last place of the output format (LSB). Float errors are absolute unless noted.
+ * The implementation use ANSI C and could be compiled and run on any platform
+ */
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**@{*/
+/**
+ * @brief   Q15 sine and cosine
+ *
+ * Minimax polynomial of degree 7 on a quarter turn. Max error 1 LSB.
+ *
+ * @param angle: binary angle, angle/32768 * pi radians
+ *
+ * @return: sin(angle) or cos(angle) in Q15, saturated to 32767
+ */
+int16_t dsps_fast_sin_q15(int16_t angle);
+int16_t dsps_fast_cos_q15(int16_t angle);
+/**@}*/
+
+/**
+ * @brief   Q15 four quadrant arctangent
+ *
+ * Octant reduction, one integer division and a minimax polynomial of degree 9. Max error 1 LSB.
+ *
+ * @param y: ordinate, any scale
+ * @param x: abscissa, same scale as y
+ *
+ * @return: binary angle of (x, y) in Q15 (32768 = pi), 0 for the origin
+ */
+int16_t dsps_fast_atan2_q15(int16_t y, int16_t x);
+
+/**
+ * @brief   Q15 square root
+ *
+ * Rounded result of the Q31 square root. Max error 0.5 LSB.
+ *
+ * @param x: Q15 value, negative values return 0
+ *
+ * @return: sqrt(x) in Q15
+ */
+int16_t dsps_fast_sqrt_q15(int16_t x);
+
+/**
+ * @brief   Q15 base 2 logarithm
+ *
+ * Normalization and a minimax polynomial of degree 4 of log2(1 + f). Max error 1 LSB.
+ *
+ * @param x: Q15 value (0..1)
+ *
+ * @return: log2(x) in Q11, INT16_MIN for x <= 0
+ */
+int16_t dsps_fast_log2_q15(int16_t x);
+
+/**
+ * @brief   Q15 base 2 exponential
+ *
+ * Minimax polynomial of degree 4 of 2^(f-1) and a shift. Max error 1 LSB.
+ *
+ * @param x: Q11 value, -16..0
+ *
+ * @return: 2^x in Q15, saturated to 32767 for x >= 0
+ */
+int16_t dsps_fast_exp2_q15(int16_t x);
+
+/**
+ * @brief   Q31 sine and cosine
+ *
+ * CORDIC rotation, 18 iterations without multiplications, and the remaining angle applied to first
+ * order. Max error 10 LSB (5e-9).
+ *
+ * @param angle: binary angle, angle/2^31 * pi radians
+ * @param[out] sin: sin(angle) in Q31, saturated to INT32_MAX. Could be NULL
+ * @param[out] cos: cos(angle) in Q31, saturated to INT32_MAX. Could be NULL
+ */
+void dsps_fast_sincos_q31(int32_t angle, int32_t *sin, int32_t *cos);
+
+/**
+ * @brief   Q31 four quadrant arctangent
+ *
+ * CORDIC vectoring, 30 iterations, on the inputs normalized to 29 bits. Max error 8 LSB (1.2e-8 rad).
+ *
+ * @param y: ordinate, any scale
+ * @param x: abscissa, same scale as y
+ *
+ * @return: binary angle of (x, y) in Q31 (2^31 = pi), 0 for the origin
+ */
+int32_t dsps_fast_atan2_q31(int32_t y, int32_t x);
+
+/**
+ * @brief   Q31 square root
+ *
+ * Normalization, three Newton iterations of the inverse square root and one of the square root. Max error 1 LSB.
+ *
+ * @param x: Q31 value, negative values return 0
+ *
+ * @return: sqrt(x) in Q31
+ */
+int32_t dsps_fast_sqrt_q31(int32_t x);
+
+/**
+ * @brief   Q30 inverse square root
+ *
+ * Normalization, a quadratic estimate and three Newton iterations. Relative error 2e-9.
+ *
+ * @param x: Q30 value, positive
+ *
+ * @return: 1/sqrt(x) in Q30, saturated to INT32_MAX for x < 0.25 and for x <= 0
+ */
+int32_t dsps_fast_rsqrt_q30(int32_t x);
+
+/**
+ * @brief   Q31 base 2 logarithm
+ *
+ * Normalization and a minimax polynomial of degree 9 of log2(1 + f). Max error 2 LSB (3e-8).
+ *
+ * @param x: Q31 value (0..1)
+ *
+ * @return: log2(x) in Q26, INT32_MIN for x <= 0
+ */
+int32_t dsps_fast_log2_q31(int32_t x);
+
+/**
+ * @brief   Q31 base 2 exponential
+ *
+ * Minimax polynomial of degree 7 of 2^(f-1) and a shift. Max error 3 LSB.
+ *
+ * @param x: Q26 value, -32..0
+ *
+ * @return: 2^x in Q31, saturated to INT32_MAX for x >= 0
+ */
+int32_t dsps_fast_exp2_q31(int32_t x);
+
+/**@{*/
+/**
+ * @brief   float sine and cosine
+ *
+ * Reduction to [-pi/4..pi/4] in two steps (Cody-Waite) and minimax polynomials of degree 7 (sine)
+ * and 6 (cosine). Max error 1.5e-7 for |x| < 1000, growing with |x| as the reduction loses bits.
+ *
+ * @param x: angle, radians
+ *
+ * @return: sin(x) or cos(x)
+ */
+float dsps_fast_sinf(float x);
+float dsps_fast_cosf(float x);
+/**@}*/
+
+/**
+ * @brief   float four quadrant arctangent
+ *
+ * Octant reduction and a minimax polynomial of degree 15. Max error 3e-7 rad.
+ *
+ * @param y: ordinate
+ * @param x: abscissa
+ *
+ * @return: angle of (x, y), -pi..pi, 0 for the origin
+ */
+float dsps_fast_atan2f(float y, float x);
+
+/**
+ * @brief   float square root
+ *
+ * Inverse square root estimate with a corrected square root step. Relative error 1e-7.
+ *
+ * @param x: input, negative values return 0
+ *
+ * @return: sqrt(x)
+ */
+float dsps_fast_sqrtf(float x);
+
+/**
+ * @brief   float inverse square root
+ *
+ * Bit level estimate and two Newton iterations. Relative error 5e-6.
+ *
+ * @param x: positive input
+ *
+ * @return: 1/sqrt(x)
+ */
+float dsps_fast_rsqrtf(float x);
+
+/**
+ * @brief   float base 2 logarithm
+ *
+ * Exponent extraction and a minimax polynomial of degree 8 of log2(1 + f). Max error
+ * 2e-7 * max(1, |log2(x)|), normal numbers only.
+ *
+ * @param x: positive input
+ *
+ * @return: log2(x), -INFINITY for x <= 0
+ */
+float dsps_fast_log2f(float x);
+
+/**
+ * @brief   float base 2 exponential
+ *
+ * Minimax polynomial of degree 5 of 2^f and exponent insertion. Relative error 2e-7.
+ *
+ * @param x: input, clamped to -126..128
+ *
+ * @return: 2^x
+ */
+float dsps_fast_exp2f(float x);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _dsps_fastmath_H_
@@ -0,0 +1,216 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsps_fastmath.h"
+#include "dsp_tests.h"
+
+static const char *TAG = "dsps_fastmath";
+
+#define N_RANDOM    20000
+
+static uint32_t fm_rand32(void)
+{
+    return ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+}
+
+// Difference of two binary angles, wrapped to half a turn
+static double fm_angle_err(double a, double b, double turn)
+{
+    double d = fmod(a - b, turn);
+    if (d > turn / 2) {
+        d -= turn;
+    } else if (d < -turn / 2) {
+        d += turn;
+    }
+    return fabs(d);
+}
+
+TEST_CASE("dsps_fastmath q15 functionality", "[dsps]")
+{
+    double e_sin = 0, e_cos = 0, e_sqrt = 0, e_log = 0, e_exp = 0, e_atan = 0;
+    for (int i = INT16_MIN; i <= INT16_MAX; i++) {
+        const double a = i * M_PI / 32768;
+        e_sin = fmax(e_sin, fabs(dsps_fast_sin_q15(i) - fmin(32767, sin(a) * 32768)));
+        e_cos = fmax(e_cos, fabs(dsps_fast_cos_q15(i) - fmin(32767, cos(a) * 32768)));
+        if (i >= 0) {
+            e_sqrt = fmax(e_sqrt, fabs(dsps_fast_sqrt_q15(i) - fmin(32767, sqrt(i / 32768.0) * 32768)));
+        }
+        if (i > 0) {
+            e_log = fmax(e_log, fabs(dsps_fast_log2_q15(i) - log2(i / 32768.0) * 2048));
+        }
+        if ((i < 0) && (i >= -16 * 2048)) {
+            e_exp = fmax(e_exp, fabs(dsps_fast_exp2_q15(i) - exp2(i / 2048.0) * 32768));
+        }
+    }
+    for (int i = 0; i < N_RANDOM; i++) {
+        int16_t y = (int16_t)rand();
+        int16_t x = (int16_t)rand();
+        double ref = atan2(y, x) / M_PI * 32768;
+        e_atan = fmax(e_atan, fm_angle_err(dsps_fast_atan2_q15(y, x), ref, 65536));
+    }
+    ESP_LOGI(TAG, "Q15 max error, LSB: sin %f, cos %f, atan2 %f, sqrt %f, log2 %f, exp2 %f", e_sin, e_cos, e_atan, e_sqrt, e_log, e_exp);
+    TEST_ASSERT_TRUE(e_sin <= 1.0);
+    TEST_ASSERT_TRUE(e_cos <= 1.0);
+    TEST_ASSERT_TRUE(e_atan <= 1.0);
+    TEST_ASSERT_TRUE(e_sqrt <= 0.5);
+    TEST_ASSERT_TRUE(e_log <= 1.0);
+    TEST_ASSERT_TRUE(e_exp <= 1.0);
+
+    TEST_ASSERT_EQUAL(0, dsps_fast_atan2_q15(0, 0));
+    TEST_ASSERT_EQUAL(16384, dsps_fast_atan2_q15(100, 0));
+    TEST_ASSERT_EQUAL(INT16_MIN, dsps_fast_log2_q15(0));
+    TEST_ASSERT_EQUAL(INT16_MAX, dsps_fast_exp2_q15(0));
+}
+
+TEST_CASE("dsps_fastmath q31 functionality", "[dsps]")
+{
+    double e_sin = 0, e_cos = 0, e_sqrt = 0, e_rsqrt = 0, e_log = 0, e_exp = 0, e_atan = 0;
+    const double q31 = 2147483648.0;
+    for (int i = 0; i < N_RANDOM; i++) {
+        const int32_t a = (int32_t)fm_rand32();
+        int32_t s, c;
+        dsps_fast_sincos_q31(a, &s, &c);
+        e_sin = fmax(e_sin, fabs(s - fmin(INT32_MAX, sin(a * M_PI / q31) * q31)));
+        e_cos = fmax(e_cos, fabs(c - fmin(INT32_MAX, cos(a * M_PI / q31) * q31)));
+
+        // Inputs of every magnitude
+        const int32_t x = (int32_t)(fm_rand32() >> (1 + i % 31));
+        const int32_t y = (int32_t)fm_rand32() >> (i % 31);
+        const int32_t z = (int32_t)fm_rand32() >> (i % 31);
+        if (x > 0) {
+            e_sqrt = fmax(e_sqrt, fabs(dsps_fast_sqrt_q31(x) - fmin(INT32_MAX, sqrt(x / q31) * q31)));
+            e_log = fmax(e_log, fabs(dsps_fast_log2_q31(x) - log2(x / q31) * 67108864.0));
+            // 1/sqrt(x) relative error, where it does not saturate
+            if (x >= (1 << 28)) {
+                double ref = 1 / sqrt(x / 1073741824.0);
+                e_rsqrt = fmax(e_rsqrt, fabs(dsps_fast_rsqrt_q30(x) / 1073741824.0 - ref) / ref);
+            }
+        }
+        if (abs(y) + abs(z) > 0) {
+            double ref = atan2(y, z) / M_PI * q31;
+            e_atan = fmax(e_atan, fm_angle_err(dsps_fast_atan2_q31(y, z), ref, 2 * q31));
+        }
+        const int32_t ex = -(int32_t)(fm_rand32() % (32u << 26)) - 1;
+        e_exp = fmax(e_exp, fabs(dsps_fast_exp2_q31(ex) - exp2(ex / 67108864.0) * q31));
+    }
+    ESP_LOGI(TAG, "Q31 max error, LSB: sin %f, cos %f, atan2 %f, sqrt %f, log2 %f, exp2 %f; rsqrt Q30 relative %e",
+             e_sin, e_cos, e_atan, e_sqrt, e_log, e_exp, e_rsqrt);
+    TEST_ASSERT_TRUE(e_sin <= 10.0);
+    TEST_ASSERT_TRUE(e_cos <= 10.0);
+    TEST_ASSERT_TRUE(e_atan <= 8.0);
+    TEST_ASSERT_TRUE(e_sqrt <= 1.0);
+    TEST_ASSERT_TRUE(e_log <= 2.0);
+    TEST_ASSERT_TRUE(e_exp <= 3.0);
+    TEST_ASSERT_TRUE(e_rsqrt <= 2e-9);
+
+    TEST_ASSERT_EQUAL(1 << 30, dsps_fast_rsqrt_q30(1 << 30));
+    TEST_ASSERT_EQUAL(INT32_MAX, dsps_fast_rsqrt_q30((1 << 28) - 1));
+    TEST_ASSERT_EQUAL(0, dsps_fast_atan2_q31(0, 0));
+}
+
+TEST_CASE("dsps_fastmath f32 functionality", "[dsps]")
+{
+    double e_sin = 0, e_cos = 0, e_atan = 0, e_sqrt = 0, e_rsqrt = 0, e_log = 0, e_exp = 0;
+    for (int i = 0; i < N_RANDOM; i++) {
+        const float a = ((float)rand() / RAND_MAX - 0.5f) * 2000;
+        e_sin = fmax(e_sin, fabs(dsps_fast_sinf(a) - sin(a)));
+        e_cos = fmax(e_cos, fabs(dsps_fast_cosf(a) - cos(a)));
+
+        const float y = (float)rand() / RAND_MAX - 0.5f;
+        const float x = (float)rand() / RAND_MAX - 0.5f;
+        e_atan = fmax(e_atan, fabs(dsps_fast_atan2f(y, x) - atan2(y, x)));
+
+        // Positive values over 60 decades
+        const float p = (float)exp2(((double)rand() / RAND_MAX - 0.5) * 200);
+        e_sqrt = fmax(e_sqrt, fabs(dsps_fast_sqrtf(p) / sqrt(p) - 1));
+        e_rsqrt = fmax(e_rsqrt, fabs(dsps_fast_rsqrtf(p) * sqrt(p) - 1));
+        e_log = fmax(e_log, fabs(dsps_fast_log2f(p) - log2(p)) / fmax(1, fabs(log2(p))));
+        const float ex = ((float)rand() / RAND_MAX - 0.5f) * 200;
+        e_exp = fmax(e_exp, fabs(dsps_fast_exp2f(ex) / exp2(ex) - 1));
+    }
+    ESP_LOGI(TAG, "float max error: sin %e, cos %e, atan2 %e; relative: sqrt %e, rsqrt %e, exp2 %e; log2 %e",
+             e_sin, e_cos, e_atan, e_sqrt, e_rsqrt, e_exp, e_log);
+    TEST_ASSERT_TRUE(e_sin <= 1.5e-7);
+    TEST_ASSERT_TRUE(e_cos <= 1.5e-7);
+    TEST_ASSERT_TRUE(e_atan <= 3e-7);
+    TEST_ASSERT_TRUE(e_sqrt <= 1e-7);
+    TEST_ASSERT_TRUE(e_rsqrt <= 5e-6);
+    TEST_ASSERT_TRUE(e_log <= 2e-7);
+    TEST_ASSERT_TRUE(e_exp <= 2e-7);
+}
+
+#define FM_BENCH_N  256
+
+static float fm_in_f[FM_BENCH_N];
+static float fm_in_f2[FM_BENCH_N];
+static int32_t fm_in_i[FM_BENCH_N];
+static volatile float fm_sink_f;
+static volatile int32_t fm_sink_i;
+
+// Cycles per call of expr, evaluated for i in [0..FM_BENCH_N)
+#define FM_BENCH(result, sink, expr) do { \
+        unsigned int start_b = dsp_get_cpu_cycle_count(); \
+        for (int i = 0; i < FM_BENCH_N; i++) { \
+            sink = (expr); \
+        } \
+        result = (float)(dsp_get_cpu_cycle_count() - start_b) / FM_BENCH_N; \
+    } while (0)
+
+TEST_CASE("dsps_fastmath benchmark", "[dsps]")
+{
+    for (int i = 0; i < FM_BENCH_N; i++) {
+        fm_in_f[i] = (float)rand() / RAND_MAX * 6 - 3;
+        fm_in_f2[i] = (float)rand() / RAND_MAX + 0.01f;
+        fm_in_i[i] = (int32_t)fm_rand32() >> 1;
+    }
+    float lib, q15, q31, fast;
+
+    FM_BENCH(lib, fm_sink_f, sinf(fm_in_f[i]));
+    FM_BENCH(fast, fm_sink_f, dsps_fast_sinf(fm_in_f[i]));
+    FM_BENCH(q15, fm_sink_i, dsps_fast_sin_q15((int16_t)fm_in_i[i]));
+    FM_BENCH(q31, fm_sink_i, (dsps_fast_sincos_q31(fm_in_i[i], (int32_t *)&fm_sink_i, NULL), 0));
+    ESP_LOGI(TAG, "sin:   newlib %8.1f, fast float %8.1f, Q15 %8.1f, Q31 %8.1f cycles", lib, fast, q15, q31);
+    TEST_ASSERT_EXEC_IN_RANGE(1, 300, q15);
+
+    FM_BENCH(lib, fm_sink_f, atan2f(fm_in_f[i], fm_in_f2[i]));
+    FM_BENCH(fast, fm_sink_f, dsps_fast_atan2f(fm_in_f[i], fm_in_f2[i]));
+    FM_BENCH(q15, fm_sink_i, dsps_fast_atan2_q15((int16_t)fm_in_i[i], (int16_t)(fm_in_i[i] >> 16)));
+    FM_BENCH(q31, fm_sink_i, dsps_fast_atan2_q31(fm_in_i[i], fm_in_i[(i + 1) % FM_BENCH_N]));
+    ESP_LOGI(TAG, "atan2: newlib %8.1f, fast float %8.1f, Q15 %8.1f, Q31 %8.1f cycles", lib, fast, q15, q31);
+    TEST_ASSERT_EXEC_IN_RANGE(1, 300, q15);
+
+    FM_BENCH(lib, fm_sink_f, sqrtf(fm_in_f2[i]));
+    FM_BENCH(fast, fm_sink_f, dsps_fast_sqrtf(fm_in_f2[i]));
+    FM_BENCH(q15, fm_sink_i, dsps_fast_sqrt_q15((int16_t)(fm_in_i[i] >> 16)));
+    FM_BENCH(q31, fm_sink_i, dsps_fast_sqrt_q31(fm_in_i[i]));
+    ESP_LOGI(TAG, "sqrt:  newlib %8.1f, fast float %8.1f, Q15 %8.1f, Q31 %8.1f cycles", lib, fast, q15, q31);
+
+    FM_BENCH(lib, fm_sink_f, 1.0f / sqrtf(fm_in_f2[i]));
+    FM_BENCH(fast, fm_sink_f, dsps_fast_rsqrtf(fm_in_f2[i]));
+    FM_BENCH(q31, fm_sink_i, dsps_fast_rsqrt_q30(fm_in_i[i]));
+    ESP_LOGI(TAG, "rsqrt: newlib %8.1f, fast float %8.1f, Q30 %8.1f cycles", lib, fast, q31);
+
+    FM_BENCH(lib, fm_sink_f, log2f(fm_in_f2[i]));
+    FM_BENCH(fast, fm_sink_f, dsps_fast_log2f(fm_in_f2[i]));
+    FM_BENCH(q15, fm_sink_i, dsps_fast_log2_q15((int16_t)(fm_in_i[i] >> 16)));
+    FM_BENCH(q31, fm_sink_i, dsps_fast_log2_q31(fm_in_i[i]));
+    ESP_LOGI(TAG, "log2:  newlib %8.1f, fast float %8.1f, Q15 %8.1f, Q31 %8.1f cycles", lib, fast, q15, q31);
+
+    FM_BENCH(lib, fm_sink_f, exp2f(fm_in_f[i]));
+    FM_BENCH(fast, fm_sink_f, dsps_fast_exp2f(fm_in_f[i]));
+    FM_BENCH(q15, fm_sink_i, dsps_fast_exp2_q15((int16_t)(-(fm_in_i[i] & 0x7fff))));
+    FM_BENCH(q31, fm_sink_i, dsps_fast_exp2_q31(-(fm_in_i[i] & 0x7fffffff)));
+    ESP_LOGI(TAG, "exp2:  newlib %8.1f, fast float %8.1f, Q15 %8.1f, Q31 %8.1f cycles", lib, fast, q15, q31);
+    TEST_ASSERT_EXEC_IN_RANGE(1, 300, q31);
+}
@@ -21,5 +21,6 @@
 #include "dsps_addc.h"
 #include "dsps_mulc.h"
 #include "dsps_sqrt.h"
+#include "dsps_fastmath.h"
 
 #endif // _dsps_math_H_
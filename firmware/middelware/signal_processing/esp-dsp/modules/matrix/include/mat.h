@@ -15,6 +15,7 @@
 #ifndef _dspm_mat_h_
 #define _dspm_mat_h_
 #include <iostream>
+#include "mat_alloc.h"
 
 /**
  * @brief   DSP matrix namespace
@@ -22,12 +23,41 @@
  * DSP library matrix namespace.
  */
 namespace dspm {
+class Mat;
+
+/**
+ * @brief   Matrix expression
+ *
+ * Base of the lazy expressions returned by the Mat arithmetic operators.
+ * An expression keeps references to its operands and is evaluated in one loop
+ * when it is assigned to a matrix. See mat_expr.h.
+ */
+template <typename E>
+class MatExpr {
+public:
+    /**
+     * The expression as its concrete type.
+     */
+    inline const E &derived() const
+    {
+        return static_cast<const E &>(*this);
+    }
+
+    /**
+     * Evaluate the expression and transpose the result.
+     *
+     * @return
+     *      - transposed matrix
+     */
+    Mat t() const;
+};
+
 /**
  * @brief   Matrix
  *
  * The Mat class provides basic matrix operations on single-precision floating point values.
  */
-class Mat {
+class Mat : public MatExpr<Mat> {
 public:
 
     int rows;               /*!< Amount of rows*/
@@ -37,8 +67,10 @@ public:
     float *data;            /*!< Buffer with matrix data*/
     int length;             /*!< Total amount of data in data array*/
     static float abs_tol;   /*!< Max acceptable absolute tolerance*/
+    static unsigned int alloc_count; /*!< Amount of internal buffers allocated by all matrices, for profiling*/
     bool ext_buff;          /*!< Flag indicates that matrix use external buffer*/
     bool sub_matrix;        /*!< Flag indicates that matrix is a subset of another matrix*/
+    MatAllocator *allocator; /*!< Allocator of the internal buffer, NULL for the heap. See mat_alloc.h*/
 
     /**
      * @brief Rectangular area
@@ -116,6 +148,27 @@ public:
      */
     Mat(const Mat &src);
 
+    /**
+     * @brief Move matrix.
+     *
+     * if src matrix allocated its buffer, the buffer is taken over and src is left empty (0x0)
+     * otherwise the matrix is copied as with the copy constructor
+     *
+     * @param[in] src: source matrix
+     */
+    Mat(Mat &&src);
+
+    /**
+     * @brief Evaluate a matrix expression into a new matrix.
+     *
+     * The whole expression is calculated in one loop, only the matrix products
+     * inside of it use temporary buffers.
+     *
+     * @param[in] expr: matrix expression, for example A + B * C
+     */
+    template <typename E>
+    Mat(const MatExpr<E> &expr);
+
     /**
      * @brief Create a subset of matrix as ROI (Region of Interest)
      *
@@ -207,6 +260,33 @@ public:
      */
     Mat &operator=(const Mat &src);
 
+    /**
+     * Move operator
+     *
+     * A matrix with the same dimensions keeps its buffer and the data is copied,
+     * so sub-matrices of it stay valid. Otherwise the buffer of src is taken over
+     * if src allocated it from the same allocator as this matrix, see mat_alloc.h.
+     *
+     * @param[in] src: source matrix
+     *
+     * @return
+     *      - result matrix
+     */
+    Mat &operator=(Mat &&src);
+
+    /**
+     * Assign a matrix expression.
+     * The expression is written directly to the matrix buffer when the size is
+     * the same, and through a temporary matrix when it aliases the destination.
+     *
+     * @param[in] expr: matrix expression
+     *
+     * @return
+     *      - result matrix
+     */
+    template <typename E>
+    Mat &operator=(const MatExpr<E> &expr);
+
     /**
      * Access to the matrix elements.
      * @param[in] row: row position
@@ -243,6 +323,17 @@ public:
      */
     Mat &operator+=(const Mat &A);
 
+    /**
+     * += operator with a matrix expression, evaluated in one loop.
+     *
+     * @param[in] expr: matrix expression
+     *
+     * @return
+     *      - result matrix: result += expr
+     */
+    template <typename E>
+    Mat &operator+=(const MatExpr<E> &expr);
+
     /**
      * += operator
      * The operator use DSP optimized implementation of multiplication.
@@ -264,6 +355,17 @@ public:
      */
     Mat &operator-=(const Mat &A);
 
+    /**
+     * -= operator with a matrix expression, evaluated in one loop.
+     *
+     * @param[in] expr: matrix expression
+     *
+     * @return
+     *      - result matrix: result -= expr
+     */
+    template <typename E>
+    Mat &operator-=(const MatExpr<E> &expr);
+
     /**
      * -= operator
      * The operator use DSP optimized implementation of multiplication.
@@ -518,7 +620,12 @@ private:
     Mat adjoint();
 
     void allocate(); // Allocate buffer
+    void allocate(MatAllocator *allocator); // Allocate buffer from allocator, NULL for the heap
+    void release(); // Free internal buffer
+    void moveFrom(Mat &src); // Take over header and buffer of src, src is left empty
     Mat expHelper(const Mat &m, int num);
+
+    template <typename L, typename R> friend class MatProductExpr;
 };
 /**
  * Print matrix to the standard iostream.
@@ -551,109 +658,125 @@ std::ostream &operator<<(std::ostream &os, const Mat::Rect &rect);
 std::istream &operator>>(std::istream &is, Mat &m);
 
 /**
- * + operator, sum of two matrices
- * The operator use DSP optimized implementation of multiplication.
+ * Sum of two matrices into an existing matrix, dst = A + B.
+ * dst keeps its buffer if it has the dimensions of A, otherwise it is reallocated.
  *
  * @param[in] A: Input matrix A
  * @param[in] B: Input matrix B
- *
- * @return
- *     - result matrix A+B
-*/
-Mat operator+(const Mat &A, const Mat &B);
-/**
- * + operator, sum of matrix with constant
- * The operator use DSP optimized implementation of multiplication.
- *
- * @param[in] A: Input matrix A
- * @param[in] C: Input constant
- *
- * @return
- *     - result matrix A+C
-*/
-Mat operator+(const Mat &A, float C);
+ * @param[out] dst: result matrix
+ */
+void add_into(const Mat &A, const Mat &B, Mat &dst);
 
 /**
- * - operator, subtraction of two matrices
- * The operator use DSP optimized implementation of multiplication.
+ * Subtraction of two matrices into an existing matrix, dst = A - B.
+ * dst keeps its buffer if it has the dimensions of A, otherwise it is reallocated.
  *
  * @param[in] A: Input matrix A
  * @param[in] B: Input matrix B
- *
- * @return
- *     - result matrix A-B
-*/
-Mat operator-(const Mat &A, const Mat &B);
+ * @param[out] dst: result matrix
+ */
+void sub_into(const Mat &A, const Mat &B, Mat &dst);
+
 /**
- * - operator, sum of matrix with constant
- * The operator use DSP optimized implementation of multiplication.
+ * Multiplication of matrix with constant into an existing matrix, dst = A * C.
+ * dst keeps its buffer if it has the dimensions of A, otherwise it is reallocated.
  *
  * @param[in] A: Input matrix A
- * @param[in] C: Input constant
+ * @param[in] C: constant value
+ * @param[out] dst: result matrix
+ */
+void mult_into(const Mat &A, float C, Mat &dst);
+
+/**
+ * Product of two matrices into an existing matrix, dst = A * B.
+ * dst keeps its buffer if it has the dimensions of the result, otherwise it is reallocated.
+ * If dst shares data with A or B, the product is calculated in a temporary matrix.
  *
- * @return
- *     - result matrix A+C
-*/
-Mat operator-(const Mat &A, float C);
+ * @param[in] A: Input matrix A [m]x[n]
+ * @param[in] B: Input matrix B [n]x[k]
+ * @param[out] dst: result matrix [m]x[k]
+ */
+void mult_into(const Mat &A, const Mat &B, Mat &dst);
 
 /**
- * * operator, multiplication of two matrices.
- * The operator use DSP optimized implementation of multiplication.
+ * Product with transposed matrix into an existing matrix, dst = A * B', without forming B'.
+ * dst keeps its buffer if it has the dimensions of the result, otherwise it is reallocated.
+ * If dst shares data with A or B, the product is calculated in a temporary matrix.
  *
- * @param[in] A: Input matrix A
- * @param[in] B: Input matrix B
+ * @param[in] A: Input matrix A [m]x[n]
+ * @param[in] B: Input matrix B [k]x[n]
+ * @param[out] dst: result matrix [m]x[k]
+ */
+void mult_bt_into(const Mat &A, const Mat &B, Mat &dst);
+
+/**
+ * Transpose into an existing matrix, dst = A'.
+ * dst keeps its buffer if it has the dimensions of A', otherwise it is reallocated.
  *
- * @return
- *     - result matrix A*B
-*/
-Mat operator*(const Mat &A, const Mat &B);
+ * @param[in] A: Input matrix A [m]x[n]
+ * @param[out] dst: result matrix [n]x[m]
+ */
+void transpose_into(const Mat &A, Mat &dst);
 
 /**
- * * operator, multiplication of matrix with constant
- * The operator use DSP optimized implementation of multiplication.
+ * Product with a symmetric result into an existing matrix, dst = A * B'.
+ * For products known to be symmetric, like F*P*F'. Only the upper triangle is
+ * calculated and mirrored to the lower one, so dst is exactly symmetric.
+ * dst keeps its buffer if it has the dimensions of the result, otherwise it is reallocated.
+ * If dst shares data with A or B, the product is calculated in a temporary matrix.
  *
- * @param[in] A: Input matrix A
- * @param[in] C: floating point value
+ * @param[in] A: Input matrix A [m]x[n]
+ * @param[in] B: Input matrix B [m]x[n]
+ * @param[out] dst: result matrix [m]x[m]
+ */
+void mult_bt_sym_into(const Mat &A, const Mat &B, Mat &dst);
+
+/**
+ * Copy the upper triangle of a square matrix to the lower one.
  *
- * @return
- *     - result matrix A*B
-*/
-Mat operator*(const Mat &A, float C);
+ * @param[in,out] A: square matrix
+ */
+void sym_mirror(Mat &A);
 
 /**
- * * operator, multiplication of matrix with constant
- * The operator use DSP optimized implementation of multiplication.
+ * Symmetry error of a square matrix.
  *
- * @param[in] C: floating point value
- * @param[in] A: Input matrix A
+ * @param[in] A: square matrix
  *
  * @return
- *     - result matrix A*B
-*/
-Mat operator*(float C, const Mat &A);
+ *      - max |A(i, j) - A(j, i)|
+ */
+float sym_error(const Mat &A);
 
 /**
- * / operator, divide of matrix by constant
- * The operator use DSP optimized implementation of multiplication.
+ * Amount of values of a packed symmetric matrix.
  *
- * @param[in] A: Input matrix A
- * @param[in] C: floating point value
+ * @param[in] n: amount of rows and columns
  *
  * @return
- *     - result matrix A*B
-*/
-Mat operator/(const Mat &A, float C);
+ *      - n*(n + 1)/2
+ */
+inline int sym_packed_length(int n)
+{
+    return n * (n + 1) / 2;
+}
 
 /**
- * / operator, divide matrix A by matrix B
+ * Copy a symmetric matrix to packed storage: the upper triangle row by row,
+ * A(0,0) ... A(0,n-1), A(1,1) ... A(1,n-1), ... A(n-1,n-1).
  *
- * @param[in] A: Input matrix A
- * @param[in] B: Input matrix B
+ * @param[in] A: square matrix [n]x[n]
+ * @param[out] packed: sym_packed_length(n) values
+ */
+void sym_pack(const Mat &A, float *packed);
+
+/**
+ * Copy packed storage to a symmetric matrix, see sym_pack().
  *
- * @return
- *     - result matrix C, where C[i,j] = A[i,j]/B[i,j]
-*/
-Mat operator/(const Mat &A, const Mat &B);
+ * @param[in] packed: sym_packed_length(dst.rows) values
+ * @param[out] dst: square matrix [n]x[n]
+ */
+void sym_unpack(const float *packed, Mat &dst);
 
 /**
  * == operator, compare two matrices
@@ -668,4 +791,7 @@ Mat operator/(const Mat &A, const Mat &B);
 bool operator==(const Mat &A, const Mat &B);
 
 }
+
+#include "mat_expr.h"
+
 #endif //_dspm_mat_h_
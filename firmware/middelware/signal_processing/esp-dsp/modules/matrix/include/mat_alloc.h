@@ -0,0 +1,206 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _dspm_mat_alloc_h_
+#define _dspm_mat_alloc_h_
+
+#include <stddef.h>
+
+namespace dspm {
+
+/**
+ * @brief   Allocator of matrix buffers
+ *
+ * By default dspm::Mat allocates its buffers with new[]. A MatAllocatorScope installs
+ * another allocator for the current task: the matrices allocated inside of the scope take
+ * their buffers from it and give them back when they are destroyed, also after the scope.
+ * An allocator that returns NULL makes the matrix fall back to the heap.
+ *
+ * A matrix keeps the allocator of its first buffer: when an assignment changes its size,
+ * the new buffer comes from the same allocator, and the buffer of a temporary from another
+ * allocator is copied instead of taken over. So the result of a MatArenaStep assigned to a
+ * matrix created outside of the step does not keep a buffer of the arena.
+ *
+ * The allocators are not thread safe, one allocator must be used by one task.
+ */
+class MatAllocator {
+public:
+    virtual ~MatAllocator() {}
+
+    /**
+     * Allocate a buffer.
+     * @param[in] length: amount of float values
+     *
+     * @return
+     *      - buffer, aligned to 16 bytes
+     *      - NULL if there is no memory, the matrix uses the heap then
+     */
+    virtual float *alloc(int length) = 0;
+
+    /**
+     * Give back a buffer of alloc().
+     * @param[in] data: buffer
+     * @param[in] length: amount of float values, as given to alloc()
+     */
+    virtual void free(float *data, int length) = 0;
+
+    /**
+     * Allocator of the current task.
+     *
+     * @return
+     *      - allocator installed by the innermost MatAllocatorScope
+     *      - NULL for the heap
+     */
+    static MatAllocator *active();
+
+private:
+    friend class MatAllocatorScope;
+    static void setActive(MatAllocator *allocator);
+};
+
+/**
+ * @brief   Bump arena for temporary matrices
+ *
+ * Buffers are taken one after the other from one memory block, so allocation is a few
+ * instructions and the heap is not fragmented. A freed buffer is reused immediately when
+ * it is the last one, which is the usual case for temporary matrices. reset() makes the
+ * whole block free again after a processing step.
+ *
+ * peak reports the highest use, so the block can be sized statically. Allocations that
+ * do not fit are counted in overflows and go to the heap.
+ */
+class MatArena : public MatAllocator {
+public:
+    /**
+     * Arena on an external memory block.
+     * @param[in] buffer: memory block, aligned to 16 bytes. The first values of a misaligned
+     *                    block are not used, and an error is logged
+     * @param[in] length: size of the block in float values
+     */
+    MatArena(float *buffer, int length);
+
+    /**
+     * Arena with a memory block allocated once from the heap, aligned to 16 bytes.
+     * @param[in] length: size of the block in float values
+     */
+    explicit MatArena(int length);
+    virtual ~MatArena();
+
+    virtual float *alloc(int length);
+    virtual void free(float *data, int length);
+
+    /**
+     * Make the whole block free.
+     * The arena is not reset while matrices still use it, an error is logged instead.
+     *
+     * @return
+     *      - true if the arena was reset
+     *      - false if matrices still use the arena
+     */
+    bool reset();
+
+    float *buffer;      /*!< Memory block*/
+    int length;         /*!< Size of the memory block in float values*/
+    int used;           /*!< Amount of float values in use*/
+    int peak;           /*!< Highest amount of float values in use*/
+    int live;           /*!< Amount of buffers in use*/
+    int overflows;      /*!< Amount of allocations that did not fit and used the heap*/
+    bool ext_buff;      /*!< Flag indicates that the arena uses external memory block*/
+};
+
+/**
+ * @brief   Pool of buffers for long-lived matrices
+ *
+ * Buffers are rounded up to the next power of two size class, from 4 to 8192 float values.
+ * A freed buffer is kept in a list of its class and reused by the next allocation of the
+ * same class, so matrices created and destroyed at run time do not fragment the heap.
+ * New buffers are taken from one memory block, allocations that do not fit are counted
+ * in overflows and go to the heap.
+ */
+class MatPool : public MatAllocator {
+public:
+    /**
+     * Pool on an external memory block.
+     * @param[in] buffer: memory block, aligned to 16 bytes. The first values of a misaligned
+     *                    block are not used, and an error is logged
+     * @param[in] length: size of the block in float values
+     */
+    MatPool(float *buffer, int length);
+
+    /**
+     * Pool with a memory block allocated once from the heap, aligned to 16 bytes.
+     * @param[in] length: size of the block in float values
+     */
+    explicit MatPool(int length);
+    virtual ~MatPool();
+
+    virtual float *alloc(int length);
+    virtual void free(float *data, int length);
+
+    static const int classes = 12;  /*!< Amount of size classes, 4 << (classes - 1) is the largest buffer*/
+
+    float *buffer;      /*!< Memory block*/
+    int length;         /*!< Size of the memory block in float values*/
+    int used;           /*!< Amount of float values taken from the memory block*/
+    int live;           /*!< Amount of buffers in use*/
+    int overflows;      /*!< Amount of allocations that did not fit and used the heap*/
+    bool ext_buff;      /*!< Flag indicates that the pool uses external memory block*/
+
+private:
+    float *free_list[classes];
+};
+
+/**
+ * @brief   Install an allocator for the matrices created in a scope
+ *
+ * The previous allocator is restored when the object is destroyed. Scopes can be nested.
+ */
+class MatAllocatorScope {
+public:
+    /**
+     * @param[in] allocator: allocator for the new matrices, NULL for the heap
+     */
+    explicit MatAllocatorScope(MatAllocator *allocator);
+    ~MatAllocatorScope();
+
+private:
+    MatAllocator *previous;
+
+    MatAllocatorScope(const MatAllocatorScope &);
+    MatAllocatorScope &operator=(const MatAllocatorScope &);
+};
+
+/**
+ * @brief   One processing step on an arena
+ *
+ * The temporary matrices of the scope use the arena, and the arena is reset at the end
+ * of the scope:
+ *
+ *     dspm::MatArena arena(1024);
+ *     while (true) {
+ *         dspm::MatArenaStep step(arena);
+ *         filter.Process(u, dt);
+ *         filter.UpdateRefMeasurement(accel, magn, R);
+ *     }
+ */
+class MatArenaStep {
+public:
+    /**
+     * @param[in] arena: arena for the temporary matrices
+     */
+    explicit MatArenaStep(MatArena &arena);
+    ~MatArenaStep();
+
+private:
+    MatArena &arena;
+    MatAllocatorScope scope;
+
+    MatArenaStep(const MatArenaStep &);
+    MatArenaStep &operator=(const MatArenaStep &);
+};
+
+}
+#endif // _dspm_mat_alloc_h_
@@ -0,0 +1,530 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _dspm_mat_expr_h_
+#define _dspm_mat_expr_h_
+
+// Lazy matrix expressions behind the Mat arithmetic operators.
+// The file is included at the end of mat.h, include mat.h instead.
+//
+// The operators +, -, * and / build a small expression tree instead of a
+// temporary matrix per operator. The tree is evaluated when it is assigned to a
+// matrix, element by element in one loop. Matrix products can not be calculated
+// element by element, so a product used inside of a bigger expression is
+// calculated once into a temporary buffer, and a product assigned directly to a
+// matrix is written to the destination buffer.
+//
+// Expressions keep references to their matrix operands, so they must be
+// evaluated in the statement where they are created (do not store them with auto).
+
+#include <utility>
+#include "mat.h"
+
+namespace dspm {
+
+/**
+ * Matrix product into a preallocated matrix C = A*B.
+ * The function uses dspm_mult_ex_f32() if one of the matrices is a sub-matrix
+ * and dspm_mult_f32() otherwise. C must not share data with A or B.
+ *
+ * @param[in] A: input matrix [m]x[n]
+ * @param[in] B: input matrix [n]x[k]
+ * @param[out] C: result matrix [m]x[k]
+ */
+void mat_mult(const Mat &A, const Mat &B, Mat &C);
+
+/**
+ * Report a matrix operation with wrong matrix dimensions.
+ *
+ * @param[in] message: error message
+ */
+void mat_expr_error(const char *message);
+
+/**
+ * Check if the data of two matrices overlaps.
+ *
+ * @param[in] A: first matrix
+ * @param[in] B: second matrix
+ *
+ * @return
+ *      - true if the matrices share data
+ */
+inline bool mat_overlap(const Mat &A, const Mat &B)
+{
+    const float *a_end = A.data + (A.rows - 1) * A.stride + A.cols;
+    const float *b_end = B.data + (B.rows - 1) * B.stride + B.cols;
+    return (A.data < b_end) && (B.data < a_end);
+}
+
+/**
+ * @brief   Expression node properties
+ *
+ * Expressions are nested by value, matrices by reference.
+ */
+template <typename E>
+struct MatExprTraits {
+    typedef const E Nested;
+    static inline bool valid(const E &expr)
+    {
+        return expr.valid;
+    }
+    static inline void prepare(const E &expr)
+    {
+        expr.prepare();
+    }
+    static inline bool aliases(const E &expr, const Mat &dst)
+    {
+        return expr.aliases(dst);
+    }
+};
+
+template <>
+struct MatExprTraits<Mat> {
+    typedef const Mat &Nested;
+    static inline bool valid(const Mat &)
+    {
+        return true;
+    }
+    static inline void prepare(const Mat &)
+    {
+    }
+    // Element by element evaluation is safe when the destination is the same matrix
+    static inline bool aliases(const Mat &m, const Mat &dst)
+    {
+        return mat_overlap(m, dst) && !((m.data == dst.data) && (m.stride == dst.stride));
+    }
+};
+
+/**
+ * @brief   Operand of a matrix product
+ *
+ * Matrices are used directly, expressions are evaluated to a temporary matrix.
+ */
+template <typename E>
+class MatOperand {
+public:
+    explicit MatOperand(const E &expr) : value(expr) {}
+    inline const Mat &get() const
+    {
+        return value;
+    }
+private:
+    Mat value;
+};
+
+template <>
+class MatOperand<Mat> {
+public:
+    explicit MatOperand(const Mat &m) : value(m) {}
+    inline const Mat &get() const
+    {
+        return value;
+    }
+private:
+    const Mat &value;
+};
+
+struct MatOpAdd {
+    static inline float apply(float a, float b)
+    {
+        return a + b;
+    }
+};
+
+struct MatOpSub {
+    static inline float apply(float a, float b)
+    {
+        return a - b;
+    }
+};
+
+struct MatOpMul {
+    static inline float apply(float a, float b)
+    {
+        return a * b;
+    }
+};
+
+struct MatOpDiv {
+    static inline float apply(float a, float b)
+    {
+        return a / b;
+    }
+};
+
+/**
+ * Evaluate an element by element expression into dst.
+ */
+template <typename E>
+void mat_expr_eval(const E &expr, Mat &dst)
+{
+    expr.prepare();
+    if (expr.aliases(dst)) {
+        Mat temp(dst.rows, dst.cols);
+        mat_expr_eval(expr, temp);
+        dst = temp;
+        return;
+    }
+    for (int row = 0; row < dst.rows; row++) {
+        float *out = dst.data + row * dst.stride;
+        for (int col = 0; col < dst.cols; col++) {
+            out[col] = expr(row, col);
+        }
+    }
+}
+
+/**
+ * @brief   Element by element operation of two matrices
+ */
+template <typename L, typename R, typename Op>
+class MatBinaryExpr : public MatExpr<MatBinaryExpr<L, R, Op> > {
+public:
+    int rows;   /*!< Amount of rows*/
+    int cols;   /*!< Amount of columns*/
+    bool valid; /*!< Flag indicates that the dimensions of all operands match*/
+
+    MatBinaryExpr(const L &A, const R &B, const char *error) : rows(A.rows), cols(A.cols), lhs(A), rhs(B)
+    {
+        valid = MatExprTraits<L>::valid(A) && MatExprTraits<R>::valid(B);
+        if (valid && ((A.rows != B.rows) || (A.cols != B.cols))) {
+            mat_expr_error(error);
+            valid = false;
+        }
+    }
+
+    inline float operator()(int row, int col) const
+    {
+        return Op::apply(lhs(row, col), rhs(row, col));
+    }
+
+    inline void prepare() const
+    {
+        MatExprTraits<L>::prepare(lhs);
+        MatExprTraits<R>::prepare(rhs);
+    }
+
+    inline bool aliases(const Mat &dst) const
+    {
+        return MatExprTraits<L>::aliases(lhs, dst) || MatExprTraits<R>::aliases(rhs, dst);
+    }
+
+    inline void evalTo(Mat &dst) const
+    {
+        mat_expr_eval(*this, dst);
+    }
+
+private:
+    typename MatExprTraits<L>::Nested lhs;
+    typename MatExprTraits<R>::Nested rhs;
+};
+
+/**
+ * @brief   Element by element operation of a matrix and a constant
+ */
+template <typename E, typename Op>
+class MatScalarExpr : public MatExpr<MatScalarExpr<E, Op> > {
+public:
+    int rows;   /*!< Amount of rows*/
+    int cols;   /*!< Amount of columns*/
+    bool valid; /*!< Flag indicates that the dimensions of all operands match*/
+
+    MatScalarExpr(const E &A, float C) : rows(A.rows), cols(A.cols), valid(MatExprTraits<E>::valid(A)), expr(A), C(C) {}
+
+    inline float operator()(int row, int col) const
+    {
+        return Op::apply(expr(row, col), C);
+    }
+
+    inline void prepare() const
+    {
+        MatExprTraits<E>::prepare(expr);
+    }
+
+    inline bool aliases(const Mat &dst) const
+    {
+        return MatExprTraits<E>::aliases(expr, dst);
+    }
+
+    inline void evalTo(Mat &dst) const
+    {
+        mat_expr_eval(*this, dst);
+    }
+
+private:
+    typename MatExprTraits<E>::Nested expr;
+    float C;
+};
+
+/**
+ * @brief   Product of two matrices
+ *
+ * Assigned to a matrix, the product is written to the destination buffer.
+ * Inside of an element by element expression, it is calculated once into
+ * a temporary buffer before the loop.
+ */
+template <typename L, typename R>
+class MatProductExpr : public MatExpr<MatProductExpr<L, R> > {
+public:
+    int rows;   /*!< Amount of rows*/
+    int cols;   /*!< Amount of columns*/
+    bool valid; /*!< Flag indicates that the dimensions of all operands match*/
+
+    MatProductExpr(const L &A, const R &B) : rows(A.rows), cols(B.cols), lhs(A), rhs(B), result(NULL, 0, 0, 0)
+    {
+        valid = MatExprTraits<L>::valid(A) && MatExprTraits<R>::valid(B);
+        if (valid && (A.cols != B.rows)) {
+            mat_expr_error("operator * Error: matrices do not have correct dimensions");
+            valid = false;
+        }
+    }
+
+    // The copy is made while the expression is built, before the product is calculated
+    MatProductExpr(const MatProductExpr &src) : rows(src.rows), cols(src.cols), valid(src.valid), lhs(src.lhs), rhs(src.rhs), result(NULL, 0, 0, 0) {}
+
+    inline float operator()(int row, int col) const
+    {
+        return result.data[row * cols + col];
+    }
+
+    void prepare() const
+    {
+        if (result.data == NULL) {
+            result.rows = rows;
+            result.cols = cols;
+            result.stride = cols;
+            result.sub_matrix = false;
+            result.allocate();
+            evalTo(result);
+        }
+    }
+
+    // The product is calculated before the destination is written
+    inline bool aliases(const Mat &) const
+    {
+        return false;
+    }
+
+    void evalTo(Mat &dst) const
+    {
+        MatOperand<L> A(lhs);
+        MatOperand<R> B(rhs);
+        if (mat_overlap(A.get(), dst) || mat_overlap(B.get(), dst)) {
+            Mat temp(rows, cols);
+            mat_mult(A.get(), B.get(), temp);
+            dst = temp;
+        } else {
+            mat_mult(A.get(), B.get(), dst);
+        }
+    }
+
+private:
+    typename MatExprTraits<L>::Nested lhs;
+    typename MatExprTraits<R>::Nested rhs;
+    mutable Mat result;
+
+    MatProductExpr &operator=(const MatProductExpr &src);
+};
+
+template <typename E>
+inline Mat MatExpr<E>::t() const
+{
+    Mat temp(derived());
+    return temp.t();
+}
+
+template <typename E>
+Mat::Mat(const MatExpr<E> &src)
+{
+    const E &expr = src.derived();
+    bool valid = MatExprTraits<E>::valid(expr);
+    this->rows = valid ? expr.rows : 1;
+    this->cols = valid ? expr.cols : 1;
+    this->sub_matrix = false;
+    this->stride = this->cols;
+    this->padding = 0;
+    allocate();
+    if (valid) {
+        expr.evalTo(*this);
+    } else {
+        this->data[0] = 0;
+    }
+}
+
+template <typename E>
+Mat &Mat::operator=(const MatExpr<E> &src)
+{
+    const E &expr = src.derived();
+    if (!MatExprTraits<E>::valid(expr) || (this->rows != expr.rows) || (this->cols != expr.cols)) {
+        // Size changes: the expression may use the current buffer
+        Mat temp(expr);
+        return (*this = std::move(temp));
+    }
+    expr.evalTo(*this);
+    return *this;
+}
+
+template <typename E>
+Mat &Mat::operator+=(const MatExpr<E> &src)
+{
+    const E &expr = src.derived();
+    if (!MatExprTraits<E>::valid(expr) || (this->rows != expr.rows) || (this->cols != expr.cols)) {
+        mat_expr_error("operator += Error: matrices do not have equal dimensions");
+        return *this;
+    }
+    MatBinaryExpr<Mat, E, MatOpAdd>(*this, expr, NULL).evalTo(*this);
+    return *this;
+}
+
+template <typename E>
+Mat &Mat::operator-=(const MatExpr<E> &src)
+{
+    const E &expr = src.derived();
+    if (!MatExprTraits<E>::valid(expr) || (this->rows != expr.rows) || (this->cols != expr.cols)) {
+        mat_expr_error("operator -= Error: matrices do not have equal dimensions");
+        return *this;
+    }
+    MatBinaryExpr<Mat, E, MatOpSub>(*this, expr, NULL).evalTo(*this);
+    return *this;
+}
+
+/**
+ * + operator, sum of two matrices
+ *
+ * @param[in] A: Input matrix or expression A
+ * @param[in] B: Input matrix or expression B
+ *
+ * @return
+ *     - expression A+B
+*/
+template <typename L, typename R>
+inline MatBinaryExpr<L, R, MatOpAdd> operator+(const MatExpr<L> &A, const MatExpr<R> &B)
+{
+    return MatBinaryExpr<L, R, MatOpAdd>(A.derived(), B.derived(), "operator + Error: matrices do not have equal dimensions");
+}
+
+/**
+ * + operator, sum of matrix with constant
+ *
+ * @param[in] A: Input matrix or expression A
+ * @param[in] C: Input constant
+ *
+ * @return
+ *     - expression A+C
+*/
+template <typename E>
+inline MatScalarExpr<E, MatOpAdd> operator+(const MatExpr<E> &A, float C)
+{
+    return MatScalarExpr<E, MatOpAdd>(A.derived(), C);
+}
+
+/**
+ * - operator, subtraction of two matrices
+ *
+ * @param[in] A: Input matrix or expression A
+ * @param[in] B: Input matrix or expression B
+ *
+ * @return
+ *     - expression A-B
+*/
+template <typename L, typename R>
+inline MatBinaryExpr<L, R, MatOpSub> operator-(const MatExpr<L> &A, const MatExpr<R> &B)
+{
+    return MatBinaryExpr<L, R, MatOpSub>(A.derived(), B.derived(), "operator - Error: matrices do not have equal dimensions");
+}
+
+/**
+ * - operator, subtraction of constant from matrix
+ *
+ * @param[in] A: Input matrix or expression A
+ * @param[in] C: Input constant
+ *
+ * @return
+ *     - expression A-C
+*/
+template <typename E>
+inline MatScalarExpr<E, MatOpSub> operator-(const MatExpr<E> &A, float C)
+{
+    return MatScalarExpr<E, MatOpSub>(A.derived(), C);
+}
+
+/**
+ * * operator, multiplication of two matrices.
+ * The product uses DSP optimized implementation of multiplication.
+ *
+ * @param[in] A: Input matrix or expression A
+ * @param[in] B: Input matrix or expression B
+ *
+ * @return
+ *     - expression A*B
+*/
+template <typename L, typename R>
+inline MatProductExpr<L, R> operator*(const MatExpr<L> &A, const MatExpr<R> &B)
+{
+    return MatProductExpr<L, R>(A.derived(), B.derived());
+}
+
+/**
+ * * operator, multiplication of matrix with constant
+ *
+ * @param[in] A: Input matrix or expression A
+ * @param[in] C: floating point value
+ *
+ * @return
+ *     - expression A*C
+*/
+template <typename E>
+inline MatScalarExpr<E, MatOpMul> operator*(const MatExpr<E> &A, float C)
+{
+    return MatScalarExpr<E, MatOpMul>(A.derived(), C);
+}
+
+/**
+ * * operator, multiplication of matrix with constant
+ *
+ * @param[in] C: floating point value
+ * @param[in] A: Input matrix or expression A
+ *
+ * @return
+ *     - expression C*A
+*/
+template <typename E>
+inline MatScalarExpr<E, MatOpMul> operator*(float C, const MatExpr<E> &A)
+{
+    return MatScalarExpr<E, MatOpMul>(A.derived(), C);
+}
+
+/**
+ * / operator, divide of matrix by constant
+ *
+ * @param[in] A: Input matrix or expression A
+ * @param[in] C: floating point value
+ *
+ * @return
+ *     - expression A*(1/C)
+*/
+template <typename E>
+inline MatScalarExpr<E, MatOpMul> operator/(const MatExpr<E> &A, float C)
+{
+    return MatScalarExpr<E, MatOpMul>(A.derived(), 1 / C);
+}
+
+/**
+ * / operator, divide matrix A by matrix B
+ *
+ * @param[in] A: Input matrix or expression A
+ * @param[in] B: Input matrix or expression B
+ *
+ * @return
+ *     - expression C, where C[i,j] = A[i,j]/B[i,j]
+*/
+template <typename L, typename R>
+inline MatBinaryExpr<L, R, MatOpDiv> operator/(const MatExpr<L> &A, const MatExpr<R> &B)
+{
+    return MatBinaryExpr<L, R, MatOpDiv>(A.derived(), B.derived(), "operator / Error: matrices do not have equal dimensions");
+}
+
+}
+#endif // _dspm_mat_expr_h_
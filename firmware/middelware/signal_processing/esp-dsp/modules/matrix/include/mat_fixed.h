@@ -0,0 +1,559 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _dspm_mat_fixed_h_
+#define _dspm_mat_fixed_h_
+
+#include <string.h>
+#include <math.h>
+#include "mat.h"
+
+namespace dspm {
+
+/**
+ * @brief   Matrix product kernels with compile time dimensions
+ *
+ * C[M x K] = A[M x N] * B[N x K], all matrices row-major without padding.
+ * The sum order is the same as in dspm_mult_f32_ansi(), so the results are the same
+ * as the results of the Mat operators. Inner dimensions 3 and 4 are unrolled.
+ */
+template <int M, int N, int K>
+struct FixedMult {
+    static inline void mult(const float *A, const float *B, float *C)
+    {
+        for (int i = 0; i < M; i++) {
+            for (int j = 0; j < K; j++) {
+                float acc = A[i * N] * B[j];
+                for (int s = 1; s < N; s++) {
+                    acc += A[i * N + s] * B[s * K + j];
+                }
+                C[i * K + j] = acc;
+            }
+        }
+    }
+
+    // C[M x K] = A[M x N] * B[K x N]'
+    static inline void mult_bt(const float *A, const float *B, float *C)
+    {
+        for (int i = 0; i < M; i++) {
+            for (int j = 0; j < K; j++) {
+                float acc = A[i * N] * B[j * N];
+                for (int s = 1; s < N; s++) {
+                    acc += A[i * N + s] * B[j * N + s];
+                }
+                C[i * K + j] = acc;
+            }
+        }
+    }
+};
+
+template <int M, int K>
+struct FixedMult<M, 3, K> {
+    static inline void mult(const float *A, const float *B, float *C)
+    {
+        for (int i = 0; i < M; i++) {
+            const float a0 = A[i * 3];
+            const float a1 = A[i * 3 + 1];
+            const float a2 = A[i * 3 + 2];
+            for (int j = 0; j < K; j++) {
+                C[i * K + j] = a0 * B[j] + a1 * B[K + j] + a2 * B[2 * K + j];
+            }
+        }
+    }
+
+    static inline void mult_bt(const float *A, const float *B, float *C)
+    {
+        for (int i = 0; i < M; i++) {
+            const float a0 = A[i * 3];
+            const float a1 = A[i * 3 + 1];
+            const float a2 = A[i * 3 + 2];
+            for (int j = 0; j < K; j++) {
+                C[i * K + j] = a0 * B[j * 3] + a1 * B[j * 3 + 1] + a2 * B[j * 3 + 2];
+            }
+        }
+    }
+};
+
+template <int M, int K>
+struct FixedMult<M, 4, K> {
+    static inline void mult(const float *A, const float *B, float *C)
+    {
+        for (int i = 0; i < M; i++) {
+            const float a0 = A[i * 4];
+            const float a1 = A[i * 4 + 1];
+            const float a2 = A[i * 4 + 2];
+            const float a3 = A[i * 4 + 3];
+            for (int j = 0; j < K; j++) {
+                C[i * K + j] = a0 * B[j] + a1 * B[K + j] + a2 * B[2 * K + j] + a3 * B[3 * K + j];
+            }
+        }
+    }
+
+    static inline void mult_bt(const float *A, const float *B, float *C)
+    {
+        for (int i = 0; i < M; i++) {
+            const float a0 = A[i * 4];
+            const float a1 = A[i * 4 + 1];
+            const float a2 = A[i * 4 + 2];
+            const float a3 = A[i * 4 + 3];
+            for (int j = 0; j < K; j++) {
+                C[i * K + j] = a0 * B[j * 4] + a1 * B[j * 4 + 1] + a2 * B[j * 4 + 2] + a3 * B[j * 4 + 3];
+            }
+        }
+    }
+};
+
+/**
+ * @brief   Matrix product kernel with symmetric result
+ *
+ * C[M x M] = A[M x N] * B[M x N]' for products known to be symmetric, like F*P*F'.
+ * Only the upper triangle is calculated and mirrored to the lower one, so C is exactly
+ * symmetric and about half of the multiplications are saved. The upper triangle is
+ * the same as the result of FixedMult<M, N, M>::mult_bt().
+ */
+template <int M, int N>
+struct FixedSymMult {
+    static inline void mult_bt(const float *A, const float *B, float *C)
+    {
+        for (int i = 0; i < M; i++) {
+            for (int j = i; j < M; j++) {
+                float acc = A[i * N] * B[j * N];
+                for (int s = 1; s < N; s++) {
+                    acc += A[i * N + s] * B[j * N + s];
+                }
+                C[i * M + j] = acc;
+                C[j * M + i] = acc;
+            }
+        }
+    }
+};
+
+/**
+ * @brief   Matrix with compile time dimensions
+ *
+ * The FixedMat class keeps the data inside of the object, so a matrix on the stack
+ * or inside of a filter object never uses the heap. The dimensions of all operations
+ * are checked by the compiler. A FixedMat is converted to a Mat view with view()
+ * and a Mat, or a block of it, is copied to a FixedMat with the constructor.
+ */
+template <int R, int C>
+class FixedMat {
+public:
+    static_assert((R > 0) && (C > 0), "FixedMat dimensions must be positive");
+
+    static constexpr int rows = R;  /*!< Amount of rows*/
+    static constexpr int cols = C;  /*!< Amount of columns*/
+    float data[R * C];              /*!< Matrix data, row-major*/
+
+    /**
+     * Constructor, all elements are set to 0.
+     */
+    FixedMat()
+    {
+        memset(data, 0, sizeof(data));
+    }
+
+    /**
+     * Constructor from row-major data.
+     * @param[in] src: R*C values
+     */
+    explicit FixedMat(const float *src)
+    {
+        memcpy(data, src, sizeof(data));
+    }
+
+    /**
+     * Copy a block of a Mat.
+     * The matrix is set to 0 if the block is outside of src.
+     *
+     * @param[in] src: source matrix
+     * @param[in] row: first row of the block in src
+     * @param[in] col: first column of the block in src
+     */
+    explicit FixedMat(const Mat &src, int row = 0, int col = 0)
+    {
+        load(src, row, col);
+    }
+
+    /**
+     * Copy a Mat with the same dimensions.
+     * The matrix is set to 0 if the dimensions are different.
+     *
+     * @param[in] src: source matrix
+     *
+     * @return
+     *      - result matrix
+     */
+    FixedMat &operator=(const Mat &src)
+    {
+        if ((src.rows != R) || (src.cols != C)) {
+            mat_expr_error("FixedMat operator = Error: matrices do not have equal dimensions");
+            memset(data, 0, sizeof(data));
+            return *this;
+        }
+        load(src, 0, 0);
+        return *this;
+    }
+
+    /**
+     * Create identity matrix.
+     *
+     * @return
+     *      - matrix with 1 in the diagonal
+     */
+    static FixedMat eye()
+    {
+        FixedMat result;
+        for (int i = 0; (i < R) && (i < C); i++) {
+            result.data[i * C + i] = 1;
+        }
+        return result;
+    }
+
+    /**
+     * Access to the matrix elements.
+     * @param[in] row: row position
+     * @param[in] col: column position
+     *
+     * @return
+     *      - element of matrix M[row][col]
+     */
+    inline float &operator()(int row, int col)
+    {
+        return data[row * C + col];
+    }
+
+    /**
+     * Access to the matrix elements.
+     * @param[in] row: row position
+     * @param[in] col: column position
+     *
+     * @return
+     *      - element of matrix M[row][col]
+     */
+    inline const float &operator()(int row, int col) const
+    {
+        return data[row * C + col];
+    }
+
+    /**
+     * Mat header that uses the data of this matrix.
+     * No data is copied, the view is valid while this matrix exists.
+     *
+     * @return
+     *      - sub-matrix view [R]x[C]
+     */
+    inline Mat view()
+    {
+        return Mat(data, R, C, C);
+    }
+
+    /**
+     * Copy of this matrix as a Mat with own data.
+     *
+     * @return
+     *      - matrix [R]x[C]
+     */
+    Mat toMat() const
+    {
+        Mat result(R, C);
+        memcpy(result.data, data, sizeof(data));
+        return result;
+    }
+
+    /**
+     * Copy a matrix to the position (ROW, COL).
+     * The block must fit into this matrix, it is checked by the compiler.
+     *
+     * @param[in] src: source matrix
+     */
+    template <int ROW, int COL, int R2, int C2>
+    void Copy(const FixedMat<R2, C2> &src)
+    {
+        static_assert((ROW >= 0) && (COL >= 0) && (ROW + R2 <= R) && (COL + C2 <= C), "FixedMat Copy: block is outside of the matrix");
+        for (int r = 0; r < R2; r++) {
+            memcpy(&data[(ROW + r) * C + COL], &src.data[r * C2], C2 * sizeof(float));
+        }
+    }
+
+    /**
+     * Return the block [R2]x[C2] at the position (ROW, COL).
+     * The block must be inside of this matrix, it is checked by the compiler.
+     *
+     * @return
+     *      - matrix [R2]x[C2]
+     */
+    template <int ROW, int COL, int R2, int C2>
+    FixedMat<R2, C2> Get() const
+    {
+        static_assert((ROW >= 0) && (COL >= 0) && (ROW + R2 <= R) && (COL + C2 <= C), "FixedMat Get: block is outside of the matrix");
+        FixedMat<R2, C2> result;
+        for (int r = 0; r < R2; r++) {
+            memcpy(&result.data[r * C2], &data[(ROW + r) * C + COL], C2 * sizeof(float));
+        }
+        return result;
+    }
+
+    /**
+     * Matrix transpose.
+     *
+     * @return
+     *      - transposed matrix [C]x[R]
+     */
+    FixedMat<C, R> t() const
+    {
+        FixedMat<C, R> result;
+        for (int r = 0; r < R; r++) {
+            for (int c = 0; c < C; c++) {
+                result.data[c * R + r] = data[r * C + c];
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Return norm of the vector or matrix.
+     *
+     * @return
+     *      - matrix norm
+     */
+    float norm() const
+    {
+        float sqr_norm = 0;
+        for (int i = 0; i < R * C; i++) {
+            sqr_norm += data[i] * data[i];
+        }
+        return sqrtf(sqr_norm);
+    }
+
+    /**
+     * += operator
+     * @param[in] A: source matrix
+     *
+     * @return
+     *      - result matrix: result += A
+     */
+    FixedMat &operator+=(const FixedMat &A)
+    {
+        for (int i = 0; i < R * C; i++) {
+            data[i] += A.data[i];
+        }
+        return *this;
+    }
+
+    /**
+     * -= operator
+     * @param[in] A: source matrix
+     *
+     * @return
+     *      - result matrix: result -= A
+     */
+    FixedMat &operator-=(const FixedMat &A)
+    {
+        for (int i = 0; i < R * C; i++) {
+            data[i] -= A.data[i];
+        }
+        return *this;
+    }
+
+    /**
+     * *= with constant operator
+     * @param[in] num: constant value
+     *
+     * @return
+     *      - result matrix: result *= num
+     */
+    FixedMat &operator*=(float num)
+    {
+        for (int i = 0; i < R * C; i++) {
+            data[i] *= num;
+        }
+        return *this;
+    }
+
+    /**
+     * /= with constant operator
+     * @param[in] num: constant value
+     *
+     * @return
+     *      - result matrix: result /= num
+     */
+    FixedMat &operator/=(float num)
+    {
+        return (*this *= 1 / num);
+    }
+
+private:
+    void load(const Mat &src, int row, int col)
+    {
+        if ((row < 0) || (col < 0) || (row + R > src.rows) || (col + C > src.cols)) {
+            mat_expr_error("FixedMat Error: block is outside of the source matrix");
+            memset(data, 0, sizeof(data));
+            return;
+        }
+        for (int r = 0; r < R; r++) {
+            memcpy(&data[r * C], &src.data[(row + r) * src.stride + col], C * sizeof(float));
+        }
+    }
+};
+
+/**
+ * Matrix product into a preallocated matrix C = A*B, without temporary matrices.
+ * If C is the same matrix as A or B, the product is calculated on the stack.
+ *
+ * @param[in] A: input matrix [M]x[N]
+ * @param[in] B: input matrix [N]x[K]
+ * @param[out] C: result matrix [M]x[K]
+ */
+template <int M, int N, int K>
+inline void mult_into(const FixedMat<M, N> &A, const FixedMat<N, K> &B, FixedMat<M, K> &C)
+{
+    if (((const void *)&C == (const void *)&A) || ((const void *)&C == (const void *)&B)) {
+        FixedMat<M, K> temp;
+        FixedMult<M, N, K>::mult(A.data, B.data, temp.data);
+        C = temp;
+    } else {
+        FixedMult<M, N, K>::mult(A.data, B.data, C.data);
+    }
+}
+
+/**
+ * Product with transposed matrix C = A*B', without forming B'.
+ * If C is the same matrix as A or B, the product is calculated on the stack.
+ *
+ * @param[in] A: input matrix [M]x[N]
+ * @param[in] B: input matrix [K]x[N]
+ * @param[out] C: result matrix [M]x[K]
+ */
+template <int M, int N, int K>
+inline void mult_bt_into(const FixedMat<M, N> &A, const FixedMat<K, N> &B, FixedMat<M, K> &C)
+{
+    if (((const void *)&C == (const void *)&A) || ((const void *)&C == (const void *)&B)) {
+        FixedMat<M, K> temp;
+        FixedMult<M, N, K>::mult_bt(A.data, B.data, temp.data);
+        C = temp;
+    } else {
+        FixedMult<M, N, K>::mult_bt(A.data, B.data, C.data);
+    }
+}
+
+/**
+ * Product with symmetric result C = A*B', see FixedSymMult.
+ * If C is the same matrix as A or B, the product is calculated on the stack.
+ *
+ * @param[in] A: input matrix [M]x[N]
+ * @param[in] B: input matrix [M]x[N]
+ * @param[out] C: result matrix [M]x[M]
+ */
+template <int M, int N>
+inline void mult_bt_sym_into(const FixedMat<M, N> &A, const FixedMat<M, N> &B, FixedMat<M, M> &C)
+{
+    if (((const void *)&C == (const void *)&A) || ((const void *)&C == (const void *)&B)) {
+        FixedMat<M, M> temp;
+        FixedSymMult<M, N>::mult_bt(A.data, B.data, temp.data);
+        C = temp;
+    } else {
+        FixedSymMult<M, N>::mult_bt(A.data, B.data, C.data);
+    }
+}
+
+/**
+ * * operator, product of two matrices. The inner dimensions are checked by the compiler.
+ *
+ * @param[in] A: Input matrix [M]x[N]
+ * @param[in] B: Input matrix [N]x[K]
+ *
+ * @return
+ *     - result matrix A*B [M]x[K]
+*/
+template <int M, int N, int K>
+inline FixedMat<M, K> operator*(const FixedMat<M, N> &A, const FixedMat<N, K> &B)
+{
+    FixedMat<M, K> result;
+    FixedMult<M, N, K>::mult(A.data, B.data, result.data);
+    return result;
+}
+
+/**
+ * + operator, sum of two matrices
+ *
+ * @return
+ *     - result matrix A+B
+*/
+template <int R, int C>
+inline FixedMat<R, C> operator+(const FixedMat<R, C> &A, const FixedMat<R, C> &B)
+{
+    FixedMat<R, C> result(A);
+    return (result += B);
+}
+
+/**
+ * - operator, subtraction of two matrices
+ *
+ * @return
+ *     - result matrix A-B
+*/
+template <int R, int C>
+inline FixedMat<R, C> operator-(const FixedMat<R, C> &A, const FixedMat<R, C> &B)
+{
+    FixedMat<R, C> result(A);
+    return (result -= B);
+}
+
+/**
+ * - operator, negative matrix
+ *
+ * @return
+ *     - result matrix -A
+*/
+template <int R, int C>
+inline FixedMat<R, C> operator-(const FixedMat<R, C> &A)
+{
+    FixedMat<R, C> result(A);
+    return (result *= -1.0f);
+}
+
+/**
+ * * operator, multiplication of matrix with constant
+ *
+ * @return
+ *     - result matrix A*num
+*/
+template <int R, int C>
+inline FixedMat<R, C> operator*(const FixedMat<R, C> &A, float num)
+{
+    FixedMat<R, C> result(A);
+    return (result *= num);
+}
+
+/**
+ * * operator, multiplication of matrix with constant
+ *
+ * @return
+ *     - result matrix num*A
+*/
+template <int R, int C>
+inline FixedMat<R, C> operator*(float num, const FixedMat<R, C> &A)
+{
+    FixedMat<R, C> result(A);
+    return (result *= num);
+}
+
+/**
+ * / operator, divide of matrix by constant
+ *
+ * @return
+ *     - result matrix A/num
+*/
+template <int R, int C>
+inline FixedMat<R, C> operator/(const FixedMat<R, C> &A, float num)
+{
+    FixedMat<R, C> result(A);
+    return (result /= num);
+}
+
+}
+#endif // _dspm_mat_fixed_h_
@@ -0,0 +1,105 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _dspm_mat_solve_h_
+#define _dspm_mat_solve_h_
+
+#include "mat.h"
+
+namespace dspm {
+
+/**
+ * Cholesky factorization A = L*L' of a symmetric positive definite matrix, in place.
+ * Only the lower triangle of A is used: it is replaced by L, the strict upper triangle
+ * is not changed.
+ *
+ * @param[in,out] A: square matrix [n]x[n]
+ *
+ * @return
+ *      - true if A is positive definite
+ *      - false otherwise, A is partially factorized
+ */
+bool cholesky_factor(Mat &A);
+
+/**
+ * Solve A*X = B with the factor of cholesky_factor(), X replaces B.
+ *
+ * @param[in] L: factor from cholesky_factor() [n]x[n]
+ * @param[in,out] B: right hand side [n]x[k], result X
+ */
+void cholesky_solve(const Mat &L, Mat &B);
+
+/**
+ * LDL' factorization A = L*D*L' of a symmetric matrix, in place, without pivoting.
+ * Same as Cholesky, but without square roots, and A may also be indefinite if all
+ * pivots are not zero. Only the lower triangle of A is used: the strict lower triangle
+ * is replaced by the unit lower triangular L, the diagonal by D, the strict upper
+ * triangle is not changed.
+ *
+ * @param[in,out] A: square matrix [n]x[n]
+ *
+ * @return
+ *      - true on success
+ *      - false if a pivot is zero, A is partially factorized
+ */
+bool ldl_factor(Mat &A);
+
+/**
+ * Solve A*X = B with the factors of ldl_factor(), X replaces B.
+ *
+ * @param[in] LD: factors from ldl_factor() [n]x[n]
+ * @param[in,out] B: right hand side [n]x[k], result X
+ */
+void ldl_solve(const Mat &LD, Mat &B);
+
+/**
+ * LU factorization P*A = L*U with partial pivoting, in place.
+ * The strict lower triangle of A is replaced by the unit lower triangular L, the upper
+ * triangle by U. Row i was exchanged with row pivot[i] at step i.
+ *
+ * @param[in,out] A: square matrix [n]x[n]
+ * @param[out] pivot: buffer for n row indexes
+ *
+ * @return
+ *      - true on success
+ *      - false if A is singular, A is partially factorized
+ */
+bool lu_factor(Mat &A, int *pivot);
+
+/**
+ * Solve A*X = B with the factors of lu_factor(), X replaces B.
+ *
+ * @param[in] LU: factors from lu_factor() [n]x[n]
+ * @param[in] pivot: row indexes from lu_factor()
+ * @param[in,out] B: right hand side [n]x[k], result X
+ */
+void lu_solve(const Mat &LU, const int *pivot, Mat &B);
+
+/**
+ * Solve A*X = B in place, instead of inverse(A)*B.
+ * The factorization is selected from the matrix:
+ *      - symmetric with positive diagonal, like covariance matrices: Cholesky
+ *      - other symmetric matrices: LDL'
+ *      - all other matrices: LU with partial pivoting
+ * A matrix is symmetric if each asymmetry |A(i, j) - A(j, i)| is within 1e-5 of the larger
+ * of the two elements or of sqrt(|A(i, i)*A(j, j)|), like the result of a product.
+ * If Cholesky or LDL' fails (indefinite matrix, zero pivot), the lower triangle of A is
+ * restored from the upper one and A is solved with LU.
+ * A is replaced by its factors, X replaces B, no memory is allocated.
+ *
+ * @param[in,out] A: square matrix [n]x[n]
+ * @param[in,out] B: right hand side [n]x[k], result X
+ * @param[out] pivot: buffer for n row indexes, used by LU
+ * @param[out] diag: buffer for n values, keeps the diagonal of A while Cholesky or LDL' is tried
+ *
+ * @return
+ *      - true on success
+ *      - false if A is singular, B is not changed
+ */
+bool solve_into(Mat &A, Mat &B, int *pivot, float *diag);
+
+}
+#endif // _dspm_mat_solve_h_
@@ -0,0 +1,89 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _dspm_mat_sparse_h_
+#define _dspm_mat_sparse_h_
+
+#include "mat.h"
+
+namespace dspm {
+
+/**
+ * @brief   Sparsity pattern of a matrix
+ *
+ * Positions of the nonzero elements of a dense matrix in compressed sparse row form:
+ * the nonzero columns of row i are col_index[row_start[i]] ... col_index[row_start[i + 1] - 1],
+ * in increasing order. The values stay in the dense dspm::Mat, so a pattern describes
+ * the structure of a Jacobian once, for example as constant arrays, and the products
+ * below skip all other elements.
+ *
+ * The pattern may contain elements that are zero, but all elements outside of the
+ * pattern must be zero.
+ */
+struct SparsePattern {
+    int rows;               /*!< Amount of rows*/
+    int cols;               /*!< Amount of columns*/
+    const int *row_start;   /*!< rows + 1 offsets in col_index*/
+    const int *col_index;   /*!< Columns of the nonzero elements, row by row*/
+
+    /**
+     * Amount of elements in the pattern.
+     *
+     * @return
+     *      - amount of elements
+     */
+    inline int nnz() const
+    {
+        return row_start[rows];
+    }
+
+    /**
+     * Find the pattern of the nonzero elements of a matrix.
+     * @param[in] A: matrix
+     * @param[out] row_start: buffer for A.rows + 1 values
+     * @param[out] col_index: buffer for up to A.rows*A.cols values
+     *
+     * @return
+     *      - pattern of A, pointing to row_start and col_index
+     */
+    static SparsePattern find(const Mat &A, int *row_start, int *col_index);
+
+    /**
+     * Check that all elements of a matrix outside of the pattern are zero.
+     * @param[in] A: matrix
+     *
+     * @return
+     *      - true if the pattern describes A
+     */
+    bool covers(const Mat &A) const;
+};
+
+/**
+ * Product with sparse matrix C = A*B, the nonzero elements of A are given by a pattern.
+ * The sum order of the nonzero elements is the same as in dspm_mult_f32_ansi(),
+ * so the result is the same as the dense product.
+ *
+ * @param[in] pattern: pattern of A [m]x[n]
+ * @param[in] A: input matrix A [m]x[n]
+ * @param[in] B: input matrix B [n]x[k]
+ * @param[out] C: result matrix [m]x[k], it must not share data with A or B
+ */
+void mult_sparse_into(const SparsePattern &pattern, const Mat &A, const Mat &B, Mat &C);
+
+/**
+ * Product with symmetric result C = A*B', the nonzero elements of B are given by a pattern.
+ * For products known to be symmetric, like F*P*F' with F*P in A and F in B. Only the
+ * upper triangle is calculated and mirrored to the lower one, see mult_bt_sym_into().
+ *
+ * @param[in] A: input matrix A [m]x[n]
+ * @param[in] pattern: pattern of B [m]x[n]
+ * @param[in] B: input matrix B [m]x[n]
+ * @param[out] C: result matrix [m]x[m], it must not share data with A or B
+ */
+void mult_bt_sparse_sym_into(const Mat &A, const SparsePattern &pattern, const Mat &B, Mat &C);
+
+}
+#endif // _dspm_mat_sparse_h_
@@ -32,6 +32,7 @@ using std::endl;
 namespace dspm {
 
 float Mat::abs_tol = 1e-10;
+unsigned int Mat::alloc_count = 0;
 
 Mat::Rect::Rect(int x, int y, int width, int height)
 {
@@ -64,6 +65,7 @@ Mat::Mat(float *data, int roi_rows, int roi_cols, int stride)
     this->length = this->rows * this->cols;
     this->ext_buff = true;
     this->sub_matrix = true;
+    this->allocator = NULL;
 }
 
 Mat::Mat(int rows, int cols)
@@ -82,6 +84,7 @@ Mat::Mat(float *data, int rows, int cols)
 {
     ESP_LOGD("Mat", "Mat(data, %i, %i)", rows, cols);
     this->ext_buff = true;
+    this->allocator = NULL;
     this->rows = rows;
     this->cols = cols;
     this->data = data;
@@ -109,9 +112,7 @@ Mat::Mat()
 Mat::~Mat()
 {
     ESP_LOGD("Mat", "~Mat(%i, %i), ext_buff=%i, data = %p", this->rows, this->cols, this->ext_buff, this->data);
-    if (false == this->ext_buff) {
-        delete[] data;
-    }
+    release();
 }
 
 Mat::Mat(const Mat &m)
@@ -127,12 +128,35 @@ Mat::Mat(const Mat &m)
         this->length = m.length;
         this->data = m.data;
         this->ext_buff = true;
+        this->allocator = NULL;
     } else {
         allocate();
         memcpy(this->data, m.data, this->length * sizeof(float));
     }
 }
 
+Mat::Mat(Mat &&m)
+{
+    if (m.ext_buff) {
+        // The buffer belongs to somebody else, same as the copy constructor
+        this->rows = m.rows;
+        this->cols = m.cols;
+        this->padding = m.padding;
+        this->stride = m.stride;
+        this->data = m.data;
+        this->length = m.length;
+        this->ext_buff = true;
+        this->allocator = NULL;
+        this->sub_matrix = m.sub_matrix;
+        if (!m.sub_matrix) {
+            allocate();
+            memcpy(this->data, m.data, this->length * sizeof(float));
+        }
+        return;
+    }
+    moveFrom(m);
+}
+
 Mat Mat::getROI(int startRow, int startCol, int roiRows, int roiCols, int stride)
 {
     Mat result(this->data, roiRows, roiCols, 0);
@@ -179,9 +203,7 @@ void Mat::Copy(const Mat &src, int row_pos, int col_pos)
 
 void Mat::CopyHead(const Mat &src)
 {
-    if (!this->ext_buff) {
-        delete[] this->data;
-    }
+    release();
     this->rows = src.rows;
     this->cols = src.cols;
     this->length = src.length;
@@ -190,6 +212,7 @@ void Mat::CopyHead(const Mat &src)
     this->data = src.data;
     this->ext_buff = src.ext_buff;
     this->sub_matrix = src.sub_matrix;
+    this->allocator = src.allocator;
 }
 
 void Mat::PrintHead(void)
@@ -239,16 +262,16 @@ Mat &Mat::operator=(const Mat &m)
             ESP_LOGE("Mat", "operator = Error for sub-matrices: operands matrices dimensions %dx%d and %dx%d do not match", this->rows, this->cols, m.rows, m.cols);
             return *this;
         }
-        if (!this->ext_buff) {
-            delete[] this->data;
-        }
+        // The new buffer comes from the allocator of this matrix, not from the one of the task
+        MatAllocator *allocator = this->ext_buff ? NULL : this->allocator;
+        release();
         this->ext_buff = false;
         this->rows = m.rows;
         this->cols = m.cols;
         this->stride = this->cols;
         this->padding = 0;
         this->sub_matrix = false;
-        allocate();
+        allocate(allocator);
     }
 
     for (int row = 0; row < this->rows; row++) {
@@ -257,6 +280,22 @@ Mat &Mat::operator=(const Mat &m)
     return *this;
 }
 
+Mat &Mat::operator=(Mat &&m)
+{
+    if (this == &m) {
+        return *this;
+    }
+    // Same size, a sub-matrix, a buffer of somebody else or of another allocator: the data is copied.
+    // A buffer of an arena does not move to a matrix that lives longer than the arena step.
+    if (((this->rows == m.rows) && (this->cols == m.cols)) || this->sub_matrix || m.ext_buff ||
+            (m.allocator != (this->ext_buff ? NULL : this->allocator))) {
+        return (*this = static_cast<const Mat &>(m));
+    }
+    release();
+    moveFrom(m);
+    return *this;
+}
+
 Mat &Mat::operator+=(const Mat &m)
 {
     if ((this->rows != m.rows) || (this->cols != m.cols)) {
@@ -731,7 +770,7 @@ Mat Mat::cofactor(int row, int col, int n)
 
                 // Row is filled, so increase row index and
                 // reset col index
-                if (j == this->rows - 1) {
+                if (j == n - 1) {
                     j = 0;
                     i++;
                 }
@@ -819,13 +858,65 @@ Mat Mat::inverse()
 }
 
 void Mat::allocate()
+{
+    // Buffer from the allocator of the task
+    allocate(MatAllocator::active());
+}
+
+void Mat::allocate(MatAllocator *allocator)
 {
     this->ext_buff = false;
     this->length = this->rows * this->cols;
-    data = new float[this->length];
+    // Buffer from the heap if there is no allocator or it is full
+    this->allocator = allocator;
+    this->data = NULL;
+    if (this->allocator) {
+        this->data = this->allocator->alloc(this->length);
+    }
+    if (this->data == NULL) {
+        this->allocator = NULL;
+        this->data = new float[this->length];
+    }
+    alloc_count++;
     ESP_LOGD("Mat", "allocate(%i) = %p", this->length, this->data);
 }
 
+void Mat::release()
+{
+    if (this->ext_buff) {
+        return;
+    }
+    if (this->allocator) {
+        this->allocator->free(this->data, this->length);
+    } else {
+        delete[] this->data;
+    }
+}
+
+void Mat::moveFrom(Mat &src)
+{
+    this->rows = src.rows;
+    this->cols = src.cols;
+    this->padding = src.padding;
+    this->stride = src.stride;
+    this->data = src.data;
+    this->length = src.length;
+    this->ext_buff = src.ext_buff;
+    this->sub_matrix = src.sub_matrix;
+    this->allocator = src.allocator;
+
+    // src is left as an empty matrix without buffer
+    src.rows = 0;
+    src.cols = 0;
+    src.padding = 0;
+    src.stride = 0;
+    src.data = NULL;
+    src.length = 0;
+    src.ext_buff = true;
+    src.sub_matrix = false;
+    src.allocator = NULL;
+}
+
 Mat Mat::expHelper(const Mat &m, int num)
 {
     if (num == 0) {
@@ -839,147 +930,244 @@ Mat Mat::expHelper(const Mat &m, int num)
     }
 }
 
-Mat operator+(const Mat &m1, const Mat &m2)
+void mat_mult(const Mat &A, const Mat &B, Mat &C)
 {
-    if ((m1.rows != m2.rows) || (m1.cols != m2.cols)) {
-        ESP_LOGW("Mat", "operator + Error: matrices do not have equal dimensions");
-        Mat err_ret;
-        return err_ret;
-    }
-
-    if (m1.sub_matrix || m2.sub_matrix) {
-        Mat temp(m1.rows, m2.cols);
-        dspm_add_f32(m1.data, m2.data, temp.data, m1.rows, m1.cols, m1.padding, m2.padding, temp.padding, 1, 1, 1);
-        return temp;
+    if (A.sub_matrix || B.sub_matrix || C.sub_matrix) {
+        dspm_mult_ex_f32(A.data, B.data, C.data, A.rows, A.cols, B.cols, A.padding, B.padding, C.padding);
     } else {
-        Mat temp(m1);
-        return (temp += m2);
+        dspm_mult_f32(A.data, B.data, C.data, A.rows, A.cols, B.cols);
     }
 }
 
-Mat operator+(const Mat &m, float C)
+void mat_expr_error(const char *message)
 {
-    if (m.sub_matrix) {
-        Mat temp(m.rows, m.cols);
-        dspm_addc_f32(m.data, temp.data, C, m.rows, m.cols, m.padding, temp.padding, 1, 1);
-        return temp;
-    } else {
-        Mat temp(m);
-        return (temp += C);
-    }
+    ESP_LOGW("Mat", "%s", message);
 }
 
-bool operator==(const Mat &m1, const Mat &m2)
+// Give dst the size rows x cols, the buffer is kept if the size is the same
+static bool mat_into_size(Mat &dst, int rows, int cols, const char *name)
 {
-    if ((m1.cols != m2.cols) || (m1.rows != m2.rows)) {
+    if ((dst.rows == rows) && (dst.cols == cols)) {
+        return true;
+    }
+    if (dst.sub_matrix) {
+        ESP_LOGE("Mat", "%s Error for sub-matrices: result dimensions %dx%d and %dx%d do not match", name, dst.rows, dst.cols, rows, cols);
         return false;
     }
+    dst = Mat(rows, cols);
+    return true;
+}
 
-    for (int row = 0; row < m1.rows; row++) {
-        for (int col = 0; col < m1.cols; col++) {
-            if (m1(row, col) != m2(row, col)) {
-                ESP_LOGW("Mat", "operator == Error: %i %i, m1.data=%f, m2.data=%f \n", row, col, m1(row, col), m2(row, col));
-                return false;
-            }
-        }
+void add_into(const Mat &A, const Mat &B, Mat &dst)
+{
+    if ((A.rows != B.rows) || (A.cols != B.cols)) {
+        ESP_LOGW("Mat", "add_into Error: matrices do not have equal dimensions");
+        return;
     }
+    if (!mat_into_size(dst, A.rows, A.cols, "add_into")) {
+        return;
+    }
+    dspm_add_f32(A.data, B.data, dst.data, A.rows, A.cols, A.padding, B.padding, dst.padding, 1, 1, 1);
+}
 
-    return true;
+void sub_into(const Mat &A, const Mat &B, Mat &dst)
+{
+    if ((A.rows != B.rows) || (A.cols != B.cols)) {
+        ESP_LOGW("Mat", "sub_into Error: matrices do not have equal dimensions");
+        return;
+    }
+    if (!mat_into_size(dst, A.rows, A.cols, "sub_into")) {
+        return;
+    }
+    dspm_sub_f32(A.data, B.data, dst.data, A.rows, A.cols, A.padding, B.padding, dst.padding, 1, 1, 1);
 }
 
-Mat operator-(const Mat &m1, const Mat &m2)
+void mult_into(const Mat &A, float C, Mat &dst)
 {
-    if ((m1.rows != m2.rows) || (m1.cols != m2.cols)) {
-        ESP_LOGW("Mat", "operator - Error: matrices do not have equal dimensions");
-        Mat err_ret;
-        return err_ret;
+    if (!mat_into_size(dst, A.rows, A.cols, "mult_into")) {
+        return;
     }
+    dspm_mulc_f32(A.data, dst.data, C, A.rows, A.cols, A.padding, dst.padding, 1, 1);
+}
 
-    if (m1.sub_matrix || m2.sub_matrix) {
-        Mat temp(m1.rows, m1.cols);
-        dspm_sub_f32(m1.data, m2.data, temp.data, m1.rows, m1.cols, m1.padding, m2.padding, temp.padding, 1, 1, 1);
-        return temp;
-    } else {
-        Mat temp(m1);
-        return (temp -= m2);
+void mult_into(const Mat &A, const Mat &B, Mat &dst)
+{
+    if (A.cols != B.rows) {
+        ESP_LOGW("Mat", "mult_into Error: matrices do not have correct dimensions");
+        return;
     }
+    if (mat_overlap(A, dst) || mat_overlap(B, dst)) {
+        Mat temp(A.rows, B.cols);
+        mat_mult(A, B, temp);
+        dst = std::move(temp);
+        return;
+    }
+    if (!mat_into_size(dst, A.rows, B.cols, "mult_into")) {
+        return;
+    }
+    mat_mult(A, B, dst);
 }
 
-Mat operator-(const Mat &m, float C)
+// dst = A * B', same order of the sum as dspm_mult_f32_ansi()
+static void mat_mult_bt(const Mat &A, const Mat &B, Mat &dst)
 {
-    if (m.sub_matrix) {
-        Mat temp(m.rows, m.cols);
-        dspm_addc_f32(m.data, temp.data, -C, m.rows, m.cols, m.padding, temp.padding, 1, 1);
-        return temp;
-    } else {
-        Mat temp(m);
-        return (temp -= C);
+    for (int i = 0; i < A.rows; i++) {
+        const float *a = A.data + i * A.stride;
+        float *out = dst.data + i * dst.stride;
+        for (int j = 0; j < B.rows; j++) {
+            const float *b = B.data + j * B.stride;
+            float acc = a[0] * b[0];
+            for (int s = 1; s < A.cols; s++) {
+                acc += a[s] * b[s];
+            }
+            out[j] = acc;
+        }
     }
 }
 
-Mat operator*(const Mat &m1, const Mat &m2)
+void mult_bt_into(const Mat &A, const Mat &B, Mat &dst)
 {
-    if (m1.cols != m2.rows) {
-        ESP_LOGW("Mat", "operator * Error: matrices do not have correct dimensions");
-        Mat err_ret;
-        return err_ret;
+    if (A.cols != B.cols) {
+        ESP_LOGW("Mat", "mult_bt_into Error: matrices do not have correct dimensions");
+        return;
     }
-    Mat temp(m1.rows, m2.cols);
+    if (mat_overlap(A, dst) || mat_overlap(B, dst)) {
+        Mat temp(A.rows, B.rows);
+        mat_mult_bt(A, B, temp);
+        dst = std::move(temp);
+        return;
+    }
+    if (!mat_into_size(dst, A.rows, B.rows, "mult_bt_into")) {
+        return;
+    }
+    mat_mult_bt(A, B, dst);
+}
 
-    if (m1.sub_matrix || m2.sub_matrix) {
-        dspm_mult_ex_f32(m1.data, m2.data, temp.data, m1.rows, m1.cols, m2.cols, m1.padding, m2.padding, temp.padding);
-    } else {
-        dspm_mult_f32(m1.data, m2.data, temp.data, m1.rows, m1.cols, m2.cols);
+void transpose_into(const Mat &A, Mat &dst)
+{
+    if (mat_overlap(A, dst)) {
+        Mat temp(A.cols, A.rows);
+        transpose_into(A, temp);
+        dst = std::move(temp);
+        return;
+    }
+    if (!mat_into_size(dst, A.cols, A.rows, "transpose_into")) {
+        return;
     }
+    for (int row = 0; row < A.rows; row++) {
+        for (int col = 0; col < A.cols; col++) {
+            dst(col, row) = A(row, col);
+        }
+    }
+}
 
-    return temp;
+// Upper triangle of dst = A * B', mirrored to the lower one
+static void mat_mult_bt_sym(const Mat &A, const Mat &B, Mat &dst)
+{
+    for (int i = 0; i < A.rows; i++) {
+        const float *a = A.data + i * A.stride;
+        for (int j = i; j < B.rows; j++) {
+            const float *b = B.data + j * B.stride;
+            float acc = a[0] * b[0];
+            for (int s = 1; s < A.cols; s++) {
+                acc += a[s] * b[s];
+            }
+            dst(i, j) = acc;
+            dst(j, i) = acc;
+        }
+    }
+}
 
+void mult_bt_sym_into(const Mat &A, const Mat &B, Mat &dst)
+{
+    if ((A.cols != B.cols) || (A.rows != B.rows)) {
+        ESP_LOGW("Mat", "mult_bt_sym_into Error: matrices do not have correct dimensions");
+        return;
+    }
+    if (mat_overlap(A, dst) || mat_overlap(B, dst)) {
+        Mat temp(A.rows, A.rows);
+        mat_mult_bt_sym(A, B, temp);
+        dst = std::move(temp);
+        return;
+    }
+    if (!mat_into_size(dst, A.rows, A.rows, "mult_bt_sym_into")) {
+        return;
+    }
+    mat_mult_bt_sym(A, B, dst);
 }
 
-Mat operator*(const Mat &m, float num)
+void sym_mirror(Mat &A)
 {
-    if (m.sub_matrix) {
-        Mat temp(m.rows, m.cols);
-        dspm_mulc_f32(m.data, temp.data, num, m.rows, m.cols, m.padding, temp.padding, 1, 1);
-        return temp;
-    } else {
-        Mat temp(m);
-        return (temp *= num);
+    if (A.rows != A.cols) {
+        ESP_LOGW("Mat", "sym_mirror Error: matrix is not square");
+        return;
+    }
+    for (int i = 1; i < A.rows; i++) {
+        for (int j = 0; j < i; j++) {
+            A(i, j) = A(j, i);
+        }
     }
 }
 
-Mat operator*(float num, const Mat &m)
+float sym_error(const Mat &A)
 {
-    return (m * num);
+    if (A.rows != A.cols) {
+        ESP_LOGW("Mat", "sym_error Error: matrix is not square");
+        return 0;
+    }
+    float result = 0;
+    for (int i = 1; i < A.rows; i++) {
+        for (int j = 0; j < i; j++) {
+            float error = fabsf(A(i, j) - A(j, i));
+            if (error > result) {
+                result = error;
+            }
+        }
+    }
+    return result;
 }
 
-Mat operator/(const Mat &m, float num)
+void sym_pack(const Mat &A, float *packed)
 {
-    if (m.sub_matrix) {
-        Mat temp(m.rows, m.cols);
-        dspm_mulc_f32(m.data, temp.data, 1 / num, m.rows, m.cols, m.padding, temp.padding, 1, 1);
-        return temp;
-    } else {
-        Mat temp(m);
-        return (temp /= num);
+    if (A.rows != A.cols) {
+        ESP_LOGW("Mat", "sym_pack Error: matrix is not square");
+        return;
+    }
+    for (int i = 0; i < A.rows; i++) {
+        memcpy(packed, &A.data[i * A.stride + i], (A.cols - i) * sizeof(float));
+        packed += A.cols - i;
     }
 }
 
-Mat operator/(const Mat &A, const Mat &B)
+void sym_unpack(const float *packed, Mat &dst)
 {
-    if ((A.rows != B.rows) || (A.cols != B.cols)) {
-        ESP_LOGW("Mat", "Operator + Error: matrices do not have equal dimensions");
-        Mat err_ret;
-        return err_ret;
+    if (dst.rows != dst.cols) {
+        ESP_LOGW("Mat", "sym_unpack Error: matrix is not square");
+        return;
     }
+    for (int i = 0; i < dst.rows; i++) {
+        memcpy(&dst.data[i * dst.stride + i], packed, (dst.cols - i) * sizeof(float));
+        packed += dst.cols - i;
+    }
+    sym_mirror(dst);
+}
 
-    Mat temp(A.rows, A.cols);
-    for (int row = 0; row < A.rows; row++) {
-        for (int col = 0; col < A.cols; col++) {
-            temp(row, col) = A(row, col) / B(row, col);
+bool operator==(const Mat &m1, const Mat &m2)
+{
+    if ((m1.cols != m2.cols) || (m1.rows != m2.rows)) {
+        return false;
+    }
+
+    for (int row = 0; row < m1.rows; row++) {
+        for (int col = 0; col < m1.cols; col++) {
+            if (m1(row, col) != m2(row, col)) {
+                ESP_LOGW("Mat", "operator == Error: %i %i, m1.data=%f, m2.data=%f \n", row, col, m1(row, col), m2(row, col));
+                return false;
+            }
         }
     }
-    return temp;
+
+    return true;
 }
 
 ostream &operator<<(ostream &os, const Mat &m)
@@ -0,0 +1,214 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdint.h>
+#include "malloc.h"
+#include "mat_alloc.h"
+#include "esp_log.h"
+
+static const char *TAG = "MatAlloc";
+
+namespace dspm {
+
+// Buffers are aligned to 16 bytes
+#define MAT_ALLOC_ALIGN 4
+
+static inline int mat_alloc_round(int length)
+{
+    return (length + MAT_ALLOC_ALIGN - 1) & ~(MAT_ALLOC_ALIGN - 1);
+}
+
+// Start of an external memory block aligned to 16 bytes. A misaligned block is an error,
+// its first values are skipped so the buffers are still aligned.
+static float *mat_alloc_align(float *buffer, int *length, const char *name)
+{
+    int skip = (-(int)((uintptr_t)buffer / sizeof(float))) & (MAT_ALLOC_ALIGN - 1);
+    if (skip != 0) {
+        ESP_LOGE(TAG, "%s Error: memory block %p is not aligned to 16 bytes", name, buffer);
+        *length = (*length > skip) ? *length - skip : 0;
+    }
+    return buffer + skip;
+}
+
+static thread_local MatAllocator *mat_allocator_active = NULL;
+
+MatAllocator *MatAllocator::active()
+{
+    return mat_allocator_active;
+}
+
+void MatAllocator::setActive(MatAllocator *allocator)
+{
+    mat_allocator_active = allocator;
+}
+
+MatArena::MatArena(float *buffer, int length)
+{
+    this->buffer = mat_alloc_align(buffer, &length, "MatArena");
+    this->length = length;
+    this->used = 0;
+    this->peak = 0;
+    this->live = 0;
+    this->overflows = 0;
+    this->ext_buff = true;
+}
+
+MatArena::MatArena(int length)
+{
+    this->buffer = (float *)memalign(16, length * sizeof(float));
+    this->length = (this->buffer != NULL) ? length : 0;
+    this->used = 0;
+    this->peak = 0;
+    this->live = 0;
+    this->overflows = 0;
+    this->ext_buff = false;
+}
+
+MatArena::~MatArena()
+{
+    if (this->live != 0) {
+        ESP_LOGE(TAG, "MatArena destroyed with %i buffers in use", this->live);
+    }
+    if (!this->ext_buff) {
+        ::free(this->buffer);
+    }
+}
+
+float *MatArena::alloc(int length)
+{
+    int size = mat_alloc_round(length);
+    if (size > this->length - this->used) {
+        this->overflows++;
+        return NULL;
+    }
+    float *result = this->buffer + this->used;
+    this->used += size;
+    this->live++;
+    if (this->used > this->peak) {
+        this->peak = this->used;
+    }
+    return result;
+}
+
+void MatArena::free(float *data, int length)
+{
+    int size = mat_alloc_round(length);
+    this->live--;
+    // The last buffer is reused immediately, others at reset()
+    if (data + size == this->buffer + this->used) {
+        this->used -= size;
+    }
+    if (this->live == 0) {
+        this->used = 0;
+    }
+}
+
+bool MatArena::reset()
+{
+    if (this->live != 0) {
+        ESP_LOGE(TAG, "MatArena reset with %i buffers in use", this->live);
+        return false;
+    }
+    this->used = 0;
+    return true;
+}
+
+// Size class of a buffer: 4 << class float values
+static int mat_pool_class(int length)
+{
+    int result = 0;
+    while ((MAT_ALLOC_ALIGN << result) < length) {
+        result++;
+    }
+    return result;
+}
+
+MatPool::MatPool(float *buffer, int length)
+{
+    this->buffer = mat_alloc_align(buffer, &length, "MatPool");
+    this->length = length;
+    this->used = 0;
+    this->live = 0;
+    this->overflows = 0;
+    this->ext_buff = true;
+    memset(this->free_list, 0, sizeof(this->free_list));
+}
+
+MatPool::MatPool(int length)
+{
+    this->buffer = (float *)memalign(16, length * sizeof(float));
+    this->length = (this->buffer != NULL) ? length : 0;
+    this->used = 0;
+    this->live = 0;
+    this->overflows = 0;
+    this->ext_buff = false;
+    memset(this->free_list, 0, sizeof(this->free_list));
+}
+
+MatPool::~MatPool()
+{
+    if (this->live != 0) {
+        ESP_LOGE(TAG, "MatPool destroyed with %i buffers in use", this->live);
+    }
+    if (!this->ext_buff) {
+        ::free(this->buffer);
+    }
+}
+
+float *MatPool::alloc(int length)
+{
+    int size_class = mat_pool_class(length);
+    if (size_class >= MatPool::classes) {
+        this->overflows++;
+        return NULL;
+    }
+    float *result = this->free_list[size_class];
+    if (result != NULL) {
+        // The free buffer keeps the pointer to the next free buffer of the class
+        memcpy(&this->free_list[size_class], result, sizeof(float *));
+    } else {
+        int size = MAT_ALLOC_ALIGN << size_class;
+        if (size > this->length - this->used) {
+            this->overflows++;
+            return NULL;
+        }
+        result = this->buffer + this->used;
+        this->used += size;
+    }
+    this->live++;
+    return result;
+}
+
+void MatPool::free(float *data, int length)
+{
+    int size_class = mat_pool_class(length);
+    memcpy(data, &this->free_list[size_class], sizeof(float *));
+    this->free_list[size_class] = data;
+    this->live--;
+}
+
+MatAllocatorScope::MatAllocatorScope(MatAllocator *allocator)
+{
+    this->previous = MatAllocator::active();
+    MatAllocator::setActive(allocator);
+}
+
+MatAllocatorScope::~MatAllocatorScope()
+{
+    MatAllocator::setActive(this->previous);
+}
+
+MatArenaStep::MatArenaStep(MatArena &arena) : arena(arena), scope(&arena)
+{
+}
+
+MatArenaStep::~MatArenaStep()
+{
+    this->arena.reset();
+}
+
+}
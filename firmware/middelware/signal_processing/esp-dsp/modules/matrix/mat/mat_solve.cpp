@@ -0,0 +1,285 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <math.h>
+#include "mat_solve.h"
+#include "esp_log.h"
+
+namespace dspm {
+
+static bool mat_solve_check(const Mat &A, const Mat &B, const char *name)
+{
+    if ((A.rows != A.cols) || (B.rows != A.rows)) {
+        ESP_LOGW("Mat", "%s Error: matrices do not have correct dimensions", name);
+        return false;
+    }
+    return true;
+}
+
+// row(i) -= a*row(j) of B
+static inline void mat_row_sub(Mat &B, int i, int j, float a)
+{
+    float *bi = B.data + i * B.stride;
+    const float *bj = B.data + j * B.stride;
+    for (int k = 0; k < B.cols; k++) {
+        bi[k] -= a * bj[k];
+    }
+}
+
+static inline void mat_row_scale(Mat &B, int i, float a)
+{
+    float *bi = B.data + i * B.stride;
+    for (int k = 0; k < B.cols; k++) {
+        bi[k] *= a;
+    }
+}
+
+// B = inv(L)*B, L lower triangular, with unit diagonal if diag is false
+static void mat_forward(const Mat &L, Mat &B, bool diag)
+{
+    for (int i = 0; i < L.rows; i++) {
+        const float *l = L.data + i * L.stride;
+        for (int j = 0; j < i; j++) {
+            if (l[j] != 0) {
+                mat_row_sub(B, i, j, l[j]);
+            }
+        }
+        if (diag) {
+            mat_row_scale(B, i, 1 / l[i]);
+        }
+    }
+}
+
+// B = inv(L')*B, L lower triangular, with unit diagonal if diag is false
+static void mat_backward_lt(const Mat &L, Mat &B, bool diag)
+{
+    for (int i = L.rows - 1; i >= 0; i--) {
+        for (int j = i + 1; j < L.rows; j++) {
+            float l = L(j, i);
+            if (l != 0) {
+                mat_row_sub(B, i, j, l);
+            }
+        }
+        if (diag) {
+            mat_row_scale(B, i, 1 / L(i, i));
+        }
+    }
+}
+
+bool cholesky_factor(Mat &A)
+{
+    if (A.rows != A.cols) {
+        ESP_LOGW("Mat", "cholesky_factor Error: matrix is not square");
+        return false;
+    }
+    int n = A.rows;
+    for (int j = 0; j < n; j++) {
+        float d = A(j, j);
+        if (!(d > 0)) {
+            return false;
+        }
+        d = sqrtf(d);
+        A(j, j) = d;
+        float inv_d = 1 / d;
+        for (int i = j + 1; i < n; i++) {
+            A(i, j) *= inv_d;
+        }
+        // Lower triangle of the rest: A = A - l*l'
+        for (int i = j + 1; i < n; i++) {
+            float *a = A.data + i * A.stride;
+            float l = a[j];
+            for (int k = j + 1; k <= i; k++) {
+                a[k] -= l * A(k, j);
+            }
+        }
+    }
+    return true;
+}
+
+void cholesky_solve(const Mat &L, Mat &B)
+{
+    if (!mat_solve_check(L, B, "cholesky_solve")) {
+        return;
+    }
+    mat_forward(L, B, true);
+    mat_backward_lt(L, B, true);
+}
+
+bool ldl_factor(Mat &A)
+{
+    if (A.rows != A.cols) {
+        ESP_LOGW("Mat", "ldl_factor Error: matrix is not square");
+        return false;
+    }
+    int n = A.rows;
+    for (int j = 0; j < n; j++) {
+        float d = A(j, j);
+        if (d == 0) {
+            return false;
+        }
+        float inv_d = 1 / d;
+        // Lower triangle of the rest: A = A - l*d*l'. The rows are updated from the last one,
+        // so column j of the rows above still holds l*d.
+        for (int i = n - 1; i > j; i--) {
+            float *a = A.data + i * A.stride;
+            float l = a[j] * inv_d;
+            for (int k = j + 1; k <= i; k++) {
+                a[k] -= l * A(k, j);
+            }
+            a[j] = l;
+        }
+    }
+    return true;
+}
+
+void ldl_solve(const Mat &LD, Mat &B)
+{
+    if (!mat_solve_check(LD, B, "ldl_solve")) {
+        return;
+    }
+    mat_forward(LD, B, false);
+    for (int i = 0; i < LD.rows; i++) {
+        mat_row_scale(B, i, 1 / LD(i, i));
+    }
+    mat_backward_lt(LD, B, false);
+}
+
+bool lu_factor(Mat &A, int *pivot)
+{
+    if (A.rows != A.cols) {
+        ESP_LOGW("Mat", "lu_factor Error: matrix is not square");
+        return false;
+    }
+    int n = A.rows;
+    for (int j = 0; j < n; j++) {
+        int p = j;
+        float max = fabsf(A(j, j));
+        for (int i = j + 1; i < n; i++) {
+            if (fabsf(A(i, j)) > max) {
+                max = fabsf(A(i, j));
+                p = i;
+            }
+        }
+        pivot[j] = p;
+        if (max == 0) {
+            return false;
+        }
+        if (p != j) {
+            float *a = A.data + j * A.stride;
+            float *b = A.data + p * A.stride;
+            for (int k = 0; k < n; k++) {
+                float temp = a[k];
+                a[k] = b[k];
+                b[k] = temp;
+            }
+        }
+        const float *u = A.data + j * A.stride;
+        float inv_d = 1 / u[j];
+        for (int i = j + 1; i < n; i++) {
+            float *a = A.data + i * A.stride;
+            float l = a[j] * inv_d;
+            a[j] = l;
+            if (l != 0) {
+                for (int k = j + 1; k < n; k++) {
+                    a[k] -= l * u[k];
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void lu_solve(const Mat &LU, const int *pivot, Mat &B)
+{
+    if (!mat_solve_check(LU, B, "lu_solve")) {
+        return;
+    }
+    int n = LU.rows;
+    for (int j = 0; j < n; j++) {
+        if (pivot[j] != j) {
+            float *a = B.data + j * B.stride;
+            float *b = B.data + pivot[j] * B.stride;
+            for (int k = 0; k < B.cols; k++) {
+                float temp = a[k];
+                a[k] = b[k];
+                b[k] = temp;
+            }
+        }
+    }
+    mat_forward(LU, B, false);
+    for (int i = n - 1; i >= 0; i--) {
+        const float *u = LU.data + i * LU.stride;
+        for (int j = i + 1; j < n; j++) {
+            if (u[j] != 0) {
+                mat_row_sub(B, i, j, u[j]);
+            }
+        }
+        mat_row_scale(B, i, 1 / u[i]);
+    }
+}
+
+// Symmetric within the float rounding of a product: each asymmetry relative to the larger of
+// the two elements, or to sqrt(A(i, i)*A(j, j)) for the elements that cancel, like in a covariance
+static bool mat_is_symmetric(const Mat &A)
+{
+    for (int i = 1; i < A.rows; i++) {
+        for (int j = 0; j < i; j++) {
+            const float a = fabsf(A(i, j));
+            const float b = fabsf(A(j, i));
+            const float d = sqrtf(fabsf(A(i, i) * A(j, j)));
+            float scale = a > b ? a : b;
+            scale = d > scale ? d : scale;
+            if (fabsf(A(i, j) - A(j, i)) > 1e-5f * scale) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Cholesky and LDL' change only the lower triangle: it is restored from the upper one and the
+// diagonal from diag
+static void mat_restore_lower(Mat &A, const float *diag)
+{
+    for (int i = 0; i < A.rows; i++) {
+        A(i, i) = diag[i];
+        for (int j = 0; j < i; j++) {
+            A(i, j) = A(j, i);
+        }
+    }
+}
+
+bool solve_into(Mat &A, Mat &B, int *pivot, float *diag)
+{
+    if (!mat_solve_check(A, B, "solve_into")) {
+        return false;
+    }
+    if (mat_is_symmetric(A)) {
+        bool positive = true;
+        for (int i = 0; i < A.rows; i++) {
+            diag[i] = A(i, i);
+            positive = positive && (A(i, i) > 0);
+        }
+        if (positive ? cholesky_factor(A) : ldl_factor(A)) {
+            if (positive) {
+                cholesky_solve(A, B);
+            } else {
+                ldl_solve(A, B);
+            }
+            return true;
+        }
+        // Indefinite with positive diagonal, or a zero pivot without pivoting
+        mat_restore_lower(A, diag);
+    }
+    if (!lu_factor(A, pivot)) {
+        ESP_LOGW("Mat", "solve_into Error: matrix is singular");
+        return false;
+    }
+    lu_solve(A, pivot, B);
+    return true;
+}
+
+}
@@ -0,0 +1,105 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "mat_sparse.h"
+#include "esp_log.h"
+
+namespace dspm {
+
+SparsePattern SparsePattern::find(const Mat &A, int *row_start, int *col_index)
+{
+    int count = 0;
+    for (int row = 0; row < A.rows; row++) {
+        row_start[row] = count;
+        for (int col = 0; col < A.cols; col++) {
+            if (A(row, col) != 0) {
+                col_index[count++] = col;
+            }
+        }
+    }
+    row_start[A.rows] = count;
+
+    SparsePattern result = {A.rows, A.cols, row_start, col_index};
+    return result;
+}
+
+bool SparsePattern::covers(const Mat &A) const
+{
+    if ((A.rows != this->rows) || (A.cols != this->cols)) {
+        return false;
+    }
+    for (int row = 0; row < A.rows; row++) {
+        int next = this->row_start[row];
+        for (int col = 0; col < A.cols; col++) {
+            if ((next < this->row_start[row + 1]) && (this->col_index[next] == col)) {
+                next++;
+            } else if (A(row, col) != 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void mult_sparse_into(const SparsePattern &pattern, const Mat &A, const Mat &B, Mat &C)
+{
+    if ((pattern.rows != A.rows) || (pattern.cols != A.cols) || (A.cols != B.rows) ||
+            (C.rows != A.rows) || (C.cols != B.cols)) {
+        ESP_LOGW("Mat", "mult_sparse_into Error: matrices do not have correct dimensions");
+        return;
+    }
+    for (int i = 0; i < A.rows; i++) {
+        float *c = C.data + i * C.stride;
+        int start = pattern.row_start[i];
+        int end = pattern.row_start[i + 1];
+        if (start == end) {
+            for (int j = 0; j < B.cols; j++) {
+                c[j] = 0;
+            }
+            continue;
+        }
+        // C(i, :) = sum of A(i, k)*B(k, :) for the nonzero A(i, k)
+        float a = A(i, pattern.col_index[start]);
+        const float *b = B.data + pattern.col_index[start] * B.stride;
+        for (int j = 0; j < B.cols; j++) {
+            c[j] = a * b[j];
+        }
+        for (int s = start + 1; s < end; s++) {
+            a = A(i, pattern.col_index[s]);
+            b = B.data + pattern.col_index[s] * B.stride;
+            for (int j = 0; j < B.cols; j++) {
+                c[j] += a * b[j];
+            }
+        }
+    }
+}
+
+void mult_bt_sparse_sym_into(const Mat &A, const SparsePattern &pattern, const Mat &B, Mat &C)
+{
+    if ((pattern.rows != B.rows) || (pattern.cols != B.cols) || (A.cols != B.cols) ||
+            (A.rows != B.rows) || (C.rows != A.rows) || (C.cols != A.rows)) {
+        ESP_LOGW("Mat", "mult_bt_sparse_sym_into Error: matrices do not have correct dimensions");
+        return;
+    }
+    for (int j = 0; j < B.rows; j++) {
+        const float *b = B.data + j * B.stride;
+        int start = pattern.row_start[j];
+        int end = pattern.row_start[j + 1];
+        // C(i, j) = sum of A(i, k)*B(j, k) for the nonzero B(j, k), i <= j
+        for (int i = 0; i <= j; i++) {
+            const float *a = A.data + i * A.stride;
+            float acc = 0;
+            for (int s = start; s < end; s++) {
+                int k = pattern.col_index[s];
+                acc += a[k] * b[k];
+            }
+            C(i, j) = acc;
+            C(j, i) = acc;
+        }
+    }
+}
+
+}
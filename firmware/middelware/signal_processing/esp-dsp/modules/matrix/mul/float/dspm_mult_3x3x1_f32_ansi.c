@@ -0,0 +1,19 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "dspm_mult.h"
+
+// C(3,1) = A(3,3)*B(3,1), same order of the sums as dspm_mult_f32_ansi()
+esp_err_t dspm_mult_3x3x1_f32_ansi(const float *A, const float *B, float *C)
+{
+    float b0 = B[0];
+    float b1 = B[1];
+    float b2 = B[2];
+    C[0] = A[0] * b0 + A[1] * b1 + A[2] * b2;
+    C[1] = A[3] * b0 + A[4] * b1 + A[5] * b2;
+    C[2] = A[6] * b0 + A[7] * b1 + A[8] * b2;
+    return ESP_OK;
+}
@@ -0,0 +1,26 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "dspm_mult.h"
+
+// C(3,3) = A(3,3)*B(3,3), same order of the sums as dspm_mult_f32_ansi()
+esp_err_t dspm_mult_3x3x3_f32_ansi(const float *A, const float *B, float *C)
+{
+    float b00 = B[0], b01 = B[1], b02 = B[2];
+    float b10 = B[3], b11 = B[4], b12 = B[5];
+    float b20 = B[6], b21 = B[7], b22 = B[8];
+    for (int i = 0; i < 3; i++) {
+        float a0 = A[0];
+        float a1 = A[1];
+        float a2 = A[2];
+        C[0] = a0 * b00 + a1 * b10 + a2 * b20;
+        C[1] = a0 * b01 + a1 * b11 + a2 * b21;
+        C[2] = a0 * b02 + a1 * b12 + a2 * b22;
+        A += 3;
+        C += 3;
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,21 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "dspm_mult.h"
+
+// C(4,1) = A(4,4)*B(4,1), same order of the sums as dspm_mult_f32_ansi()
+esp_err_t dspm_mult_4x4x1_f32_ansi(const float *A, const float *B, float *C)
+{
+    float b0 = B[0];
+    float b1 = B[1];
+    float b2 = B[2];
+    float b3 = B[3];
+    C[0] = A[0] * b0 + A[1] * b1 + A[2] * b2 + A[3] * b3;
+    C[1] = A[4] * b0 + A[5] * b1 + A[6] * b2 + A[7] * b3;
+    C[2] = A[8] * b0 + A[9] * b1 + A[10] * b2 + A[11] * b3;
+    C[3] = A[12] * b0 + A[13] * b1 + A[14] * b2 + A[15] * b3;
+    return ESP_OK;
+}
@@ -0,0 +1,29 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "dspm_mult.h"
+
+// C(4,4) = A(4,4)*B(4,4), same order of the sums as dspm_mult_f32_ansi()
+esp_err_t dspm_mult_4x4x4_f32_ansi(const float *A, const float *B, float *C)
+{
+    float b00 = B[0], b01 = B[1], b02 = B[2], b03 = B[3];
+    float b10 = B[4], b11 = B[5], b12 = B[6], b13 = B[7];
+    float b20 = B[8], b21 = B[9], b22 = B[10], b23 = B[11];
+    float b30 = B[12], b31 = B[13], b32 = B[14], b33 = B[15];
+    for (int i = 0; i < 4; i++) {
+        float a0 = A[0];
+        float a1 = A[1];
+        float a2 = A[2];
+        float a3 = A[3];
+        C[0] = a0 * b00 + a1 * b10 + a2 * b20 + a3 * b30;
+        C[1] = a0 * b01 + a1 * b11 + a2 * b21 + a3 * b31;
+        C[2] = a0 * b02 + a1 * b12 + a2 * b22 + a3 * b32;
+        C[3] = a0 * b03 + a1 * b13 + a2 * b23 + a3 * b33;
+        A += 4;
+        C += 4;
+    }
+    return ESP_OK;
+}
@@ -6,6 +6,129 @@
 
 #include "dspm_mult.h"
 
+// The products are calculated in blocks of 4x4 elements of C: 16 sums stay in registers, and
+// every value loaded from A and B is used 4 times. Every sum starts with a(i,0)*b(0,j) and adds
+// the products in the order of s, so the results are the same as with the simple loops.
+static inline void dspm_mult_block_4x4(const float *A, const float *B, float *C, int n, int A_step, int B_step, int C_step)
+{
+    const float *a0 = A;
+    const float *a1 = a0 + A_step;
+    const float *a2 = a1 + A_step;
+    const float *a3 = a2 + A_step;
+    float b0 = B[0];
+    float b1 = B[1];
+    float b2 = B[2];
+    float b3 = B[3];
+    float c00 = a0[0] * b0, c01 = a0[0] * b1, c02 = a0[0] * b2, c03 = a0[0] * b3;
+    float c10 = a1[0] * b0, c11 = a1[0] * b1, c12 = a1[0] * b2, c13 = a1[0] * b3;
+    float c20 = a2[0] * b0, c21 = a2[0] * b1, c22 = a2[0] * b2, c23 = a2[0] * b3;
+    float c30 = a3[0] * b0, c31 = a3[0] * b1, c32 = a3[0] * b2, c33 = a3[0] * b3;
+    for (int s = 1; s < n; s++) {
+        B += B_step;
+        b0 = B[0];
+        b1 = B[1];
+        b2 = B[2];
+        b3 = B[3];
+        float a = a0[s];
+        c00 += a * b0;
+        c01 += a * b1;
+        c02 += a * b2;
+        c03 += a * b3;
+        a = a1[s];
+        c10 += a * b0;
+        c11 += a * b1;
+        c12 += a * b2;
+        c13 += a * b3;
+        a = a2[s];
+        c20 += a * b0;
+        c21 += a * b1;
+        c22 += a * b2;
+        c23 += a * b3;
+        a = a3[s];
+        c30 += a * b0;
+        c31 += a * b1;
+        c32 += a * b2;
+        c33 += a * b3;
+    }
+    C[0] = c00;
+    C[1] = c01;
+    C[2] = c02;
+    C[3] = c03;
+    C += C_step;
+    C[0] = c10;
+    C[1] = c11;
+    C[2] = c12;
+    C[3] = c13;
+    C += C_step;
+    C[0] = c20;
+    C[1] = c21;
+    C[2] = c22;
+    C[3] = c23;
+    C += C_step;
+    C[0] = c30;
+    C[1] = c31;
+    C[2] = c32;
+    C[3] = c33;
+}
+
+// 4 rows of one column of C
+static inline void dspm_mult_block_4x1(const float *A, const float *B, float *C, int n, int A_step, int B_step, int C_step)
+{
+    const float *a0 = A;
+    const float *a1 = a0 + A_step;
+    const float *a2 = a1 + A_step;
+    const float *a3 = a2 + A_step;
+    float b = B[0];
+    float c0 = a0[0] * b;
+    float c1 = a1[0] * b;
+    float c2 = a2[0] * b;
+    float c3 = a3[0] * b;
+    for (int s = 1; s < n; s++) {
+        B += B_step;
+        b = B[0];
+        c0 += a0[s] * b;
+        c1 += a1[s] * b;
+        c2 += a2[s] * b;
+        c3 += a3[s] * b;
+    }
+    C[0] = c0;
+    C[C_step] = c1;
+    C[2 * C_step] = c2;
+    C[3 * C_step] = c3;
+}
+
+// 4 columns of one row of C
+static inline void dspm_mult_block_1x4(const float *A, const float *B, float *C, int n, int B_step)
+{
+    float a = A[0];
+    float c0 = a * B[0];
+    float c1 = a * B[1];
+    float c2 = a * B[2];
+    float c3 = a * B[3];
+    for (int s = 1; s < n; s++) {
+        B += B_step;
+        a = A[s];
+        c0 += a * B[0];
+        c1 += a * B[1];
+        c2 += a * B[2];
+        c3 += a * B[3];
+    }
+    C[0] = c0;
+    C[1] = c1;
+    C[2] = c2;
+    C[3] = c3;
+}
+
+static inline void dspm_mult_block_1x1(const float *A, const float *B, float *C, int n, int B_step)
+{
+    float c = A[0] * B[0];
+    for (int s = 1; s < n; s++) {
+        B += B_step;
+        c += A[s] * B[0];
+    }
+    C[0] = c;
+}
+
 // Matrix A(m,n), m - amount or rows, n - amount of columns
 // C(m,k) = A(m,n)*B(n,k)
 // c(i * c_step,j) = sum(a(i * a_step,s)*b(s * b_step,j)) , s=1..n
@@ -45,12 +168,27 @@ esp_err_t dspm_mult_ex_f32_ansi(const float *A, const float *B, float *C, int A_
     const int B_step = B_cols + B_padding;
     const int C_step = B_cols + C_padding;
 
-    for (int i = 0; i < A_rows; i++) {
-        for (int j = 0; j < B_cols; j++) {
-            C[i * C_step + j] = A[i * A_step] * B[j];
-            for (int s = 1; s < A_cols; s++) {
-                C[i * C_step + j] += A[i * A_step + s] * B[s * B_step + j];
-            }
+    int i = 0;
+    for (; i + 4 <= A_rows; i += 4) {
+        const float *a = A + i * A_step;
+        float *c = C + i * C_step;
+        int j = 0;
+        for (; j + 4 <= B_cols; j += 4) {
+            dspm_mult_block_4x4(a, B + j, c + j, A_cols, A_step, B_step, C_step);
+        }
+        for (; j < B_cols; j++) {
+            dspm_mult_block_4x1(a, B + j, c + j, A_cols, A_step, B_step, C_step);
+        }
+    }
+    for (; i < A_rows; i++) {
+        const float *a = A + i * A_step;
+        float *c = C + i * C_step;
+        int j = 0;
+        for (; j + 4 <= B_cols; j += 4) {
+            dspm_mult_block_1x4(a, B + j, c + j, A_cols, B_step);
+        }
+        for (; j < B_cols; j++) {
+            dspm_mult_block_1x1(a, B + j, c + j, A_cols, B_step);
         }
     }
     return ESP_OK;
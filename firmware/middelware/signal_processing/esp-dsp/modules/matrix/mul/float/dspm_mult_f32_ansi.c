@@ -19,15 +19,25 @@
 // Matrinx A(m,n), m - amount or rows, n - amount of columns
 // C(m,k) = A(m,n)*B(n,k)
 // c(i,j) = sum(a(i,s)*b(s,j)) , s=1..n
+// 3x3 and 4x4 matrices use the unrolled functions, all other sizes are calculated
+// by dspm_mult_ex_f32_ansi() in register blocks of 4x4 elements
 esp_err_t dspm_mult_f32_ansi(const float *A, const float *B, float *C, int m, int n, int k)
 {
-    for (int i = 0 ; i < m ; i++) {
-        for (int j = 0 ; j < k ; j++) {
-            C[i * k + j] = A[i * n] * B[j];
-            for (int s = 1; s < n ; s++) {
-                C[i * k + j] += A[i * n + s] * B[s * k + j];
-            }
+    if ((m == 3) && (n == 3)) {
+        if (k == 3) {
+            return dspm_mult_3x3x3_f32_ansi(A, B, C);
+        }
+        if (k == 1) {
+            return dspm_mult_3x3x1_f32_ansi(A, B, C);
+        }
+    }
+    if ((m == 4) && (n == 4)) {
+        if (k == 4) {
+            return dspm_mult_4x4x4_f32_ansi(A, B, C);
+        }
+        if (k == 1) {
+            return dspm_mult_4x4x1_f32_ansi(A, B, C);
         }
     }
-    return ESP_OK;
+    return dspm_mult_ex_f32_ansi(A, B, C, m, n, k, 0, 0, 0);
 }
@@ -51,7 +51,8 @@ esp_err_t dspm_mult_f32_aes3(const float *A, const float *B, float *C, int m, in
  * @brief   Matrix multiplication A[3x3]xB[3x1]
  *
  * Matrix multiplication for two floating point matrices 3x3 and 3x1: C[1][3] = A[3][3] * B[3][1]
- * The implementation is optimized for ESP32 chip.
+ * The extension (_ansi) use ANSI C and could be compiled and run on any platform.
+ * The extension (_ae32) is optimized for ESP32 chip.
  *
  * @param[in] A  input matrix A[3][3]
  * @param[in] B  input matrix/vector B[3][1]
@@ -60,13 +61,15 @@ esp_err_t dspm_mult_f32_aes3(const float *A, const float *B, float *C, int m, in
  *      - ESP_OK on success
  *      - One of the error codes from DSP library
  */
+esp_err_t dspm_mult_3x3x1_f32_ansi(const float *A, const float *B, float *C);
 esp_err_t dspm_mult_3x3x1_f32_ae32(const float *A, const float *B, float *C);
 
 /**
  * @brief   Matrix multiplication A[3x3]xB[3x3]
  *
  * Matrix multiplication for two square 3x3 floating point matrices: C[3][3] = A[3][3] * B[3][3]
- * The implementation is optimized for ESP32 chip.
+ * The extension (_ansi) use ANSI C and could be compiled and run on any platform.
+ * The extension (_ae32) is optimized for ESP32 chip.
  *
  * @param[in] A  input matrix A[3][3]
  * @param[in] B  input matrix B[3][3]
@@ -75,13 +78,15 @@ esp_err_t dspm_mult_3x3x1_f32_ae32(const float *A, const float *B, float *C);
  *      - ESP_OK on success
  *      - One of the error codes from DSP library
  */
+esp_err_t dspm_mult_3x3x3_f32_ansi(const float *A, const float *B, float *C);
 esp_err_t dspm_mult_3x3x3_f32_ae32(const float *A, const float *B, float *C);
 
 /**
  * @brief   Matrix multiplication A[4x4]xB[4x1]
  *
  * Matrix multiplication for two floating point matrices 4x4 and 4x1: C[1][4] = A[4][4] * B[4][1]
- * The implementation is optimized for ESP32 chip.
+ * The extension (_ansi) use ANSI C and could be compiled and run on any platform.
+ * The extension (_ae32) is optimized for ESP32 chip.
  *
  * @param[in] A  input matrix A[4][4]
  * @param[in] B  input matrix/vector B[4][1]
@@ -90,14 +95,15 @@ esp_err_t dspm_mult_3x3x3_f32_ae32(const float *A, const float *B, float *C);
  *      - ESP_OK on success
  *      - One of the error codes from DSP library
  */
-
+esp_err_t dspm_mult_4x4x1_f32_ansi(const float *A, const float *B, float *C);
 esp_err_t dspm_mult_4x4x1_f32_ae32(const float *A, const float *B, float *C);
 
 /**
  * @brief   Matrix multiplication A[4x4]xB[4x4]
  *
  * Matrix multiplication for two square 3x3 floating point matrices: C[4][4] = A[4][4] * B[4][4]
- * The implementation is optimized for ESP32 chip.
+ * The extension (_ansi) use ANSI C and could be compiled and run on any platform.
+ * The extension (_ae32) is optimized for ESP32 chip.
  *
  * @param[in] A  input matrix A[4][4]
  * @param[in] B  input matrix B[4][4]
@@ -106,6 +112,7 @@ esp_err_t dspm_mult_4x4x1_f32_ae32(const float *A, const float *B, float *C);
  *      - ESP_OK on success
  *      - One of the error codes from DSP library
  */
+esp_err_t dspm_mult_4x4x4_f32_ansi(const float *A, const float *B, float *C);
 esp_err_t dspm_mult_4x4x4_f32_ae32(const float *A, const float *B, float *C);
 
 /**@{*/
@@ -187,17 +194,17 @@ esp_err_t dspm_mult_ex_f32_aes3(const float *A, const float *B, float *C, int m,
 #if (dspm_mult_3x3x1_f32_ae32_enabled == 1)
 #define dspm_mult_3x3x1_f32 dspm_mult_3x3x1_f32_ae32
 #else
-#define dspm_mult_3x3x1_f32(A,B,C) dspm_mult_f32_ansi(A,B,C, 3, 3, 1)
+#define dspm_mult_3x3x1_f32 dspm_mult_3x3x1_f32_ansi
 #endif
 #if (dspm_mult_3x3x3_f32_ae32_enabled == 1)
 #define dspm_mult_3x3x3_f32(A,B,C) dspm_mult_3x3x3_f32_ae32(A,B,C)
 #else
-#define dspm_mult_3x3x3_f32(A,B,C) dspm_mult_f32_ansi(A,B,B,3,3,3);
+#define dspm_mult_3x3x3_f32 dspm_mult_3x3x3_f32_ansi
 #endif
 #if (dspm_mult_4x4x1_f32_ae32_enabled == 1)
 #define dspm_mult_4x4x1_f32(A,B,C) dspm_mult_4x4x1_f32_ae32(A,B,C)
 #else
-#define dspm_mult_4x4x1_f32(A,B,C) dspm_mult_f32_ansi(A,B,C, 4, 4, 1)
+#define dspm_mult_4x4x1_f32 dspm_mult_4x4x1_f32_ansi
 #endif
 
 #if (dspm_mult_f32_aes3_enabled == 1)
@@ -205,16 +212,18 @@ esp_err_t dspm_mult_ex_f32_aes3(const float *A, const float *B, float *C, int m,
 #elif (dspm_mult_4x4x4_f32_ae32_enabled == 1)
 #define dspm_mult_4x4x4_f32 dspm_mult_4x4x4_f32_ae32
 #else
-#define dspm_mult_4x4x4_f32(A,B,C) dspm_mult_f32_ansi(A,B,C, 4, 4, 4)
+#define dspm_mult_4x4x4_f32 dspm_mult_4x4x4_f32_ansi
 #endif
 
 #else
 #define dspm_mult_s16 dspm_mult_s16_ansi
 #define dspm_mult_f32 dspm_mult_f32_ansi
-#define dspm_mult_3x3x1_f32(A,B,C) dspm_mult_f32_ansi(A,B,C, 3, 3, 1)
+#define dspm_mult_3x3x1_f32 dspm_mult_3x3x1_f32_ansi
+#define dspm_mult_3x3x3_f32 dspm_mult_3x3x3_f32_ansi
+#define dspm_mult_4x4x1_f32 dspm_mult_4x4x1_f32_ansi
 #define dsps_sub_f32 dsps_sub_f32_ansi
 #define dsps_add_f32 dsps_add_f32_ansi
-#define dspm_mult_4x4x4_f32(A,B,C) dspm_mult_f32_ansi(A,B,C, 4, 4, 4)
+#define dspm_mult_4x4x4_f32 dspm_mult_4x4x4_f32_ansi
 #define dspm_mult_ex_f32 dspm_mult_ex_f32_ansi
 #endif // CONFIG_DSP_OPTIMIZED
 
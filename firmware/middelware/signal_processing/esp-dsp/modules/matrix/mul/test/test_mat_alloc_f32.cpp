@@ -0,0 +1,187 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsp_tests.h"
+#include "mat.h"
+#include "mat_alloc.h"
+
+static const char *TAG = "dspm_mat_alloc";
+
+static bool in_buffer(const float *data, const float *buffer, int length)
+{
+    return (data >= buffer) && (data < buffer + length);
+}
+
+TEST_CASE("Mat allocators functionality", "[dspm]")
+{
+    static float arena_buffer[64] __attribute__((aligned(16)));
+    dspm::MatArena arena(arena_buffer, 64);
+    TEST_ASSERT_NULL(dspm::MatAllocator::active());
+
+    {
+        dspm::MatAllocatorScope scope(&arena);
+        TEST_ASSERT_EQUAL_PTR(&arena, dspm::MatAllocator::active());
+        dspm::Mat A(3, 3);
+        dspm::Mat B(2, 2);
+        TEST_ASSERT_EQUAL_PTR(arena_buffer, A.data);
+        // 9 values rounded up to 12 for the alignment
+        TEST_ASSERT_EQUAL_PTR(arena_buffer + 12, B.data);
+        TEST_ASSERT_EQUAL(16, arena.used);
+        TEST_ASSERT_EQUAL(2, arena.live);
+        {
+            // The last buffer is reused immediately
+            dspm::Mat C = A * A;
+            TEST_ASSERT_EQUAL_PTR(arena_buffer + 16, C.data);
+        }
+        TEST_ASSERT_EQUAL(16, arena.used);
+        TEST_ASSERT_EQUAL(28, arena.peak);
+
+        // A buffer that does not fit goes to the heap
+        dspm::Mat big(8, 8);
+        TEST_ASSERT_EQUAL(1, arena.overflows);
+        TEST_ASSERT_NULL(big.allocator);
+        TEST_ASSERT_FALSE(in_buffer(big.data, arena_buffer, 64));
+
+        // Nested scope with the heap
+        {
+            dspm::MatAllocatorScope heap(NULL);
+            dspm::Mat D(2, 2);
+            TEST_ASSERT_NULL(D.allocator);
+        }
+        TEST_ASSERT_EQUAL_PTR(&arena, dspm::MatAllocator::active());
+
+        // The arena is not reset while matrices use it
+        ESP_LOGI(TAG, "following is expected error message about buffers in use");
+        TEST_ASSERT_FALSE(arena.reset());
+    }
+    TEST_ASSERT_NULL(dspm::MatAllocator::active());
+    TEST_ASSERT_EQUAL(0, arena.live);
+    TEST_ASSERT_EQUAL(0, arena.used);
+    TEST_ASSERT_TRUE(arena.reset());
+
+    // A result of a step assigned to a matrix from outside of the step does not keep
+    // the buffer of the arena, inside of the step the buffer is taken over
+    dspm::Mat keep;
+    for (int i = 0; i < 2; i++) {
+        dspm::MatArenaStep step(arena);
+        dspm::Mat A = dspm::Mat::eye(3);
+        keep = A * A;
+        dspm::Mat C;
+        unsigned int allocs = dspm::Mat::alloc_count;
+        C = A * A;
+        TEST_ASSERT_EQUAL(1, dspm::Mat::alloc_count - allocs);
+        TEST_ASSERT_EQUAL_PTR(&arena, C.allocator);
+    }
+    TEST_ASSERT_NULL(keep.allocator);
+    TEST_ASSERT_FALSE(in_buffer(keep.data, arena_buffer, 64));
+    TEST_ASSERT_EQUAL_FLOAT(1, keep(2, 2));
+    TEST_ASSERT_EQUAL(0, arena.live);
+    TEST_ASSERT_EQUAL(0, arena.used);
+
+    // The buffers are aligned to 16 bytes, also on a misaligned external block
+    dspm::MatArena heap_arena(64);
+    TEST_ASSERT_EQUAL(0, (uintptr_t)heap_arena.buffer % 16);
+    ESP_LOGI(TAG, "following is expected error message about alignment");
+    dspm::MatArena misaligned(arena_buffer + 1, 63);
+    TEST_ASSERT_EQUAL_PTR(arena_buffer + 4, misaligned.buffer);
+    TEST_ASSERT_EQUAL(60, misaligned.length);
+
+    // A matrix keeps its allocator after the scope, also when it is moved
+    dspm::MatPool pool(256);
+    dspm::Mat *kept;
+    {
+        dspm::MatAllocatorScope scope(&pool);
+        dspm::Mat A(5, 5);
+        kept = new dspm::Mat(std::move(A));
+    }
+    TEST_ASSERT_EQUAL(0, (uintptr_t)pool.buffer % 16);
+    TEST_ASSERT_EQUAL_PTR(&pool, kept->allocator);
+    TEST_ASSERT_TRUE(in_buffer(kept->data, pool.buffer, 256));
+    // 25 values use the size class of 32
+    TEST_ASSERT_EQUAL(32, pool.used);
+    float *pool_data = kept->data;
+    delete kept;
+    TEST_ASSERT_EQUAL(0, pool.live);
+
+    // A freed buffer is reused by the same size class
+    {
+        dspm::MatAllocatorScope scope(&pool);
+        dspm::Mat small(2, 2);
+        dspm::Mat A(4, 6);
+        dspm::Mat B(4, 6);
+        TEST_ASSERT_EQUAL_PTR(pool_data, A.data);
+        TEST_ASSERT_EQUAL(4 + 32 + 32, pool.used);
+        A = dspm::Mat(6, 4);
+        B = A;
+        TEST_ASSERT_EQUAL(0, pool.overflows);
+        // Larger than the largest size class
+        dspm::Mat huge(128, 128);
+        TEST_ASSERT_EQUAL(1, pool.overflows);
+        TEST_ASSERT_NULL(huge.allocator);
+    }
+    TEST_ASSERT_EQUAL(0, pool.live);
+}
+
+TEST_CASE("Mat allocators benchmark", "[dspm]")
+{
+    // Covariance prediction with temporary matrices: P = F*P*F' + G*Q*G'
+    const int repeat = 16;
+    const int states = 13;
+    const int noises = 18;
+    dspm::MatPool pool(4096);
+    dspm::MatAllocatorScope pool_scope(&pool);
+    dspm::Mat F = dspm::Mat::eye(states);
+    dspm::Mat P = dspm::Mat::eye(states);
+    dspm::Mat G(states, noises);
+    dspm::Mat Q = dspm::Mat::eye(noises) * 0.01f;
+    for (int i = 0; i < states * states; i++) {
+        F.data[i] += (float)(rand() % 2001 - 1000) / 100000.0f;
+    }
+    for (int i = 0; i < states * noises; i++) {
+        G.data[i] = (float)(rand() % 2001 - 1000) / 1000.0f;
+    }
+    TEST_ASSERT_EQUAL(0, pool.overflows);
+    dspm::Mat P_heap(P);
+
+    dspm::MatArena arena(1024);
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    for (int i = 0; i < repeat; i++) {
+        dspm::MatArenaStep step(arena);
+        P = F * P * F.t() + G * Q * G.t();
+    }
+    unsigned int end_b = dsp_get_cpu_cycle_count();
+    float cycles_arena = (float)(end_b - start_b) / repeat;
+
+    dspm::MatAllocatorScope heap(NULL);
+    start_b = dsp_get_cpu_cycle_count();
+    for (int i = 0; i < repeat; i++) {
+        P_heap = F * P_heap * F.t() + G * Q * G.t();
+    }
+    end_b = dsp_get_cpu_cycle_count();
+    float cycles_heap = (float)(end_b - start_b) / repeat;
+
+    ESP_LOGI(TAG, "F*P*F' + G*Q*G': arena %f cycles, heap %f cycles", cycles_arena, cycles_heap);
+    ESP_LOGI(TAG, "arena peak %i of %i values, %i heap allocations; pool %i of %i values",
+             arena.peak, arena.length, arena.overflows, pool.used, pool.length);
+
+    for (int i = 0; i < states * states; i++) {
+        TEST_ASSERT_EQUAL_FLOAT(P_heap.data[i], P.data[i]);
+    }
+    TEST_ASSERT_EQUAL(0, arena.overflows);
+    TEST_ASSERT_EQUAL(0, arena.used);
+    TEST_ASSERT_EQUAL(0, pool.overflows);
+    float min_exec = 1;
+    float max_exec = 2000000;
+    TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles_arena);
+}
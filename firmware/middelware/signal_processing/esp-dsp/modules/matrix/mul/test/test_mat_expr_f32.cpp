@@ -0,0 +1,435 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsp_tests.h"
+#include "mat.h"
+#include "test_mat_common.h"
+
+static const char *TAG = "dspm_mat_expr";
+
+static void fill_rand(dspm::Mat &m)
+{
+    for (int row = 0; row < m.rows; row++) {
+        for (int col = 0; col < m.cols; col++) {
+            m(row, col) = (float)(rand() % 2001 - 1000) / 500.0f;
+        }
+    }
+}
+
+// Reference product in double precision, C = A*B
+static void ref_mult(const dspm::Mat &A, const dspm::Mat &B, dspm::Mat &C)
+{
+    for (int i = 0; i < A.rows; i++) {
+        for (int j = 0; j < B.cols; j++) {
+            double acc = 0;
+            for (int k = 0; k < A.cols; k++) {
+                acc += (double)A(i, k) * B(k, j);
+            }
+            C(i, j) = (float)acc;
+        }
+    }
+}
+
+static void assert_near(const dspm::Mat &expected, const dspm::Mat &actual, float tol, const char *message)
+{
+    TEST_ASSERT_EQUAL_INT_MESSAGE(expected.rows, actual.rows, message);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(expected.cols, actual.cols, message);
+    for (int row = 0; row < expected.rows; row++) {
+        for (int col = 0; col < expected.cols; col++) {
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(tol, expected(row, col), actual(row, col), message);
+        }
+    }
+}
+
+TEST_CASE("Mat expressions functionality", "[dspm]")
+{
+    dspm::Mat A(4, 5);
+    dspm::Mat B(4, 5);
+    dspm::Mat C(5, 3);
+    dspm::Mat D(4, 3);
+    dspm::Mat E(3, 3);
+    dspm::Mat E4(4, 4);
+    fill_rand(A);
+    fill_rand(B);
+    fill_rand(C);
+    fill_rand(D);
+    fill_rand(E);
+    fill_rand(E4);
+
+    // Element by element expression, evaluated in one loop
+    dspm::Mat R = A + 2.0f * B - A / 4.0f + 1.0f;
+    dspm::Mat ref(4, 5);
+    for (int row = 0; row < 4; row++) {
+        for (int col = 0; col < 5; col++) {
+            ref(row, col) = A(row, col) + 2.0f * B(row, col) - A(row, col) * (1 / 4.0f) + 1.0f;
+        }
+    }
+    assert_near(ref, R, 1e-6, "element by element expression");
+
+    // Products inside of an expression, nested products
+    dspm::Mat AC(4, 3);
+    dspm::Mat ACE(4, 3);
+    ref_mult(A, C, AC);
+    ref_mult(AC, E, ACE);
+    R = A * C + D * 0.5f;
+    dspm::Mat ref2 = AC;
+    for (int row = 0; row < 4; row++) {
+        for (int col = 0; col < 3; col++) {
+            ref2(row, col) += D(row, col) * 0.5f;
+        }
+    }
+    assert_near(ref2, R, 1e-4, "product in expression");
+    R = (A * C) * E;
+    assert_near(ACE, R, 1e-4, "nested product");
+    R = A * (C * E);
+    assert_near(ACE, R, 1e-4, "nested product, right side");
+    R = (A + B - B) * C;
+    assert_near(AC, R, 1e-4, "product of expressions");
+
+    // Destination used as operand
+    dspm::Mat S = D;
+    dspm::Mat ref3(4, 3);
+    ref_mult(D, E, ref3);
+    S = S * E;
+    assert_near(ref3, S, 1e-4, "S = S * E");
+    S = D;
+    ref_mult(E4, D, ref3);
+    S = E4 * S;
+    assert_near(ref3, S, 1e-4, "S = E4 * S");
+    S = D;
+    S = S + S * 2.0f;
+    assert_near(D * 3.0f, S, 1e-5, "S = S + S * 2");
+    S = D;
+    S += E4 * S;
+    assert_near(D + ref3, S, 1e-4, "S += E4 * S");
+    S = D;
+    S -= D * 0.5f;
+    assert_near(D * 0.5f, S, 1e-6, "S -= D * 0.5");
+
+    // Size of the destination changes
+    dspm::Mat v(1, 4);
+    fill_rand(v);
+    dspm::Mat ref4(1, 3);
+    ref_mult(v, D, ref4);
+    v = v * D;
+    assert_near(ref4, v, 1e-4, "v = v * D");
+
+    // Sub-matrices as destination and as operands
+    dspm::Mat big(6, 7);
+    fill_rand(big);
+    dspm::Mat big_orig = big;
+    dspm::Mat sub = big.getROI(1, 2, 4, 3);
+    ref_mult(D, E, ref3);
+    sub = D * E;
+    assert_near(ref3, sub, 1e-4, "product to sub-matrix");
+    test_assert_check_area_mat_mat(big_orig, sub, 1, 2, "area around sub-matrix changed");
+    dspm::Mat sub_a = big_orig.getROI(0, 0, 4, 5);
+    dspm::Mat sub_c = big_orig.getROI(1, 2, 5, 3);
+    dspm::Mat sub_a_copy = sub_a.Get(0, 4, 0, 5);
+    dspm::Mat sub_c_copy = sub_c.Get(0, 5, 0, 3);
+    ref_mult(sub_a_copy, sub_c_copy, ref3);
+    R = sub_a * sub_c;
+    assert_near(ref3, R, 1e-4, "product of sub-matrices");
+    R = 0.5f * (sub_a * sub_c) + 1.0f;
+    assert_near(ref3 * 0.5f + 1.0f, R, 1e-4, "expression with sub-matrices");
+
+    // Destination overlaps an operand with another offset
+    big = big_orig;
+    dspm::Mat left = big.getROI(0, 0, 4, 4);
+    dspm::Mat right = big.getROI(0, 1, 4, 4);
+    dspm::Mat right_copy = right.Get(0, 4, 0, 4);
+    left = right * 2.0f;
+    assert_near(right_copy * 2.0f, left, 1e-6, "overlapping sub-matrices");
+
+    // Wrong dimensions give 1x1 matrix, as before
+    ESP_LOGI(TAG, "following are expected error messages about matrices dimensions");
+    R = A + D;
+    TEST_ASSERT_EQUAL(1, R.rows);
+    TEST_ASSERT_EQUAL(1, R.cols);
+    TEST_ASSERT_EQUAL_FLOAT(0, R(0, 0));
+    R = A * B + 1.0f;
+    TEST_ASSERT_EQUAL(1, R.rows);
+    S = D;
+    S += A;
+    assert_near(D, S, 0, "+= with wrong dimensions must not change the matrix");
+
+    // Allocations: element by element expressions use no buffers,
+    // every product one buffer
+    dspm::Mat K1(13, 1), K2(13, 1), K3(13, 1), K4(13, 1), x(13, 1), xl(13, 1);
+    R = D;
+    unsigned int allocs = dspm::Mat::alloc_count;
+    x = xl + (K1 + 2.0f * K2 + 2.0f * K3 + K4) * (0.01f / 6.0f);
+    TEST_ASSERT_EQUAL(0, dspm::Mat::alloc_count - allocs);
+    allocs = dspm::Mat::alloc_count;
+    R = (A * C) * E + D;
+    TEST_ASSERT_EQUAL(2, dspm::Mat::alloc_count - allocs);
+    allocs = dspm::Mat::alloc_count;
+    R = A * C;
+    TEST_ASSERT_EQUAL(0, dspm::Mat::alloc_count - allocs);
+}
+
+TEST_CASE("Mat move and into functions", "[dspm]")
+{
+    dspm::Mat A(4, 5);
+    dspm::Mat B(4, 5);
+    dspm::Mat C(5, 3);
+    dspm::Mat E(3, 3);
+    fill_rand(A);
+    fill_rand(B);
+    fill_rand(C);
+    fill_rand(E);
+    dspm::Mat A_copy = A;
+
+    // Move of a matrix with own buffer takes the buffer over
+    unsigned int allocs = dspm::Mat::alloc_count;
+    float *buffer = A_copy.data;
+    dspm::Mat moved(std::move(A_copy));
+    TEST_ASSERT_EQUAL(0, dspm::Mat::alloc_count - allocs);
+    TEST_ASSERT_EQUAL_PTR(buffer, moved.data);
+    TEST_ASSERT_EQUAL(0, A_copy.rows);
+    TEST_ASSERT_EQUAL(0, A_copy.cols);
+    TEST_ASSERT_NULL(A_copy.data);
+    assert_near(A, moved, 0, "moved matrix");
+    A_copy = A;
+    assert_near(A, A_copy, 0, "assignment to moved from matrix");
+
+    // External buffers and sub-matrices are not taken over
+    float ext_data[4] = {1, 2, 3, 4};
+    dspm::Mat ext(ext_data, 2, 2);
+    dspm::Mat ext_moved(std::move(ext));
+    TEST_ASSERT_TRUE(ext_moved.data != ext_data);
+    TEST_ASSERT_EQUAL_PTR(ext_data, ext.data);
+    TEST_ASSERT_EQUAL_FLOAT(4, ext_moved(1, 1));
+    dspm::Mat roi = moved.getROI(1, 1, 2, 2);
+    dspm::Mat roi_moved(std::move(roi));
+    TEST_ASSERT_TRUE(roi_moved.sub_matrix);
+    TEST_ASSERT_EQUAL_PTR(&moved(1, 1), roi_moved.data);
+
+    // Move assignment with the same size keeps the buffer, so sub-matrices stay valid
+    dspm::Mat S(3, 3);
+    buffer = S.data;
+    dspm::Mat S_roi = S.getROI(1, 1, 2, 2);
+    S = dspm::Mat::eye(3);
+    TEST_ASSERT_EQUAL_PTR(buffer, S.data);
+    TEST_ASSERT_EQUAL_FLOAT(1, S_roi(1, 1));
+    // Other size: the buffer of the temporary matrix is taken over, no copy
+    dspm::Mat v(2, 2);
+    allocs = dspm::Mat::alloc_count;
+    v = dspm::Mat::eye(4);
+    TEST_ASSERT_EQUAL(1, dspm::Mat::alloc_count - allocs);
+    assert_near(dspm::Mat::eye(4), v, 0, "move assignment with other size");
+    allocs = dspm::Mat::alloc_count;
+    dspm::Mat At = A.t();
+    TEST_ASSERT_EQUAL(1, dspm::Mat::alloc_count - allocs);
+
+    // Into functions write to the existing buffer
+    dspm::Mat R(4, 5);
+    dspm::Mat AC(4, 3);
+    dspm::Mat ref(4, 3);
+    ref_mult(A, C, ref);
+    dspm::Mat Ct = C.t();
+    allocs = dspm::Mat::alloc_count;
+    dspm::add_into(A, B, R);
+    assert_near(A + B, R, 0, "add_into");
+    dspm::sub_into(A, B, R);
+    assert_near(A - B, R, 0, "sub_into");
+    dspm::mult_into(A, 0.5f, R);
+    assert_near(A * 0.5f, R, 0, "mult_into with constant");
+    dspm::mult_into(A, C, AC);
+    assert_near(ref, AC, 1e-4, "mult_into");
+    dspm::mult_bt_into(A, Ct, AC);
+    assert_near(ref, AC, 1e-4, "mult_bt_into");
+    dspm::transpose_into(A, At);
+    assert_near(A.t(), At, 0, "transpose_into");
+    dspm::mult_into(A, 2.0f, A_copy);
+    dspm::mult_into(A_copy, 0.5f, A_copy);
+    assert_near(A, A_copy, 0, "mult_into in place");
+    unsigned int allocs_into = dspm::Mat::alloc_count - allocs;
+    // A.t(), A + B, A - B and A * 0.5f above allocate 4 matrices
+    TEST_ASSERT_EQUAL(4, allocs_into);
+
+    // Destination is an operand, or has another size
+    dspm::Mat D(4, 3);
+    fill_rand(D);
+    dspm::Mat DE(4, 3);
+    ref_mult(D, E, DE);
+    dspm::Mat T = D;
+    dspm::mult_into(T, E, T);
+    assert_near(DE, T, 1e-4, "mult_into to operand");
+    T = D;
+    dspm::mult_bt_into(T, E.t(), T);
+    assert_near(DE, T, 1e-4, "mult_bt_into to operand");
+    dspm::Mat sq = E;
+    dspm::transpose_into(sq, sq);
+    assert_near(E.t(), sq, 0, "transpose_into to operand");
+    dspm::Mat small(1, 1);
+    dspm::mult_into(D, E, small);
+    assert_near(DE, small, 1e-4, "mult_into resizes the destination");
+
+    // Sub-matrix destination
+    dspm::Mat big(6, 7);
+    fill_rand(big);
+    dspm::Mat big_orig = big;
+    dspm::Mat sub = big.getROI(1, 2, 4, 3);
+    dspm::mult_into(D, E, sub);
+    assert_near(DE, sub, 1e-4, "mult_into to sub-matrix");
+    test_assert_check_area_mat_mat(big_orig, sub, 1, 2, "area around sub-matrix changed");
+    ESP_LOGI(TAG, "following are expected error messages about matrices dimensions");
+    dspm::Mat sub_copy = sub.Get(0, 4, 0, 3);
+    dspm::mult_into(A, C.t(), sub);
+    dspm::add_into(A, D, R);
+    dspm::mult_into(A, E, sub);
+    assert_near(sub_copy, sub, 0, "wrong dimensions must not change the matrix");
+}
+
+TEST_CASE("Mat symmetric functions", "[dspm]")
+{
+    // F*P*F' with the upper triangle only
+    dspm::Mat F(7, 7);
+    dspm::Mat L(7, 7);
+    fill_rand(F);
+    fill_rand(L);
+    dspm::Mat P = L * L.t();
+    dspm::Mat FP = F * P;
+    dspm::Mat full(7, 7);
+    dspm::mult_bt_into(FP, F, full);
+    dspm::Mat sym(7, 7);
+    dspm::mult_bt_sym_into(FP, F, sym);
+    for (int i = 0; i < 7; i++) {
+        for (int j = i; j < 7; j++) {
+            TEST_ASSERT_EQUAL_FLOAT(full(i, j), sym(i, j));
+            TEST_ASSERT_EQUAL_FLOAT(sym(i, j), sym(j, i));
+        }
+    }
+    TEST_ASSERT_EQUAL_FLOAT(0, dspm::sym_error(sym));
+
+    // Destination is an operand, or a sub-matrix
+    dspm::Mat A(5, 3);
+    fill_rand(A);
+    dspm::Mat AAt(5, 5);
+    dspm::mult_bt_sym_into(A, A, AAt);
+    dspm::mult_bt_sym_into(A, A, A);
+    TEST_ASSERT_TRUE(AAt == A);
+    dspm::Mat big(8, 8);
+    dspm::Mat roi = big.getROI(2, 2, 5, 5);
+    dspm::mult_bt_sym_into(FP.getROI(0, 0, 5, 7), F.getROI(0, 0, 5, 7), roi);
+    TEST_ASSERT_EQUAL_FLOAT(full(1, 3), big(3, 5));
+    TEST_ASSERT_EQUAL_FLOAT(full(1, 3), big(5, 3));
+    TEST_ASSERT_EQUAL_FLOAT(0, big(7, 7));
+
+    // Symmetry error and mirror
+    full(2, 5) += 0.25f;
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, fabsf(full(2, 5) - full(5, 2)), dspm::sym_error(full));
+    dspm::sym_mirror(full);
+    TEST_ASSERT_EQUAL_FLOAT(0, dspm::sym_error(full));
+    TEST_ASSERT_EQUAL_FLOAT(full(2, 5), full(5, 2));
+
+    // Packed storage
+    float packed[28];
+    TEST_ASSERT_EQUAL(28, dspm::sym_packed_length(7));
+    dspm::sym_pack(sym, packed);
+    TEST_ASSERT_EQUAL_FLOAT(sym(0, 6), packed[6]);
+    TEST_ASSERT_EQUAL_FLOAT(sym(1, 1), packed[7]);
+    TEST_ASSERT_EQUAL_FLOAT(sym(6, 6), packed[27]);
+    dspm::Mat unpacked(7, 7);
+    dspm::sym_unpack(packed, unpacked);
+    TEST_ASSERT_TRUE(unpacked == sym);
+    big *= 0;
+    dspm::sym_unpack(packed, roi);
+    TEST_ASSERT_EQUAL_FLOAT(sym(4, 0), big(6, 2));
+
+    ESP_LOGI(TAG, "following are expected error messages about matrices dimensions");
+    dspm::mult_bt_sym_into(A, F, sym);
+    TEST_ASSERT_EQUAL_FLOAT(0, dspm::sym_error(FP.getROI(0, 0, 3, 5)));
+}
+
+TEST_CASE("Mat expressions benchmark", "[dspm]")
+{
+    // Covariance prediction and Runge-Kutta step of the 13 states EKF
+    const int N = 13;
+    const int W = 18;
+    const float dt = 0.01f;
+    dspm::Mat F(N, N), P(N, N), Ft(N, N), G(N, W), Q(W, W), Gt(W, N);
+    dspm::Mat K1(N, 1), K2(N, 1), K3(N, 1), K4(N, 1), x(N, 1), xl(N, 1);
+    fill_rand(F);
+    fill_rand(P);
+    fill_rand(G);
+    fill_rand(Q);
+    fill_rand(K1);
+    fill_rand(K2);
+    fill_rand(K3);
+    fill_rand(K4);
+    fill_rand(xl);
+    Ft = F.t();
+    Gt = G.t();
+    dspm::Mat P0 = P;
+
+    // One temporary matrix per operator, the way the operators worked before
+    unsigned int allocs = dspm::Mat::alloc_count;
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    {
+        dspm::Mat FP = F * P;
+        dspm::Mat FPFt = FP * Ft;
+        dspm::Mat GQ = G * Q;
+        dspm::Mat GQGt = GQ * Gt;
+        dspm::Mat GQGt_dt = GQGt * (dt * dt);
+        dspm::Mat sum = FPFt + GQGt_dt;
+        P = sum;
+    }
+    unsigned int end_b = dsp_get_cpu_cycle_count();
+    unsigned int allocs_cov_ref = dspm::Mat::alloc_count - allocs;
+    float cycles_cov_ref = (float)(end_b - start_b);
+    dspm::Mat P_ref = P;
+
+    P = P0;
+    allocs = dspm::Mat::alloc_count;
+    start_b = dsp_get_cpu_cycle_count();
+    P = (F * P) * Ft + (dt * dt) * ((G * Q) * Gt);
+    end_b = dsp_get_cpu_cycle_count();
+    unsigned int allocs_cov = dspm::Mat::alloc_count - allocs;
+    float cycles_cov = (float)(end_b - start_b);
+    assert_near(P_ref, P, 1e-3, "covariance prediction");
+
+    allocs = dspm::Mat::alloc_count;
+    start_b = dsp_get_cpu_cycle_count();
+    {
+        dspm::Mat k2 = 2.0f * K2;
+        dspm::Mat k12 = K1 + k2;
+        dspm::Mat k3 = 2.0f * K3;
+        dspm::Mat k123 = k12 + k3;
+        dspm::Mat k1234 = k123 + K4;
+        dspm::Mat step = k1234 * (dt / 6.0f);
+        x = xl + step;
+    }
+    end_b = dsp_get_cpu_cycle_count();
+    unsigned int allocs_rk_ref = dspm::Mat::alloc_count - allocs;
+    float cycles_rk_ref = (float)(end_b - start_b);
+    dspm::Mat x_ref = x;
+
+    allocs = dspm::Mat::alloc_count;
+    start_b = dsp_get_cpu_cycle_count();
+    x = xl + (K1 + 2.0f * K2 + 2.0f * K3 + K4) * (dt / 6.0f);
+    end_b = dsp_get_cpu_cycle_count();
+    unsigned int allocs_rk = dspm::Mat::alloc_count - allocs;
+    float cycles_rk = (float)(end_b - start_b);
+    assert_near(x_ref, x, 1e-6, "Runge-Kutta step");
+
+    ESP_LOGI(TAG, "P = F*P*F' + dt^2*G*Q*G': temporaries %u allocations, %f cycles; expression %u allocations, %f cycles",
+             allocs_cov_ref, cycles_cov_ref, allocs_cov, cycles_cov);
+    ESP_LOGI(TAG, "x = x + (k1 + 2*k2 + 2*k3 + k4)*dt/6: temporaries %u allocations, %f cycles; expression %u allocations, %f cycles",
+             allocs_rk_ref, cycles_rk_ref, allocs_rk, cycles_rk);
+
+    TEST_ASSERT_EQUAL(4, allocs_cov);
+    TEST_ASSERT_EQUAL(0, allocs_rk);
+    TEST_ASSERT_LESS_THAN(allocs_cov_ref, allocs_cov);
+}
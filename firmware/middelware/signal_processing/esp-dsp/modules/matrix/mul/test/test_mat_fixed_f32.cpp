@@ -0,0 +1,223 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsp_tests.h"
+#include "mat.h"
+#include "mat_fixed.h"
+
+static const char *TAG = "dspm_mat_fixed";
+
+template <int R, int C>
+static void fill_rand(dspm::FixedMat<R, C> &m)
+{
+    for (int i = 0; i < R * C; i++) {
+        m.data[i] = (float)(rand() % 2001 - 1000) / 500.0f;
+    }
+}
+
+// The fixed size kernels use the same sum order as the Mat product
+template <int R, int C>
+static void assert_equal(const dspm::Mat &expected, const dspm::FixedMat<R, C> &actual, const char *message)
+{
+    TEST_ASSERT_EQUAL_INT_MESSAGE(R, expected.rows, message);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(C, expected.cols, message);
+    for (int row = 0; row < R; row++) {
+        for (int col = 0; col < C; col++) {
+            TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-5, expected(row, col), actual(row, col), message);
+        }
+    }
+}
+
+template <int M, int N, int K>
+static void test_product(const char *message)
+{
+    dspm::FixedMat<M, N> A;
+    dspm::FixedMat<N, K> B;
+    dspm::FixedMat<K, N> Bt;
+    fill_rand(A);
+    fill_rand(B);
+    Bt = B.t();
+    dspm::Mat C_mat = A.toMat() * B.toMat();
+
+    assert_equal(C_mat, A * B, message);
+    dspm::FixedMat<M, K> C;
+    dspm::mult_into(A, B, C);
+    assert_equal(C_mat, C, message);
+    dspm::mult_bt_into(A, Bt, C);
+    assert_equal(C_mat, C, message);
+
+    // Symmetric product A*A'
+    dspm::FixedMat<M, M> S;
+    dspm::mult_bt_sym_into(A, A, S);
+    dspm::Mat S_mat = A.toMat() * A.toMat().t();
+    assert_equal(S_mat, S, message);
+    TEST_ASSERT_EQUAL_FLOAT_MESSAGE(0, dspm::sym_error(S.view()), message);
+}
+
+TEST_CASE("FixedMat functionality", "[dspm]")
+{
+    test_product<3, 3, 3>("product 3x3");
+    test_product<4, 4, 4>("product 4x4");
+    test_product<4, 4, 1>("product 4x4 * 4x1");
+    test_product<3, 4, 5>("product 3x4 * 4x5");
+    test_product<13, 13, 13>("product 13x13");
+    test_product<13, 18, 18>("product 13x18 * 18x18");
+
+    // Destination is an operand
+    dspm::FixedMat<4, 4> A;
+    dspm::FixedMat<4, 4> B;
+    fill_rand(A);
+    fill_rand(B);
+    dspm::FixedMat<4, 4> AB = A * B;
+    dspm::mult_into(A, B, A);
+    for (int i = 0; i < 16; i++) {
+        TEST_ASSERT_EQUAL_FLOAT(AB.data[i], A.data[i]);
+    }
+
+    // Element by element operations
+    fill_rand(A);
+    dspm::FixedMat<4, 4> S = 2.0f * A + B - A / 4.0f - (-B) * 0.5f;
+    for (int i = 0; i < 16; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(1e-5, 2.0f * A.data[i] + B.data[i] - A.data[i] * 0.25f + B.data[i] * 0.5f, S.data[i]);
+    }
+
+    // Blocks, identity and transpose
+    dspm::FixedMat<3, 4> block;
+    fill_rand(block);
+    dspm::FixedMat<6, 13> H;
+    H.Copy<3, 9>(block);
+    for (int row = 0; row < 6; row++) {
+        for (int col = 0; col < 13; col++) {
+            bool inside = (row >= 3) && (col >= 9);
+            TEST_ASSERT_EQUAL_FLOAT(inside ? block(row - 3, col - 9) : 0, H(row, col));
+        }
+    }
+    dspm::FixedMat<3, 4> block_copy = H.Get<3, 9, 3, 4>();
+    TEST_ASSERT_EQUAL(0, memcmp(block.data, block_copy.data, sizeof(block.data)));
+    dspm::FixedMat<4, 3> block_t = block.t();
+    TEST_ASSERT_EQUAL_FLOAT(block(1, 2), block_t(2, 1));
+    dspm::FixedMat<3, 3> I = dspm::FixedMat<3, 3>::eye();
+    TEST_ASSERT_EQUAL_FLOAT(sqrtf(3), I.norm());
+
+    // Conversion from and to Mat
+    dspm::Mat big(6, 7);
+    for (int i = 0; i < 6 * 7; i++) {
+        big.data[i] = i;
+    }
+    dspm::FixedMat<3, 4> from_mat(big, 2, 3);
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 4; col++) {
+            TEST_ASSERT_EQUAL_FLOAT(big(row + 2, col + 3), from_mat(row, col));
+        }
+    }
+    dspm::Mat roi = big.getROI(1, 1, 3, 4);
+    from_mat = roi;
+    TEST_ASSERT_EQUAL_FLOAT(big(1, 1), from_mat(0, 0));
+    TEST_ASSERT_EQUAL_FLOAT(big(3, 4), from_mat(2, 3));
+
+    dspm::Mat v = from_mat.view();
+    v(1, 1) = 100;
+    TEST_ASSERT_EQUAL_FLOAT(100, from_mat(1, 1));
+    dspm::Mat m = from_mat.toMat();
+    m(1, 1) = 0;
+    TEST_ASSERT_EQUAL_FLOAT(100, from_mat(1, 1));
+    big.Copy(from_mat.view(), 3, 3);
+    TEST_ASSERT_EQUAL_FLOAT(100, big(4, 4));
+
+    ESP_LOGI(TAG, "following are expected error messages about matrices dimensions");
+    dspm::FixedMat<3, 4> outside(big, 4, 4);
+    TEST_ASSERT_EQUAL_FLOAT(0, outside.norm());
+    fill_rand(outside);
+    outside = big;
+    TEST_ASSERT_EQUAL_FLOAT(0, outside.norm());
+
+    // No heap allocations
+    unsigned int allocs = dspm::Mat::alloc_count;
+    dspm::FixedMat<13, 13> F = dspm::FixedMat<13, 13>::eye();
+    dspm::FixedMat<13, 13> P;
+    fill_rand(P);
+    dspm::FixedMat<13, 13> FP;
+    dspm::mult_into(F, P, FP);
+    dspm::mult_bt_into(FP, F, P);
+    dspm::Mat P_view = P.view();
+    P_view *= 2;
+    TEST_ASSERT_EQUAL(0, dspm::Mat::alloc_count - allocs);
+}
+
+TEST_CASE("FixedMat benchmark", "[dspm]")
+{
+    // Products of the 13 states EKF: F*P*F' and G*Q*G'
+    const int repeat = 16;
+    dspm::FixedMat<13, 13> F;
+    dspm::FixedMat<13, 13> P;
+    dspm::FixedMat<13, 13> FP;
+    dspm::FixedMat<13, 13> FPF;
+    dspm::FixedMat<13, 18> G;
+    dspm::FixedMat<18, 18> Q;
+    dspm::FixedMat<13, 18> GQ;
+    dspm::FixedMat<13, 13> GQG;
+    fill_rand(F);
+    fill_rand(P);
+    fill_rand(G);
+    fill_rand(Q);
+    dspm::Mat F_mat = F.toMat();
+    dspm::Mat P_mat = P.toMat();
+    dspm::Mat G_mat = G.toMat();
+    dspm::Mat Q_mat = Q.toMat();
+    dspm::Mat Ft_mat = F_mat.t();
+    dspm::Mat Gt_mat = G_mat.t();
+    dspm::Mat result(13, 13);
+
+    unsigned int allocs = dspm::Mat::alloc_count;
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    for (int i = 0; i < repeat; i++) {
+        result = (F_mat * P_mat) * Ft_mat + (G_mat * Q_mat) * Gt_mat;
+    }
+    unsigned int end_b = dsp_get_cpu_cycle_count();
+    float cycles_mat = (float)(end_b - start_b) / repeat;
+    float allocs_mat = (float)(dspm::Mat::alloc_count - allocs) / repeat;
+
+    allocs = dspm::Mat::alloc_count;
+    start_b = dsp_get_cpu_cycle_count();
+    for (int i = 0; i < repeat; i++) {
+        dspm::mult_into(F, P, FP);
+        dspm::mult_bt_into(FP, F, FPF);
+        dspm::mult_into(G, Q, GQ);
+        dspm::mult_bt_into(GQ, G, GQG);
+        FPF += GQG;
+    }
+    end_b = dsp_get_cpu_cycle_count();
+    float cycles_fixed = (float)(end_b - start_b) / repeat;
+    unsigned int allocs_fixed = dspm::Mat::alloc_count - allocs;
+    assert_equal(result, FPF, "F*P*F' + G*Q*G'");
+
+    dspm::FixedMat<3, 3> R3;
+    dspm::FixedMat<3, 1> v3;
+    fill_rand(R3);
+    fill_rand(v3);
+    start_b = dsp_get_cpu_cycle_count();
+    for (int i = 0; i < repeat; i++) {
+        v3 = R3 * v3;
+    }
+    end_b = dsp_get_cpu_cycle_count();
+    float cycles_3x3 = (float)(end_b - start_b) / repeat;
+
+    ESP_LOGI(TAG, "F*P*F' + G*Q*G': Mat %f cycles, %f allocations; FixedMat %f cycles, %u allocations",
+             cycles_mat, allocs_mat, cycles_fixed, allocs_fixed);
+    ESP_LOGI(TAG, "3x3 * 3x1: FixedMat %f cycles", cycles_3x3);
+
+    TEST_ASSERT_EQUAL(0, allocs_fixed);
+    float min_exec = 1;
+    float max_exec = 200000;
+    TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles_fixed);
+}
@@ -0,0 +1,288 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsp_tests.h"
+#include "mat.h"
+#include "mat_solve.h"
+
+static const char *TAG = "dspm_mat_solve";
+
+static void fill_rand(dspm::Mat &m)
+{
+    for (int row = 0; row < m.rows; row++) {
+        for (int col = 0; col < m.cols; col++) {
+            m(row, col) = (float)(rand() % 2001 - 1000) / 500.0f;
+        }
+    }
+}
+
+// Symmetric positive definite matrix, like a covariance
+static dspm::Mat rand_spd(int n)
+{
+    dspm::Mat L(n, n);
+    fill_rand(L);
+    dspm::Mat result = L * L.t();
+    for (int i = 0; i < n; i++) {
+        result(i, i) += 1;
+    }
+    return result;
+}
+
+// max |A*X - B| relative to max |B|
+static float solve_error(const dspm::Mat &A, const dspm::Mat &X, const dspm::Mat &B)
+{
+    dspm::Mat AX = A * X;
+    float error = 0;
+    float scale = 0;
+    for (int row = 0; row < B.rows; row++) {
+        for (int col = 0; col < B.cols; col++) {
+            float e = fabsf(AX(row, col) - B(row, col));
+            error = e > error ? e : error;
+            scale = fabsf(B(row, col)) > scale ? fabsf(B(row, col)) : scale;
+        }
+    }
+    return error / scale;
+}
+
+TEST_CASE("Mat solve functionality", "[dspm]")
+{
+    int pivot[16];
+    float diag[16];
+    for (int n = 1; n <= 16; n++) {
+        dspm::Mat B(n, 3);
+        fill_rand(B);
+
+        // Cholesky: L*L' = A, the upper triangle is not changed
+        dspm::Mat A = rand_spd(n);
+        dspm::Mat F = A;
+        TEST_ASSERT_TRUE(dspm::cholesky_factor(F));
+        dspm::Mat L(n, n);
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j <= i; j++) {
+                L(i, j) = F(i, j);
+            }
+            for (int j = i + 1; j < n; j++) {
+                TEST_ASSERT_EQUAL_FLOAT(A(i, j), F(i, j));
+            }
+        }
+        dspm::Mat LL = L * L.t();
+        for (int i = 0; i < n * n; i++) {
+            TEST_ASSERT_FLOAT_WITHIN(1e-4 * fabsf(A.data[i]) + 1e-4, A.data[i], LL.data[i]);
+        }
+        dspm::Mat X = B;
+        dspm::cholesky_solve(F, X);
+        TEST_ASSERT_TRUE(solve_error(A, X, B) < 1e-4f);
+
+        // LDL' of the same matrix
+        F = A;
+        TEST_ASSERT_TRUE(dspm::ldl_factor(F));
+        X = B;
+        dspm::ldl_solve(F, X);
+        TEST_ASSERT_TRUE(solve_error(A, X, B) < 1e-4f);
+
+        // LDL' of a symmetric indefinite matrix
+        dspm::Mat S = A;
+        for (int i = 0; i < n; i += 2) {
+            S(i, i) = -S(i, i) - 10;
+        }
+        F = S;
+        TEST_ASSERT_TRUE(dspm::ldl_factor(F));
+        X = B;
+        dspm::ldl_solve(F, X);
+        TEST_ASSERT_TRUE(solve_error(S, X, B) < 1e-4f);
+
+        // LU of a general matrix
+        dspm::Mat G(n, n);
+        fill_rand(G);
+        for (int i = 0; i < n; i++) {
+            G(i, i) += 4;
+        }
+        F = G;
+        TEST_ASSERT_TRUE(dspm::lu_factor(F, pivot));
+        X = B;
+        dspm::lu_solve(F, pivot, X);
+        TEST_ASSERT_TRUE(solve_error(G, X, B) < 1e-4f);
+
+        // solve_into selects the factorization and does not allocate memory
+        dspm::Mat A_f = A;
+        dspm::Mat S_f = S;
+        dspm::Mat G_f = G;
+        dspm::Mat X_A = B;
+        dspm::Mat X_S = B;
+        dspm::Mat X_G = B;
+        unsigned int allocs = dspm::Mat::alloc_count;
+        TEST_ASSERT_TRUE(dspm::solve_into(A_f, X_A, pivot, diag));
+        TEST_ASSERT_TRUE(dspm::solve_into(S_f, X_S, pivot, diag));
+        TEST_ASSERT_TRUE(dspm::solve_into(G_f, X_G, pivot, diag));
+        TEST_ASSERT_EQUAL(0, dspm::Mat::alloc_count - allocs);
+        TEST_ASSERT_TRUE(solve_error(A, X_A, B) < 1e-4f);
+        TEST_ASSERT_TRUE(solve_error(S, X_S, B) < 1e-4f);
+        TEST_ASSERT_TRUE(solve_error(G, X_G, B) < 1e-4f);
+    }
+
+    // Pivoting: zero in the first diagonal element
+    float p_data[9] = {0, 2, 1, 1, 1, 1, 2, 1, 0};
+    float b_data[3] = {3, 3, 3};
+    dspm::Mat P(p_data, 3, 3);
+    dspm::Mat P_f = P;
+    dspm::Mat x(b_data, 3, 1);
+    TEST_ASSERT_TRUE(dspm::solve_into(P_f, x, pivot, diag));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5, 1, x(0, 0));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5, 1, x(1, 0));
+    TEST_ASSERT_FLOAT_WITHIN(1e-5, 1, x(2, 0));
+
+    // Sub-matrices
+    dspm::Mat big(10, 10);
+    dspm::Mat A = rand_spd(4);
+    dspm::Mat roi = big.getROI(2, 3, 4, 4);
+    roi = A;
+    dspm::Mat B(4, 2);
+    fill_rand(B);
+    dspm::Mat X = B;
+    TEST_ASSERT_TRUE(dspm::solve_into(roi, X, pivot, diag));
+    TEST_ASSERT_TRUE(solve_error(A, X, B) < 1e-4f);
+    TEST_ASSERT_EQUAL_FLOAT(0, big(2, 2));
+
+    // Failures
+    dspm::Mat singular(3, 3);
+    singular(0, 1) = 1;
+    TEST_ASSERT_FALSE(dspm::lu_factor(singular, pivot));
+    dspm::Mat indefinite = dspm::Mat::eye(3);
+    indefinite(0, 1) = indefinite(1, 0) = 2;
+    dspm::Mat F = indefinite;
+    TEST_ASSERT_FALSE(dspm::cholesky_factor(F));
+    F = indefinite;
+    TEST_ASSERT_TRUE(dspm::ldl_factor(F));
+    dspm::Mat zero_pivot(2, 2);
+    zero_pivot(0, 1) = zero_pivot(1, 0) = 1;
+    TEST_ASSERT_FALSE(dspm::ldl_factor(zero_pivot));
+
+    // solve_into falls back to LU when the symmetric factorization fails
+    dspm::Mat b(3, 1);
+    b(0, 0) = 1;
+    b(1, 0) = 2;
+    b(2, 0) = 3;
+    F = indefinite;
+    X = b;
+    TEST_ASSERT_TRUE(dspm::solve_into(F, X, pivot, diag));
+    TEST_ASSERT_TRUE(solve_error(indefinite, X, b) < 1e-6f);
+    float s_data[2][4] = {{1, 2, 2, 1}, {0, 1, 1, 0}};
+    for (int i = 0; i < 2; i++) {
+        dspm::Mat S(s_data[i], 2, 2);
+        dspm::Mat S_f = S;
+        dspm::Mat x2 = b.Get(0, 2, 0, 1);
+        TEST_ASSERT_TRUE(dspm::solve_into(S_f, x2, pivot, diag));
+        TEST_ASSERT_TRUE(solve_error(S, x2, b.Get(0, 2, 0, 1)) < 1e-6f);
+    }
+
+    // Rounding of a product does not make a covariance asymmetric
+    dspm::Mat G(8, 8);
+    fill_rand(G);
+    dspm::Mat C = G * rand_spd(8) * G.t();
+    TEST_ASSERT_TRUE(dspm::sym_error(C) > 0);
+    F = C;
+    X = B.Get(0, 8, 0, 2);
+    TEST_ASSERT_TRUE(dspm::solve_into(F, X, pivot, diag));
+    TEST_ASSERT_EQUAL_FLOAT(C(0, 1), F(0, 1));
+    TEST_ASSERT_EQUAL_FLOAT(sqrtf(C(0, 0)), F(0, 0));
+
+    // Not symmetric, with a large diagonal element: the lower triangle alone is another matrix
+    float n_data[4] = {1e6, 0, 0.5, 1};
+    dspm::Mat N(n_data, 2, 2);
+    F = N;
+    dspm::Mat y = b.Get(0, 2, 0, 1);
+    TEST_ASSERT_TRUE(dspm::solve_into(F, y, pivot, diag));
+    TEST_ASSERT_FLOAT_WITHIN(1e-12, 1e-6, y(0, 0));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6, 2 - 0.5e-6, y(1, 0));
+
+    ESP_LOGI(TAG, "following are expected error messages");
+    F = singular;
+    X = b;
+    TEST_ASSERT_FALSE(dspm::solve_into(F, X, pivot, diag));
+    TEST_ASSERT_EQUAL_FLOAT(1, X(0, 0));
+    TEST_ASSERT_EQUAL_FLOAT(3, X(2, 0));
+    TEST_ASSERT_FALSE(dspm::solve_into(F, B, pivot, diag));
+}
+
+TEST_CASE("Mat solve benchmark", "[dspm]")
+{
+    // A*X = B with 3 right hand sides: inverse(A)*B, pinv(A)*B and solve_into(A, B).
+    // inverse() uses cofactors, its time grows with n!, it is measured up to 6x6 only.
+    const int repeat = 4;
+    int pivot[16];
+    float diag[16];
+    for (int n = 3; n <= 16; n++) {
+        dspm::Mat A = rand_spd(n);
+        dspm::Mat B(n, 3);
+        fill_rand(B);
+        float cycles_inverse = 0;
+        float error_inverse = 0;
+        if (n <= 6) {
+            dspm::Mat X;
+            unsigned int start_b = dsp_get_cpu_cycle_count();
+            for (int i = 0; i < repeat; i++) {
+                X = A.inverse() * B;
+            }
+            cycles_inverse = (float)(dsp_get_cpu_cycle_count() - start_b) / repeat;
+            error_inverse = solve_error(A, X, B);
+        }
+
+        dspm::Mat X;
+        unsigned int start_b = dsp_get_cpu_cycle_count();
+        for (int i = 0; i < repeat; i++) {
+            X = A.pinv() * B;
+        }
+        float cycles_pinv = (float)(dsp_get_cpu_cycle_count() - start_b) / repeat;
+        float error_pinv = solve_error(A, X, B);
+
+        dspm::Mat F(n, n);
+        float cycles_chol = 0;
+        for (int i = 0; i < repeat; i++) {
+            F = A;
+            X = B;
+            start_b = dsp_get_cpu_cycle_count();
+            dspm::solve_into(F, X, pivot, diag);
+            cycles_chol += dsp_get_cpu_cycle_count() - start_b;
+        }
+        cycles_chol /= repeat;
+        float error_chol = solve_error(A, X, B);
+
+        float cycles_lu = 0;
+        for (int i = 0; i < repeat; i++) {
+            F = A;
+            X = B;
+            start_b = dsp_get_cpu_cycle_count();
+            dspm::lu_factor(F, pivot);
+            dspm::lu_solve(F, pivot, X);
+            cycles_lu += dsp_get_cpu_cycle_count() - start_b;
+        }
+        cycles_lu /= repeat;
+        float error_lu = solve_error(A, X, B);
+
+        ESP_LOGI(TAG, "%2ix%2i: inverse %9.0f (%.1e), pinv %8.0f (%.1e), Cholesky %6.0f (%.1e), LU %6.0f (%.1e) cycles (error)",
+                 n, n, cycles_inverse, error_inverse, cycles_pinv, error_pinv, cycles_chol, error_chol, cycles_lu, error_lu);
+        TEST_ASSERT_TRUE(error_chol < 1e-4f);
+        TEST_ASSERT_TRUE(error_lu < 1e-4f);
+        TEST_ASSERT_TRUE(cycles_chol < cycles_pinv);
+    }
+    float min_exec = 1;
+    float max_exec = 200000;
+    dspm::Mat A = rand_spd(16);
+    dspm::Mat B(16, 3);
+    fill_rand(B);
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    dspm::solve_into(A, B, pivot, diag);
+    float cycles = dsp_get_cpu_cycle_count() - start_b;
+    TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles);
+}
@@ -0,0 +1,159 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsp_tests.h"
+#include "mat.h"
+#include "mat_sparse.h"
+
+static const char *TAG = "dspm_mat_sparse";
+
+static void fill_rand(dspm::Mat &m)
+{
+    for (int row = 0; row < m.rows; row++) {
+        for (int col = 0; col < m.cols; col++) {
+            m(row, col) = (float)(rand() % 2001 - 1000) / 500.0f;
+        }
+    }
+}
+
+// About one of four elements is not zero, rows without elements included
+static void fill_sparse(dspm::Mat &m)
+{
+    for (int row = 0; row < m.rows; row++) {
+        for (int col = 0; col < m.cols; col++) {
+            m(row, col) = ((rand() % 4) == 0) ? (float)(rand() % 2001 - 1000) / 500.0f : 0;
+        }
+    }
+    for (int col = 0; col < m.cols; col++) {
+        m(1, col) = 0;
+    }
+}
+
+TEST_CASE("Mat sparse functionality", "[dspm]")
+{
+    dspm::Mat A(9, 11);
+    fill_sparse(A);
+    int row_start[10];
+    int col_index[9 * 11];
+    dspm::SparsePattern pattern = dspm::SparsePattern::find(A, row_start, col_index);
+    TEST_ASSERT_EQUAL(9, pattern.rows);
+    TEST_ASSERT_EQUAL(11, pattern.cols);
+    TEST_ASSERT_EQUAL(pattern.row_start[1], pattern.row_start[2]);
+    int nnz = 0;
+    for (int i = 0; i < 9 * 11; i++) {
+        nnz += (A.data[i] != 0) ? 1 : 0;
+    }
+    TEST_ASSERT_EQUAL(nnz, pattern.nnz());
+    TEST_ASSERT_TRUE(pattern.covers(A));
+    dspm::Mat A2 = A;
+    A2(1, 3) = 1;
+    TEST_ASSERT_FALSE(pattern.covers(A2));
+    TEST_ASSERT_FALSE(pattern.covers(A.t()));
+
+    // Same result as the dense product
+    dspm::Mat B(11, 7);
+    fill_rand(B);
+    dspm::Mat C(9, 7);
+    fill_rand(C);
+    dspm::mult_sparse_into(pattern, A, B, C);
+    dspm::Mat C_dense = A * B;
+    TEST_ASSERT_TRUE(C_dense == C);
+
+    // Upper triangle of F*P*F'
+    dspm::Mat F(9, 9);
+    fill_sparse(F);
+    for (int i = 0; i < 9; i++) {
+        F(i, i) = 1;
+    }
+    dspm::Mat L(9, 9);
+    fill_rand(L);
+    dspm::Mat P = L * L.t();
+    int f_row_start[10];
+    int f_col_index[9 * 9];
+    dspm::SparsePattern f_pattern = dspm::SparsePattern::find(F, f_row_start, f_col_index);
+    dspm::Mat FP(9, 9);
+    dspm::mult_sparse_into(f_pattern, F, P, FP);
+    dspm::Mat FPF(9, 9);
+    dspm::mult_bt_sparse_sym_into(FP, f_pattern, F, FPF);
+    dspm::Mat FPF_dense(9, 9);
+    dspm::mult_bt_sym_into(F * P, F, FPF_dense);
+    TEST_ASSERT_TRUE(FPF_dense == FPF);
+
+    // A pattern with zero elements gives the same result
+    int full_row_start[10];
+    int full_col_index[9 * 11];
+    dspm::SparsePattern full_pattern = {9, 11, full_row_start, full_col_index};
+    for (int row = 0; row < 9; row++) {
+        full_row_start[row] = row * 11;
+        for (int col = 0; col < 11; col++) {
+            full_col_index[row * 11 + col] = col;
+        }
+    }
+    full_row_start[9] = 9 * 11;
+    TEST_ASSERT_EQUAL(99, full_pattern.nnz());
+    dspm::mult_sparse_into(full_pattern, A, B, C);
+    TEST_ASSERT_TRUE(C_dense == C);
+
+    // Sub-matrices
+    dspm::Mat big(12, 12);
+    dspm::Mat roi = big.getROI(1, 2, 9, 7);
+    dspm::mult_sparse_into(pattern, A, B, roi);
+    TEST_ASSERT_EQUAL_FLOAT(C_dense(3, 4), big(4, 6));
+    TEST_ASSERT_EQUAL_FLOAT(0, big(0, 0));
+
+    ESP_LOGI(TAG, "following are expected error messages about matrices dimensions");
+    dspm::mult_sparse_into(pattern, A, C, C);
+    dspm::mult_bt_sparse_sym_into(FP, pattern, F, FPF);
+    TEST_ASSERT_TRUE(FPF_dense == FPF);
+}
+
+TEST_CASE("Mat sparse benchmark", "[dspm]")
+{
+    // F*P*F' with a Jacobian of the 13 states EKF structure: 4 rows of 7 elements and identity
+    const int repeat = 16;
+    dspm::Mat F = dspm::Mat::eye(13);
+    for (int i = 0; i < 4; i++) {
+        for (int k = 0; k < 7; k++) {
+            F(i, k) = (float)(rand() % 2001 - 1000) / 500.0f;
+        }
+    }
+    dspm::Mat L(13, 13);
+    fill_rand(L);
+    dspm::Mat P = L * L.t();
+    int row_start[14];
+    int col_index[13 * 13];
+    dspm::SparsePattern pattern = dspm::SparsePattern::find(F, row_start, col_index);
+    dspm::Mat FP(13, 13);
+    dspm::Mat FPF(13, 13);
+
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    for (int i = 0; i < repeat; i++) {
+        dspm::mult_into(F, P, FP);
+        dspm::mult_bt_sym_into(FP, F, FPF);
+    }
+    unsigned int end_b = dsp_get_cpu_cycle_count();
+    float cycles_dense = (float)(end_b - start_b) / repeat;
+
+    start_b = dsp_get_cpu_cycle_count();
+    for (int i = 0; i < repeat; i++) {
+        dspm::mult_sparse_into(pattern, F, P, FP);
+        dspm::mult_bt_sparse_sym_into(FP, pattern, F, FPF);
+    }
+    end_b = dsp_get_cpu_cycle_count();
+    float cycles_sparse = (float)(end_b - start_b) / repeat;
+
+    ESP_LOGI(TAG, "F*P*F' 13x13 with %i nonzero elements: dense %f, sparse %f cycles", pattern.nnz(), cycles_dense, cycles_sparse);
+    float min_exec = 1;
+    float max_exec = 200000;
+    TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles_sparse);
+}
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <string.h>
+#include <stdlib.h>
 #include "unity.h"
 #include "esp_dsp.h"
 #include "dsp_platform.h"
@@ -27,9 +28,9 @@ static const char *TAG = "dspm_mult_f32_ansi";
 // Test dsps_dotprod_s16_ansi function
 TEST_CASE("dspm_mult_f32_ansi functionality", "[dspm]")
 {
-    for (int m = 1 ; m < 8 ; m++) {
-        for (int n = 1; n < 8 ; n++) {
-            for (int k = 1; k < 8 ; k++) {
+    for (int m = 1 ; m < 10 ; m++) {
+        for (int n = 1; n < 10 ; n++) {
+            for (int k = 1; k < 10 ; k++) {
                 float A[m][n];
                 float *A_ptr = (float *)A;
 
@@ -41,10 +42,6 @@ TEST_CASE("dspm_mult_f32_ansi functionality", "[dspm]")
                 float C_compare[m][k];
                 float *Cc_ptr = (float *)C_compare;
 
-                for (int i = 0 ; i < m * n; i++) {
-                    A_ptr[i] = i;
-                    B_ptr[i] = i;
-                }
                 for (int i = 0 ; i < m ; i++) {
                     for (int j = 0 ; j < n ; j++) {
                         A[i][j] = i * n + j;
@@ -116,3 +113,139 @@ TEST_CASE("dspm_mult_f32_ansi benchmark", "[dspm]")
     float max_exec = 2000;
     TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles);
 }
+
+// Simple loops, as dspm_mult_ex_f32_ansi() without register blocks
+static void mult_ref(const float *A, const float *B, float *C, int m, int n, int k, int A_step, int B_step, int C_step)
+{
+    for (int i = 0 ; i < m ; i++) {
+        for (int j = 0 ; j < k ; j++) {
+            C[i * C_step + j] = A[i * A_step] * B[j];
+            for (int s = 1; s < n ; s++) {
+                C[i * C_step + j] += A[i * A_step + s] * B[s * B_step + j];
+            }
+        }
+    }
+}
+
+static void fill_rand(float *data, int length)
+{
+    for (int i = 0 ; i < length ; i++) {
+        data[i] = (float)(rand() % 2001 - 1000) / 300.0f;
+    }
+}
+
+TEST_CASE("dspm_mult_3x3xx_f32_ansi and dspm_mult_4x4xx_f32_ansi functionality", "[dspm]")
+{
+    float A[16];
+    float B[16];
+    float C[16];
+    float C_compare[16];
+    fill_rand(A, 16);
+    fill_rand(B, 16);
+
+    dspm_mult_3x3x1_f32_ansi(A, B, C);
+    mult_ref(A, B, C_compare, 3, 3, 1, 3, 1, 1);
+    for (int i = 0 ; i < 3 ; i++) {
+        TEST_ASSERT_EQUAL_FLOAT(C_compare[i], C[i]);
+    }
+    dspm_mult_3x3x3_f32_ansi(A, B, C);
+    mult_ref(A, B, C_compare, 3, 3, 3, 3, 3, 3);
+    for (int i = 0 ; i < 9 ; i++) {
+        TEST_ASSERT_EQUAL_FLOAT(C_compare[i], C[i]);
+    }
+    dspm_mult_4x4x1_f32_ansi(A, B, C);
+    mult_ref(A, B, C_compare, 4, 4, 1, 4, 1, 1);
+    for (int i = 0 ; i < 4 ; i++) {
+        TEST_ASSERT_EQUAL_FLOAT(C_compare[i], C[i]);
+    }
+    dspm_mult_4x4x4_f32_ansi(A, B, C);
+    mult_ref(A, B, C_compare, 4, 4, 4, 4, 4, 4);
+    for (int i = 0 ; i < 16 ; i++) {
+        TEST_ASSERT_EQUAL_FLOAT(C_compare[i], C[i]);
+    }
+
+    // The size specific macros select the same results
+    dspm_mult_3x3x3_f32(A, B, C);
+    mult_ref(A, B, C_compare, 3, 3, 3, 3, 3, 3);
+    for (int i = 0 ; i < 9 ; i++) {
+        TEST_ASSERT_EQUAL_FLOAT(C_compare[i], C[i]);
+    }
+    float B_copy[16];
+    memcpy(B_copy, B, sizeof(B));
+    dspm_mult_3x3x3_f32(A, B, C);
+    TEST_ASSERT_EQUAL_MEMORY(B_copy, B, sizeof(B));
+    dspm_mult_4x4x4_f32(A, B, C);
+    mult_ref(A, B, C_compare, 4, 4, 4, 4, 4, 4);
+    for (int i = 0 ; i < 16 ; i++) {
+        TEST_ASSERT_EQUAL_FLOAT(C_compare[i], C[i]);
+    }
+}
+
+TEST_CASE("dspm_mult_ex_f32_ansi register blocks functionality", "[dspm]")
+{
+    // Sub-matrices of 20x20 buffers: all combinations of full blocks and remaining rows and columns
+    const int max_size = 13;
+    const int step = 20;
+    float *A = (float *)malloc(step * step * sizeof(float));
+    float *B = (float *)malloc(step * step * sizeof(float));
+    float *C = (float *)malloc(step * step * sizeof(float));
+    float *C_compare = (float *)malloc(step * step * sizeof(float));
+    fill_rand(A, step * step);
+    fill_rand(B, step * step);
+    for (int m = 1 ; m <= max_size ; m++) {
+        for (int n = 1; n <= max_size ; n++) {
+            for (int k = 1; k <= max_size ; k++) {
+                for (int i = 0 ; i < step * step ; i++) {
+                    C[i] = -1;
+                    C_compare[i] = -1;
+                }
+                dspm_mult_ex_f32_ansi(A, B, C, m, n, k, step - n, step - k, step - k);
+                mult_ref(A, B, C_compare, m, n, k, step, step, step);
+                for (int i = 0 ; i < step * step ; i++) {
+                    if (C_compare[i] != C[i]) {
+                        ESP_LOGE(TAG, "%ix%ix%i: C[%i] = %f, expected %f", m, n, k, i, C[i], C_compare[i]);
+                        TEST_ASSERT_EQUAL_FLOAT(C_compare[i], C[i]);
+                    }
+                }
+            }
+        }
+    }
+    free(A);
+    free(B);
+    free(C);
+    free(C_compare);
+}
+
+TEST_CASE("dspm_mult_f32_ansi register blocks benchmark", "[dspm]")
+{
+    const int sizes[][3] = {{3, 3, 3}, {4, 4, 4}, {6, 6, 6}, {8, 8, 8}, {13, 13, 13}, {13, 13, 18}, {16, 16, 16}};
+    const int repeat_count = 16;
+    float *A = (float *)malloc(16 * 18 * sizeof(float));
+    float *B = (float *)malloc(16 * 18 * sizeof(float));
+    float *C = (float *)malloc(16 * 18 * sizeof(float));
+    fill_rand(A, 16 * 18);
+    fill_rand(B, 16 * 18);
+    float cycles = 0;
+    for (int t = 0 ; t < sizeof(sizes) / sizeof(sizes[0]) ; t++) {
+        int m = sizes[t][0];
+        int n = sizes[t][1];
+        int k = sizes[t][2];
+        unsigned int start_b = dsp_get_cpu_cycle_count();
+        for (int i = 0 ; i < repeat_count ; i++) {
+            mult_ref(A, B, C, m, n, k, n, k, k);
+        }
+        float cycles_ref = (float)(dsp_get_cpu_cycle_count() - start_b) / repeat_count;
+        start_b = dsp_get_cpu_cycle_count();
+        for (int i = 0 ; i < repeat_count ; i++) {
+            dspm_mult_f32_ansi(A, B, C, m, n, k);
+        }
+        cycles = (float)(dsp_get_cpu_cycle_count() - start_b) / repeat_count;
+        ESP_LOGI(TAG, "%2ix%2ix%2i: simple loops %8.0f, dspm_mult_f32_ansi %8.0f cycles", m, n, k, cycles_ref, cycles);
+    }
+    free(A);
+    free(B);
+    free(C);
+    float min_exec = 10;
+    float max_exec = 200000;
+    TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles);
+}
@@ -0,0 +1,220 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <math.h>
+#include "dsps_octave.h"
+#include "dsps_biquad.h"
+#include "dsps_biquad_gen.h"
+#include "dsps_dotprod.h"
+
+// 4th order Butterworth, same Q values as the IIR filter middleware
+#define OCTAVE_LPF_Q1   (1 / 0.765)
+#define OCTAVE_LPF_Q2   (1 / 1.848)
+
+typedef struct {
+    double re;
+    double im;
+} octave_cplx_t;
+
+static octave_cplx_t cplx_mul(octave_cplx_t a, octave_cplx_t b)
+{
+    octave_cplx_t r = {a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re};
+    return r;
+}
+
+static octave_cplx_t cplx_div(octave_cplx_t a, octave_cplx_t b)
+{
+    double d = b.re * b.re + b.im * b.im;
+    octave_cplx_t r = {(a.re * b.re + a.im * b.im) / d, (a.im * b.re - a.re * b.im) / d};
+    return r;
+}
+
+static octave_cplx_t cplx_sqrt(octave_cplx_t a)
+{
+    double m = sqrt(sqrt(a.re * a.re + a.im * a.im));
+    double ph = 0.5 * atan2(a.im, a.re);
+    octave_cplx_t r = {m * cos(ph), m * sin(ph)};
+    return r;
+}
+
+// Biquad with the poles z, conj(z) and zeros at +-1, unity numerator gain
+static void octave_biquad_from_pole(float *coeffs, octave_cplx_t z, double gain)
+{
+    coeffs[0] = gain;
+    coeffs[1] = 0;
+    coeffs[2] = -gain;
+    coeffs[3] = -2 * z.re;
+    coeffs[4] = z.re * z.re + z.im * z.im;
+}
+
+// |H(e^jw)| of a biquad stored as b0,b1,b2,a1,a2
+static double octave_biquad_mag(const float *c, double w)
+{
+    octave_cplx_t z1 = {cos(w), -sin(w)};
+    octave_cplx_t z2 = cplx_mul(z1, z1);
+    octave_cplx_t num = {c[0] + c[1] * z1.re + c[2] * z2.re, c[1] * z1.im + c[2] * z2.im};
+    octave_cplx_t den = {1 + c[3] * z1.re + c[4] * z2.re, c[3] * z1.im + c[4] * z2.im};
+    return sqrt((num.re * num.re + num.im * num.im) / (den.re * den.re + den.im * den.im));
+}
+
+// 4th order Butterworth band-pass between f1 and f2 (relative to fs), bilinear transform with prewarping
+static void octave_design_band(float coeffs[2][5], double f1, double f2)
+{
+    double w1 = tan(M_PI * f1);
+    double w2 = tan(M_PI * f2);
+    double w0_2 = w1 * w2;
+    double bw = w2 - w1;
+
+    // Low-pass prototype pole e^(j*3pi/4), s^2 - p*bw*s + w0^2 = 0
+    octave_cplx_t pb = {-M_SQRT1_2 * bw, M_SQRT1_2 * bw};
+    octave_cplx_t disc = cplx_mul(pb, pb);
+    disc.re -= 4 * w0_2;
+    octave_cplx_t sq = cplx_sqrt(disc);
+    octave_cplx_t s[2] = {{(pb.re + sq.re) / 2, (pb.im + sq.im) / 2}, {(pb.re - sq.re) / 2, (pb.im - sq.im) / 2}};
+
+    for (int i = 0; i < 2; i++) {
+        octave_cplx_t one_plus = {1 + s[i].re, s[i].im};
+        octave_cplx_t one_minus = {1 - s[i].re, -s[i].im};
+        octave_biquad_from_pole(coeffs[i], cplx_div(one_plus, one_minus), 1.0);
+    }
+
+    // Unity gain at the center frequency, split between both sections
+    double wc = 2 * atan(sqrt(w0_2));
+    double g = 1.0 / sqrt(octave_biquad_mag(coeffs[0], wc) * octave_biquad_mag(coeffs[1], wc));
+    for (int i = 0; i < 2; i++) {
+        coeffs[i][0] *= g;
+        coeffs[i][2] *= g;
+    }
+}
+
+esp_err_t dsps_octave_init_f32(octave_f32_t *ob, float f_center, int n_octaves, int bpo, int window_len)
+{
+    if ((bpo != 1) && (bpo != 3)) {
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    if ((n_octaves < 1) || (n_octaves > DSPS_OCTAVE_MAX_OCTAVES)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    double half_band = pow(2.0, 1.0 / (2 * bpo));
+    if ((f_center <= 0) || (f_center * half_band > 0.25)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    if ((window_len <= 0) || (window_len % (1 << (n_octaves - 1)))) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+
+    ob->n_octaves = n_octaves;
+    ob->bpo = bpo;
+    ob->window_len = window_len;
+
+    for (int b = 0; b < bpo; b++) {
+        double fc = f_center * pow(2.0, -(double)b / bpo);
+        ob->centers[b] = fc;
+        octave_design_band(ob->band_coeffs[b], fc / half_band, fc * half_band);
+    }
+
+    // Pass the highest band of the next stage, reject its image around fs/2
+    double pass = f_center * half_band / 2;
+    double fc = sqrt(pass * (0.5 - pass));
+    dsps_biquad_gen_lpf_f32(ob->lpf_coeffs[0], fc, OCTAVE_LPF_Q1);
+    dsps_biquad_gen_lpf_f32(ob->lpf_coeffs[1], fc, OCTAVE_LPF_Q2);
+
+    return dsps_octave_reset_f32(ob);
+}
+
+esp_err_t dsps_octave_reset_f32(octave_f32_t *ob)
+{
+    float *d = &ob->band_delay[0][0][0];
+    for (int i = 0; i < (int)(sizeof(ob->band_delay) / sizeof(float)); i++) {
+        d[i] = 0;
+    }
+    d = &ob->lpf_delay[0][0][0];
+    for (int i = 0; i < (int)(sizeof(ob->lpf_delay) / sizeof(float)); i++) {
+        d[i] = 0;
+    }
+    for (int i = 0; i < DSPS_OCTAVE_MAX_BANDS; i++) {
+        ob->energy[i] = 0;
+    }
+    for (int i = 0; i < DSPS_OCTAVE_MAX_OCTAVES; i++) {
+        ob->phase[i] = 0;
+    }
+    ob->window_pos = 0;
+    return ESP_OK;
+}
+
+esp_err_t dsps_octave_centers_f32(const octave_f32_t *ob, float *centers)
+{
+    const int n_bands = ob->n_octaves * ob->bpo;
+    for (int k = 0; k < ob->n_octaves; k++) {
+        for (int b = 0; b < ob->bpo; b++) {
+            centers[n_bands - 1 - (k * ob->bpo + b)] = ob->centers[b] / (float)(1 << k);
+        }
+    }
+    return ESP_OK;
+}
+
+// Runs the stages on a chunk that does not cross a window boundary
+static void octave_process_chunk(octave_f32_t *ob, const float *input, int len)
+{
+    const float *in = input;
+    for (int k = 0; (k < ob->n_octaves) && (len > 0); k++) {
+        for (int b = 0; b < ob->bpo; b++) {
+            int band = k * ob->bpo + b;
+            float energy;
+            dsps_biquad_f32(in, ob->band_buf, len, ob->band_coeffs[b][0], ob->band_delay[band][0]);
+            dsps_biquad_f32(ob->band_buf, ob->band_buf, len, ob->band_coeffs[b][1], ob->band_delay[band][1]);
+            dsps_dotprod_f32(ob->band_buf, ob->band_buf, &energy, len);
+            ob->energy[band] += energy;
+        }
+        if (k == ob->n_octaves - 1) {
+            break;
+        }
+
+        // Anti-alias filter and decimation by 2, in place in the stage buffer
+        dsps_biquad_f32(in, ob->stage_buf, len, ob->lpf_coeffs[0], ob->lpf_delay[k][0]);
+        dsps_biquad_f32(ob->stage_buf, ob->stage_buf, len, ob->lpf_coeffs[1], ob->lpf_delay[k][1]);
+        int out = 0;
+        for (int i = 0; i < len; i++) {
+            ob->phase[k] ^= 1;
+            if (ob->phase[k] == 0) {
+                ob->stage_buf[out++] = ob->stage_buf[i];
+            }
+        }
+        in = ob->stage_buf;
+        len = out;
+    }
+}
+
+int dsps_octave_f32(octave_f32_t *ob, const float *input, int len, float *rms)
+{
+    const int n_bands = ob->n_octaves * ob->bpo;
+    int result = 0;
+    while (len > 0) {
+        int chunk = ob->window_len - ob->window_pos;
+        if (chunk > DSPS_OCTAVE_CHUNK) {
+            chunk = DSPS_OCTAVE_CHUNK;
+        }
+        if (chunk > len) {
+            chunk = len;
+        }
+        octave_process_chunk(ob, input, chunk);
+        input += chunk;
+        len -= chunk;
+        ob->window_pos += chunk;
+
+        if (ob->window_pos == ob->window_len) {
+            // Stage k received exactly window_len/2^k samples
+            for (int band = 0; band < n_bands; band++) {
+                int samples = ob->window_len >> (band / ob->bpo);
+                rms[result * n_bands + n_bands - 1 - band] = sqrtf(ob->energy[band] / samples);
+                ob->energy[band] = 0;
+            }
+            ob->window_pos = 0;
+            result++;
+        }
+    }
+    return result;
+}
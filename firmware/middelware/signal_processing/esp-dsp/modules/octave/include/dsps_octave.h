@@ -0,0 +1,115 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _dsps_octave_H_
+#define _dsps_octave_H_
+
+#include "dsp_err.h"
+#include "dsp_common.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define DSPS_OCTAVE_MAX_OCTAVES     10  /*!< Maximum number of octaves (decimation stages)*/
+#define DSPS_OCTAVE_MAX_BPO         3   /*!< Maximum number of bands per octave*/
+#define DSPS_OCTAVE_MAX_BANDS       (DSPS_OCTAVE_MAX_OCTAVES * DSPS_OCTAVE_MAX_BPO)
+#define DSPS_OCTAVE_CHUNK           64  /*!< Input samples processed at once by every stage*/
+
+/**
+ * @brief Data struct of f32 octave filter bank
+ *
+ * The bank is a decimation tree: every stage holds the band-pass filters of one octave and a
+ * half-band low-pass filter, and passes every second sample of the low-pass output to the next stage.
+ * All the stages share the same coefficients, and stage k runs at fs/2^k, so the total cost is
+ * below twice the cost of the first stage regardless of the number of octaves.
+ * All fields of this structure are initialized by the dsps_octave_init_f32(...) function.
+ */
+typedef struct octave_f32_s {
+    float   band_coeffs[DSPS_OCTAVE_MAX_BPO][2][5];                 /*!< Band-pass biquads of one octave, highest band first*/
+    float   lpf_coeffs[2][5];                                       /*!< Anti-alias low-pass biquads*/
+    float   band_delay[DSPS_OCTAVE_MAX_BANDS][2][2];                /*!< Band-pass delay lines*/
+    float   lpf_delay[DSPS_OCTAVE_MAX_OCTAVES][2][2];               /*!< Low-pass delay lines*/
+    float   energy[DSPS_OCTAVE_MAX_BANDS];                          /*!< Sum of squares over the current window*/
+    float   centers[DSPS_OCTAVE_MAX_BPO];                           /*!< Center frequencies of the first stage, relative to fs*/
+    float   stage_buf[DSPS_OCTAVE_CHUNK];                           /*!< Input of the stage being processed*/
+    float   band_buf[DSPS_OCTAVE_CHUNK];                            /*!< Band-pass output*/
+    uint8_t phase[DSPS_OCTAVE_MAX_OCTAVES];                         /*!< Decimation phase of every stage*/
+    int     n_octaves;                                              /*!< Number of octaves*/
+    int     bpo;                                                    /*!< Bands per octave (1 or 3)*/
+    int     window_len;                                             /*!< Integration window, in input samples*/
+    int     window_pos;                                             /*!< Input samples received in the current window*/
+} octave_f32_t;
+
+/**
+ * @brief   initialize structure for octave or third-octave filter bank
+ *
+ * Every band is a 4th order Butterworth band-pass (two biquads) with edges at fc*2^(+-1/(2*bpo)),
+ * designed by the bilinear transform. The anti-alias filter of every stage is a 4th order Butterworth
+ * low-pass. The upper edge of the highest band must be below fs/4, so the aliases of the next stages
+ * stay more than 35 dB down.
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param ob: pointer to filter bank structure, that must be preallocated
+ * @param f_center: center frequency of the highest band, relative to the sample rate
+ * @param n_octaves: number of octaves [1..DSPS_OCTAVE_MAX_OCTAVES]
+ * @param bpo: bands per octave, 1 (octave) or 3 (third-octave)
+ * @param window_len: RMS integration window in input samples, must be a multiple of 2^(n_octaves - 1)
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_PARAM if bpo is not 1 or 3
+ *      - ESP_ERR_DSP_INVALID_LENGTH if window_len is not valid
+ *      - ESP_ERR_DSP_PARAM_OUTOFRANGE if f_center or n_octaves are out of range
+ */
+esp_err_t dsps_octave_init_f32(octave_f32_t *ob, float f_center, int n_octaves, int bpo, int window_len);
+
+/**
+ * @brief   reset the filter bank
+ *
+ * Function clears all the delay lines and the current integration window.
+ *
+ * @param ob: pointer to filter bank structure, that must be initialized before
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dsps_octave_reset_f32(octave_f32_t *ob);
+
+/**
+ * @brief   center frequencies of the bands
+ *
+ * @param ob: pointer to filter bank structure, that must be initialized before
+ * @param[out] centers: array of n_octaves*bpo center frequencies relative to the sample rate, lowest band first
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dsps_octave_centers_f32(const octave_f32_t *ob, float *centers);
+
+/**
+ * @brief   octave filter bank
+ *
+ * Function filters len input samples. Every time an integration window is completed, the RMS value
+ * of all the bands is written to the rms array, lowest band first, n_octaves*bpo values per window.
+ * The window phase is kept between calls, so the input could be split into blocks of any length.
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param ob: pointer to filter bank structure, that must be initialized before
+ * @param[in] input: input array
+ * @param len: length of input array
+ * @param[out] rms: output array. Must have at least (len/window_len + 1)*n_octaves*bpo elements
+ *
+ * @return: function returns the number of RMS vectors stored in the rms array
+ */
+int dsps_octave_f32(octave_f32_t *ob, const float *input, int len, float *rms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _dsps_octave_H_
@@ -0,0 +1,109 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <math.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsps_octave.h"
+#include "dsp_tests.h"
+
+static const char *TAG = "dsps_octave_f32";
+
+#define N_OCTAVES   6
+#define WINDOW      4096
+#define N_WINDOWS   4
+#define N_SAMPLES   (WINDOW * N_WINDOWS)
+
+static float x[N_SAMPLES];
+static float rms[(N_WINDOWS + 1) * DSPS_OCTAVE_MAX_BANDS];
+static float centers[DSPS_OCTAVE_MAX_BANDS];
+static octave_f32_t bank;
+
+// Feeds a tone in uneven blocks and returns the band levels of the last window
+static const float *octave_run_tone(float f, float amplitude)
+{
+    for (int i = 0; i < N_SAMPLES; i++) {
+        x[i] = amplitude * sinf(2 * M_PI * f * i);
+    }
+    dsps_octave_reset_f32(&bank);
+    int total = 0;
+    int pos = 0;
+    while (pos < N_SAMPLES) {
+        int block = 100;
+        if (pos + block > N_SAMPLES) {
+            block = N_SAMPLES - pos;
+        }
+        total += dsps_octave_f32(&bank, &x[pos], block, &rms[total * bank.n_octaves * bank.bpo]);
+        pos += block;
+    }
+    return (total == N_WINDOWS) ? &rms[(total - 1) * bank.n_octaves * bank.bpo] : NULL;
+}
+
+TEST_CASE("dsps_octave_f32 functionality", "[dsps]")
+{
+    const int bpo_list[] = {1, 3};
+    const float amplitude = 0.5f;
+    for (int t = 0; t < 2; t++) {
+        int bpo = bpo_list[t];
+        int n_bands = N_OCTAVES * bpo;
+        TEST_ASSERT_EQUAL(ESP_OK, dsps_octave_init_f32(&bank, 0.16f, N_OCTAVES, bpo, WINDOW));
+        dsps_octave_centers_f32(&bank, centers);
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.16f, centers[n_bands - 1]);
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.16f / 32, centers[bpo - 1]);
+
+        // A tone at every band center, the lowest bands go through the whole decimation tree
+        for (int b = 0; b < n_bands; b++) {
+            const float *level = octave_run_tone(centers[b], amplitude);
+            TEST_ASSERT_NOT_NULL(level);
+            ESP_LOGI(TAG, "bpo %i, band %2i (%f): %f", bpo, b, centers[b], level[b]);
+            TEST_ASSERT_FLOAT_WITHIN(0.05f * amplitude, amplitude / sqrtf(2), level[b]);
+            // 4th order band-pass: the band one octave away is at least 10 dB down
+            if (b >= bpo) {
+                TEST_ASSERT_TRUE(level[b - bpo] < level[b] * 0.32f);
+            }
+            if (b + bpo < n_bands) {
+                TEST_ASSERT_TRUE(level[b + bpo] < level[b] * 0.32f);
+            }
+        }
+    }
+
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_LENGTH, dsps_octave_init_f32(&bank, 0.16f, N_OCTAVES, 1, 1000));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_octave_init_f32(&bank, 0.2f, N_OCTAVES, 1, WINDOW));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_PARAM, dsps_octave_init_f32(&bank, 0.16f, N_OCTAVES, 2, WINDOW));
+}
+
+TEST_CASE("dsps_octave_f32 benchmark", "[dsps]")
+{
+    for (int i = 0; i < N_SAMPLES; i++) {
+        x[i] = sinf(0.1f * i);
+    }
+
+    // Single band-pass filter at full rate: two biquads and the energy accumulation
+    dsps_octave_init_f32(&bank, 0.16f, 1, 1, WINDOW);
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    dsps_octave_f32(&bank, x, N_SAMPLES, rms);
+    unsigned int end_b = dsp_get_cpu_cycle_count();
+    float cycles_single = (float)(end_b - start_b) / N_SAMPLES;
+
+    const int bpo_list[] = {1, 3};
+    for (int t = 0; t < 2; t++) {
+        dsps_octave_init_f32(&bank, 0.16f, DSPS_OCTAVE_MAX_OCTAVES, bpo_list[t], WINDOW);
+        start_b = dsp_get_cpu_cycle_count();
+        dsps_octave_f32(&bank, x, N_SAMPLES, rms);
+        end_b = dsp_get_cpu_cycle_count();
+        float cycles = (float)(end_b - start_b) / N_SAMPLES;
+        ESP_LOGI(TAG, "%i bands: %f cycles per input sample, single band filter %f", DSPS_OCTAVE_MAX_OCTAVES * bpo_list[t], cycles, cycles_single);
+
+        // Two times the first stage: bpo band filters plus the anti-alias filter
+        float min_exec = 1;
+        float max_exec = 2.5f * (bpo_list[t] + 1) * cycles_single;
+        TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles);
+    }
+}
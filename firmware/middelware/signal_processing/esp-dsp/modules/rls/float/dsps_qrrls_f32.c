@@ -0,0 +1,104 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <math.h>
+#include "dsps_rls.h"
+
+esp_err_t dsps_qrrls_init_f32(qrrls_f32_t *qr, float *R, float *z, float *work, int N, float lambda, float delta)
+{
+    if (N < 1) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    if ((lambda <= 0) || (lambda > 1) || (delta <= 0)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    qr->R = R;
+    qr->z = z;
+    qr->x = work;
+    qr->delay = work + N;
+    qr->sqrt_lambda = sqrtf(lambda);
+    qr->N = N;
+
+    // R'*R = P^-1 = I/delta
+    memset(R, 0, N * N * sizeof(float));
+    memset(z, 0, N * sizeof(float));
+    memset(work, 0, 2 * N * sizeof(float));
+    const float r0 = 1.0f / sqrtf(delta);
+    for (int i = 0; i < N; i++) {
+        R[i * N + i] = r0;
+    }
+    return ESP_OK;
+}
+
+float dsps_qrrls_update_f32(qrrls_f32_t *qr, const float *x, float d)
+{
+    const int N = qr->N;
+    const float sl = qr->sqrt_lambda;
+    float *R = qr->R;
+    float *z = qr->z;
+    float *xr = qr->x;
+    memcpy(xr, x, N * sizeof(float));
+
+    // Rotate the row [x' d] into [sqrt(lambda)*R sqrt(lambda)*z], one column at a time.
+    // xi ends as the angle normalized error and gamma as the square root of the conversion factor.
+    float xi = d;
+    float gamma = 1;
+    for (int i = 0; i < N; i++) {
+        float *row = &R[i * N];
+        const float a = sl * row[i];
+        const float b = xr[i];
+        const float r = sqrtf(a * a + b * b);
+        float c = 1;
+        float s = 0;
+        if (r > 0) {
+            c = a / r;
+            s = b / r;
+        }
+        row[i] = r;
+        for (int j = i + 1; j < N; j++) {
+            const float rij = sl * row[j];
+            const float xj = xr[j];
+            row[j] = c * rij + s * xj;
+            xr[j] = c * xj - s * rij;
+        }
+        const float zi = sl * z[i];
+        z[i] = c * zi + s * xi;
+        xi = c * xi - s * zi;
+        gamma *= c;
+    }
+    // a priori error = xi/gamma, a posteriori error = xi*gamma
+    return (gamma > 0) ? xi / gamma : xi;
+}
+
+esp_err_t dsps_qrrls_f32(qrrls_f32_t *qr, const float *input, const float *desired, float *error, int len)
+{
+    const int N = qr->N;
+    float *delay = qr->delay;
+    for (int n = 0; n < len; n++) {
+        memmove(&delay[1], &delay[0], (N - 1) * sizeof(float));
+        delay[0] = input[n];
+        float e = dsps_qrrls_update_f32(qr, delay, desired[n]);
+        if (error) {
+            error[n] = e;
+        }
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_qrrls_weights_f32(qrrls_f32_t *qr, float *w)
+{
+    const int N = qr->N;
+    const float *R = qr->R;
+    for (int i = N - 1; i >= 0; i--) {
+        float acc = qr->z[i];
+        for (int j = i + 1; j < N; j++) {
+            acc -= R[i * N + j] * w[j];
+        }
+        w[i] = acc / R[i * N + i];
+    }
+    return ESP_OK;
+}
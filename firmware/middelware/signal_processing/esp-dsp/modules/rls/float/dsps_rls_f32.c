@@ -0,0 +1,84 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include "dsps_rls.h"
+#include "dsps_dotprod.h"
+
+esp_err_t dsps_rls_init_f32(rls_f32_t *rls, float *w, float *P, float *work, int N, float lambda, float delta)
+{
+    if (N < 1) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    if ((lambda <= 0) || (lambda > 1) || (delta <= 0)) {
+        return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+    }
+    rls->w = w;
+    rls->P = P;
+    rls->pi = work;
+    rls->delay = work + N;
+    rls->lambda = lambda;
+    rls->inv_lambda = 1.0f / lambda;
+    rls->N = N;
+
+    memset(w, 0, N * sizeof(float));
+    memset(P, 0, N * N * sizeof(float));
+    memset(work, 0, 2 * N * sizeof(float));
+    for (int i = 0; i < N; i++) {
+        P[i * N + i] = delta;
+    }
+    return ESP_OK;
+}
+
+float dsps_rls_update_f32(rls_f32_t *rls, const float *x, float d)
+{
+    const int N = rls->N;
+    float *P = rls->P;
+    float *pi = rls->pi;
+    float *w = rls->w;
+
+    // pi = P*x, gamma = lambda + x'*P*x
+    for (int i = 0; i < N; i++) {
+        dsps_dotprod_f32(&P[i * N], x, &pi[i], N);
+    }
+    float gamma;
+    dsps_dotprod_f32(x, pi, &gamma, N);
+    gamma += rls->lambda;
+
+    float y;
+    dsps_dotprod_f32(w, x, &y, N);
+    const float e = d - y;
+
+    // k = pi/gamma, w += k*e, P = (P - k*pi')/lambda on the upper triangle, mirrored to the lower one
+    const float inv_gamma = 1.0f / gamma;
+    const float inv_lambda = rls->inv_lambda;
+    for (int i = 0; i < N; i++) {
+        const float k = pi[i] * inv_gamma;
+        w[i] += k * e;
+        float *row = &P[i * N];
+        for (int j = i; j < N; j++) {
+            const float p = (row[j] - k * pi[j]) * inv_lambda;
+            row[j] = p;
+            P[j * N + i] = p;
+        }
+    }
+    return e;
+}
+
+esp_err_t dsps_rls_f32(rls_f32_t *rls, const float *input, const float *desired, float *error, int len)
+{
+    const int N = rls->N;
+    float *delay = rls->delay;
+    for (int n = 0; n < len; n++) {
+        memmove(&delay[1], &delay[0], (N - 1) * sizeof(float));
+        delay[0] = input[n];
+        float e = dsps_rls_update_f32(rls, delay, desired[n]);
+        if (error) {
+            error[n] = e;
+        }
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,172 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _dsps_rls_H_
+#define _dsps_rls_H_
+
+#include "dsp_err.h"
+#include "dsp_common.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Data struct of the recursive least squares filter
+ *
+ * Exponentially weighted RLS that minimizes sum(lambda^(n-i) * e(i)^2). The inverse correlation matrix
+ * P is stored as a full N x N matrix so its rows can be multiplied with dsps_dotprod_f32, but only its
+ * upper triangle is updated and mirrored, which halves the update and keeps P exactly symmetric.
+ * All memory is provided by the caller, nothing is allocated.
+ * All fields of this structure are initialized by the dsps_rls_init_f32(...) function.
+ */
+typedef struct rls_f32_s {
+    float  *w;          /*!< Weights, length N.*/
+    float  *P;          /*!< Inverse correlation matrix, N x N.*/
+    float  *pi;         /*!< P*x of the last update, length N.*/
+    float  *delay;      /*!< Regressor of the FIR mode, newest sample first, length N.*/
+    float   lambda;     /*!< Forgetting factor.*/
+    float   inv_lambda; /*!< 1/lambda.*/
+    int     N;          /*!< Number of weights.*/
+} rls_f32_t;
+
+/**
+ * @brief Data struct of the QR decomposition based recursive least squares filter
+ *
+ * Keeps the Cholesky factor R of the weighted correlation matrix (R'*R = P^-1) and the rotated desired
+ * signal z, and appends every new sample with N Givens rotations. The factor stays positive definite by
+ * construction, so the filter remains stable with lambda close to 1, poorly exciting inputs or long runs
+ * where the conventional update slowly loses the positive definiteness of P.
+ * The weights are only computed on request, by back substitution.
+ * All fields of this structure are initialized by the dsps_qrrls_init_f32(...) function.
+ */
+typedef struct qrrls_f32_s {
+    float  *R;          /*!< Upper triangular factor, N x N.*/
+    float  *z;          /*!< Rotated desired signal, length N.*/
+    float  *x;          /*!< Copy of the regressor rotated during the update, length N.*/
+    float  *delay;      /*!< Regressor of the FIR mode, newest sample first, length N.*/
+    float   sqrt_lambda;/*!< Square root of the forgetting factor.*/
+    int     N;          /*!< Number of weights.*/
+} qrrls_f32_t;
+
+/**
+ * @brief   init recursive least squares filter
+ *
+ * @param rls: pointer to RLS structure, that must be preallocated
+ * @param w: weights array, length N. Cleared by the function
+ * @param P: inverse correlation matrix, N*N elements. Set to delta*I by the function
+ * @param work: working array, 2*N elements
+ * @param N: number of weights
+ * @param lambda: forgetting factor (0..1], the memory of the filter is about 1/(1 - lambda) samples
+ * @param delta: initial value of the diagonal of P. Large values (100..10000) give a fast initial convergence
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_LENGTH if N is less than 1
+ *      - ESP_ERR_DSP_PARAM_OUTOFRANGE if lambda or delta are out of range
+ */
+esp_err_t dsps_rls_init_f32(rls_f32_t *rls, float *w, float *P, float *work, int N, float lambda, float delta);
+
+/**
+ * @brief   recursive least squares update with an arbitrary regressor
+ *
+ * One O(N^2) update of the weights and of P for the model d = w'*x + e.
+ * The regressor can hold any signals, for example past outputs and inputs of an ARX model.
+ *
+ * @param rls: pointer to RLS structure, that must be initialized before
+ * @param[in] x: regressor, length N
+ * @param d: desired signal
+ *
+ * @return a priori error d - w'*x, computed with the weights before the update
+ */
+float dsps_rls_update_f32(rls_f32_t *rls, const float *x, float d);
+
+/**
+ * @brief   recursive least squares FIR filter
+ *
+ * Identifies the FIR filter w that maps input to desired. The regressor is the N last input samples,
+ * newest first, kept in the structure between calls.
+ *
+ * @param rls: pointer to RLS structure, that must be initialized before
+ * @param[in] input: input array
+ * @param[in] desired: desired array
+ * @param[out] error: a priori error array, can be NULL
+ * @param len: length of the arrays
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dsps_rls_f32(rls_f32_t *rls, const float *input, const float *desired, float *error, int len);
+
+/**
+ * @brief   init QR decomposition based recursive least squares filter
+ *
+ * Parameters have the same meaning as in dsps_rls_init_f32, R is set to I/sqrt(delta).
+ *
+ * @param qr: pointer to QR-RLS structure, that must be preallocated
+ * @param R: upper triangular factor, N*N elements
+ * @param z: rotated desired signal, length N
+ * @param work: working array, 2*N elements
+ * @param N: number of weights
+ * @param lambda: forgetting factor (0..1]
+ * @param delta: initial value of the diagonal of P
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_LENGTH if N is less than 1
+ *      - ESP_ERR_DSP_PARAM_OUTOFRANGE if lambda or delta are out of range
+ */
+esp_err_t dsps_qrrls_init_f32(qrrls_f32_t *qr, float *R, float *z, float *work, int N, float lambda, float delta);
+
+/**
+ * @brief   QR-RLS update with an arbitrary regressor
+ *
+ * One O(N^2) update with N Givens rotations, N square roots and no division by the conversion factor
+ * except for the returned error.
+ *
+ * @param qr: pointer to QR-RLS structure, that must be initialized before
+ * @param[in] x: regressor, length N
+ * @param d: desired signal
+ *
+ * @return a priori error d - w'*x, computed with the weights before the update
+ */
+float dsps_qrrls_update_f32(qrrls_f32_t *qr, const float *x, float d);
+
+/**
+ * @brief   QR-RLS FIR filter
+ *
+ * Same as dsps_rls_f32(...) with the QR-RLS update.
+ *
+ * @param qr: pointer to QR-RLS structure, that must be initialized before
+ * @param[in] input: input array
+ * @param[in] desired: desired array
+ * @param[out] error: a priori error array, can be NULL
+ * @param len: length of the arrays
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dsps_qrrls_f32(qrrls_f32_t *qr, const float *input, const float *desired, float *error, int len);
+
+/**
+ * @brief   weights of the QR-RLS filter
+ *
+ * Solves R*w = z by back substitution, O(N^2).
+ *
+ * @param qr: pointer to QR-RLS structure
+ * @param[out] w: weights, length N
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dsps_qrrls_weights_f32(qrrls_f32_t *qr, float *w);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _dsps_rls_H_
@@ -0,0 +1,161 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsps_rls.h"
+#include "dsp_tests.h"
+
+static const char *TAG = "dsps_rls_f32";
+
+#define N_SAMPLES   1000
+#define MAX_N       16
+
+static float x[N_SAMPLES];
+static float d[N_SAMPLES];
+static float e[N_SAMPLES];
+static float e_qr[N_SAMPLES];
+static float w[MAX_N];
+static float w_qr[MAX_N];
+static float P[MAX_N * MAX_N];
+static float R[MAX_N * MAX_N];
+static float z[MAX_N];
+static float work[2 * MAX_N];
+static float work_qr[2 * MAX_N];
+
+static float rls_rand(void)
+{
+    return (float)rand() / RAND_MAX * 2 - 1;
+}
+
+// Desired signal of a FIR system h plus measurement noise
+static void rls_system(const float *h, int N, int from, int to, float noise)
+{
+    for (int n = from; n < to; n++) {
+        float acc = 0;
+        for (int k = 0; k < N && k <= n; k++) {
+            acc += h[k] * x[n - k];
+        }
+        d[n] = acc + noise * rls_rand();
+    }
+}
+
+TEST_CASE("dsps_rls_f32 functionality", "[dsps]")
+{
+    const int N = 8;
+    const float h1[8] = {0.5f, -0.3f, 0.2f, 0.1f, -0.05f, 0.02f, 0.7f, -0.4f};
+    const float h2[8] = {-0.2f, 0.6f, 0.1f, -0.3f, 0.25f, 0, 0.1f, 0.05f};
+    rls_f32_t rls;
+    qrrls_f32_t qr;
+
+    for (int n = 0; n < N_SAMPLES; n++) {
+        x[n] = rls_rand();
+    }
+    // The system changes in the middle of the record, the forgetting factor must track it
+    rls_system(h1, N, 0, N_SAMPLES / 2, 0.001f);
+    rls_system(h2, N, N_SAMPLES / 2, N_SAMPLES, 0.001f);
+
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_rls_init_f32(&rls, w, P, work, N, 0.98f, 1000));
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_qrrls_init_f32(&qr, R, z, work_qr, N, 0.98f, 1000));
+    dsps_rls_f32(&rls, x, d, e, N_SAMPLES / 2);
+    dsps_qrrls_f32(&qr, x, d, e_qr, N_SAMPLES / 2);
+    dsps_qrrls_weights_f32(&qr, w_qr);
+    for (int k = 0; k < N; k++) {
+        TEST_ASSERT_FLOAT_WITHIN(0.005f, h1[k], w[k]);
+        TEST_ASSERT_FLOAT_WITHIN(0.005f, h1[k], w_qr[k]);
+    }
+
+    dsps_rls_f32(&rls, &x[N_SAMPLES / 2], &d[N_SAMPLES / 2], &e[N_SAMPLES / 2], N_SAMPLES / 2);
+    dsps_qrrls_f32(&qr, &x[N_SAMPLES / 2], &d[N_SAMPLES / 2], &e_qr[N_SAMPLES / 2], N_SAMPLES / 2);
+    dsps_qrrls_weights_f32(&qr, w_qr);
+    for (int k = 0; k < N; k++) {
+        TEST_ASSERT_FLOAT_WITHIN(0.005f, h2[k], w[k]);
+        TEST_ASSERT_FLOAT_WITHIN(0.005f, h2[k], w_qr[k]);
+    }
+
+    // Both algorithms compute the same a priori error. It converges within a few times N samples
+    // from the start, and within a few memory lengths 1/(1 - lambda) after the change of the system
+    for (int n = 0; n < N_SAMPLES; n++) {
+        TEST_ASSERT_FLOAT_WITHIN(0.01f * (1 + fabsf(e[n])), e[n], e_qr[n]);
+        if (((n > 4 * N) && (n < N_SAMPLES / 2)) || (n > N_SAMPLES / 2 + 300)) {
+            TEST_ASSERT_FLOAT_WITHIN(0.01f, 0, e[n]);
+        }
+    }
+
+    // The update keeps P exactly symmetric
+    for (int i = 0; i < N; i++) {
+        for (int j = 0; j < N; j++) {
+            TEST_ASSERT_EQUAL(P[i * N + j], P[j * N + i]);
+        }
+    }
+
+    // ARX model of a first order plant, y[n] = a*y[n-1] + b*u[n-1], with an arbitrary regressor
+    const float a = 0.9f;
+    const float b = 0.25f;
+    float y_prev = 0;
+    float u_prev = 0;
+    dsps_rls_init_f32(&rls, w, P, work, 2, 1, 100);
+    dsps_qrrls_init_f32(&qr, R, z, work_qr, 2, 1, 100);
+    for (int n = 0; n < 200; n++) {
+        float u = (n % 40) < 20 ? 1.0f : -1.0f;
+        float y = a * y_prev + b * u_prev;
+        float reg[2] = {y_prev, u_prev};
+        dsps_rls_update_f32(&rls, reg, y);
+        dsps_qrrls_update_f32(&qr, reg, y);
+        y_prev = y;
+        u_prev = u;
+    }
+    dsps_qrrls_weights_f32(&qr, w_qr);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, a, w[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, b, w[1]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, a, w_qr[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, b, w_qr[1]);
+
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_LENGTH, dsps_rls_init_f32(&rls, w, P, work, 0, 0.99f, 100));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_rls_init_f32(&rls, w, P, work, N, 1.5f, 100));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_qrrls_init_f32(&qr, R, z, work_qr, N, 0.99f, 0));
+}
+
+TEST_CASE("dsps_rls_f32 benchmark", "[dsps]")
+{
+    const int lengths[] = {4, 8, 16};
+    const int repeat = 100;
+    rls_f32_t rls;
+    qrrls_f32_t qr;
+    for (int n = 0; n < N_SAMPLES; n++) {
+        x[n] = rls_rand();
+        d[n] = rls_rand();
+    }
+
+    for (int l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        const int N = lengths[l];
+        dsps_rls_init_f32(&rls, w, P, work, N, 0.99f, 100);
+        dsps_qrrls_init_f32(&qr, R, z, work_qr, N, 0.99f, 100);
+
+        unsigned int start_b = dsp_get_cpu_cycle_count();
+        dsps_rls_f32(&rls, x, d, e, repeat);
+        unsigned int end_b = dsp_get_cpu_cycle_count();
+        float cycles_rls = (float)(end_b - start_b) / repeat;
+
+        start_b = dsp_get_cpu_cycle_count();
+        dsps_qrrls_f32(&qr, x, d, e_qr, repeat);
+        end_b = dsp_get_cpu_cycle_count();
+        float cycles_qr = (float)(end_b - start_b) / repeat;
+
+        ESP_LOGI(TAG, "N = %i: RLS %f, QR-RLS %f cycles per sample", N, cycles_rls, cycles_qr);
+
+        float min_exec = N * N;
+        float max_exec = N * N * 200;
+        TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles_rls);
+        TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles_qr);
+    }
+}
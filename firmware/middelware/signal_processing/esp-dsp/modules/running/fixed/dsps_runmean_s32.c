@@ -0,0 +1,49 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "dsps_running.h"
+
+esp_err_t dsps_runmean_init_s32(runmean_s32_t *rm, int32_t *buf, int len)
+{
+    if (buf == NULL) {
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    if (len < 1) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    rm->buf = buf;
+    rm->len = len;
+    rm->pos = 0;
+    rm->count = 0;
+    rm->sum = 0;
+    return ESP_OK;
+}
+
+esp_err_t dsps_runmean_s32(runmean_s32_t *rm, const int32_t *input, int32_t *output, int len)
+{
+    for (int i = 0; i < len; i++) {
+        int32_t x = input[i];
+        if (rm->count < rm->len) {
+            rm->count++;
+        } else {
+            rm->sum -= rm->buf[rm->pos];
+        }
+        rm->sum += x;
+        rm->buf[rm->pos] = x;
+        if (++rm->pos >= rm->len) {
+            rm->pos = 0;
+        }
+
+        // Round half away from zero
+        int64_t half = rm->count / 2;
+        if (rm->sum >= 0) {
+            output[i] = (int32_t)((rm->sum + half) / rm->count);
+        } else {
+            output[i] = (int32_t)((rm->sum - half) / rm->count);
+        }
+    }
+    return ESP_OK;
+}
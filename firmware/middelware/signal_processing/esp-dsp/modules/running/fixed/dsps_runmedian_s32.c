@@ -0,0 +1,139 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "dsps_running.h"
+
+// Heap position 0 is the median, positive positions the min heap (upper half, children of i at 2i, 2i+1)
+// and negative positions the max heap (lower half, children of -i at -2i, -2i-1).
+
+#define MIN_CT(rm) (((rm)->count - 1) / 2)
+#define MAX_CT(rm) ((rm)->count / 2)
+
+static inline int runmedian_less(runmedian_s32_t *rm, int i, int j)
+{
+    return rm->data[rm->heap[i]] < rm->data[rm->heap[j]];
+}
+
+// Swaps heap positions i and j if the value at i is lower than the value at j
+static inline int runmedian_cmp_exch(runmedian_s32_t *rm, int i, int j)
+{
+    if (!runmedian_less(rm, i, j)) {
+        return 0;
+    }
+    int16_t t = rm->heap[i];
+    rm->heap[i] = rm->heap[j];
+    rm->heap[j] = t;
+    rm->pos[rm->heap[i]] = i;
+    rm->pos[rm->heap[j]] = j;
+    return 1;
+}
+
+static void runmedian_min_sort_down(runmedian_s32_t *rm, int i)
+{
+    for (; i <= MIN_CT(rm); i *= 2) {
+        if ((i > 1) && (i < MIN_CT(rm)) && runmedian_less(rm, i + 1, i)) {
+            ++i;
+        }
+        if (!runmedian_cmp_exch(rm, i, i / 2)) {
+            break;
+        }
+    }
+}
+
+static void runmedian_max_sort_down(runmedian_s32_t *rm, int i)
+{
+    for (; i >= -MAX_CT(rm); i *= 2) {
+        if ((i < -1) && (i > -MAX_CT(rm)) && runmedian_less(rm, i, i - 1)) {
+            --i;
+        }
+        if (!runmedian_cmp_exch(rm, i / 2, i)) {
+            break;
+        }
+    }
+}
+
+// Returns 1 if the sample reached the median position
+static int runmedian_min_sort_up(runmedian_s32_t *rm, int i)
+{
+    while ((i > 0) && runmedian_cmp_exch(rm, i, i / 2)) {
+        i /= 2;
+    }
+    return i == 0;
+}
+
+static int runmedian_max_sort_up(runmedian_s32_t *rm, int i)
+{
+    while ((i < 0) && runmedian_cmp_exch(rm, i / 2, i)) {
+        i /= 2;
+    }
+    return i == 0;
+}
+
+esp_err_t dsps_runmedian_init_s32(runmedian_s32_t *rm, int32_t *data, int16_t *index, int len)
+{
+    if ((data == NULL) || (index == NULL)) {
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    if ((len < 1) || (len > INT16_MAX)) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    rm->data = data;
+    rm->pos = index;
+    rm->heap = index + len + len / 2;
+    rm->len = len;
+    rm->idx = 0;
+    rm->count = 0;
+    // Slots are assigned alternately to the max and the min heap, so the window fills around the median
+    for (int i = len - 1; i >= 0; i--) {
+        rm->pos[i] = ((i + 1) / 2) * ((i & 1) ? -1 : 1);
+        rm->heap[rm->pos[i]] = i;
+        rm->data[i] = 0;
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_runmedian_s32(runmedian_s32_t *rm, const int32_t *input, int32_t *output, int len)
+{
+    for (int i = 0; i < len; i++) {
+        int32_t v = input[i];
+        int is_new = rm->count < rm->len;
+        int p = rm->pos[rm->idx];
+        int32_t old = rm->data[rm->idx];
+        rm->data[rm->idx] = v;
+        if (++rm->idx >= rm->len) {
+            rm->idx = 0;
+        }
+        rm->count += is_new;
+
+        if (p > 0) {
+            if (!is_new && (old < v)) {
+                runmedian_min_sort_down(rm, p * 2);
+            } else if (runmedian_min_sort_up(rm, p)) {
+                runmedian_max_sort_down(rm, -1);
+            }
+        } else if (p < 0) {
+            if (!is_new && (v < old)) {
+                runmedian_max_sort_down(rm, p * 2);
+            } else if (runmedian_max_sort_up(rm, p)) {
+                runmedian_min_sort_down(rm, 1);
+            }
+        } else {
+            if (MAX_CT(rm)) {
+                runmedian_max_sort_down(rm, -1);
+            }
+            if (MIN_CT(rm)) {
+                runmedian_min_sort_down(rm, 1);
+            }
+        }
+
+        int32_t med = rm->data[rm->heap[0]];
+        if ((rm->count & 1) == 0) {
+            med = (int32_t)(((int64_t)med + rm->data[rm->heap[-1]]) / 2);
+        }
+        output[i] = med;
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,102 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "dsps_running.h"
+
+esp_err_t dsps_runminmax_init_s32(runminmax_s32_t *rmm, int32_t *buf, int16_t *index, int len)
+{
+    if ((buf == NULL) || (index == NULL)) {
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    if ((len < 1) || (len > INT16_MAX)) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    rmm->buf = buf;
+    rmm->min_q = index;
+    rmm->max_q = index + len;
+    rmm->len = len;
+    rmm->pos = 0;
+    rmm->count = 0;
+    rmm->min_head = 0;
+    rmm->min_size = 0;
+    rmm->max_head = 0;
+    rmm->max_size = 0;
+    return ESP_OK;
+}
+
+esp_err_t dsps_runminmax_s32(runminmax_s32_t *rmm, const int32_t *input, int32_t *min, int32_t *max, int len)
+{
+    const int n = rmm->len;
+    for (int i = 0; i < len; i++) {
+        int32_t x = input[i];
+        int p = rmm->pos;
+
+        // The sample at p leaves the window, drop it if it is at the front of a deque
+        if (rmm->count == n) {
+            if ((rmm->min_size > 0) && (rmm->min_q[rmm->min_head] == p)) {
+                if (++rmm->min_head >= n) {
+                    rmm->min_head = 0;
+                }
+                rmm->min_size--;
+            }
+            if ((rmm->max_size > 0) && (rmm->max_q[rmm->max_head] == p)) {
+                if (++rmm->max_head >= n) {
+                    rmm->max_head = 0;
+                }
+                rmm->max_size--;
+            }
+        } else {
+            rmm->count++;
+        }
+        rmm->buf[p] = x;
+
+        // Drop from the back every sample that can no longer be the extreme
+        while (rmm->min_size > 0) {
+            int back = rmm->min_head + rmm->min_size - 1;
+            if (back >= n) {
+                back -= n;
+            }
+            if (rmm->buf[rmm->min_q[back]] < x) {
+                break;
+            }
+            rmm->min_size--;
+        }
+        int tail = rmm->min_head + rmm->min_size;
+        if (tail >= n) {
+            tail -= n;
+        }
+        rmm->min_q[tail] = p;
+        rmm->min_size++;
+
+        while (rmm->max_size > 0) {
+            int back = rmm->max_head + rmm->max_size - 1;
+            if (back >= n) {
+                back -= n;
+            }
+            if (rmm->buf[rmm->max_q[back]] > x) {
+                break;
+            }
+            rmm->max_size--;
+        }
+        tail = rmm->max_head + rmm->max_size;
+        if (tail >= n) {
+            tail -= n;
+        }
+        rmm->max_q[tail] = p;
+        rmm->max_size++;
+
+        if (++rmm->pos >= n) {
+            rmm->pos = 0;
+        }
+        if (min) {
+            min[i] = rmm->buf[rmm->min_q[rmm->min_head]];
+        }
+        if (max) {
+            max[i] = rmm->buf[rmm->max_q[rmm->max_head]];
+        }
+    }
+    return ESP_OK;
+}
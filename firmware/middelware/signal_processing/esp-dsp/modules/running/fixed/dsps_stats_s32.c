@@ -0,0 +1,326 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <math.h>
+#include <string.h>
+#include "dsps_stats.h"
+
+#define P2_ONE  (1 << 16)
+
+// Two's complement 128-bit arithmetic on 32-bit targets, without __int128
+typedef struct {
+    uint64_t lo;
+    uint64_t hi;
+} stats_u128_t;
+
+static inline void u128_add(stats_u128_t *a, uint64_t lo, uint64_t hi)
+{
+    a->lo += lo;
+    a->hi += hi + (a->lo < lo);
+}
+
+static stats_u128_t u128_mul_u64(uint64_t a, uint64_t b)
+{
+    uint64_t a0 = (uint32_t)a, a1 = a >> 32;
+    uint64_t b0 = (uint32_t)b, b1 = b >> 32;
+    uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    uint64_t mid = (p00 >> 32) + (uint32_t)p01 + (uint32_t)p10;
+    stats_u128_t r = {
+        .lo = (mid << 32) | (uint32_t)p00,
+        .hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32),
+    };
+    return r;
+}
+
+static stats_u128_t u128_mul_s64(int64_t a, int64_t b)
+{
+    uint64_t ua = (a < 0) ? -(uint64_t)a : (uint64_t)a;
+    uint64_t ub = (b < 0) ? -(uint64_t)b : (uint64_t)b;
+    stats_u128_t r = u128_mul_u64(ua, ub);
+    if ((a < 0) != (b < 0)) {
+        r.lo = ~r.lo + 1;
+        r.hi = ~r.hi + (r.lo == 0);
+    }
+    return r;
+}
+
+static inline double u128_to_double(stats_u128_t a)
+{
+    return (double)a.hi * 18446744073709551616.0 + (double)a.lo;
+}
+
+static void stats_clear_s32(stats_s32_t *st)
+{
+    st->count = 0;
+    st->ref = 0;
+    st->sum = 0;
+    st->sum2_lo = 0;
+    st->sum2_hi = 0;
+    st->min = 0;
+    st->max = 0;
+    for (int i = 0; i < st->n_quantiles; i++) {
+        const float p = st->p[i];
+        stats_p2_s32_t *m = &st->p2[i];
+        for (int j = 0; j < 5; j++) {
+            m->q[j] = 0;
+            m->n[j] = j;
+        }
+        m->np[0] = 0;
+        m->np[1] = (int64_t)lroundf(2 * p * P2_ONE);
+        m->np[2] = (int64_t)lroundf(4 * p * P2_ONE);
+        m->np[3] = (int64_t)lroundf((2 + 2 * p) * P2_ONE);
+        m->np[4] = 4 * P2_ONE;
+        m->dn[0] = 0;
+        m->dn[1] = (int32_t)lroundf(p / 2 * P2_ONE);
+        m->dn[2] = (int32_t)lroundf(p * P2_ONE);
+        m->dn[3] = (int32_t)lroundf((1 + p) / 2 * P2_ONE);
+        m->dn[4] = P2_ONE;
+    }
+}
+
+esp_err_t dsps_stats_init_s32(stats_s32_t *st, const float *quantiles, int n_quantiles)
+{
+    if ((quantiles == NULL) && (n_quantiles != 0)) {
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    if ((n_quantiles < 0) || (n_quantiles > DSPS_STATS_MAX_QUANTILES)) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    for (int i = 0; i < n_quantiles; i++) {
+        if (!((quantiles[i] > 0) && (quantiles[i] < 1))) {
+            return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+        }
+        st->p[i] = quantiles[i];
+    }
+    st->n_quantiles = n_quantiles;
+    st->seq = 0;
+    st->reset_req = 0;
+    stats_clear_s32(st);
+    return ESP_OK;
+}
+
+// Inserts one of the first five samples, q[0..count-1] is kept sorted
+static void p2_insert_s32(stats_p2_s32_t *m, int32_t x, uint32_t count)
+{
+    int j = count;
+    for (; (j > 0) && (m->q[j - 1] > x); j--) {
+        m->q[j] = m->q[j - 1];
+    }
+    m->q[j] = x;
+}
+
+// Rounded division, b > 0
+static inline int64_t p2_div_s64(int64_t a, int64_t b)
+{
+    return (a >= 0) ? (a + b / 2) / b : -((-a + b / 2) / b);
+}
+
+static void p2_update_s32(stats_p2_s32_t *m, int32_t x)
+{
+    int k;
+    if (x < m->q[0]) {
+        m->q[0] = x;
+        k = 0;
+    } else if (x >= m->q[4]) {
+        m->q[4] = x;
+        k = 3;
+    } else {
+        for (k = 0; x >= m->q[k + 1]; k++) {
+        }
+    }
+    for (int i = k + 1; i < 5; i++) {
+        m->n[i]++;
+    }
+    for (int i = 0; i < 5; i++) {
+        m->np[i] += m->dn[i];
+    }
+    for (int i = 1; i < 4; i++) {
+        int64_t d = m->np[i] - ((int64_t)m->n[i] << 16);
+        int32_t dr = m->n[i + 1] - m->n[i];
+        int32_t dl = m->n[i] - m->n[i - 1];
+        int s;
+        if ((d >= P2_ONE) && (dr > 1)) {
+            s = 1;
+        } else if ((d <= -P2_ONE) && (dl > 1)) {
+            s = -1;
+        } else {
+            continue;
+        }
+        // Piecewise parabolic prediction, linear when it would leave the neighbours' interval.
+        // Heights differ by less than 2^31, so every product fits in 63 bits.
+        int64_t qr = (int64_t)m->q[i + 1] - m->q[i];
+        int64_t ql = (int64_t)m->q[i] - m->q[i - 1];
+        int64_t t = p2_div_s64((dl + s) * qr, dr) + p2_div_s64((dr - s) * ql, dl);
+        int64_t qp = m->q[i] + s * p2_div_s64(t, (int64_t)dl + dr);
+        if ((m->q[i - 1] < qp) && (qp < m->q[i + 1])) {
+            m->q[i] = (int32_t)qp;
+        } else if (s > 0) {
+            m->q[i] += (int32_t)p2_div_s64(qr, dr);
+        } else {
+            m->q[i] -= (int32_t)p2_div_s64(ql, dl);
+        }
+        m->n[i] += s;
+    }
+}
+
+esp_err_t dsps_stats_s32(stats_s32_t *st, const int32_t *input, int len)
+{
+    uint32_t seq = st->seq;
+    __atomic_store_n(&st->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    if (st->reset_req) {
+        stats_clear_s32(st);
+        st->reset_req = 0;
+    }
+    uint32_t count = st->count;
+    int32_t min = st->min;
+    int32_t max = st->max;
+    int64_t sum = st->sum;
+    stats_u128_t sum2 = { st->sum2_lo, st->sum2_hi };
+    if ((count == 0) && (len > 0)) {
+        st->ref = input[0];
+        min = input[0];
+        max = input[0];
+    }
+    const int32_t ref = st->ref;
+    for (int i = 0; i < len; i++) {
+        const int32_t x = input[i];
+        if (x < min) {
+            min = x;
+        } else if (x > max) {
+            max = x;
+        }
+        int64_t d = (int64_t)x - ref;
+        uint64_t d2 = (uint64_t)(d * d);
+        sum += d;
+        u128_add(&sum2, d2, 0);
+        for (int j = 0; j < st->n_quantiles; j++) {
+            if (count < 5) {
+                p2_insert_s32(&st->p2[j], x, count);
+            } else {
+                p2_update_s32(&st->p2[j], x);
+            }
+        }
+        count++;
+    }
+    st->count = count;
+    st->min = min;
+    st->max = max;
+    st->sum = sum;
+    st->sum2_lo = sum2.lo;
+    st->sum2_hi = sum2.hi;
+
+    __atomic_store_n(&st->seq, seq + 2, __ATOMIC_RELEASE);
+    return ESP_OK;
+}
+
+esp_err_t dsps_stats_merge_s32(stats_s32_t *dst, const stats_s32_t *src)
+{
+    if (src->count == 0) {
+        return ESP_OK;
+    }
+    uint32_t seq = dst->seq;
+    __atomic_store_n(&dst->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    if (dst->count == 0) {
+        dst->count = src->count;
+        dst->ref = src->ref;
+        dst->sum = src->sum;
+        dst->sum2_lo = src->sum2_lo;
+        dst->sum2_hi = src->sum2_hi;
+        dst->min = src->min;
+        dst->max = src->max;
+        // An empty destination takes the markers of the same quantiles as they are
+        for (int i = 0; i < dst->n_quantiles; i++) {
+            for (int j = 0; j < src->n_quantiles; j++) {
+                if (src->p[j] == dst->p[i]) {
+                    dst->p2[i] = src->p2[j];
+                }
+            }
+        }
+    } else {
+        // Rebase src on the reference of dst: sum(d + D) = S + n*D, sum((d + D)^2) = Q + 2*D*S + n*D^2
+        int64_t D = (int64_t)src->ref - dst->ref;
+        stats_u128_t sum2 = { dst->sum2_lo, dst->sum2_hi };
+        stats_u128_t t = u128_mul_s64(2 * D, src->sum);
+        u128_add(&sum2, src->sum2_lo, src->sum2_hi);
+        u128_add(&sum2, t.lo, t.hi);
+        t = u128_mul_u64(src->count, (uint64_t)(D * D));
+        u128_add(&sum2, t.lo, t.hi);
+        dst->sum2_lo = sum2.lo;
+        dst->sum2_hi = sum2.hi;
+        dst->sum += src->sum + (int64_t)src->count * D;
+        dst->count += src->count;
+        if (src->min < dst->min) {
+            dst->min = src->min;
+        }
+        if (src->max > dst->max) {
+            dst->max = src->max;
+        }
+    }
+
+    __atomic_store_n(&dst->seq, seq + 2, __ATOMIC_RELEASE);
+    return ESP_OK;
+}
+
+static int32_t p2_result_s32(const stats_p2_s32_t *m, float p, uint32_t count)
+{
+    if (count >= 5) {
+        return m->q[2];
+    }
+    return m->q[(int)(p * (count - 1) + 0.5f)];
+}
+
+esp_err_t dsps_stats_snapshot_s32(const stats_s32_t *st, stats_summary_s32_t *out)
+{
+    stats_s32_t copy;
+    int retry = 0;
+    for (;;) {
+        uint32_t seq = __atomic_load_n(&st->seq, __ATOMIC_ACQUIRE);
+        if ((seq & 1) == 0) {
+            memcpy(&copy, (const void *)st, sizeof(copy));
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&st->seq, __ATOMIC_RELAXED) == seq) {
+                break;
+            }
+        }
+        if (++retry >= DSPS_STATS_SNAPSHOT_RETRIES) {
+            return ESP_ERR_INVALID_STATE;
+        }
+    }
+    if (copy.reset_req) {
+        copy.count = 0;
+    }
+    memset(out, 0, sizeof(*out));
+    out->count = copy.count;
+    if (copy.count == 0) {
+        return ESP_OK;
+    }
+    out->mean = (float)(copy.ref + (double)copy.sum / copy.count);
+    if (copy.count > 1) {
+        // n*Q - S^2 is exact, so the variance does not suffer from cancellation
+        stats_u128_t nq = u128_mul_u64(copy.count, copy.sum2_lo);
+        nq.hi += copy.count * copy.sum2_hi;
+        stats_u128_t s2 = u128_mul_s64(copy.sum, copy.sum);
+        u128_add(&nq, ~s2.lo + 1, ~s2.hi + (s2.lo == 0));
+        double var = u128_to_double(nq) / ((double)copy.count * (copy.count - 1));
+        out->std = (float)sqrt(var);
+    }
+    out->min = copy.min;
+    out->max = copy.max;
+    for (int i = 0; i < copy.n_quantiles; i++) {
+        out->quantile[i] = p2_result_s32(&copy.p2[i], copy.p[i], copy.count);
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_stats_reset_s32(stats_s32_t *st)
+{
+    __atomic_store_n(&st->reset_req, 1, __ATOMIC_RELEASE);
+    return ESP_OK;
+}
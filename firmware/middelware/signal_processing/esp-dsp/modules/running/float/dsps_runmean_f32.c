@@ -0,0 +1,55 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include "dsps_running.h"
+
+esp_err_t dsps_runmean_init_f32(runmean_f32_t *rm, float *buf, int len)
+{
+    if (buf == NULL) {
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    if (len < 1) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    rm->buf = buf;
+    rm->len = len;
+    rm->pos = 0;
+    rm->count = 0;
+    rm->sum = 0;
+    rm->comp = 0;
+    return ESP_OK;
+}
+
+esp_err_t dsps_runmean_f32(runmean_f32_t *rm, const float *input, float *output, int len)
+{
+    const float inv_len = 1.0f / rm->len;
+    for (int i = 0; i < len; i++) {
+        float x = input[i];
+        float delta = x;
+        if (rm->count < rm->len) {
+            rm->count++;
+        } else {
+            delta -= rm->buf[rm->pos];
+        }
+        rm->buf[rm->pos] = x;
+        if (++rm->pos >= rm->len) {
+            rm->pos = 0;
+        }
+
+        // Kahan summation of the difference between the new and the leaving sample
+        float y = delta - rm->comp;
+        float t = rm->sum + y;
+        rm->comp = (t - rm->sum) - y;
+        rm->sum = t;
+
+        if (rm->count == rm->len) {
+            output[i] = rm->sum * inv_len;
+        } else {
+            output[i] = rm->sum / rm->count;
+        }
+    }
+    return ESP_OK;
+}
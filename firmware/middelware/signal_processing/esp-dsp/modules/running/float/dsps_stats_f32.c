@@ -0,0 +1,251 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <math.h>
+#include <string.h>
+#include "dsps_stats.h"
+
+#define P2_ONE  (1 << 16)
+
+static void stats_clear_f32(stats_f32_t *st)
+{
+    st->count = 0;
+    st->mean = 0;
+    st->m2 = 0;
+    st->min = 0;
+    st->max = 0;
+    for (int i = 0; i < st->n_quantiles; i++) {
+        const float p = st->p[i];
+        stats_p2_f32_t *m = &st->p2[i];
+        for (int j = 0; j < 5; j++) {
+            m->q[j] = 0;
+            m->n[j] = j;
+        }
+        m->np[0] = 0;
+        m->np[1] = (int64_t)lroundf(2 * p * P2_ONE);
+        m->np[2] = (int64_t)lroundf(4 * p * P2_ONE);
+        m->np[3] = (int64_t)lroundf((2 + 2 * p) * P2_ONE);
+        m->np[4] = 4 * P2_ONE;
+        m->dn[0] = 0;
+        m->dn[1] = (int32_t)lroundf(p / 2 * P2_ONE);
+        m->dn[2] = (int32_t)lroundf(p * P2_ONE);
+        m->dn[3] = (int32_t)lroundf((1 + p) / 2 * P2_ONE);
+        m->dn[4] = P2_ONE;
+    }
+}
+
+esp_err_t dsps_stats_init_f32(stats_f32_t *st, const float *quantiles, int n_quantiles)
+{
+    if ((quantiles == NULL) && (n_quantiles != 0)) {
+        return ESP_ERR_DSP_INVALID_PARAM;
+    }
+    if ((n_quantiles < 0) || (n_quantiles > DSPS_STATS_MAX_QUANTILES)) {
+        return ESP_ERR_DSP_INVALID_LENGTH;
+    }
+    for (int i = 0; i < n_quantiles; i++) {
+        if (!((quantiles[i] > 0) && (quantiles[i] < 1))) {
+            return ESP_ERR_DSP_PARAM_OUTOFRANGE;
+        }
+        st->p[i] = quantiles[i];
+    }
+    st->n_quantiles = n_quantiles;
+    st->seq = 0;
+    st->reset_req = 0;
+    stats_clear_f32(st);
+    return ESP_OK;
+}
+
+// Inserts one of the first five samples, q[0..count-1] is kept sorted
+static void p2_insert_f32(stats_p2_f32_t *m, float x, uint32_t count)
+{
+    int j = count;
+    for (; (j > 0) && (m->q[j - 1] > x); j--) {
+        m->q[j] = m->q[j - 1];
+    }
+    m->q[j] = x;
+}
+
+static void p2_update_f32(stats_p2_f32_t *m, float x)
+{
+    int k;
+    if (x < m->q[0]) {
+        m->q[0] = x;
+        k = 0;
+    } else if (x >= m->q[4]) {
+        m->q[4] = x;
+        k = 3;
+    } else {
+        for (k = 0; x >= m->q[k + 1]; k++) {
+        }
+    }
+    for (int i = k + 1; i < 5; i++) {
+        m->n[i]++;
+    }
+    for (int i = 0; i < 5; i++) {
+        m->np[i] += m->dn[i];
+    }
+    for (int i = 1; i < 4; i++) {
+        int64_t d = m->np[i] - ((int64_t)m->n[i] << 16);
+        int32_t dr = m->n[i + 1] - m->n[i];
+        int32_t dl = m->n[i] - m->n[i - 1];
+        int s;
+        if ((d >= P2_ONE) && (dr > 1)) {
+            s = 1;
+        } else if ((d <= -P2_ONE) && (dl > 1)) {
+            s = -1;
+        } else {
+            continue;
+        }
+        // Piecewise parabolic prediction, linear when it would leave the neighbours' interval
+        float qr = m->q[i + 1] - m->q[i];
+        float ql = m->q[i] - m->q[i - 1];
+        float qp = m->q[i] + (float)s / (dl + dr) * ((dl + s) * qr / dr + (dr - s) * ql / dl);
+        if ((m->q[i - 1] < qp) && (qp < m->q[i + 1])) {
+            m->q[i] = qp;
+        } else if (s > 0) {
+            m->q[i] += qr / dr;
+        } else {
+            m->q[i] -= ql / dl;
+        }
+        m->n[i] += s;
+    }
+}
+
+esp_err_t dsps_stats_f32(stats_f32_t *st, const float *input, int len)
+{
+    uint32_t seq = st->seq;
+    __atomic_store_n(&st->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    if (st->reset_req) {
+        stats_clear_f32(st);
+        st->reset_req = 0;
+    }
+    uint32_t count = st->count;
+    float mean = st->mean;
+    float m2 = st->m2;
+    float min = st->min;
+    float max = st->max;
+    for (int i = 0; i < len; i++) {
+        const float x = input[i];
+        if (count == 0) {
+            min = x;
+            max = x;
+        } else if (x < min) {
+            min = x;
+        } else if (x > max) {
+            max = x;
+        }
+        float delta = x - mean;
+        mean += delta / (float)(count + 1);
+        m2 += delta * (x - mean);
+        for (int j = 0; j < st->n_quantiles; j++) {
+            if (count < 5) {
+                p2_insert_f32(&st->p2[j], x, count);
+            } else {
+                p2_update_f32(&st->p2[j], x);
+            }
+        }
+        count++;
+    }
+    st->count = count;
+    st->mean = mean;
+    st->m2 = m2;
+    st->min = min;
+    st->max = max;
+
+    __atomic_store_n(&st->seq, seq + 2, __ATOMIC_RELEASE);
+    return ESP_OK;
+}
+
+esp_err_t dsps_stats_merge_f32(stats_f32_t *dst, const stats_f32_t *src)
+{
+    if (src->count == 0) {
+        return ESP_OK;
+    }
+    uint32_t seq = dst->seq;
+    __atomic_store_n(&dst->seq, seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    if (dst->count == 0) {
+        dst->count = src->count;
+        dst->mean = src->mean;
+        dst->m2 = src->m2;
+        dst->min = src->min;
+        dst->max = src->max;
+        // An empty destination takes the markers of the same quantiles as they are
+        for (int i = 0; i < dst->n_quantiles; i++) {
+            for (int j = 0; j < src->n_quantiles; j++) {
+                if (src->p[j] == dst->p[i]) {
+                    dst->p2[i] = src->p2[j];
+                }
+            }
+        }
+    } else {
+        float na = (float)dst->count;
+        float nb = (float)src->count;
+        float n = na + nb;
+        float delta = src->mean - dst->mean;
+        dst->mean += delta * (nb / n);
+        dst->m2 += src->m2 + delta * delta * (na * nb / n);
+        dst->count += src->count;
+        dst->min = fminf(dst->min, src->min);
+        dst->max = fmaxf(dst->max, src->max);
+    }
+
+    __atomic_store_n(&dst->seq, seq + 2, __ATOMIC_RELEASE);
+    return ESP_OK;
+}
+
+// Quantile of the sorted first samples, nearest rank
+static float p2_result_f32(const stats_p2_f32_t *m, float p, uint32_t count)
+{
+    if (count >= 5) {
+        return m->q[2];
+    }
+    return m->q[(int)(p * (count - 1) + 0.5f)];
+}
+
+esp_err_t dsps_stats_snapshot_f32(const stats_f32_t *st, stats_summary_f32_t *out)
+{
+    stats_f32_t copy;
+    int retry = 0;
+    for (;;) {
+        uint32_t seq = __atomic_load_n(&st->seq, __ATOMIC_ACQUIRE);
+        if ((seq & 1) == 0) {
+            memcpy(&copy, (const void *)st, sizeof(copy));
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&st->seq, __ATOMIC_RELAXED) == seq) {
+                break;
+            }
+        }
+        if (++retry >= DSPS_STATS_SNAPSHOT_RETRIES) {
+            return ESP_ERR_INVALID_STATE;
+        }
+    }
+    if (copy.reset_req) {
+        copy.count = 0;
+    }
+    memset(out, 0, sizeof(*out));
+    out->count = copy.count;
+    if (copy.count == 0) {
+        return ESP_OK;
+    }
+    out->mean = copy.mean;
+    out->std = (copy.count > 1) ? sqrtf(fmaxf(copy.m2, 0) / (copy.count - 1)) : 0;
+    out->min = copy.min;
+    out->max = copy.max;
+    for (int i = 0; i < copy.n_quantiles; i++) {
+        out->quantile[i] = p2_result_f32(&copy.p2[i], copy.p[i], copy.count);
+    }
+    return ESP_OK;
+}
+
+esp_err_t dsps_stats_reset_f32(stats_f32_t *st)
+{
+    __atomic_store_n(&st->reset_req, 1, __ATOMIC_RELEASE);
+    return ESP_OK;
+}
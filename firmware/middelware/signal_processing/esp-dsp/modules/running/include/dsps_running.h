@@ -0,0 +1,252 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _dsps_running_H_
+#define _dsps_running_H_
+
+#include "dsp_err.h"
+#include "dsp_common.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Streaming window filters over the last len samples.
+ *
+ * All the filters work on caller provided storage and keep their state between calls, so they can
+ * be fed one sample at a time right after a sensor driver (HX711, HC-SR04, ADC) or with whole blocks.
+ * Until the window is filled, the statistics are computed over the samples received so far.
+ * The output array could be the same as the input array.
+ */
+
+/**
+ * @brief Data struct of f32 running mean
+ *
+ * All fields of this structure are initialized by the dsps_runmean_init_f32(...) function.
+ */
+typedef struct runmean_f32_s {
+    float  *buf;        /*!< Pointer to the window buffer.*/
+    int     len;        /*!< Window length.*/
+    int     pos;        /*!< Position of the oldest sample in the window.*/
+    int     count;      /*!< Number of valid samples in the window.*/
+    float   sum;        /*!< Running sum of the window.*/
+    float   comp;       /*!< Compensation term of the running sum (Kahan summation).*/
+} runmean_f32_t;
+
+/**
+ * @brief Data struct of s32 running mean
+ *
+ * All fields of this structure are initialized by the dsps_runmean_init_s32(...) function.
+ */
+typedef struct runmean_s32_s {
+    int32_t    *buf;    /*!< Pointer to the window buffer.*/
+    int         len;    /*!< Window length.*/
+    int         pos;    /*!< Position of the oldest sample in the window.*/
+    int         count;  /*!< Number of valid samples in the window.*/
+    int64_t     sum;    /*!< Running sum of the window, exact.*/
+} runmean_s32_t;
+
+/**
+ * @brief Data struct of f32 running median
+ *
+ * Two indexed heaps share one array: the max heap holds the lower half of the window, the min heap
+ * the upper half, and the median sits between them. When a sample leaves the window it is replaced
+ * in place by the new one, which is then sifted, so every update costs O(log len).
+ * All fields of this structure are initialized by the dsps_runmedian_init_f32(...) function.
+ */
+typedef struct runmedian_f32_s {
+    float      *data;   /*!< Pointer to the window buffer.*/
+    int16_t    *pos;    /*!< Heap position of every window slot.*/
+    int16_t    *heap;   /*!< Window slot of every heap position, centered on the median.*/
+    int         len;    /*!< Window length.*/
+    int         idx;    /*!< Position of the oldest sample in the window.*/
+    int         count;  /*!< Number of valid samples in the window.*/
+} runmedian_f32_t;
+
+/**
+ * @brief Data struct of s32 running median
+ *
+ * See runmedian_f32_t.
+ * All fields of this structure are initialized by the dsps_runmedian_init_s32(...) function.
+ */
+typedef struct runmedian_s32_s {
+    int32_t    *data;   /*!< Pointer to the window buffer.*/
+    int16_t    *pos;    /*!< Heap position of every window slot.*/
+    int16_t    *heap;   /*!< Window slot of every heap position, centered on the median.*/
+    int         len;    /*!< Window length.*/
+    int         idx;    /*!< Position of the oldest sample in the window.*/
+    int         count;  /*!< Number of valid samples in the window.*/
+} runmedian_s32_t;
+
+/**
+ * @brief Data struct of f32 running minimum and maximum
+ *
+ * Two monotonic deques of window positions are kept, so every update is O(1) amortized.
+ * All fields of this structure are initialized by the dsps_runminmax_init_f32(...) function.
+ */
+typedef struct runminmax_f32_s {
+    float      *buf;        /*!< Pointer to the window buffer.*/
+    int16_t    *min_q;      /*!< Deque of window positions with increasing values.*/
+    int16_t    *max_q;      /*!< Deque of window positions with decreasing values.*/
+    int         len;        /*!< Window length.*/
+    int         pos;        /*!< Position of the oldest sample in the window.*/
+    int         count;      /*!< Number of valid samples in the window.*/
+    int         min_head;   /*!< Head of the minimum deque.*/
+    int         min_size;   /*!< Number of elements in the minimum deque.*/
+    int         max_head;   /*!< Head of the maximum deque.*/
+    int         max_size;   /*!< Number of elements in the maximum deque.*/
+} runminmax_f32_t;
+
+/**
+ * @brief Data struct of s32 running minimum and maximum
+ *
+ * See runminmax_f32_t.
+ * All fields of this structure are initialized by the dsps_runminmax_init_s32(...) function.
+ */
+typedef struct runminmax_s32_s {
+    int32_t    *buf;        /*!< Pointer to the window buffer.*/
+    int16_t    *min_q;      /*!< Deque of window positions with increasing values.*/
+    int16_t    *max_q;      /*!< Deque of window positions with decreasing values.*/
+    int         len;        /*!< Window length.*/
+    int         pos;        /*!< Position of the oldest sample in the window.*/
+    int         count;      /*!< Number of valid samples in the window.*/
+    int         min_head;   /*!< Head of the minimum deque.*/
+    int         min_size;   /*!< Number of elements in the minimum deque.*/
+    int         max_head;   /*!< Head of the maximum deque.*/
+    int         max_size;   /*!< Number of elements in the maximum deque.*/
+} runminmax_s32_t;
+
+/**@{*/
+/**
+ * @brief   initialize structure for running mean
+ *
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param rm: pointer to running mean structure, that must be preallocated
+ * @param buf: array for the window. Must be length len
+ * @param len: window length, must be higher than 0
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_PARAM if buf is NULL
+ *      - ESP_ERR_DSP_INVALID_LENGTH if len is lower than 1
+ */
+esp_err_t dsps_runmean_init_f32(runmean_f32_t *rm, float *buf, int len);
+esp_err_t dsps_runmean_init_s32(runmean_s32_t *rm, int32_t *buf, int len);
+/**@}*/
+
+/**@{*/
+/**
+ * @brief   running mean
+ *
+ * Function pushes len samples into the window and stores the mean of the window after every sample.
+ * Cost is O(1) per sample: one sample enters and one leaves the running sum.
+ * The float version uses compensated summation, so the sum does not drift over long sessions.
+ * The integer version keeps an exact 64 bit sum and rounds the result to the nearest integer.
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param rm: pointer to running mean structure, that must be initialized before
+ * @param[in] input: input array
+ * @param[out] output: output array
+ * @param len: length of input and output arrays
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dsps_runmean_f32(runmean_f32_t *rm, const float *input, float *output, int len);
+esp_err_t dsps_runmean_s32(runmean_s32_t *rm, const int32_t *input, int32_t *output, int len);
+/**@}*/
+
+/**@{*/
+/**
+ * @brief   initialize structure for running median
+ *
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param rm: pointer to running median structure, that must be preallocated
+ * @param data: array for the window. Must be length len
+ * @param index: array for the heap indexes. Must be length 2*len
+ * @param len: window length [1..INT16_MAX]
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_PARAM if data or index is NULL
+ *      - ESP_ERR_DSP_INVALID_LENGTH if len is out of range
+ */
+esp_err_t dsps_runmedian_init_f32(runmedian_f32_t *rm, float *data, int16_t *index, int len);
+esp_err_t dsps_runmedian_init_s32(runmedian_s32_t *rm, int32_t *data, int16_t *index, int len);
+/**@}*/
+
+/**@{*/
+/**
+ * @brief   running median
+ *
+ * Function pushes len samples into the window and stores the median of the window after every sample.
+ * For an even number of samples the mean of the two central values is returned
+ * (rounded toward zero for the integer version).
+ * Cost is O(log len) per sample.
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param rm: pointer to running median structure, that must be initialized before
+ * @param[in] input: input array
+ * @param[out] output: output array
+ * @param len: length of input and output arrays
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dsps_runmedian_f32(runmedian_f32_t *rm, const float *input, float *output, int len);
+esp_err_t dsps_runmedian_s32(runmedian_s32_t *rm, const int32_t *input, int32_t *output, int len);
+/**@}*/
+
+/**@{*/
+/**
+ * @brief   initialize structure for running minimum and maximum
+ *
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param rmm: pointer to running min/max structure, that must be preallocated
+ * @param buf: array for the window. Must be length len
+ * @param index: array for the two deques. Must be length 2*len
+ * @param len: window length [1..INT16_MAX]
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_PARAM if buf or index is NULL
+ *      - ESP_ERR_DSP_INVALID_LENGTH if len is out of range
+ */
+esp_err_t dsps_runminmax_init_f32(runminmax_f32_t *rmm, float *buf, int16_t *index, int len);
+esp_err_t dsps_runminmax_init_s32(runminmax_s32_t *rmm, int32_t *buf, int16_t *index, int len);
+/**@}*/
+
+/**@{*/
+/**
+ * @brief   running minimum and maximum
+ *
+ * Function pushes len samples into the window and stores the minimum and maximum of the window after every sample.
+ * Cost is O(1) amortized per sample.
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param rmm: pointer to running min/max structure, that must be initialized before
+ * @param[in] input: input array
+ * @param[out] min: output array for the minimum, could be NULL
+ * @param[out] max: output array for the maximum, could be NULL
+ * @param len: length of input and output arrays
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dsps_runminmax_f32(runminmax_f32_t *rmm, const float *input, float *min, float *max, int len);
+esp_err_t dsps_runminmax_s32(runminmax_s32_t *rmm, const int32_t *input, int32_t *min, int32_t *max, int len);
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _dsps_running_H_
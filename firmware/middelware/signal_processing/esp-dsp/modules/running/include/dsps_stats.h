@@ -0,0 +1,221 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#ifndef _dsps_stats_H_
+#define _dsps_stats_H_
+
+#include "dsp_err.h"
+#include "dsp_common.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*
+ * Constant memory statistics over a whole session: count, mean, standard deviation, minimum, maximum
+ * and up to DSPS_STATS_MAX_QUANTILES quantiles (for example median and p95), for ADC, HX711 or HC-SR04
+ * streams of any length. Nothing is stored per sample.
+ *
+ * Quantiles use the P^2 algorithm (Jain and Chlamtac): five markers per quantile are moved with a
+ * piecewise parabolic prediction, and the desired marker positions are kept in Q16 so they do not
+ * lose precision on long sessions. The first five samples give exact quantiles.
+ *
+ * One task pushes samples; any other task may call the snapshot and reset functions at any time.
+ * Every push is published with a sequence counter (odd while the producer updates the state), and
+ * the snapshot copies the state until it reads the same even counter before and after the copy.
+ * A reset is only requested by the caller and applied by the producer before its next sample,
+ * so it never races with an update.
+ */
+
+#define DSPS_STATS_MAX_QUANTILES    4   /*!< Maximum number of quantiles per channel*/
+#define DSPS_STATS_SNAPSHOT_RETRIES 16  /*!< Copies attempted by a snapshot while the producer updates*/
+
+/**
+ * @brief P^2 quantile estimator, f32 marker heights
+ */
+typedef struct stats_p2_f32_s {
+    float       q[5];       /*!< Marker heights, the sorted first samples until there are five.*/
+    int32_t     n[5];       /*!< Marker positions.*/
+    int64_t     np[5];      /*!< Desired marker positions, Q16.*/
+    int32_t     dn[5];      /*!< Increments of the desired positions, Q16.*/
+} stats_p2_f32_t;
+
+/**
+ * @brief P^2 quantile estimator, s32 marker heights
+ */
+typedef struct stats_p2_s32_s {
+    int32_t     q[5];       /*!< Marker heights, the sorted first samples until there are five.*/
+    int32_t     n[5];       /*!< Marker positions.*/
+    int64_t     np[5];      /*!< Desired marker positions, Q16.*/
+    int32_t     dn[5];      /*!< Increments of the desired positions, Q16.*/
+} stats_p2_s32_t;
+
+/**
+ * @brief Data struct of f32 session statistics
+ *
+ * Mean and variance use the Welford update: mean += (x - mean)/n, m2 += (x - mean_old)*(x - mean_new).
+ * All fields of this structure are initialized by the dsps_stats_init_f32(...) function.
+ */
+typedef struct stats_f32_s {
+    uint32_t        count;      /*!< Number of samples.*/
+    float           mean;       /*!< Running mean.*/
+    float           m2;         /*!< Sum of the squared deviations from the mean.*/
+    float           min;        /*!< Minimum.*/
+    float           max;        /*!< Maximum.*/
+    float           p[DSPS_STATS_MAX_QUANTILES];        /*!< Requested quantiles, 0..1.*/
+    stats_p2_f32_t  p2[DSPS_STATS_MAX_QUANTILES];       /*!< Quantile estimators.*/
+    int             n_quantiles;    /*!< Number of quantiles.*/
+    volatile uint32_t   seq;        /*!< Update sequence, odd while the producer updates the state.*/
+    volatile uint32_t   reset_req;  /*!< Reset requested by dsps_stats_reset_f32.*/
+} stats_f32_t;
+
+/**
+ * @brief Data struct of s32 session statistics
+ *
+ * Integer only per sample: the sums of the deviations d = x - first sample are exact, the sum of d^2
+ * is kept in 128 bits. Mean and variance are computed from them by the snapshot.
+ * All fields of this structure are initialized by the dsps_stats_init_s32(...) function.
+ */
+typedef struct stats_s32_s {
+    uint32_t        count;      /*!< Number of samples.*/
+    int32_t         ref;        /*!< First sample, reference of the deviations.*/
+    int64_t         sum;        /*!< Sum of d.*/
+    uint64_t        sum2_lo;    /*!< Sum of d^2, low 64 bits.*/
+    uint64_t        sum2_hi;    /*!< Sum of d^2, high 64 bits.*/
+    int32_t         min;        /*!< Minimum.*/
+    int32_t         max;        /*!< Maximum.*/
+    float           p[DSPS_STATS_MAX_QUANTILES];        /*!< Requested quantiles, 0..1.*/
+    stats_p2_s32_t  p2[DSPS_STATS_MAX_QUANTILES];       /*!< Quantile estimators.*/
+    int             n_quantiles;    /*!< Number of quantiles.*/
+    volatile uint32_t   seq;        /*!< Update sequence, odd while the producer updates the state.*/
+    volatile uint32_t   reset_req;  /*!< Reset requested by dsps_stats_reset_s32.*/
+} stats_s32_t;
+
+/**
+ * @brief Statistics returned by dsps_stats_snapshot_f32
+ */
+typedef struct stats_summary_f32_s {
+    uint32_t    count;      /*!< Number of samples.*/
+    float       mean;       /*!< Mean.*/
+    float       std;        /*!< Sample standard deviation, 0 for less than two samples.*/
+    float       min;        /*!< Minimum.*/
+    float       max;        /*!< Maximum.*/
+    float       quantile[DSPS_STATS_MAX_QUANTILES]; /*!< Estimated quantiles, in the order of init.*/
+} stats_summary_f32_t;
+
+/**
+ * @brief Statistics returned by dsps_stats_snapshot_s32
+ */
+typedef struct stats_summary_s32_s {
+    uint32_t    count;      /*!< Number of samples.*/
+    float       mean;       /*!< Mean.*/
+    float       std;        /*!< Sample standard deviation, 0 for less than two samples.*/
+    int32_t     min;        /*!< Minimum.*/
+    int32_t     max;        /*!< Maximum.*/
+    int32_t     quantile[DSPS_STATS_MAX_QUANTILES]; /*!< Estimated quantiles, in the order of init.*/
+} stats_summary_s32_t;
+
+/**@{*/
+/**
+ * @brief   initialize session statistics
+ *
+ * The implementation use ANSI C and could be compiled and run on any platform
+ *
+ * @param st: pointer to statistics structure, that must be preallocated
+ * @param quantiles: requested quantiles in (0..1), for example {0.5, 0.95}. Could be NULL if n_quantiles is 0
+ * @param n_quantiles: number of quantiles [0..DSPS_STATS_MAX_QUANTILES]
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_DSP_INVALID_PARAM if quantiles is NULL and n_quantiles is not 0
+ *      - ESP_ERR_DSP_INVALID_LENGTH if n_quantiles is out of range
+ *      - ESP_ERR_DSP_PARAM_OUTOFRANGE if a quantile is not in (0..1)
+ */
+esp_err_t dsps_stats_init_f32(stats_f32_t *st, const float *quantiles, int n_quantiles);
+esp_err_t dsps_stats_init_s32(stats_s32_t *st, const float *quantiles, int n_quantiles);
+/**@}*/
+
+/**@{*/
+/**
+ * @brief   push samples into session statistics
+ *
+ * Function applies a pending reset, then adds len samples. Cost per sample is O(1): the Welford or
+ * integer sum update, two comparisons and one P^2 update per quantile.
+ * The s32 version is integer only; samples must be within +-2^30.
+ * Must be called from one task at a time.
+ *
+ * @param st: pointer to statistics structure, that must be initialized before
+ * @param[in] input: input samples
+ * @param len: length of the input array
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dsps_stats_f32(stats_f32_t *st, const float *input, int len);
+esp_err_t dsps_stats_s32(stats_s32_t *st, const int32_t *input, int len);
+/**@}*/
+
+/**@{*/
+/**
+ * @brief   merge session statistics
+ *
+ * Function adds the count, mean, variance and extremes of src to dst (Chan et al. pairwise update),
+ * for example to combine the statistics of several channels or sessions.
+ * The P^2 markers can not be merged exactly: the quantiles of dst are kept unchanged.
+ * Both structures must not be updated by another task during the call.
+ *
+ * @param dst: pointer to statistics structure that receives src
+ * @param src: pointer to statistics structure to add
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dsps_stats_merge_f32(stats_f32_t *dst, const stats_f32_t *src);
+esp_err_t dsps_stats_merge_s32(stats_s32_t *dst, const stats_s32_t *src);
+/**@}*/
+
+/**@{*/
+/**
+ * @brief   consistent copy of the session statistics
+ *
+ * Function could be called from any task while another task pushes samples. It never blocks the producer.
+ * The s32 version computes mean and standard deviation in floating point, once per snapshot.
+ *
+ * @param st: pointer to statistics structure, that must be initialized before
+ * @param[out] out: statistics of all the samples pushed before the last completed push
+ *
+ * @return
+ *      - ESP_OK on success
+ *      - ESP_ERR_INVALID_STATE if the producer was updating during DSPS_STATS_SNAPSHOT_RETRIES
+ *        attempts (the caller preempted it); try again later
+ */
+esp_err_t dsps_stats_snapshot_f32(const stats_f32_t *st, stats_summary_f32_t *out);
+esp_err_t dsps_stats_snapshot_s32(const stats_s32_t *st, stats_summary_s32_t *out);
+/**@}*/
+
+/**@{*/
+/**
+ * @brief   request a reset of the session statistics
+ *
+ * Function could be called from any task. The statistics are cleared by the producer before the next
+ * pushed sample, with the same quantiles. Samples pushed between a snapshot and the reset request are
+ * counted in neither session.
+ *
+ * @param st: pointer to statistics structure, that must be initialized before
+ *
+ * @return
+ *      - ESP_OK on success
+ */
+esp_err_t dsps_stats_reset_f32(stats_f32_t *st);
+esp_err_t dsps_stats_reset_s32(stats_s32_t *st);
+/**@}*/
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _dsps_stats_H_
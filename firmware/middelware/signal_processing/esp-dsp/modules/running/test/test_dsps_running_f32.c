@@ -0,0 +1,151 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsps_running.h"
+#include "dsp_tests.h"
+
+static const char *TAG = "dsps_running_f32";
+
+#define N_SAMPLES   1000
+#define MAX_WIN     33
+
+static float x[N_SAMPLES];
+static float y[N_SAMPLES];
+static float y2[N_SAMPLES];
+static float buf[MAX_WIN];
+static int16_t index_buf[2 * MAX_WIN];
+static float sorted[MAX_WIN];
+
+static int cmp_f32(const void *a, const void *b)
+{
+    float fa = *(const float *)a;
+    float fb = *(const float *)b;
+    return (fa > fb) - (fa < fb);
+}
+
+// Brute force statistics over the window that ends at sample i
+static void window_ref(int i, int win, float *mean, float *median, float *min, float *max)
+{
+    int first = (i + 1 >= win) ? i + 1 - win : 0;
+    int n = i + 1 - first;
+    float sum = 0;
+    *min = x[first];
+    *max = x[first];
+    for (int k = 0; k < n; k++) {
+        float v = x[first + k];
+        sorted[k] = v;
+        sum += v;
+        *min = fminf(*min, v);
+        *max = fmaxf(*max, v);
+    }
+    qsort(sorted, n, sizeof(float), cmp_f32);
+    *mean = sum / n;
+    *median = (n & 1) ? sorted[n / 2] : 0.5f * (sorted[n / 2 - 1] + sorted[n / 2]);
+}
+
+TEST_CASE("dsps_running_f32 functionality", "[dsps]")
+{
+    const int windows[] = {1, 2, 5, 16, MAX_WIN};
+    for (int i = 0; i < N_SAMPLES; i++) {
+        // Plenty of repeated values to exercise ties
+        x[i] = (float)((rand() % 200) - 100) * 0.25f;
+    }
+
+    for (int w = 0; w < sizeof(windows) / sizeof(windows[0]); w++) {
+        int win = windows[w];
+        runmean_f32_t rmean;
+        runmedian_f32_t rmed;
+        runminmax_f32_t rmm;
+        float mean, median, min, max;
+
+        TEST_ASSERT_EQUAL(ESP_OK, dsps_runmean_init_f32(&rmean, buf, win));
+        dsps_runmean_f32(&rmean, x, y, N_SAMPLES);
+        for (int i = 0; i < N_SAMPLES; i++) {
+            window_ref(i, win, &mean, &median, &min, &max);
+            TEST_ASSERT_FLOAT_WITHIN(1e-4f, mean, y[i]);
+        }
+
+        TEST_ASSERT_EQUAL(ESP_OK, dsps_runmedian_init_f32(&rmed, buf, index_buf, win));
+        // Sample by sample, the way it is used after a sensor driver
+        for (int i = 0; i < N_SAMPLES; i++) {
+            dsps_runmedian_f32(&rmed, &x[i], &y[i], 1);
+        }
+        for (int i = 0; i < N_SAMPLES; i++) {
+            window_ref(i, win, &mean, &median, &min, &max);
+            TEST_ASSERT_EQUAL_FLOAT(median, y[i]);
+        }
+
+        TEST_ASSERT_EQUAL(ESP_OK, dsps_runminmax_init_f32(&rmm, buf, index_buf, win));
+        dsps_runminmax_f32(&rmm, x, y, y2, N_SAMPLES);
+        for (int i = 0; i < N_SAMPLES; i++) {
+            window_ref(i, win, &mean, &median, &min, &max);
+            TEST_ASSERT_EQUAL_FLOAT(min, y[i]);
+            TEST_ASSERT_EQUAL_FLOAT(max, y2[i]);
+        }
+    }
+
+    // The compensated sum must not drift over a long session
+    runmean_f32_t rmean;
+    dsps_runmean_init_f32(&rmean, buf, 16);
+    for (int i = 0; i < N_SAMPLES; i++) {
+        x[i] = 1000.0f + (float)(rand() % 1000) * 0.001f;
+    }
+    for (int r = 0; r < 200; r++) {
+        dsps_runmean_f32(&rmean, x, y, N_SAMPLES);
+    }
+    float sum = 0;
+    for (int i = N_SAMPLES - 16; i < N_SAMPLES; i++) {
+        sum += x[i];
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, sum / 16, y[N_SAMPLES - 1]);
+
+    runmedian_f32_t rmed;
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_LENGTH, dsps_runmedian_init_f32(&rmed, buf, index_buf, 0));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_PARAM, dsps_runmedian_init_f32(&rmed, buf, NULL, 8));
+}
+
+TEST_CASE("dsps_running_f32 benchmark", "[dsps]")
+{
+    const int win = MAX_WIN;
+    runmean_f32_t rmean;
+    runmedian_f32_t rmed;
+    runminmax_f32_t rmm;
+    for (int i = 0; i < N_SAMPLES; i++) {
+        x[i] = (float)(rand() % 4096);
+    }
+
+    dsps_runmean_init_f32(&rmean, buf, win);
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    dsps_runmean_f32(&rmean, x, y, N_SAMPLES);
+    unsigned int end_b = dsp_get_cpu_cycle_count();
+    float cycles_mean = (float)(end_b - start_b) / N_SAMPLES;
+
+    dsps_runmedian_init_f32(&rmed, buf, index_buf, win);
+    start_b = dsp_get_cpu_cycle_count();
+    dsps_runmedian_f32(&rmed, x, y, N_SAMPLES);
+    end_b = dsp_get_cpu_cycle_count();
+    float cycles_median = (float)(end_b - start_b) / N_SAMPLES;
+
+    dsps_runminmax_init_f32(&rmm, buf, index_buf, win);
+    start_b = dsp_get_cpu_cycle_count();
+    dsps_runminmax_f32(&rmm, x, y, y2, N_SAMPLES);
+    end_b = dsp_get_cpu_cycle_count();
+    float cycles_minmax = (float)(end_b - start_b) / N_SAMPLES;
+
+    ESP_LOGI(TAG, "window %i: mean %f, median %f, min/max %f cycles per sample", win, cycles_mean, cycles_median, cycles_minmax);
+
+    float min_exec = 1;
+    float max_exec = 2000;
+    TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles_median);
+}
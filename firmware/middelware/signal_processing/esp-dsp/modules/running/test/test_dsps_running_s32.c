@@ -0,0 +1,135 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsps_running.h"
+#include "dsp_tests.h"
+
+static const char *TAG = "dsps_running_s32";
+
+#define N_SAMPLES   1000
+#define MAX_WIN     33
+
+static int32_t x[N_SAMPLES];
+static int32_t y[N_SAMPLES];
+static int32_t y2[N_SAMPLES];
+static int32_t buf[MAX_WIN];
+static int16_t index_buf[2 * MAX_WIN];
+static int32_t sorted[MAX_WIN];
+
+static int cmp_s32(const void *a, const void *b)
+{
+    int32_t ia = *(const int32_t *)a;
+    int32_t ib = *(const int32_t *)b;
+    return (ia > ib) - (ia < ib);
+}
+
+// Brute force statistics over the window that ends at sample i
+static void window_ref(int i, int win, int32_t *mean, int32_t *median, int32_t *min, int32_t *max)
+{
+    int first = (i + 1 >= win) ? i + 1 - win : 0;
+    int n = i + 1 - first;
+    int64_t sum = 0;
+    *min = x[first];
+    *max = x[first];
+    for (int k = 0; k < n; k++) {
+        int32_t v = x[first + k];
+        sorted[k] = v;
+        sum += v;
+        *min = (v < *min) ? v : *min;
+        *max = (v > *max) ? v : *max;
+    }
+    qsort(sorted, n, sizeof(int32_t), cmp_s32);
+    *mean = (int32_t)((sum >= 0) ? (sum + n / 2) / n : (sum - n / 2) / n);
+    *median = (n & 1) ? sorted[n / 2] : (int32_t)(((int64_t)sorted[n / 2 - 1] + sorted[n / 2]) / 2);
+}
+
+TEST_CASE("dsps_running_s32 functionality", "[dsps]")
+{
+    const int windows[] = {1, 2, 5, 16, MAX_WIN};
+    for (int i = 0; i < N_SAMPLES; i++) {
+        // 24 bit samples, as returned by the HX711, with repeated values to exercise ties
+        x[i] = ((rand() % 64) - 32) * 0x3ffff;
+    }
+
+    for (int w = 0; w < sizeof(windows) / sizeof(windows[0]); w++) {
+        int win = windows[w];
+        runmean_s32_t rmean;
+        runmedian_s32_t rmed;
+        runminmax_s32_t rmm;
+        int32_t mean, median, min, max;
+
+        TEST_ASSERT_EQUAL(ESP_OK, dsps_runmean_init_s32(&rmean, buf, win));
+        dsps_runmean_s32(&rmean, x, y, N_SAMPLES);
+        for (int i = 0; i < N_SAMPLES; i++) {
+            window_ref(i, win, &mean, &median, &min, &max);
+            TEST_ASSERT_EQUAL(mean, y[i]);
+        }
+
+        TEST_ASSERT_EQUAL(ESP_OK, dsps_runmedian_init_s32(&rmed, buf, index_buf, win));
+        // Sample by sample, the way it is used after a sensor driver
+        for (int i = 0; i < N_SAMPLES; i++) {
+            dsps_runmedian_s32(&rmed, &x[i], &y[i], 1);
+        }
+        for (int i = 0; i < N_SAMPLES; i++) {
+            window_ref(i, win, &mean, &median, &min, &max);
+            TEST_ASSERT_EQUAL(median, y[i]);
+        }
+
+        TEST_ASSERT_EQUAL(ESP_OK, dsps_runminmax_init_s32(&rmm, buf, index_buf, win));
+        dsps_runminmax_s32(&rmm, x, y, y2, N_SAMPLES);
+        for (int i = 0; i < N_SAMPLES; i++) {
+            window_ref(i, win, &mean, &median, &min, &max);
+            TEST_ASSERT_EQUAL(min, y[i]);
+            TEST_ASSERT_EQUAL(max, y2[i]);
+        }
+    }
+
+    runminmax_s32_t rmm;
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_LENGTH, dsps_runminmax_init_s32(&rmm, buf, index_buf, 0));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_PARAM, dsps_runminmax_init_s32(&rmm, NULL, index_buf, 8));
+}
+
+TEST_CASE("dsps_running_s32 benchmark", "[dsps]")
+{
+    const int win = MAX_WIN;
+    runmean_s32_t rmean;
+    runmedian_s32_t rmed;
+    runminmax_s32_t rmm;
+    for (int i = 0; i < N_SAMPLES; i++) {
+        x[i] = rand() % 4096;
+    }
+
+    dsps_runmean_init_s32(&rmean, buf, win);
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    dsps_runmean_s32(&rmean, x, y, N_SAMPLES);
+    unsigned int end_b = dsp_get_cpu_cycle_count();
+    float cycles_mean = (float)(end_b - start_b) / N_SAMPLES;
+
+    dsps_runmedian_init_s32(&rmed, buf, index_buf, win);
+    start_b = dsp_get_cpu_cycle_count();
+    dsps_runmedian_s32(&rmed, x, y, N_SAMPLES);
+    end_b = dsp_get_cpu_cycle_count();
+    float cycles_median = (float)(end_b - start_b) / N_SAMPLES;
+
+    dsps_runminmax_init_s32(&rmm, buf, index_buf, win);
+    start_b = dsp_get_cpu_cycle_count();
+    dsps_runminmax_s32(&rmm, x, y, y2, N_SAMPLES);
+    end_b = dsp_get_cpu_cycle_count();
+    float cycles_minmax = (float)(end_b - start_b) / N_SAMPLES;
+
+    ESP_LOGI(TAG, "window %i: mean %f, median %f, min/max %f cycles per sample", win, cycles_mean, cycles_median, cycles_minmax);
+
+    float min_exec = 1;
+    float max_exec = 2000;
+    TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles_median);
+}
@@ -0,0 +1,166 @@
+/*
+ * SPDX-FileCopyrightText: 2025 Electronica Programable - FIUNER
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "unity.h"
+#include "esp_dsp.h"
+#include "dsp_platform.h"
+#include "esp_log.h"
+
+#include "dsps_stats.h"
+#include "dsp_tests.h"
+
+static const char *TAG = "dsps_stats_f32";
+
+#define N_SAMPLES   10000
+
+static float x[N_SAMPLES];
+static float sorted[N_SAMPLES];
+
+static int cmp_f32(const void *a, const void *b)
+{
+    float fa = *(const float *)a;
+    float fb = *(const float *)b;
+    return (fa > fb) - (fa < fb);
+}
+
+// Brute force statistics of x[0..n-1], quantiles by nearest rank
+static void stats_ref(int n, const float *p, int n_q, stats_summary_f32_t *ref)
+{
+    double sum = 0;
+    double sum2 = 0;
+    for (int i = 0; i < n; i++) {
+        sum += x[i];
+        sorted[i] = x[i];
+    }
+    double mean = sum / n;
+    for (int i = 0; i < n; i++) {
+        sum2 += (x[i] - mean) * (x[i] - mean);
+    }
+    qsort(sorted, n, sizeof(float), cmp_f32);
+    ref->count = n;
+    ref->mean = (float)mean;
+    ref->std = (n > 1) ? (float)sqrt(sum2 / (n - 1)) : 0;
+    ref->min = sorted[0];
+    ref->max = sorted[n - 1];
+    for (int i = 0; i < n_q; i++) {
+        ref->quantile[i] = sorted[(int)(p[i] * (n - 1) + 0.5f)];
+    }
+}
+
+TEST_CASE("dsps_stats_f32 functionality", "[dsps]")
+{
+    const float p[] = {0.5f, 0.95f, 0.05f};
+    const int n_q = sizeof(p) / sizeof(p[0]);
+    stats_f32_t st;
+    stats_f32_t st2;
+    stats_summary_f32_t s;
+    stats_summary_f32_t ref;
+
+    // Load cell readings: offset, noise and a few outliers
+    for (int i = 0; i < N_SAMPLES; i++) {
+        float noise = 0;
+        for (int k = 0; k < 4; k++) {
+            noise += (float)(rand() % 1001 - 500);
+        }
+        x[i] = 12500.0f + noise * 0.01f + (((rand() % 100) == 0) ? 300.0f : 0);
+    }
+
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_stats_init_f32(&st, p, n_q));
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_stats_snapshot_f32(&st, &s));
+    TEST_ASSERT_EQUAL(0, s.count);
+
+    // Exact while there are less than five samples
+    for (int n = 1; n < 5; n++) {
+        dsps_stats_f32(&st, &x[n - 1], 1);
+        dsps_stats_snapshot_f32(&st, &s);
+        stats_ref(n, p, n_q, &ref);
+        TEST_ASSERT_EQUAL(n, s.count);
+        TEST_ASSERT_EQUAL_FLOAT(ref.min, s.min);
+        TEST_ASSERT_EQUAL_FLOAT(ref.max, s.max);
+        for (int i = 0; i < n_q; i++) {
+            TEST_ASSERT_EQUAL_FLOAT(ref.quantile[i], s.quantile[i]);
+        }
+    }
+
+    dsps_stats_f32(&st, &x[4], N_SAMPLES - 4);
+    dsps_stats_snapshot_f32(&st, &s);
+    stats_ref(N_SAMPLES, p, n_q, &ref);
+    ESP_LOGI(TAG, "mean %f/%f, std %f/%f, p50 %f/%f, p95 %f/%f, p5 %f/%f", s.mean, ref.mean, s.std, ref.std,
+             s.quantile[0], ref.quantile[0], s.quantile[1], ref.quantile[1], s.quantile[2], ref.quantile[2]);
+    TEST_ASSERT_EQUAL(N_SAMPLES, s.count);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f * ref.std, ref.mean, s.mean);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f * ref.std, ref.std, s.std);
+    TEST_ASSERT_EQUAL_FLOAT(ref.min, s.min);
+    TEST_ASSERT_EQUAL_FLOAT(ref.max, s.max);
+    for (int i = 0; i < n_q; i++) {
+        TEST_ASSERT_FLOAT_WITHIN(0.05f * ref.std, ref.quantile[i], s.quantile[i]);
+    }
+
+    // Two halves merged give the statistics of the whole session
+    dsps_stats_init_f32(&st, p, n_q);
+    dsps_stats_init_f32(&st2, p, n_q);
+    dsps_stats_f32(&st, x, N_SAMPLES / 3);
+    dsps_stats_f32(&st2, &x[N_SAMPLES / 3], N_SAMPLES - N_SAMPLES / 3);
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_stats_merge_f32(&st, &st2));
+    dsps_stats_snapshot_f32(&st, &s);
+    TEST_ASSERT_EQUAL(N_SAMPLES, s.count);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f * ref.std, ref.mean, s.mean);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f * ref.std, ref.std, s.std);
+    TEST_ASSERT_EQUAL_FLOAT(ref.min, s.min);
+    TEST_ASSERT_EQUAL_FLOAT(ref.max, s.max);
+
+    // A reset is applied by the producer, a snapshot in between reports an empty session
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_stats_reset_f32(&st));
+    dsps_stats_snapshot_f32(&st, &s);
+    TEST_ASSERT_EQUAL(0, s.count);
+    dsps_stats_f32(&st, x, 100);
+    dsps_stats_snapshot_f32(&st, &s);
+    stats_ref(100, p, n_q, &ref);
+    TEST_ASSERT_EQUAL(100, s.count);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f * ref.std, ref.mean, s.mean);
+    TEST_ASSERT_EQUAL_FLOAT(ref.min, s.min);
+
+    // Producer preempted in the middle of an update
+    st.seq++;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, dsps_stats_snapshot_f32(&st, &s));
+    st.seq++;
+    TEST_ASSERT_EQUAL(ESP_OK, dsps_stats_snapshot_f32(&st, &s));
+
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_LENGTH, dsps_stats_init_f32(&st, p, DSPS_STATS_MAX_QUANTILES + 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_INVALID_PARAM, dsps_stats_init_f32(&st, NULL, 1));
+    const float bad = 1.0f;
+    TEST_ASSERT_EQUAL(ESP_ERR_DSP_PARAM_OUTOFRANGE, dsps_stats_init_f32(&st, &bad, 1));
+}
+
+TEST_CASE("dsps_stats_f32 benchmark", "[dsps]")
+{
+    const float p[] = {0.5f, 0.95f};
+    stats_f32_t st;
+    for (int i = 0; i < N_SAMPLES; i++) {
+        x[i] = (float)(rand() % 4096);
+    }
+
+    dsps_stats_init_f32(&st, NULL, 0);
+    unsigned int start_b = dsp_get_cpu_cycle_count();
+    dsps_stats_f32(&st, x, N_SAMPLES);
+    unsigned int end_b = dsp_get_cpu_cycle_count();
+    float cycles_moments = (float)(end_b - start_b) / N_SAMPLES;
+
+    dsps_stats_init_f32(&st, p, 2);
+    start_b = dsp_get_cpu_cycle_count();
+    dsps_stats_f32(&st, x, N_SAMPLES);
+    end_b = dsp_get_cpu_cycle_count();
+    float cycles_quantiles = (float)(end_b - start_b) / N_SAMPLES;
+
+    ESP_LOGI(TAG, "mean/std/min/max %f, with median and p95 %f cycles per sample", cycles_moments, cycles_quantiles);
+
+    float min_exec = 1;
+    float max_exec = 2000;
+    TEST_ASSERT_EXEC_IN_RANGE(min_exec, max_exec, cycles_quantiles);
+}